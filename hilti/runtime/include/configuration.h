@@ -56,6 +56,13 @@ struct Configuration {
      **/
     bool enable_profiling = false;
 
+    /**
+     * Take profiling measurements through the CPU's cycle counter instead of
+     * the system's monotonic clock. That's cheaper, but reports times in
+     * cycles instead of nanoseconds. Default comes from HILTI_PROFILER_CYCLES.
+     **/
+    bool profiling_use_cycle_counter = false;
+
     /** Colon-separated list of debug streams to enable. Default comes from HILTI_DEBUG. */
     std::string debug_streams;
 
@@ -80,6 +87,14 @@ inline const Configuration& unsafeGet() {
     return *detail::__configuration;
 }
 
+/**
+ * Returns the stream that `hilti::print()` writes to. That's the current
+ * context's `cout` if set, and the configuration's `cout` otherwise.
+ *
+ * @return output stream, or null if printing is silenced
+ */
+extern std::ostream* printStream();
+
 } // namespace detail
 
 /**
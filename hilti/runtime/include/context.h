@@ -4,6 +4,7 @@
 
 #include <cassert>
 #include <memory>
+#include <ostream>
 #include <utility>
 #include <vector>
 
@@ -54,6 +55,13 @@ struct Context {
      */
     std::vector<std::shared_ptr<void>> hilti_globals;
 
+    /**
+     * Output stream for `hilti::print()` while executing inside this
+     * context, overriding `Configuration::cout`; null if not set. Ownership
+     * remains with the caller.
+     */
+    std::ostream* cout = nullptr;
+
     /** A user-defined cookie value that's carried around with the context. */
     void* cookie = nullptr;
 
@@ -2,14 +2,88 @@
 
 #pragma once
 
+#include <cstdint>
 #include <fstream>
-#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <string_view>
+#include <vector>
 
+#include <hilti/rt/autogen/config.h>
 #include <hilti/rt/filesystem.h>
 #include <hilti/rt/util.h>
 
+#ifndef HILTI_RT_DISABLED_DEBUG_STREAMS
+#define HILTI_RT_DISABLED_DEBUG_STREAMS ""
+#endif
+
+namespace hilti::rt::debug {
+
+/**
+ * Handle to a debug stream. Each stream name maps to a small integer ID that
+ * remains the same for the lifetime of the process, which allows checking
+ * whether a stream is enabled through a simple bitmask test. IDs are
+ * assigned on first use of a name.
+ *
+ * Instantiating a handle from a name goes through a per-thread cache keyed
+ * by the address of the name, so that repeated lookups with the same
+ * (typically literal) string are cheap. Still, where possible, resolve a
+ * stream just once and then hold on to its handle.
+ */
+class Stream {
+public:
+    /**
+     * Constructor resolving a stream name to its ID.
+     *
+     * @param name name of the stream
+     */
+    Stream(std::string_view name); // NOLINT(google-explicit-constructor)
+
+    Stream(const char* name) : Stream(std::string_view(name)) {}        // NOLINT(google-explicit-constructor)
+    Stream(const std::string& name) : Stream(std::string_view(name)) {} // NOLINT(google-explicit-constructor)
+
+    /** Returns the stream's ID. */
+    uint64_t id() const { return _id; }
+
+    /** Returns the stream's name. */
+    std::string_view name() const { return _name; }
+
+private:
+    uint64_t _id;
+    std::string_view _name; // points into the global registry of streams
+};
+
+namespace detail {
+
+/**
+ * Returns true if debug output for a stream has been disabled at build time
+ * through the `HILTI_DISABLED_DEBUG_STREAMS` CMake option. Logging macros and
+ * functions check this first, so that with a constant stream name, the
+ * compiler removes their code altogether.
+ *
+ * @param stream name of the stream to check
+ * @param disabled colon-separated list of streams disabled
+ */
+constexpr bool isCompiledOut(std::string_view stream,
+                             std::string_view disabled = HILTI_RT_DISABLED_DEBUG_STREAMS) {
+    while ( ! disabled.empty() ) {
+        auto n = disabled.find(':');
+        if ( disabled.substr(0, n) == stream )
+            return true;
+
+        if ( n == std::string_view::npos )
+            break;
+
+        disabled.remove_prefix(n + 1);
+    }
+
+    return false;
+}
+
+} // namespace detail
+} // namespace hilti::rt::debug
+
 namespace hilti::rt::detail {
 
 /** Logger for runtime debug messages. */
@@ -17,31 +91,41 @@ class DebugLogger {
 public:
     DebugLogger(hilti::rt::filesystem::path output);
 
-    void print(std::string_view stream, std::string_view msg);
+    void print(const debug::Stream& stream, std::string_view msg);
     void enable(std::string_view streams);
 
-    bool isEnabled(std::string_view stream) { return _streams.find(stream) != _streams.end(); }
+    /** Returns true if a stream is enabled. This is just a bitmask test. */
+    bool isEnabled(const debug::Stream& stream) const {
+        auto word = stream.id() / 64;
+        return word < _enabled.size() && (_enabled[word] & (uint64_t(1) << (stream.id() % 64)));
+    }
 
-    void indent(std::string_view stream) {
-        if ( auto s = _streams.find(stream); s != _streams.end() ) {
-            auto& indent = s->second;
-            indent += 1;
-        }
+    void indent(const debug::Stream& stream) {
+        if ( ! isEnabled(stream) )
+            return;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto& indent = _indent[stream.id()];
+        indent += 1;
     }
 
-    void dedent(std::string_view stream) {
-        if ( auto s = _streams.find(stream); s != _streams.end() ) {
-            auto& indent = s->second;
-            if ( indent > 0 )
-                indent -= 1;
-        }
+    void dedent(const debug::Stream& stream) {
+        if ( ! isEnabled(stream) )
+            return;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto& indent = _indent[stream.id()];
+        if ( indent > 0 )
+            indent -= 1;
     }
 
 private:
     hilti::rt::filesystem::path _path;
     std::ostream* _output = nullptr;
     std::unique_ptr<std::ofstream> _output_file;
-    std::map<std::string_view, integer::safe<uint64_t>> _streams;
+    std::vector<uint64_t> _enabled;               // bitmask of enabled streams, indexed by stream ID
+    std::vector<integer::safe<uint64_t>> _indent; // indentation level per stream ID
+    std::mutex _mutex;                            // serializes output and indentation changes across threads
 };
 
 } // namespace hilti::rt::detail
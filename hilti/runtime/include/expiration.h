@@ -0,0 +1,267 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+/**
+ * Bookkeeping for automatic expiration of container elements.
+ *
+ * A `Tracker` records a deadline for each key of a container and keeps a
+ * priority queue of upcoming deadlines. Removing expired elements then only
+ * needs to look at the head of that queue, so each expiration costs
+ * logarithmic time and we never scan the full container.
+ *
+ * Refreshing a key's deadline on access only updates its recorded deadline;
+ * the key's queue entry remains in place and gets rescheduled lazily once it
+ * reaches the head of the queue, so accesses never grow the queue. Removing
+ * or re-adding a key leaves its old entry behind as stale; once stale
+ * entries make up the majority of the queue, we rebuild it from the
+ * recorded deadlines. That keeps the queue's size within a constant factor
+ * of the number of keys tracked.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <queue>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <hilti/rt/hash.h>
+#include <hilti/rt/types/interval.h>
+#include <hilti/rt/types/time.h>
+
+namespace hilti::rt::expiration {
+
+/** Selects the time source that expiration deadlines refer to. */
+enum class Clock {
+    Network, /**< time as set by the host application through `time::set_network_time()` */
+    Wall,    /**< current wall clock time */
+};
+
+/** Defines when the elements of a container expire. */
+struct Policy {
+    Interval timeout;             /**< time after which an element expires */
+    bool refresh_on_write = true; /**< assigning to an existing element restarts its timeout */
+    bool refresh_on_read = true;  /**< looking up an element restarts its timeout */
+    Clock clock = Clock::Wall;    /**< time source to measure the timeout against */
+};
+
+/** Returns the current time according to a clock. */
+inline Time now(Clock clock) { return clock == Clock::Network ? time::network_time() : time::current_time(); }
+
+/**
+ * Tracks expiration deadlines for the keys of a container.
+ *
+ * A default-constructed tracker is disabled, and costs no more than a single
+ * pointer. Copying a tracker copies all its state.
+ *
+ * @tparam K key type of the container
+ * @tparam Unordered true to index keys through a hash table instead of a tree
+ * @tparam Callback type of the function to call for each expired element
+ */
+template<typename K, bool Unordered, typename Callback>
+class Tracker {
+public:
+    Tracker() = default;
+    Tracker(const Tracker& other) : _state(other._state ? std::make_unique<State>(*other._state) : nullptr) {}
+    Tracker(Tracker&&) noexcept = default;
+    ~Tracker() = default;
+
+    Tracker& operator=(const Tracker& other) {
+        if ( &other != this )
+            _state = (other._state ? std::make_unique<State>(*other._state) : nullptr);
+
+        return *this;
+    }
+
+    Tracker& operator=(Tracker&&) noexcept = default;
+
+    /** Returns true if expiration has been enabled. */
+    explicit operator bool() const { return _state != nullptr; }
+
+    /**
+     * Enables expiration with a given policy. If expiration was already
+     * enabled, the new policy applies to deadlines computed from now on.
+     * Keys already in the container must be recorded through `created()`
+     * afterwards.
+     *
+     * @param policy the policy to apply
+     */
+    void enable(Policy policy) {
+        if ( ! _state )
+            _state = std::make_unique<State>();
+
+        _state->policy = policy;
+    }
+
+    /** Returns the policy in effect. Must only be called when enabled. */
+    const Policy& policy() const { return _state->policy; }
+
+    /** Returns the current time according to the policy's clock. Must only be called when enabled. */
+    Time now() const { return expiration::now(_state->policy.clock); }
+
+    /** Returns the number of elements that have expired so far. */
+    uint64_t numExpired() const { return _state ? _state->num_expired : 0; }
+
+    /** Returns the callback to execute for expired elements, which may be unset. */
+    const Callback& callback() const { return _state->callback; }
+
+    /** Sets a callback to execute for each element right before it expires. Must only be called when enabled. */
+    void setCallback(Callback cb) { _state->callback = std::move(cb); }
+
+    /**
+     * Records that a key has been added to the container.
+     *
+     * @param k the new key
+     * @param t current time
+     */
+    void created(const K& k, Time t) { track(k, t); }
+
+    /**
+     * Records that an existing key has been assigned a new value.
+     *
+     * @param k the key
+     * @param t current time
+     */
+    void written(const K& k, Time t) {
+        if ( _state->policy.refresh_on_write )
+            refresh(k, t);
+    }
+
+    /**
+     * Records that an existing key has been looked up.
+     *
+     * @param k the key
+     * @param t current time
+     */
+    void read(const K& k, Time t) const {
+        if ( _state->policy.refresh_on_read )
+            refresh(k, t);
+    }
+
+    /**
+     * Checks whether a key has passed its deadline, even if not removed yet.
+     *
+     * @param k the key
+     * @param t current time
+     */
+    bool isExpired(const K& k, Time t) const {
+        if ( auto i = _state->deadlines.find(k); i != _state->deadlines.end() )
+            return i->second.deadline <= t;
+
+        return false;
+    }
+
+    /**
+     * Records that a key has been removed from the container. Its entry in
+     * the queue goes stale and will be skipped once it reaches the head.
+     *
+     * @param k the removed key
+     */
+    void removed(const K& k) { _state->deadlines.erase(k); }
+
+    /** Records that all keys have been removed from the container. */
+    void cleared() {
+        _state->deadlines.clear();
+        _state->queue = Queue();
+    }
+
+    /**
+     * Removes all keys whose deadline has passed.
+     *
+     * @param t current time
+     * @param erase function receiving each expired key, which must then
+     *        remove the corresponding element from the container
+     * @return the number of keys expired
+     */
+    template<typename Erase>
+    uint64_t expire(Time t, Erase&& erase) {
+        uint64_t n = 0;
+        auto& queue = _state->queue;
+        auto& deadlines = _state->deadlines;
+
+        while ( ! queue.empty() && queue.top().deadline <= t ) {
+            auto next = queue.top();
+            queue.pop();
+
+            auto i = deadlines.find(next.key);
+            if ( i == deadlines.end() || i->second.seqno != next.seqno )
+                continue; // stale entry for a key that has been removed, and possibly re-added
+
+            if ( i->second.deadline > t ) {
+                // Refreshed since we queued it, reschedule.
+                next.deadline = i->second.deadline;
+                queue.push(std::move(next));
+                continue;
+            }
+
+            deadlines.erase(i);
+            ++n;
+            erase(next.key);
+        }
+
+        _state->num_expired += n;
+        return n;
+    }
+
+private:
+    struct Deadline {
+        Time deadline;
+        uint64_t seqno;
+    };
+
+    struct Entry {
+        Time deadline;
+        uint64_t seqno;
+        K key;
+
+        friend bool operator>(const Entry& a, const Entry& b) { return a.deadline > b.deadline; }
+    };
+
+    using Deadlines = std::conditional_t<Unordered, std::unordered_map<K, Deadline, Hash<K>>, std::map<K, Deadline>>;
+    using Queue = std::priority_queue<Entry, std::vector<Entry>, std::greater<>>;
+
+    struct State {
+        Policy policy;
+        Deadlines deadlines;
+        Queue queue;
+        uint64_t seqno = 0;
+        uint64_t num_expired = 0;
+        Callback callback;
+    };
+
+    void track(const K& k, Time t) {
+        auto deadline = t + _state->policy.timeout;
+        auto seqno = ++_state->seqno;
+        _state->deadlines.insert_or_assign(k, Deadline{deadline, seqno});
+        _state->queue.push(Entry{deadline, seqno, k});
+
+        if ( _state->queue.size() > 2 * _state->deadlines.size() + 64 )
+            compact();
+    }
+
+    // Rebuilds the queue from the recorded deadlines, dropping all stale entries.
+    void compact() {
+        std::vector<Entry> entries;
+        entries.reserve(_state->deadlines.size());
+
+        for ( const auto& [k, d] : _state->deadlines )
+            entries.push_back(Entry{d.deadline, d.seqno, k});
+
+        _state->queue = Queue(std::greater<>(), std::move(entries));
+    }
+
+    void refresh(const K& k, Time t) const {
+        if ( auto i = _state->deadlines.find(k); i != _state->deadlines.end() )
+            i->second.deadline = t + _state->policy.timeout;
+    }
+
+    // Refreshing on reads updates the state from const contexts, so we hold
+    // it through a pointer; it's not part of the container's value.
+    std::unique_ptr<State> _state;
+};
+
+} // namespace hilti::rt::expiration
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <csetjmp>
 #include <memory>
 #include <optional>
@@ -281,20 +282,40 @@ private:
     } _asan;
 #endif
 
-    // TODO: Usage of these isn't thread-safe. Should become "atomic" and
-    // move into global state.
-    inline static uint64_t _total_fibers;
-    inline static uint64_t _current_fibers;
-    inline static uint64_t _cached_fibers;
-    inline static uint64_t _max_fibers;
-    inline static uint64_t _max_stack_size;
-    inline static uint64_t _initialized; // number of trampolines run
+    // Process-wide statistics. These are shared across all contexts, which
+    // may be running concurrently on separate threads.
+    inline static std::atomic<uint64_t> _total_fibers;
+    inline static std::atomic<uint64_t> _current_fibers;
+    inline static std::atomic<uint64_t> _cached_fibers;
+    inline static std::atomic<uint64_t> _max_fibers;
+    inline static std::atomic<uint64_t> _max_stack_size;
+    inline static std::atomic<uint64_t> _initialized; // number of trampolines run
 };
 
 std::ostream& operator<<(std::ostream& out, const Fiber& fiber);
 
 extern void yield();
 
+/**
+ * Marks a scope as executing a function directly on the caller's stack,
+ * rather than inside a fiber. While the scope is active, there's no
+ * resumable function to suspend, so that any attempt to yield raises an
+ * exception.
+ */
+class DirectExecutionScope {
+public:
+    DirectExecutionScope();
+    ~DirectExecutionScope();
+
+    DirectExecutionScope(const DirectExecutionScope&) = delete;
+    DirectExecutionScope(DirectExecutionScope&&) = delete;
+    DirectExecutionScope& operator=(const DirectExecutionScope&) = delete;
+    DirectExecutionScope& operator=(DirectExecutionScope&&) = delete;
+
+private:
+    resumable::Handle* _previous; // resumable active when entering the scope
+};
+
 } // namespace detail
 
 /**
@@ -330,6 +351,31 @@ public:
             }
     }
 
+    /**
+     * Executes a function directly on the caller's stack, without setting up
+     * a fiber for it. That saves the fiber's allocation and the context
+     * switches into and out of it, but the function cannot suspend: an
+     * attempt to yield raises a `RuntimeError`. Use this only for functions
+     * that are known to run to completion, such as parsers operating on
+     * input that has already been frozen. Exceptions thrown by the function
+     * propagate to the caller.
+     *
+     * @param f function to be executed; it receives a null handle
+     * @return an instance that has already completed, carrying the function's result
+     */
+    template<typename Function, typename = std::enable_if_t<std::is_invocable_v<Function, resumable::Handle*>>>
+    static Resumable runDirectly(Function f) {
+        Resumable r;
+
+        {
+            detail::DirectExecutionScope _;
+            r._result = f(nullptr);
+        }
+
+        r._done = true;
+        return r;
+    }
+
     /** Starts execution of the function. This must be called only once. */
     void run();
 
@@ -407,6 +453,38 @@ ValueReference<T> copyArg(ValueReference<T>& t) {
     return ValueReference<T>(t.asSharedPtr());
 }
 
+/** Helper template to detect types that can be frozen, like streams. */
+template<typename T, typename = void>
+struct has_is_frozen : std::false_type {};
+
+template<typename T>
+struct has_is_frozen<T, std::void_t<decltype(std::declval<const T&>().isFrozen())>> : std::true_type {};
+
+/** Helper for `isInputFrozen()` checking a single argument. */
+template<typename T>
+bool isFrozen(const T& /* t */) {
+    return true;
+}
+
+template<typename T>
+bool isFrozen(const ValueReference<T>& t) {
+    if constexpr ( has_is_frozen<T>::value )
+        return t->isFrozen();
+    else
+        return true;
+}
+
+/**
+ * Returns true if all input that a function receives through its arguments
+ * has been frozen, meaning that the function will never need to suspend to
+ * wait for more of it. Input is passed as value references to streams;
+ * arguments of other types are ignored.
+ */
+template<typename... Args>
+bool isInputFrozen(const Args&... args) {
+    return (isFrozen(args) && ...);
+}
+
 } // namespace resumable::detail
 
 namespace fiber {
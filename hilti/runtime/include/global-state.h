@@ -3,6 +3,7 @@
 #pragma once
 #include <sys/resource.h>
 
+#include <atomic>
 #include <clocale>
 #include <memory>
 #include <string>
@@ -13,6 +14,7 @@
 #include <hilti/rt/debug-logger.h>
 #include <hilti/rt/init.h>
 #include <hilti/rt/profiler-state.h>
+#include <hilti/rt/types/time.h>
 
 // We collect all (or most) of the runtime's global state centrally. That's
 // 1st good to see what we have (global state should be minimal) and 2nd
@@ -26,7 +28,7 @@ namespace hilti::rt {
 struct Configuration;
 
 namespace regexp::detail {
-class CompiledRegExp;
+class Cache;
 } // namespace regexp::detail
 
 } // namespace hilti::rt
@@ -50,14 +52,11 @@ struct GlobalState {
     bool profiling_enabled = false;
 
     /** If not zero, `Configuration::abort_on_exception` is disabled. */
-    int disable_abort_on_exceptions = 0;
+    std::atomic<int> disable_abort_on_exceptions{0};
 
     /** Resource usage at library initialization time. */
     ResourceUsage resource_usage_init;
 
-    /** Profiler's global measurements. */
-    std::unordered_map<std::string, profiler::detail::MeasurementState> profilers;
-
     /** Debug logger recording runtime diagnostics. */
     std::unique_ptr<hilti::rt::detail::DebugLogger> debug_logger;
 
@@ -73,8 +72,11 @@ struct GlobalState {
      */
     std::vector<hilti::rt::detail::HiltiModule> hilti_modules;
 
-    /** Cache of already compiled regular expressions. */
-    std::unordered_map<std::string, std::shared_ptr<regexp::detail::CompiledRegExp>> regexp_cache;
+    /** Cache of already compiled regular expressions. Safe to access from multiple threads. */
+    std::unique_ptr<regexp::detail::Cache> regexp_cache;
+
+    /** Current network time, as set by the host application. */
+    Time network_time;
 
     /** Cached C locale for use with C library functions. */
     std::optional<locale_t> c_locale;
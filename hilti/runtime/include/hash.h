@@ -0,0 +1,90 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+/**
+ * Hashing support for runtime values used as keys of unordered containers.
+ *
+ * Runtime types provide `std::hash` specializations in their own headers.
+ * `hilti::rt::Hash` builds on those and additionally covers the types for
+ * which we cannot specialize `std::hash` upfront: enums generated for HILTI
+ * code, and tuples.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace hilti::rt {
+
+namespace hash {
+
+/**
+ * Combines a seed with another hash value. This follows the mixing used by
+ * Boost's `hash_combine`, with the golden ratio constant widened to 64 bits.
+ */
+inline std::size_t combine(std::size_t seed, std::size_t h) {
+    return seed ^ (h + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+namespace detail {
+
+/** Helper template to detect runtime enums created through `HILTI_RT_ENUM_WITH_DEFAULT`. */
+template<typename T, typename = void>
+struct is_enum : std::false_type {};
+
+template<typename T>
+struct is_enum<T, std::void_t<typename T::Value, decltype(std::declval<const T&>().value())>>
+    : std::is_same<decltype(std::declval<const T&>().value()), int64_t> {};
+
+} // namespace detail
+
+} // namespace hash
+
+/**
+ * Hash function object for runtime values. By default this defers to
+ * `std::hash`, with specializations for types that don't come with one.
+ */
+template<typename T, typename = void>
+struct Hash {
+    std::size_t operator()(const T& x) const { return std::hash<T>()(x); }
+};
+
+template<typename T>
+struct Hash<T, std::enable_if_t<hash::detail::is_enum<T>::value>> {
+    std::size_t operator()(const T& x) const { return std::hash<int64_t>()(x.value()); }
+};
+
+template<typename T>
+struct Hash<std::optional<T>> {
+    std::size_t operator()(const std::optional<T>& x) const {
+        // Hash unset values differently from any set one.
+        return x ? hash::combine(1, Hash<T>()(*x)) : 0;
+    }
+};
+
+template<typename... Ts>
+struct Hash<std::tuple<Ts...>> {
+    std::size_t operator()(const std::tuple<Ts...>& x) const {
+        return std::apply(
+            [](const auto&... elems) {
+                std::size_t seed = 0;
+                ((seed = hash::combine(seed, Hash<std::decay_t<decltype(elems)>>()(elems))), ...);
+                return seed;
+            },
+            x);
+    }
+};
+
+template<typename T1, typename T2>
+struct Hash<std::pair<T1, T2>> {
+    std::size_t operator()(const std::pair<T1, T2>& x) const {
+        return hash::combine(Hash<T1>()(x.first), Hash<T2>()(x.second));
+    }
+};
+
+} // namespace hilti::rt
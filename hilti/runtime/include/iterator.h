@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <iterator>
 
 #include <hilti/rt/exception.h>
@@ -10,6 +12,148 @@ namespace hilti::rt {
 
 namespace iterator::detail {
 
+template<typename T>
+class Control;
+
+/**
+ * Reference to a container's `Control`, held by safe iterators to find their
+ * container and to detect when it has gone away or has invalidated them.
+ * Retrieving the container doesn't touch any reference counts.
+ */
+template<typename T>
+class ControlRef {
+public:
+    /** Creates a reference that's not bound to any container. */
+    ControlRef() = default;
+
+    ControlRef(const ControlRef& other) : _block(other._block) { retain(); }
+    ControlRef(ControlRef&& other) noexcept : _block(other._block) { other._block = nullptr; }
+    ~ControlRef() { release(_block); }
+
+    ControlRef& operator=(const ControlRef& other) {
+        if ( &other != this ) {
+            other.retain();
+            release(_block);
+            _block = other._block;
+        }
+
+        return *this;
+    }
+
+    ControlRef& operator=(ControlRef&& other) noexcept {
+        if ( &other != this ) {
+            release(_block);
+            _block = other._block;
+            other._block = nullptr;
+        }
+
+        return *this;
+    }
+
+    /**
+     * Returns the container, or null if it's gone or has invalidated the
+     * reference.
+     */
+    T* get() const { return _block ? _block->object : nullptr; }
+
+    /** Returns true if the container is still available. */
+    explicit operator bool() const { return get() != nullptr; }
+
+private:
+    friend class Control<T>;
+
+    struct Block {
+        Block(T* object) : object(object) {}
+        std::atomic<uint64_t> refs = 1; // the first reference is held by the `Control`
+        T* object;
+    };
+
+    ControlRef(Block* block) : _block(block) { retain(); }
+
+    void retain() const {
+        if ( _block )
+            _block->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void release(Block* block) {
+        if ( block && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1 )
+            delete block;
+    }
+
+    Block* _block = nullptr;
+};
+
+/**
+ * Control block linking a container with the safe iterators created from it.
+ * The container owns the control and hands out `ControlRef`s to its
+ * iterators. Invalidating the control, or destroying it along with the
+ * container, detaches all existing references.
+ *
+ * In contrast to a `std::shared_ptr`/`std::weak_ptr` pair, checking whether
+ * an iterator's container is still available doesn't need to lock anything,
+ * so comparing and dereferencing iterators is cheap. The control block gets
+ * created on first use and is reference-counted atomically, so that threads
+ * may iterate over a shared constant container concurrently.
+ *
+ * A control is bound to its container instance: copies of a control start
+ * out without references, and assigning to a control invalidates its
+ * existing references.
+ */
+template<typename T>
+class Control {
+public:
+    Control() = default;
+    Control(const Control& /*unused*/) {}
+    Control(Control&& /*unused*/) noexcept {}
+    ~Control() { invalidate(); }
+
+    Control& operator=(const Control& /*unused*/) {
+        invalidate();
+        return *this;
+    }
+
+    Control& operator=(Control&& /*unused*/) noexcept {
+        invalidate();
+        return *this;
+    }
+
+    /**
+     * Returns a new reference to the control.
+     *
+     * @param object the container owning the control
+     */
+    ControlRef<T> ref(const T* object) const {
+        auto* block = _block.load(std::memory_order_acquire);
+
+        if ( ! block ) {
+            // Another thread may be racing us to create the block, in which
+            // case we use theirs.
+            auto* b = new Block(const_cast<T*>(object));
+            if ( _block.compare_exchange_strong(block, b, std::memory_order_acq_rel, std::memory_order_acquire) )
+                block = b;
+            else
+                delete b;
+        }
+
+        return ControlRef<T>(block);
+    }
+
+    /** Detaches all references handed out so far. */
+    void invalidate() {
+        auto* block = _block.exchange(nullptr, std::memory_order_acq_rel);
+        if ( ! block )
+            return;
+
+        block->object = nullptr;
+        ControlRef<T>::release(block);
+    }
+
+private:
+    using Block = typename ControlRef<T>::Block;
+
+    mutable std::atomic<Block*> _block = nullptr;
+};
+
 /** Proxy class returned by `range`.  */
 template<typename T>
 class Range {
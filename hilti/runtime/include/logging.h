@@ -28,13 +28,18 @@ void warning(std::string_view msg);
 /**
  * Prints a string, or a runtime value, to a specific debug stream. This is a
  * macro wrapper around `debug::detail::print(*)` that avoids evaluation of
- * the arguments if nothing is going to get logged.
+ * the arguments if nothing is going to get logged. The stream must be given
+ * as a constant name; it's resolved only once per call site. If the stream
+ * has been disabled at build time, the compiler removes the code completely.
  */
 #define HILTI_RT_DEBUG(stream, msg)                                                                                    \
     {                                                                                                                  \
-        if ( ::hilti::rt::detail::unsafeGlobalState()->debug_logger &&                                                 \
-             ::hilti::rt::detail::unsafeGlobalState()->debug_logger->isEnabled(stream) )                               \
-            ::hilti::rt::debug::detail::print(stream, msg);                                                            \
+        if ( ! ::hilti::rt::debug::detail::isCompiledOut(stream) &&                                                    \
+             ::hilti::rt::detail::unsafeGlobalState()->debug_logger ) {                                                \
+            static const ::hilti::rt::debug::Stream __stream(stream);                                                  \
+            if ( ::hilti::rt::detail::unsafeGlobalState()->debug_logger->isEnabled(__stream) )                         \
+                ::hilti::rt::debug::detail::print(__stream, msg);                                                      \
+        }                                                                                                              \
     }
 
 /** Shortcut to `hilti::rt::debug::setLocation`. */
@@ -44,20 +49,20 @@ namespace debug {
 
 namespace detail {
 /** Prints a debug message to a specific debug stream. */
-inline void print(std::string_view stream, const char* msg) {
+inline void print(const Stream& stream, const char* msg) {
     if ( ::hilti::rt::detail::globalState()->debug_logger )
         ::hilti::rt::detail::globalState()->debug_logger->print(stream, msg);
 }
 
 /** Print a string to a specific debug stream with proper escaping. */
-inline void print(std::string_view stream, std::string_view s) {
+inline void print(const Stream& stream, std::string_view s) {
     if ( ::hilti::rt::detail::globalState()->debug_logger )
         ::hilti::rt::detail::globalState()->debug_logger->print(stream, hilti::rt::escapeBytes(s));
 }
 
 template<typename T, typename std::enable_if_t<not std::is_convertible_v<T, std::string_view>>* = nullptr>
 /** Prints the string representastion of a HILTI runtime value to a specific debug stream. */
-inline void print(std::string_view stream, const T& t) {
+inline void print(const Stream& stream, const T& t) {
     if ( ::hilti::rt::detail::globalState()->debug_logger )
         ::hilti::rt::detail::globalState()->debug_logger->print(stream, hilti::rt::to_string_for_print(t));
 }
@@ -65,19 +70,19 @@ inline void print(std::string_view stream, const T& t) {
 
 /** Returns true if debug logging is enabled for a given stream. */
 inline bool isEnabled(std::string_view stream) {
-    return ::hilti::rt::detail::globalState()->debug_logger &&
+    return ! detail::isCompiledOut(stream) && ::hilti::rt::detail::globalState()->debug_logger &&
            ::hilti::rt::detail::globalState()->debug_logger->isEnabled(stream);
 }
 
 /** Increases the indentation level for a debug stream. */
 inline void indent(std::string_view stream) {
-    if ( ::hilti::rt::detail::globalState()->debug_logger )
+    if ( ! detail::isCompiledOut(stream) && ::hilti::rt::detail::globalState()->debug_logger )
         ::hilti::rt::detail::globalState()->debug_logger->indent(stream);
 }
 
 /** Decreases the indentation level for a debug stream. */
 inline void dedent(const std::string_view stream) {
-    if ( ::hilti::rt::detail::globalState()->debug_logger )
+    if ( ! detail::isCompiledOut(stream) && ::hilti::rt::detail::globalState()->debug_logger )
         ::hilti::rt::detail::globalState()->debug_logger->dedent(stream);
 }
 
@@ -116,9 +121,11 @@ inline void setLocation(const char* l = nullptr) {
  */
 template<typename T>
 inline void print(std::string_view stream, T&& msg, const TypeInfo* /* type */) {
-    if ( ::hilti::rt::detail::globalState()->debug_logger &&
-         ::hilti::rt::detail::globalState()->debug_logger->isEnabled(stream) )
-        ::hilti::rt::debug::detail::print(stream, std::forward<T>(msg));
+    if ( detail::isCompiledOut(stream) || ! ::hilti::rt::detail::globalState()->debug_logger )
+        return;
+
+    if ( Stream s(stream); ::hilti::rt::detail::globalState()->debug_logger->isEnabled(s) )
+        ::hilti::rt::debug::detail::print(s, std::forward<T>(msg));
 }
 
 } // namespace debug
@@ -58,7 +58,7 @@ inline std::string to_string(const Measurement&, detail::adl::tag /*unused*/) {
 
 namespace detail {
 
-// Structure for storing global state.
+// Structure for storing per-thread measurement state.
 struct MeasurementState {
     Measurement m = {};
     uint64_t instances = 0;
@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <utility>
 
 #include <hilti/rt/configuration.h>
 #include <hilti/rt/global-state.h>
@@ -17,6 +18,15 @@ class Profiler;
 
 namespace profiler {
 
+/**
+ * Handle identifying a block of code to profile. Tags are interned once per
+ * name through `tag()`, and then remain valid for the life-time of the
+ * process.
+ */
+using Tag = uint32_t;
+
+Tag tag(std::string_view name);
+std::optional<Profiler> start(Tag tag, std::optional<uint64_t> volume = std::nullopt);
 std::optional<Profiler> start(std::string_view name, std::optional<uint64_t> volume = std::nullopt);
 void stop(std::optional<Profiler>& p, std::optional<uint64_t> volume = std::nullopt);
 
@@ -36,9 +46,12 @@ extern void done();
 /**
  * Class representing one block of code to profile. The constructor records a
  * first measurement, and the destructor records a second. The delta between
- * the two measurements is then added to a global total kept for respective
- * block of code. Blocks are identified through descriptive names, which will
- * be shows as part of the final report.
+ * the two measurements is then added to a total kept for respective block of
+ * code. Blocks are identified through tags interned from descriptive names,
+ * which will be shows as part of the final report.
+ *
+ * Totals are maintained separately for each thread, without any locking,
+ * and then aggregated for reporting.
  *
  * Profilers can't be instantiated directly; use the `start()` and `stop()` API instead.
  */
@@ -52,19 +65,27 @@ public:
     Profiler() = default;
 
     Profiler(const Profiler& other) = delete;
-    Profiler(Profiler&& other) = default;
+    Profiler(Profiler&& other) noexcept : _tag(std::exchange(other._tag, std::nullopt)), _start(other._start) {}
 
     /** Destructor concluding any pending measurement. */
-    ~Profiler() { record(snapshot()); }
+    ~Profiler() {
+        if ( _tag )
+            record(snapshot());
+    }
 
     Profiler& operator=(const Profiler& other) = delete;
-    Profiler& operator=(Profiler&& other) = default;
+
+    Profiler& operator=(Profiler&& other) noexcept {
+        _tag = std::exchange(other._tag, std::nullopt);
+        _start = other._start;
+        return *this;
+    }
 
     /** Take final measurement and record the delta between first and final. */
     void record(const profiler::Measurement& end);
 
     /** Returns true if the profiler is currently taking an active measurement. */
-    operator bool() const { return ! _name.empty(); }
+    operator bool() const { return _tag.has_value(); }
 
     /**
      * Take and return a single measurement.
@@ -78,36 +99,62 @@ protected:
      * Constructor starting a new measurement. Don't call directly, use
      * `profiler::start()` instead.
      *
-     * @param name descriptive, unique name of the block of code to profile
+     * @param tag tag of the block of code to profile
      * @param volume optional initial absolute volume to record with the measurement
      */
-    Profiler(std::string_view name, std::optional<uint64_t> volume) : _name(name), _start(snapshot(volume)) {
+    Profiler(profiler::Tag tag, std::optional<uint64_t> volume) : _tag(tag), _start(snapshot(volume)) {
         _register();
     }
 
 private:
-    friend std::optional<Profiler> profiler::start(std::string_view name, std::optional<uint64_t> volume);
+    friend std::optional<Profiler> profiler::start(profiler::Tag tag, std::optional<uint64_t> volume);
     friend void profiler::detail::done();
 
     void _register() const;
 
-    std::string _name;            // Name of block to profile; empty is not active.
-    profiler::Measurement _start; // Initial measurement at construction time.
+    std::optional<profiler::Tag> _tag; // Tag of block to profile; unset if not active.
+    profiler::Measurement _start;      // Initial measurement at construction time.
 };
 
 namespace profiler {
+
+/**
+ * Returns the tag for a block of code, interning its name on first use.
+ * Callers executing the same block frequently should retrieve the tag once
+ * and then keep reusing it, which avoids any lookups on the fast path.
+ *
+ * @param name descriptive, unique name of the block of code to profile
+ * @return tag to pass to `start()`
+ */
+extern Tag tag(std::string_view name);
+
 /**
  * Start profiling of a code block. The returned profiler will be recording
  * until either `profiler::stop()` is called with it, or until the profiler
  * instances goes out of scope, whatever comes first.
  *
+ * @param tag tag of the block of code to profile, as returned by `tag()`
+ * @param volume optional initial absolute volume to record with the measurement
+ * @return profiler instance representing the active measurement
+ */
+inline std::optional<Profiler> start(Tag tag, std::optional<uint64_t> volume) {
+    if ( ::hilti::rt::detail::unsafeGlobalState()->profiling_enabled )
+        return Profiler(tag, volume);
+    else
+        return {};
+}
+
+/**
+ * Start profiling of a code block identified by name. This is a shortcut
+ * for calling `start()` with the result of `tag(name)`.
+ *
  * @param name descriptive, unique name of the block of code to profile.
  * @param volume optional initial absolute volume to record with the measurement
  * @return profiler instance representing the active measurement
  */
 inline std::optional<Profiler> start(std::string_view name, std::optional<uint64_t> volume) {
     if ( ::hilti::rt::detail::unsafeGlobalState()->profiling_enabled )
-        return Profiler(name, volume);
+        return start(tag(name), volume);
     else
         return {};
 }
@@ -125,15 +172,21 @@ inline void stop(std::optional<Profiler>& p, std::optional<uint64_t> volume) {
 }
 
 /**
- * Retrieves the measurement state for a code block by name, if known.
- * This is primarily for testing purposes.
+ * Retrieves the measurement state for a code block by name, if known,
+ * aggregated across all threads. This is primarily for testing purposes.
+ *
+ * Threads record their measurements without synchronization, so this must
+ * only be called while no other thread is recording any.
  *
  * @param name of the block of code to return data for
  * @return measurement state, or unset if no data is available
  */
 std::optional<Measurement> get(const std::string& name);
 
-/** Produce end-of-process summary profiling report. */
+/**
+ * Produce end-of-process summary profiling report. Like `get()`, this must
+ * only be called while no other thread is recording measurements.
+ */
 extern void report();
 
 } // namespace profiler
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <functional>
+
 #define SAFEINT_DISABLE_ADDRESS_OPERATOR
 #include <hilti/rt/3rdparty/SafeInt/SafeInt.hpp>
 #include <hilti/rt/exception.h>
@@ -35,3 +37,8 @@ inline auto operator<<(O& out, const hilti::rt::integer::safe<T>& x)
 
     return out;
 }
+
+template<typename T, typename E>
+struct std::hash<SafeInt<T, E>> {
+    std::size_t operator()(const SafeInt<T, E>& x) const { return std::hash<T>()(x.Ref()); }
+};
@@ -0,0 +1,50 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+//
+// Substring search over contiguous memory, used by the runtime's `bytes` and
+// `stream` types for finding literals.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hilti::rt::search {
+
+/**
+ * Returns the first occurrence of a needle inside a block of memory. On
+ * platforms supporting it, this filters candidate positions with SIMD
+ * comparisons of the needle's first and last bytes before verifying them; it
+ * falls back to a scalar search otherwise.
+ *
+ * @param haystack pointer to the data to search
+ * @param haystack_size number of bytes available at *haystack*
+ * @param needle pointer to the data to search for
+ * @param needle_size number of bytes available at *needle*
+ * @return pointer to the first byte of the first occurrence inside
+ * *haystack*, or null if not found; an empty needle is found at the
+ * beginning
+ */
+extern const uint8_t* forward(const uint8_t* haystack, size_t haystack_size, const uint8_t* needle,
+                              size_t needle_size);
+
+/**
+ * Returns the last occurrence of a needle inside a block of memory. See
+ * `forward()` for the implementation strategy.
+ *
+ * @param haystack pointer to the data to search
+ * @param haystack_size number of bytes available at *haystack*
+ * @param needle pointer to the data to search for
+ * @param needle_size number of bytes available at *needle*
+ * @return pointer to the first byte of the last occurrence inside
+ * *haystack*, or null if not found; an empty needle is found at the end
+ */
+extern const uint8_t* backward(const uint8_t* haystack, size_t haystack_size, const uint8_t* needle,
+                               size_t needle_size);
+
+/**
+ * Returns the name of the search implementation selected for the current
+ * CPU, for debugging and benchmarking.
+ */
+extern const char* implementation();
+
+} // namespace hilti::rt::search
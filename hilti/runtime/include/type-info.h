@@ -300,8 +300,15 @@ private:
 class IterableType {
 public:
     /**
-     * Type defining three functions that retrieve and manipulate an iterator
-     * for traversing the sequence of contained elements. The functions are:
+     * Type of a function receiving one element during `forEach()`, along
+     * with an opaque pointer passed through from the caller.
+     */
+    using Visitor = void (*)(const Value& element, void* cookie);
+
+    /**
+     * Type defining four functions that provide access to the sequence of
+     * contained elements. The first three retrieve and manipulate an iterator
+     * for traversing the sequence:
      *
      * 1. ``begin``: Given the outer value, returns an iterator of an
      * internal type that points the value's first contained element; or an
@@ -316,10 +323,15 @@ public:
      * return a pointer to the storage of the element that the iterator
      * refers to.
      *
+     * The fourth function, ``for_each``, traverses the sequence itself:
+     * Given the outer value and the type of its elements, it calls a
+     * visitor function for each element in order. As it does not need to
+     * type-erase an iterator, it does not allocate any memory.
      */
     using Accessor = std::tuple<std::optional<hilti::rt::any> (*)(const Value&),          // begin()
                                 std::optional<hilti::rt::any> (*)(const hilti::rt::any&), // next()
-                                const void* (*)(const hilti::rt::any&)>;                  // deref()
+                                const void* (*)(const hilti::rt::any&),                   // deref()
+                                void (*)(const Value&, const TypeInfo*, Visitor, void*)>; // for_each()
 
     /**
      * Constructor.
@@ -333,6 +345,21 @@ public:
     /** Returns a `Sequence` that can be iterated over to visit all the contained elements. */
     iterable_type::Sequence iterate(const Value& value) const { return iterable_type::Sequence(this, value); }
 
+    /**
+     * Calls a function for each contained element, in order. In contrast to
+     * `iterate()`, this does not allocate memory per element, making it the
+     * preferred way to convert large containers.
+     *
+     * @param value the value to traverse
+     * @param f function to call with each element's `Value`
+     */
+    template<typename F>
+    void forEach(const Value& value, F&& f) const {
+        using Function = std::remove_reference_t<F>;
+        auto visit = [](const Value& x, void* f) { (*static_cast<Function*>(f))(x); };
+        std::get<3>(_accessor)(value, _etype, visit, const_cast<void*>(static_cast<const void*>(&f))); // for_each()
+    }
+
     /**
      * Returns the type of the contained elements, as passed into the
      * constructor.
@@ -450,11 +477,21 @@ public:
 
         values.reserve(_bits.size());
         for ( const auto& f : _bits )
-            values.emplace_back(f, Value(static_cast<const char*>(v.pointer()) + f.offset, f.type, v));
+            values.emplace_back(f, value(v, f));
 
         return values;
     }
 
+    /**
+     * Returns the value of a single field, without visiting any others.
+     *
+     * @param v the value referring to the bitfield
+     * @param b the field to retrieve, which must be one of the bitfield's fields
+     */
+    Value value(const Value& v, const bitfield::Bits& b) const {
+        return Value(static_cast<const char*>(v.pointer()) + b.offset, b.type, v);
+    }
+
 private:
     const std::vector<bitfield::Bits> _bits;
 };
@@ -505,16 +542,30 @@ public:
      * returned.
      */
     enum_::Label get(const Value& v) const {
-        auto n = *static_cast<const int64_t*>(v.pointer());
+        if ( const auto* l = find(v) )
+            return *l;
+
+        return enum_::Label(fmt("<unknown-%" PRId64 ">", value(v)), value(v));
+    }
+
+    /**
+     * Given an enum value, returns the label it represents without copying
+     * it. Returns null if the value does not refer to a known label.
+     */
+    const enum_::Label* find(const Value& v) const {
+        auto n = value(v);
 
         for ( const auto& l : _labels ) {
             if ( n == l.value )
-                return l;
+                return &l;
         }
 
-        return enum_::Label(fmt("<unknown-%" PRId64 ">", n), n);
+        return nullptr;
     }
 
+    /** Given an enum value, returns its numerical value. */
+    int64_t value(const Value& v) const { return *static_cast<const int64_t*>(v.pointer()); }
+
 private:
     const std::vector<enum_::Label> _labels;
 };
@@ -639,13 +690,21 @@ private:
 /** Auxiliary type information for type ``map`. */
 class Map {
 public:
+    /**
+     * Type of a function receiving one element during `forEach()`, along
+     * with an opaque pointer passed through from the caller.
+     */
+    using Visitor = void (*)(const Value& key, const Value& value, void* cookie);
+
     /**
      * Similar semantics as with `IterableType`, but with different type for
      * dereferenced value.
      */
-    using Accessor = std::tuple<std::optional<hilti::rt::any> (*)(const Value&),                 // begin()
-                                std::optional<hilti::rt::any> (*)(const hilti::rt::any&),        // next()
-                                std::pair<const void*, const void*> (*)(const hilti::rt::any&)>; // deref()
+    using Accessor =
+        std::tuple<std::optional<hilti::rt::any> (*)(const Value&),                           // begin()
+                   std::optional<hilti::rt::any> (*)(const hilti::rt::any&),                  // next()
+                   std::pair<const void*, const void*> (*)(const hilti::rt::any&),            // deref()
+                   void (*)(const Value&, const TypeInfo*, const TypeInfo*, Visitor, void*)>; // for_each()
 
     /**
      * Constructor.
@@ -661,6 +720,22 @@ public:
     /** Returns a `Sequence` that can be iterated over to visit all the contained elements. */
     map::Sequence iterate(const Value& value) const { return map::Sequence(this, value); }
 
+    /**
+     * Calls a function for each contained element, in order. In contrast to
+     * `iterate()`, this does not allocate memory per element, making it the
+     * preferred way to convert large maps.
+     *
+     * @param value the value to traverse
+     * @param f function to call with each element's key and value
+     */
+    template<typename F>
+    void forEach(const Value& value, F&& f) const {
+        using Function = std::remove_reference_t<F>;
+        auto visit = [](const Value& k, const Value& v, void* f) { (*static_cast<Function*>(f))(k, v); };
+        std::get<3>(_accessor)(value, _ktype, _vtype, visit,
+                               const_cast<void*>(static_cast<const void*>(&f))); // for_each()
+    }
+
     /**
      * Returns the type of the key of the elements, as passed into the
      * constructor.
@@ -672,22 +747,22 @@ public:
      */
     const TypeInfo* valueType() const { return _vtype; }
 
-    template<typename K, typename V>
-    using iterator_pair =
-        std::pair<typename hilti::rt::Map<K, V>::const_iterator, typename hilti::rt::Map<K, V>::const_iterator>;
+    template<typename K, typename V, bool Unordered = false>
+    using iterator_pair = std::pair<typename hilti::rt::Map<K, V, Unordered>::const_iterator,
+                                    typename hilti::rt::Map<K, V, Unordered>::const_iterator>;
 
-    template<typename K, typename V>
+    template<typename K, typename V, bool Unordered = false>
     static Accessor accessor() {
         return std::make_tuple(
             [](const Value& v_) -> std::optional<hilti::rt::any> { // begin()
-                auto v = static_cast<const hilti::rt::Map<K, V>*>(v_.pointer());
+                auto v = static_cast<const hilti::rt::Map<K, V, Unordered>*>(v_.pointer());
                 if ( v->cbegin() != v->cend() )
                     return std::make_pair(v->cbegin(), v->cend());
                 else
                     return std::nullopt;
             },
             [](const hilti::rt::any& i_) -> std::optional<hilti::rt::any> { // next()
-                auto i = hilti::rt::any_cast<iterator_pair<K, V>>(i_);
+                auto i = hilti::rt::any_cast<iterator_pair<K, V, Unordered>>(i_);
                 auto n = std::make_pair(++i.first, i.second);
                 if ( n.first != n.second )
                     return std::move(n);
@@ -695,8 +770,13 @@ public:
                     return std::nullopt;
             },
             [](const hilti::rt::any& i_) -> std::pair<const void*, const void*> { // deref()
-                auto i = hilti::rt::any_cast<iterator_pair<K, V>>(i_);
+                auto i = hilti::rt::any_cast<iterator_pair<K, V, Unordered>>(i_);
                 return std::make_pair(&(*i.first).first, &(*i.first).second);
+            },
+            [](const Value& v_, const TypeInfo* ktype, const TypeInfo* vtype, Visitor visit,
+               void* cookie) { // for_each()
+                for ( const auto& [k, v] : *static_cast<const hilti::rt::Map<K, V, Unordered>*>(v_.pointer()) )
+                    visit(Value(&k, ktype, v_), Value(&v, vtype, v_), cookie);
             });
     }
 
@@ -779,10 +859,10 @@ public:
      */
     const TypeInfo* valueType() const { return _vtype; }
 
-    template<typename K, typename V>
+    template<typename K, typename V, bool Unordered = false>
     static auto accessor() { // deref()
         return [](const Value& v) -> std::pair<const void*, const void*> {
-            using iterator_type = const hilti::rt::map::Iterator<K, V>;
+            using iterator_type = const hilti::rt::map::Iterator<K, V, Unordered>;
             const auto& x = **static_cast<iterator_type*>(v.pointer());
             return std::make_pair(&x.first, &x.second);
         };
@@ -844,22 +924,22 @@ class Set : public detail::IterableType {
 public:
     using detail::IterableType::IterableType;
 
-    template<typename T>
-    using iterator_pair =
-        std::pair<typename hilti::rt::Set<T>::const_iterator, typename hilti::rt::Set<T>::const_iterator>;
+    template<typename T, bool Unordered = false>
+    using iterator_pair = std::pair<typename hilti::rt::Set<T, Unordered>::const_iterator,
+                                    typename hilti::rt::Set<T, Unordered>::const_iterator>;
 
-    template<typename T>
+    template<typename T, bool Unordered = false>
     static Accessor accessor() {
         return std::make_tuple(
             [](const Value& v_) -> std::optional<hilti::rt::any> {
-                auto v = static_cast<const hilti::rt::Set<T>*>(v_.pointer());
+                auto v = static_cast<const hilti::rt::Set<T, Unordered>*>(v_.pointer());
                 if ( v->begin() != v->end() )
                     return std::make_pair(v->begin(), v->end());
                 else
                     return std::nullopt;
             },
             [](const hilti::rt::any& i_) -> std::optional<hilti::rt::any> {
-                auto i = hilti::rt::any_cast<iterator_pair<T>>(i_);
+                auto i = hilti::rt::any_cast<iterator_pair<T, Unordered>>(i_);
                 auto n = std::make_pair(++i.first, i.second);
                 if ( n.first != n.second )
                     return std::move(n);
@@ -867,8 +947,12 @@ public:
                     return std::nullopt;
             },
             [](const hilti::rt::any& i_) -> const void* {
-                auto i = hilti::rt::any_cast<iterator_pair<T>>(i_);
+                auto i = hilti::rt::any_cast<iterator_pair<T, Unordered>>(i_);
                 return &*i.first;
+            },
+            [](const Value& v_, const TypeInfo* etype, Visitor visit, void* cookie) {
+                for ( const auto& x : *static_cast<const hilti::rt::Set<T, Unordered>*>(v_.pointer()) )
+                    visit(Value(&x, etype, v_), cookie);
             });
     }
 };
@@ -878,10 +962,10 @@ class SetIterator : public detail::DereferenceableType {
 public:
     using detail::DereferenceableType::DereferenceableType;
 
-    template<typename T>
+    template<typename T, bool Unordered = false>
     static auto accessor() { // deref()
         return [](const Value& v) -> const void* {
-            return &**static_cast<const hilti::rt::set::Iterator<T>*>(v.pointer());
+            return &**static_cast<const hilti::rt::set::Iterator<T, Unordered>*>(v.pointer());
         };
     }
 };
@@ -1012,14 +1096,25 @@ public:
     auto iterate(const Value& v, bool include_internal = false) const {
         std::vector<std::pair<const struct_::Field&, Value>> values;
 
-        for ( const auto& f : fields(include_internal) ) {
-            auto x = Value(static_cast<const char*>(v.pointer()) + f.get().offset, f.get().type, v);
-            values.emplace_back(f.get(), f.get().value(x));
-        }
+        for ( const auto& f : fields(include_internal) )
+            values.emplace_back(f.get(), value(v, f.get()));
 
         return values;
     }
 
+    /**
+     * Returns the value of a single field. In contrast to `iterate()`, this
+     * accesses the field directly without visiting any others.
+     *
+     * @param v the value referring to the struct
+     * @param f the field to retrieve, which must be one of the struct's fields
+     *
+     * @return the field's value, which will be invalid if the field is not set
+     */
+    Value value(const Value& v, const struct_::Field& f) const {
+        return f.value(Value(static_cast<const char*>(v.pointer()) + f.offset, f.type, v));
+    }
+
 private:
     const std::vector<struct_::Field> _fields;
 };
@@ -1196,6 +1291,10 @@ public:
             [](const hilti::rt::any& i_) -> const void* { // deref()
                 auto i = hilti::rt::any_cast<iterator_pair<T, Allocator>>(i_);
                 return &*i.first;
+            },
+            [](const Value& v_, const TypeInfo* etype, Visitor visit, void* cookie) { // for_each()
+                for ( const auto& x : *static_cast<const hilti::rt::Vector<T, Allocator>*>(v_.pointer()) )
+                    visit(Value(&x, etype, v_), cookie);
             });
     }
 };
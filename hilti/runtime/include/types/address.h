@@ -5,10 +5,12 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 
+#include <functional>
 #include <string>
 #include <tuple>
 
 #include <hilti/rt/extension-points.h>
+#include <hilti/rt/hash.h>
 #include <hilti/rt/result.h>
 #include <hilti/rt/types/bytes.h>
 #include <hilti/rt/types/stream.h>
@@ -101,6 +103,8 @@ public:
     Bytes pack(ByteOrder fmt) const;
 
 private:
+    friend struct std::hash<Address>;
+
     void _init(struct in_addr addr);
     void _init(struct in6_addr addr);
 
@@ -156,3 +160,11 @@ inline std::ostream& operator<<(std::ostream& out, const Address& x) {
 inline std::ostream& operator<<(std::ostream& out, const AddressFamily& family) { return out << to_string(family); }
 
 } // namespace hilti::rt
+
+// Consistent with `operator==`, this ignores the address family.
+template<>
+struct std::hash<hilti::rt::Address> {
+    std::size_t operator()(const hilti::rt::Address& x) const {
+        return hilti::rt::hash::combine(std::hash<uint64_t>()(x._a1), std::hash<uint64_t>()(x._a2));
+    }
+};
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 
 #include <hilti/rt/extension-points.h>
@@ -26,3 +27,8 @@ inline std::string to_string(Bool x, adl::tag /*unused*/) { return hilti::rt::to
 } // namespace detail::adl
 
 } // namespace hilti::rt
+
+template<>
+struct std::hash<hilti::rt::Bool> {
+    std::size_t operator()(const hilti::rt::Bool& x) const { return std::hash<bool>()(x); }
+};
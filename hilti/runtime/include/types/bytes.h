@@ -3,6 +3,7 @@
 #pragma once
 
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -685,3 +686,8 @@ namespace nlohmann {
 template<>
 struct adl_serializer<hilti::rt::Bytes> {};
 } // namespace nlohmann
+
+template<>
+struct std::hash<hilti::rt::Bytes> {
+    std::size_t operator()(const hilti::rt::Bytes& x) const { return std::hash<std::string>()(x.str()); }
+};
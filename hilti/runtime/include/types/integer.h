@@ -353,6 +353,42 @@ inline hilti::rt::integer::safe<UINT> noop(hilti::rt::integer::safe<UINT> v) {
     return v;
 }
 
+/**
+ * Adds two integers without checking for overflow. The code generator uses
+ * this only where the compiler has proven that the result always fits into
+ * `T`.
+ *
+ * @tparam T native type of the result
+ */
+template<typename T, typename A, typename B>
+inline hilti::rt::integer::safe<T> sum_unchecked(const A& a, const B& b) {
+    return static_cast<T>(static_cast<T>(a) + static_cast<T>(b));
+}
+
+/**
+ * Subtracts two integers without checking for overflow. The code generator
+ * uses this only where the compiler has proven that the result always fits
+ * into `T`.
+ *
+ * @tparam T native type of the result
+ */
+template<typename T, typename A, typename B>
+inline hilti::rt::integer::safe<T> difference_unchecked(const A& a, const B& b) {
+    return static_cast<T>(static_cast<T>(a) - static_cast<T>(b));
+}
+
+/**
+ * Multiplies two integers without checking for overflow. The code generator
+ * uses this only where the compiler has proven that the result always fits
+ * into `T`.
+ *
+ * @tparam T native type of the result
+ */
+template<typename T, typename A, typename B>
+inline hilti::rt::integer::safe<T> product_unchecked(const A& a, const B& b) {
+    return static_cast<T>(static_cast<T>(a) * static_cast<T>(b));
+}
+
 } // namespace integer
 
 namespace detail::adl {
@@ -4,6 +4,7 @@
 
 #include <arpa/inet.h>
 
+#include <functional>
 #include <limits>
 #include <string>
 
@@ -109,3 +110,8 @@ inline std::ostream& operator<<(std::ostream& out, const Interval& x) {
 }
 
 } // namespace hilti::rt
+
+template<>
+struct std::hash<hilti::rt::Interval> {
+    std::size_t operator()(const hilti::rt::Interval& x) const { return std::hash<int64_t>()(x.nanoseconds()); }
+};
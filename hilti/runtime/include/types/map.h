@@ -6,47 +6,62 @@
  *     - We add safe HILTI-side iterators become detectably invalid when the main
  *       containers gets destroyed.
  *
- *     - [Future] Automatic element expiration.
+ *     - Maps can alternatively be backed by a hash table, trading ordered
+ *       iteration for constant-time lookups.
+ *
+ *     - Elements can expire automatically after a configurable timeout.
  */
 
 #pragma once
 
 #include <algorithm>
+#include <functional>
 #include <initializer_list>
 #include <map>
 #include <memory>
 #include <optional>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include <hilti/rt/expiration.h>
 #include <hilti/rt/extension-points.h>
+#include <hilti/rt/hash.h>
 #include <hilti/rt/iterator.h>
 #include <hilti/rt/safe-int.h>
 #include <hilti/rt/util.h>
 
 namespace hilti::rt {
 
-template<typename K, typename V>
+template<typename K, typename V, bool Unordered = false>
 class Map;
 
+/** Alias for a `Map` that's backed by a hash table. */
+template<typename K, typename V>
+using UnorderedMap = Map<K, V, true>;
+
 namespace map {
 
-template<typename K, typename V>
+/** Selects the standard container a `Map` builds on. */
+template<typename K, typename V, bool Unordered>
+using Storage = std::conditional_t<Unordered, std::unordered_map<K, V, Hash<K>>, std::map<K, V>>;
+
+template<typename K, typename V, bool Unordered = false>
 class Iterator {
-    using M = Map<K, V>;
+    using M = Map<K, V, Unordered>;
 
-    std::weak_ptr<M*> _control;
+    typename M::C _control;
     typename M::M::iterator _iterator;
 
 public:
     Iterator() = default;
 
-    friend class Map<K, V>;
+    friend class Map<K, V, Unordered>;
 
     friend bool operator==(const Iterator& a, const Iterator& b) {
-        if ( a._control.lock() != b._control.lock() )
+        if ( a._control.get() != b._control.get() )
             throw InvalidArgument("cannot compare iterators into different maps");
 
         return a._iterator == b._iterator;
@@ -55,7 +70,7 @@ public:
     friend bool operator!=(const Iterator& a, const Iterator& b) { return ! (a == b); }
 
     Iterator& operator++() {
-        if ( ! _control.lock() ) {
+        if ( ! _control ) {
             throw IndexError("iterator is invalid");
         }
 
@@ -72,9 +87,9 @@ public:
     const typename M::M::value_type* operator->() const { return &operator*(); }
 
     typename M::M::const_reference operator*() const {
-        if ( auto&& l = _control.lock() ) {
+        if ( auto* m = _control.get() ) {
             // Iterators to `end` cannot be dereferenced.
-            if ( _iterator == static_cast<const typename M::M&>(**l).cend() )
+            if ( _iterator == static_cast<const typename M::M&>(*m).cend() )
                 throw IndexError("iterator is invalid");
 
             return *_iterator;
@@ -84,24 +99,24 @@ public:
     }
 
 private:
-    friend class Map<K, V>;
+    friend class Map<K, V, Unordered>;
 
-    Iterator(typename M::M::iterator iterator, const typename M::C& control)
-        : _control(control), _iterator(std::move(iterator)) {}
+    Iterator(typename M::M::iterator iterator, typename M::C control)
+        : _control(std::move(control)), _iterator(std::move(iterator)) {}
 };
 
-template<typename K, typename V>
+template<typename K, typename V, bool Unordered = false>
 class ConstIterator {
-    using M = Map<K, V>;
+    using M = Map<K, V, Unordered>;
 
-    std::weak_ptr<M*> _control;
+    typename M::C _control;
     typename M::M::const_iterator _iterator;
 
 public:
     ConstIterator() = default;
 
     friend bool operator==(const ConstIterator& a, const ConstIterator& b) {
-        if ( a._control.lock() != b._control.lock() )
+        if ( a._control.get() != b._control.get() )
             throw InvalidArgument("cannot compare iterators into different sets");
 
         return a._iterator == b._iterator;
@@ -110,7 +125,7 @@ public:
     friend bool operator!=(const ConstIterator& a, const ConstIterator& b) { return ! (a == b); }
 
     ConstIterator& operator++() {
-        if ( ! _control.lock() ) {
+        if ( ! _control ) {
             throw IndexError("iterator is invalid");
         }
 
@@ -127,9 +142,9 @@ public:
     const typename M::M::value_type* operator->() const { return &operator*(); }
 
     typename M::M::const_reference operator*() const {
-        if ( auto&& l = _control.lock() ) {
+        if ( auto* m = _control.get() ) {
             // Iterators to `end` cannot be dereferenced.
-            if ( _iterator == static_cast<const typename M::M&>(**l).cend() )
+            if ( _iterator == static_cast<const typename M::M&>(*m).cend() )
                 throw IndexError("iterator is invalid");
 
             return *_iterator;
@@ -139,10 +154,10 @@ public:
     }
 
 private:
-    friend class Map<K, V>;
+    friend class Map<K, V, Unordered>;
 
-    ConstIterator(typename M::M::const_iterator iterator, const typename M::C& control)
-        : _control(control), _iterator(std::move(iterator)) {}
+    ConstIterator(typename M::M::const_iterator iterator, typename M::C control)
+        : _control(std::move(control)), _iterator(std::move(iterator)) {}
 };
 
 } // namespace map
@@ -167,21 +182,36 @@ private:
  *
  * If not otherwise specified, member functions have the semantics of
  * `std::map` member functions.
+ *
+ * With `Unordered` set, the map is backed by a `std::unordered_map` instead,
+ * and iteration order is unspecified. Iterator invalidation remains the same
+ * as for the ordered version: inserting a new key invalidates all iterators,
+ * which also covers any rehashing. References to elements remain stable in
+ * either case.
+ *
+ * Once enabled through `setExpiration()`, elements expire after a timeout.
+ * Expired elements immediately disappear from lookups. They are physically
+ * removed when inserting a new key, when asking for the map's size, when
+ * starting an iteration, or when calling `expire()` explicitly. Removing
+ * expired elements invalidates all iterators into the map. An iteration
+ * already in progress may still encounter elements expiring after it
+ * started.
  * */
-template<typename K, typename V>
-class Map : protected std::map<K, V> {
+template<typename K, typename V, bool Unordered>
+class Map : protected map::Storage<K, V, Unordered> {
 public:
-    using M = std::map<K, V>;
-    using C = std::shared_ptr<Map<K, V>*>;
-
-    C _control = std::make_shared<Map<K, V>*>(this);
+    using M = map::Storage<K, V, Unordered>;
+    using C = rt::iterator::detail::ControlRef<Map<K, V, Unordered>>;
 
     using key_type = typename M::key_type;
     using value_type = typename M::value_type;
     using size_type = integer::safe<uint64_t>;
 
-    using iterator = typename map::Iterator<K, V>;
-    using const_iterator = typename map::ConstIterator<K, V>;
+    using iterator = typename map::Iterator<K, V, Unordered>;
+    using const_iterator = typename map::ConstIterator<K, V, Unordered>;
+
+    /** Type of callback to execute for elements that expire. */
+    using ExpirationCallback = std::function<void(const K&, const V&)>;
 
     Map() = default;
     Map(std::initializer_list<value_type> init) : M(std::move(init)) {}
@@ -191,7 +221,12 @@ public:
      * @param `k` the key to check for
      * @return `true` if the key is set in the map
      */
-    bool contains(const K& k) const { return this->find(k) != static_cast<const M&>(*this).end(); }
+    bool contains(const K& k) const {
+        if ( this->find(k) == static_cast<const M&>(*this).end() )
+            return false;
+
+        return ! _expiration || readUnexpired(k);
+    }
 
     /**
      * Attempts to get the value for a key.
@@ -202,7 +237,11 @@ public:
      */
     const V& get(const K& k) const& {
         try {
-            return this->at(k);
+            const auto& v = this->at(k);
+            if ( _expiration && ! readUnexpired(k) )
+                throw IndexError("key is unset");
+
+            return v;
         } catch ( const std::out_of_range& ) {
             throw IndexError("key is unset");
         }
@@ -217,7 +256,11 @@ public:
      */
     V& get(const K& k) & {
         try {
-            return this->at(k);
+            auto& v = this->at(k);
+            if ( _expiration && ! readUnexpired(k) )
+                throw IndexError("key is unset");
+
+            return v;
         } catch ( const std::out_of_range& ) {
             throw IndexError("key is unset");
         }
@@ -230,7 +273,7 @@ public:
      * @return the value, or an unset optional if the key is not set in the map
      */
     std::optional<V> get_optional(const K& k) const& {
-        if ( auto it = this->find(k); it != M::end() )
+        if ( auto it = this->find(k); it != M::end() && (! _expiration || readUnexpired(k)) )
             return it->second;
         else
             return std::nullopt;
@@ -263,7 +306,19 @@ public:
     auto operator[](const K& k) && { return this->get(k); }
 
     void index_assign(const K& key, V value) {
-        if ( ! contains(key) )
+        if ( _expiration ) {
+            auto t = _expiration.now();
+
+            if ( this->find(key) != M::end() && ! _expiration.isExpired(key, t) )
+                _expiration.written(key, t);
+            else {
+                // We are inserting a new key, which is when we remove expired ones.
+                expire(t);
+                this->invalidateIterators();
+                _expiration.created(key, t);
+            }
+        }
+        else if ( ! contains(key) )
             this->invalidateIterators();
 
         this->insert_or_assign(key, std::move(value));
@@ -272,13 +327,24 @@ public:
     auto begin() const { return this->cbegin(); }
     auto end() const { return this->cend(); }
 
-    auto begin() { return iterator(static_cast<M&>(*this).begin(), _control); }
-    auto end() { return iterator(static_cast<M&>(*this).end(), _control); }
+    auto begin() {
+        removeExpired();
+        return iterator(static_cast<M&>(*this).begin(), _control.ref(this));
+    }
+
+    auto end() { return iterator(static_cast<M&>(*this).end(), _control.ref(this)); }
+
+    auto cbegin() const {
+        removeExpired();
+        return const_iterator(static_cast<const M&>(*this).begin(), _control.ref(this));
+    }
 
-    auto cbegin() const { return const_iterator(static_cast<const M&>(*this).begin(), _control); }
-    auto cend() const { return const_iterator(static_cast<const M&>(*this).end(), _control); }
+    auto cend() const { return const_iterator(static_cast<const M&>(*this).end(), _control.ref(this)); }
 
-    size_type size() const { return M::size(); }
+    size_type size() const {
+        removeExpired();
+        return M::size();
+    }
 
     /** Erases all elements from the map.
      *
@@ -287,6 +353,9 @@ public:
     auto clear() {
         this->invalidateIterators();
 
+        if ( _expiration )
+            _expiration.cleared();
+
         return static_cast<M&>(*this).clear();
     }
 
@@ -302,59 +371,145 @@ public:
 
         if ( removed ) {
             this->invalidateIterators();
+
+            if ( _expiration )
+                _expiration.removed(key);
         }
 
         return removed;
     }
 
-    friend bool operator==(const Map& a, const Map& b) { return static_cast<const M&>(a) == static_cast<const M&>(b); }
+    /**
+     * Enables automatic expiration of elements. Elements already in the map
+     * start their timeout now. Calling this again changes the policy for
+     * deadlines computed from then on, leaving existing deadlines in place.
+     *
+     * @param policy policy defining when elements expire
+     */
+    void setExpiration(expiration::Policy policy) {
+        auto enabled = static_cast<bool>(_expiration);
+        _expiration.enable(policy);
+
+        if ( enabled )
+            return;
+
+        auto t = _expiration.now();
+        for ( const auto& x : static_cast<const M&>(*this) )
+            _expiration.created(x.first, t);
+    }
+
+    /**
+     * Sets a callback to execute for each element right before it gets
+     * removed because it expired. Expiration must have been enabled through
+     * `setExpiration()` already.
+     *
+     * @param cb callback receiving key and value of the expired element
+     * @throw `InvalidArgument` if expiration is not enabled
+     */
+    void setExpirationCallback(ExpirationCallback cb) {
+        if ( ! _expiration )
+            throw InvalidArgument("expiration is not enabled for map");
+
+        _expiration.setCallback(std::move(cb));
+    }
+
+    /** Returns the number of elements that have been removed from the map because they expired. */
+    uint64_t numExpired() const { return _expiration.numExpired(); }
+
+    /**
+     * Removes all elements that have expired by now. This function
+     * invalidates all iterators into the map iff an element was removed.
+     *
+     * @return the number of elements removed
+     */
+    uint64_t expire() { return _expiration ? expire(_expiration.now()) : 0; }
+
+    friend bool operator==(const Map& a, const Map& b) {
+        a.removeExpired();
+        b.removeExpired();
+        return static_cast<const M&>(a) == static_cast<const M&>(b);
+    }
+
     friend bool operator!=(const Map& a, const Map& b) { return ! (a == b); }
 
 private:
-    friend map::Iterator<K, V>;
-    friend map::ConstIterator<K, V>;
+    friend map::Iterator<K, V, Unordered>;
+    friend map::ConstIterator<K, V, Unordered>;
+
+    void invalidateIterators() { _control.invalidate(); }
+
+    // Returns true if a key present in the map has not expired yet, and
+    // records the read access to it. Expiration must be enabled.
+    bool readUnexpired(const K& k) const {
+        auto t = _expiration.now();
+        if ( _expiration.isExpired(k, t) )
+            return false;
+
+        _expiration.read(k, t);
+        return true;
+    }
 
-    void invalidateIterators() {
-        // Update control block to invalidate all iterators previously created from it.
-        _control = std::make_shared<Map<K, V>*>(this);
+    // Removes expired elements before operations that would otherwise
+    // still see them. Expired elements are already gone logically, so we do
+    // this from const methods as well. Constants cannot have expiration
+    // enabled, as that requires modifying them.
+    void removeExpired() const {
+        if ( _expiration )
+            const_cast<Map*>(this)->expire(_expiration.now());
     }
+
+    uint64_t expire(Time t) {
+        auto n = _expiration.expire(t, [this](const K& k) {
+            auto node = static_cast<M&>(*this).extract(k);
+            if ( const auto& cb = _expiration.callback() )
+                cb(node.key(), node.mapped());
+        });
+
+        if ( n )
+            this->invalidateIterators();
+
+        return n;
+    }
+
+    rt::iterator::detail::Control<Map> _control;
+    expiration::Tracker<K, Unordered, ExpirationCallback> _expiration;
 }; // namespace hilti::rt
 
 namespace map {
 /** Place-holder type for an empty map that doesn't have a known element type. */
 class Empty : public Map<bool, bool> {};
 
-template<typename K, typename V>
-inline bool operator==(const Map<K, V>& v, const Empty& /*unused*/) {
+template<typename K, typename V, bool U>
+inline bool operator==(const Map<K, V, U>& v, const Empty& /*unused*/) {
     return v.empty();
 }
-template<typename K, typename V>
-inline bool operator==(const Empty& /*unused*/, const Map<K, V>& v) {
+template<typename K, typename V, bool U>
+inline bool operator==(const Empty& /*unused*/, const Map<K, V, U>& v) {
     return v.empty();
 }
-template<typename K, typename V>
-inline bool operator!=(const Map<K, V>& v, const Empty& /*unused*/) {
+template<typename K, typename V, bool U>
+inline bool operator!=(const Map<K, V, U>& v, const Empty& /*unused*/) {
     return ! v.empty();
 }
-template<typename K, typename V>
-inline bool operator!=(const Empty& /*unused*/, const Map<K, V>& v) {
+template<typename K, typename V, bool U>
+inline bool operator!=(const Empty& /*unused*/, const Map<K, V, U>& v) {
     return ! v.empty();
 }
 
-template<typename K, typename V>
-inline std::ostream& operator<<(std::ostream& out, const map::Iterator<K, V>& it) {
+template<typename K, typename V, bool U>
+inline std::ostream& operator<<(std::ostream& out, const map::Iterator<K, V, U>& it) {
     return out << to_string(it);
 }
 
-template<typename K, typename V>
-inline std::ostream& operator<<(std::ostream& out, const map::ConstIterator<K, V>& it) {
+template<typename K, typename V, bool U>
+inline std::ostream& operator<<(std::ostream& out, const map::ConstIterator<K, V, U>& it) {
     return out << to_string(it);
 }
 } // namespace map
 
 namespace detail::adl {
-template<typename K, typename V>
-inline std::string to_string(const Map<K, V>& x, adl::tag /*unused*/) {
+template<typename K, typename V, bool U>
+inline std::string to_string(const Map<K, V, U>& x, adl::tag /*unused*/) {
     std::vector<std::string> r;
 
     for ( const auto& i : x )
@@ -372,20 +527,20 @@ inline std::string to_string(const std::pair<const K, V>& x, adl::tag /*unused*/
 
 inline std::string to_string(const map::Empty& x, adl::tag /*unused*/) { return "{}"; }
 
-template<typename K, typename V>
-inline std::string to_string(const map::Iterator<K, V>& /*unused*/, adl::tag /*unused*/) {
+template<typename K, typename V, bool U>
+inline std::string to_string(const map::Iterator<K, V, U>& /*unused*/, adl::tag /*unused*/) {
     return "<map iterator>";
 }
 
-template<typename K, typename V>
-inline std::string to_string(const map::ConstIterator<K, V>& /*unused*/, adl::tag /*unused*/) {
+template<typename K, typename V, bool U>
+inline std::string to_string(const map::ConstIterator<K, V, U>& /*unused*/, adl::tag /*unused*/) {
     return "<const map iterator>";
 }
 
 } // namespace detail::adl
 
-template<typename K, typename V>
-inline std::ostream& operator<<(std::ostream& out, const Map<K, V>& x) {
+template<typename K, typename V, bool U>
+inline std::ostream& operator<<(std::ostream& out, const Map<K, V, U>& x) {
     return out << to_string(x);
 }
 
@@ -4,10 +4,12 @@
 
 #include <arpa/inet.h>
 
+#include <functional>
 #include <string>
 
 #include <hilti/rt/exception.h>
 #include <hilti/rt/extension-points.h>
+#include <hilti/rt/hash.h>
 #include <hilti/rt/types/address.h>
 #include <hilti/rt/util.h>
 
@@ -117,3 +119,10 @@ inline std::ostream& operator<<(std::ostream& out, const Network& x) {
 }
 
 } // namespace hilti::rt
+
+template<>
+struct std::hash<hilti::rt::Network> {
+    std::size_t operator()(const hilti::rt::Network& x) const {
+        return hilti::rt::hash::combine(std::hash<hilti::rt::Address>()(x.prefix()), std::hash<int>()(x.length()));
+    }
+};
@@ -4,9 +4,11 @@
 
 #include <arpa/inet.h>
 
+#include <functional>
 #include <string>
 
 #include <hilti/rt/extension-points.h>
+#include <hilti/rt/hash.h>
 #include <hilti/rt/types/address.h>
 #include <hilti/rt/util.h>
 
@@ -87,3 +89,10 @@ inline std::ostream& operator<<(std::ostream& out, const Port& x) {
 }
 
 } // namespace hilti::rt
+
+template<>
+struct std::hash<hilti::rt::Port> {
+    std::size_t operator()(const hilti::rt::Port& x) const {
+        return hilti::rt::hash::combine(std::hash<uint16_t>()(x.port()), std::hash<int64_t>()(x.protocol().value()));
+    }
+};
@@ -2,8 +2,13 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <bitset>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -28,12 +33,6 @@ struct Flags {
     bool no_sub = false; /**< if true, compile without support for capturing sub-expressions */
     bool use_std =
         false; /**< if true, always use the standard matcher (for testing purposes; ignored if `no_sub` is set) */
-
-    /** Returns a string uniquely identifying the set of flags. */
-    std::string cacheKey() const {
-        char key[2] = {no_sub ? '1' : '0', use_std ? '1' : '0'};
-        return std::string(key, 2);
-    }
 };
 
 /**
@@ -70,6 +69,16 @@ inline std::ostream& operator<<(std::ostream& out, const Pattern& pattern) { ret
 /** A set of individual regular expression patterns. */
 using Patterns = std::vector<Pattern>;
 
+/** Statistics about the global cache of compiled regular expressions. */
+struct CacheStatistics {
+    uint64_t hits = 0;   /**< number of lookups that found an already compiled expression */
+    uint64_t misses = 0; /**< number of lookups that required compiling a new expression */
+    uint64_t size = 0;   /**< number of compiled expressions currently cached */
+};
+
+/** Returns statistics about the global cache of compiled regular expressions. */
+extern CacheStatistics cacheStatistics();
+
 /* Type for passing around the content of extracted capture groups. */
 using Captures = Vector<Bytes>;
 
@@ -157,6 +166,75 @@ private:
 
 namespace detail {
 
+/**
+ * Cheap test whether a set of patterns can possibly match data, used to
+ * reject input before running the actual regular expression engine. This
+ * derives conservatively from the patterns (1) the set of bytes any match
+ * must start with, and (2) the literal prefix each alternative starts with,
+ * if any. As all matching is anchored, checking data against these requires
+ * only looking at its first few bytes.
+ *
+ * If a pattern uses syntax that the analysis does not understand, or if it
+ * can match the empty string, the prefilter remains disabled and accepts
+ * any data.
+ */
+class Prefilter {
+public:
+    /** Creates a disabled prefilter accepting all data. */
+    Prefilter() = default;
+
+    /**
+     * Creates a prefilter for a set of patterns.
+     *
+     * @param patterns the patterns that will be matched
+     */
+    Prefilter(const regexp::Patterns& patterns);
+
+    /** Returns true if the prefilter can reject any data at all. */
+    bool isEnabled() const { return _enabled; }
+
+    /** Returns the set of bytes that a match may start with. Only meaningful if enabled. */
+    const auto& firstBytes() const { return _first; }
+
+    /**
+     * Returns true if the patterns may match data starting with a given
+     * chunk. False means that no match is possible, no matter what data may
+     * follow the chunk.
+     *
+     * @param data beginning of the data to match
+     * @param len length of *data*, which must be larger than zero
+     */
+    bool mayMatch(const char* data, size_t len) const {
+        if ( ! _enabled )
+            return true;
+
+        const auto c = static_cast<unsigned char>(data[0]);
+        if ( ! _first.test(c) )
+            return false;
+
+        for ( const auto& b : _branches ) {
+            if ( b.first.test(c) && b.matchesPrefix(data, len) )
+                return true;
+        }
+
+        return false;
+    }
+
+private:
+    // Information about one top-level alternative of a pattern.
+    struct Branch {
+        std::bitset<256> first; // bytes a match of this alternative may start with
+        std::string prefix;     // literal that any match starts with; lower-case if case-insensitive
+        bool case_insensitive = false;
+
+        bool matchesPrefix(const char* data, size_t len) const;
+    };
+
+    bool _enabled = false;
+    std::bitset<256> _first;
+    std::vector<Branch> _branches;
+};
+
 // Internal helper class to compile and cache regular expressions. We compile
 // each unique set of patterns once into an instance of this class, which we
 // then retain inside a global cache for later reuse when seeing the same set
@@ -176,6 +254,10 @@ public:
         return _jrx.get();
     }
 
+    const auto& patterns() const { return _patterns; }
+    const auto& flags() const { return _flags; }
+    const auto& prefilter() const { return _prefilter; }
+
 private:
     friend class rt::RegExp;
     friend class regexp::MatchState;
@@ -189,9 +271,45 @@ private:
 
     regexp::Flags _flags{};
     regexp::Patterns _patterns;
+    regexp::detail::Prefilter _prefilter;
     std::unique_ptr<jrx_regex_t, RegFree> _jrx;
 };
 
+// Thread-safe cache of compiled regular expressions, keyed by their patterns
+// and flags. Lookups hash the patterns directly, without building an
+// intermediary key. Entries are distributed across independently locked
+// shards to reduce contention between threads.
+class Cache {
+public:
+    Cache() = default;
+    ~Cache() = default;
+
+    Cache(const Cache& other) = delete;
+    Cache(Cache&& other) = delete;
+    Cache& operator=(const Cache& other) = delete;
+    Cache& operator=(Cache&& other) = delete;
+
+    // Returns the compiled expression for a set of patterns, compiling it
+    // first if not cached yet. Throws `PatternError` if compilation fails.
+    std::shared_ptr<CompiledRegExp> get(const regexp::Patterns& patterns, regexp::Flags flags);
+
+    // Returns statistics about cache usage.
+    CacheStatistics statistics() const;
+
+private:
+    static constexpr size_t NumShards = 16;
+
+    // Aligned to avoid false sharing between shards' mutexes.
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_multimap<size_t, std::shared_ptr<CompiledRegExp>> entries; // indexed by hash
+    };
+
+    std::array<Shard, NumShards> _shards;
+    std::atomic<uint64_t> _hits = 0;
+    std::atomic<uint64_t> _misses = 0;
+};
+
 } // namespace detail
 } // namespace regexp
 
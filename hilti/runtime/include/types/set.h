@@ -6,19 +6,27 @@
  *     - We add safe HILTI-side iterators become detectably invalid when the main
  *       containers gets destroyed.
  *
- *     - [Future] Automatic element expiration.
+ *     - Sets can alternatively be backed by a hash table, trading ordered
+ *       iteration for constant-time lookups.
+ *
+ *     - Elements can expire automatically after a configurable timeout.
  */
 
 #pragma once
 
 #include <algorithm>
+#include <functional>
 #include <initializer_list>
 #include <memory>
 #include <set>
 #include <string>
+#include <type_traits>
+#include <unordered_set>
 #include <utility>
 
+#include <hilti/rt/expiration.h>
 #include <hilti/rt/extension-points.h>
+#include <hilti/rt/hash.h>
 #include <hilti/rt/iterator.h>
 #include <hilti/rt/safe-int.h>
 #include <hilti/rt/types/set_fwd.h>
@@ -29,20 +37,24 @@ namespace hilti::rt {
 
 namespace set {
 
-template<typename T>
+/** Selects the standard container a `Set` builds on. */
+template<typename T, bool Unordered>
+using Storage = std::conditional_t<Unordered, std::unordered_set<T, Hash<T>>, std::set<T>>;
+
+template<typename T, bool Unordered = false>
 class Iterator {
-    using S = Set<T>;
+    using S = Set<T, Unordered>;
 
-    std::weak_ptr<S*> _control;
-    typename S::V::iterator _iterator;
+    typename S::C _control;
+    typename S::V::const_iterator _iterator;
 
 public:
     Iterator() = default;
 
     typename S::reference operator*() const {
-        if ( auto&& l = _control.lock() ) {
+        if ( auto* s = _control.get() ) {
             // Iterators to `end` cannot be dereferenced.
-            if ( _iterator == static_cast<const std::set<T>&>(**l).end() )
+            if ( _iterator == static_cast<const typename S::V&>(*s).end() )
                 throw IndexError("iterator is invalid");
 
             return *_iterator;
@@ -52,7 +64,7 @@ public:
     }
 
     Iterator& operator++() {
-        if ( ! _control.lock() )
+        if ( ! _control )
             throw IndexError("iterator is invalid");
 
         ++_iterator;
@@ -66,7 +78,7 @@ public:
     }
 
     friend bool operator==(const Iterator& a, const Iterator& b) {
-        if ( a._control.lock() != b._control.lock() )
+        if ( a._control.get() != b._control.get() )
             throw InvalidArgument("cannot compare iterators into different sets");
 
         return a._iterator == b._iterator;
@@ -75,10 +87,10 @@ public:
     friend bool operator!=(const Iterator& a, const Iterator& b) { return ! (a == b); }
 
 protected:
-    friend class Set<T>;
+    friend class Set<T, Unordered>;
 
-    Iterator(typename S::V::iterator iterator, const typename S::C& control)
-        : _control(control), _iterator(std::move(iterator)) {}
+    Iterator(typename S::V::const_iterator iterator, typename S::C control)
+        : _control(std::move(control)), _iterator(std::move(iterator)) {}
 };
 
 } // namespace set
@@ -103,31 +115,44 @@ protected:
  *
  * If not otherwise specified, member functions have the semantics of
  * `std::set` member functions.
+ *
+ * With `Unordered` set, the set is backed by a `std::unordered_set` instead,
+ * and iteration order is unspecified. Inserting an element then invalidates
+ * all iterators into the set if the insertion rehashes the underlying table.
+ *
+ * Once enabled through `setExpiration()`, elements expire after a timeout.
+ * Expired elements immediately disappear from membership tests. They are
+ * physically removed when inserting a new element, when asking for the
+ * set's size, when starting an iteration, or when calling `expire()`
+ * explicitly. Removing expired elements invalidates all iterators into the
+ * set. An iteration already in progress may still encounter elements
+ * expiring after it started.
  * */
-template<typename T>
-class Set : protected std::set<T> {
+template<typename T, bool Unordered>
+class Set : protected set::Storage<T, Unordered> {
 public:
-    using V = std::set<T>;
-    using C = std::shared_ptr<Set<T>*>;
-
-    C _control = std::make_shared<Set<T>*>(this);
+    using V = set::Storage<T, Unordered>;
+    using C = rt::iterator::detail::ControlRef<Set<T, Unordered>>;
 
     using reference = const T&;
     using const_reference = const T&;
 
-    using iterator = typename set::Iterator<T>;
-    using const_iterator = typename set::Iterator<T>;
+    using iterator = typename set::Iterator<T, Unordered>;
+    using const_iterator = typename set::Iterator<T, Unordered>;
 
     using key_type = T;
     using value_type = T;
 
     using size_type = integer::safe<uint64_t>;
 
+    /** Type of callback to execute for elements that expire. */
+    using ExpirationCallback = std::function<void(const T&)>;
+
     Set() = default;
     Set(const Set&) = default;
     Set(Set&&) noexcept = default;
-    Set(const Vector<T>& l) : std::set<T>(l.begin(), l.end()) {}
-    Set(std::initializer_list<T> l) : std::set<T>(std::move(l)) {}
+    Set(const Vector<T>& l) : V(l.begin(), l.end()) {}
+    Set(std::initializer_list<T> l) : V(std::move(l)) {}
     ~Set() = default;
 
     Set& operator=(const Set&) = default;
@@ -138,12 +163,37 @@ public:
      * @param `t` the element to check for
      * @return `true` if the element is part of the set.
      */
-    bool contains(const T& t) const { return this->count(t); }
+    bool contains(const T& t) const {
+        if ( ! this->count(t) )
+            return false;
 
-    auto begin() const { return iterator(static_cast<const V&>(*this).begin(), empty() ? nullptr : _control); }
-    auto end() const { return iterator(static_cast<const V&>(*this).end(), empty() ? nullptr : _control); }
+        if ( ! _expiration )
+            return true;
 
-    size_type size() const { return V::size(); }
+        auto now = _expiration.now();
+        if ( _expiration.isExpired(t, now) )
+            return false;
+
+        _expiration.read(t, now);
+        return true;
+    }
+
+    auto begin() const {
+        removeExpired();
+        return iterator(static_cast<const V&>(*this).begin(), V::empty() ? C() : _control.ref(this));
+    }
+
+    auto end() const { return iterator(static_cast<const V&>(*this).end(), V::empty() ? C() : _control.ref(this)); }
+
+    size_type size() const {
+        removeExpired();
+        return V::size();
+    }
+
+    bool empty() const {
+        removeExpired();
+        return V::empty();
+    }
 
     /** Removes an element from the set.
      *
@@ -153,8 +203,11 @@ public:
      * @return 1 if the element was in the set, 0 otherwise
      */
     size_type erase(const key_type& key) {
-        // Update control block to invalidate all iterators previously created from it.
-        _control = std::make_shared<Set<T>*>();
+        // Invalidate all iterators previously created.
+        _control.invalidate();
+
+        if ( _expiration )
+            _expiration.removed(key);
 
         return static_cast<V&>(*this).erase(key);
     }
@@ -164,8 +217,11 @@ public:
      * This function invalidates all iterators into the set.
      */
     void clear() {
-        // Update control block to invalidate all iterators previously created from it.
-        _control = std::make_shared<Set<T>*>();
+        // Invalidate all iterators previously created.
+        _control.invalidate();
+
+        if ( _expiration )
+            _expiration.cleared();
 
         return static_cast<V&>(*this).clear();
     }
@@ -177,18 +233,145 @@ public:
      * @return iterator pointing to the inserted element
      * */
     iterator insert(iterator hint, const T& value) {
-        auto it = V::insert(hint._iterator, value);
-        return iterator(it, _control);
+        if ( _expiration ) {
+            // Removing expired elements may invalidate the hint, so don't use it.
+            prepareInsert(value);
+            hint = end();
+        }
+
+        if constexpr ( Unordered ) {
+            auto buckets = V::bucket_count();
+            auto it = V::insert(hint._iterator, value);
+            invalidateIteratorsOnRehash(buckets);
+            return iterator(it, _control.ref(this));
+        }
+        else {
+            auto it = V::insert(hint._iterator, value);
+            return iterator(it, _control.ref(this));
+        }
     }
 
-    // Methods of `std::set`. These methods *must not* cause any iterator invalidation.
-    using V::empty;
-    using V::insert;
+    /** Inserts an element into the set.
+     *
+     * For unordered sets, this function invalidates all iterators into the
+     * set iff the insertion rehashed the underlying table.
+     *
+     * @param value value to insert
+     * @return a pair of the iterator to the element and whether it was inserted
+     */
+    auto insert(const T& value) {
+        if ( _expiration )
+            prepareInsert(value);
+
+        if constexpr ( Unordered ) {
+            auto buckets = V::bucket_count();
+            auto result = V::insert(value);
+            invalidateIteratorsOnRehash(buckets);
+            return result;
+        }
+        else
+            return V::insert(value);
+    }
+
+    /**
+     * Enables automatic expiration of elements. Elements already in the set
+     * start their timeout now. Calling this again changes the policy for
+     * deadlines computed from then on, leaving existing deadlines in place.
+     *
+     * @param policy policy defining when elements expire
+     */
+    void setExpiration(expiration::Policy policy) {
+        auto enabled = static_cast<bool>(_expiration);
+        _expiration.enable(policy);
+
+        if ( enabled )
+            return;
+
+        auto now = _expiration.now();
+        for ( const auto& x : static_cast<const V&>(*this) )
+            _expiration.created(x, now);
+    }
+
+    /**
+     * Sets a callback to execute for each element right before it gets
+     * removed because it expired. Expiration must have been enabled through
+     * `setExpiration()` already.
+     *
+     * @param cb callback receiving the expired element
+     * @throw `InvalidArgument` if expiration is not enabled
+     */
+    void setExpirationCallback(ExpirationCallback cb) {
+        if ( ! _expiration )
+            throw InvalidArgument("expiration is not enabled for set");
+
+        _expiration.setCallback(std::move(cb));
+    }
+
+    /** Returns the number of elements that have been removed from the set because they expired. */
+    uint64_t numExpired() const { return _expiration.numExpired(); }
+
+    /**
+     * Removes all elements that have expired by now. This function
+     * invalidates all iterators into the set iff an element was removed.
+     *
+     * @return the number of elements removed
+     */
+    uint64_t expire() { return _expiration ? expire(_expiration.now()) : 0; }
+
+    friend bool operator==(const Set& a, const Set& b) {
+        a.removeExpired();
+        b.removeExpired();
+        return static_cast<const V&>(a) == static_cast<const V&>(b);
+    }
 
-    friend bool operator==(const Set& a, const Set& b) { return static_cast<const V&>(a) == static_cast<const V&>(b); }
     friend bool operator!=(const Set& a, const Set& b) { return ! (a == b); }
 
-    friend set::Iterator<T>;
+    friend set::Iterator<T, Unordered>;
+
+private:
+    void invalidateIteratorsOnRehash(typename V::size_type old_bucket_count) {
+        // Rehashing invalidates all iterators into the underlying table.
+        if ( V::bucket_count() != old_bucket_count )
+            _control.invalidate();
+    }
+
+    // Updates expiration state for an element about to be inserted. Inserting
+    // a new element is when we remove expired ones.
+    void prepareInsert(const T& value) {
+        auto now = _expiration.now();
+
+        if ( V::find(value) != V::end() && ! _expiration.isExpired(value, now) )
+            _expiration.written(value, now);
+        else {
+            expire(now);
+            _expiration.created(value, now);
+        }
+    }
+
+    // Removes expired elements before operations that would otherwise
+    // still see them. Expired elements are already gone logically, so we do
+    // this from const methods as well. Constants cannot have expiration
+    // enabled, as that requires modifying them.
+    void removeExpired() const {
+        if ( _expiration )
+            const_cast<Set*>(this)->expire(_expiration.now());
+    }
+
+    uint64_t expire(Time now) {
+        auto n = _expiration.expire(now, [this](const T& t) {
+            auto node = static_cast<V&>(*this).extract(t);
+            if ( const auto& cb = _expiration.callback() )
+                cb(node.value());
+        });
+
+        if ( n )
+            _control.invalidate();
+
+        return n;
+    }
+
+    rt::iterator::detail::Control<Set> _control;
+    expiration::Tracker<T, Unordered, ExpirationCallback> _expiration;
 };
 
 namespace set {
@@ -197,45 +380,45 @@ class Empty : public Set<bool> {};
 
 inline bool operator==(const Empty& /*unused*/, const Empty& /*unused*/) { return true; }
 
-template<typename T>
-inline bool operator==(const Set<T>& v, const Empty& /*unused*/) {
+template<typename T, bool U>
+inline bool operator==(const Set<T, U>& v, const Empty& /*unused*/) {
     return v.empty();
 }
 
-template<typename T>
-inline bool operator==(const Empty& /*unused*/, const Set<T>& v) {
+template<typename T, bool U>
+inline bool operator==(const Empty& /*unused*/, const Set<T, U>& v) {
     return v.empty();
 }
 
 inline bool operator!=(const Empty& /*unused*/, const Empty& /*unused*/) { return false; }
 
-template<typename T>
-inline bool operator!=(const Set<T>& v, const Empty& /*unused*/) {
+template<typename T, bool U>
+inline bool operator!=(const Set<T, U>& v, const Empty& /*unused*/) {
     return ! v.empty();
 }
 
-template<typename T>
-inline bool operator!=(const Empty& /*unused*/, const Set<T>& v) {
+template<typename T, bool U>
+inline bool operator!=(const Empty& /*unused*/, const Set<T, U>& v) {
     return ! v.empty();
 }
 } // namespace set
 
 namespace detail::adl {
-template<typename T>
-inline std::string to_string(const Set<T>& x, adl::tag /*unused*/) {
+template<typename T, bool U>
+inline std::string to_string(const Set<T, U>& x, adl::tag /*unused*/) {
     return fmt("{%s}", rt::join(rt::transform(x, [](const T& y) { return rt::to_string(y); }), ", "));
 }
 
 inline std::string to_string(const set::Empty& x, adl::tag /*unused*/) { return "{}"; }
 
-template<typename T>
-inline std::string to_string(const set::Iterator<T>& /*unused*/, adl::tag /*unused*/) {
+template<typename T, bool U>
+inline std::string to_string(const set::Iterator<T, U>& /*unused*/, adl::tag /*unused*/) {
     return "<set iterator>";
 }
 } // namespace detail::adl
 
-template<typename T>
-inline std::ostream& operator<<(std::ostream& out, const Set<T>& x) {
+template<typename T, bool U>
+inline std::ostream& operator<<(std::ostream& out, const Set<T, U>& x) {
     out << to_string(x);
     return out;
 }
@@ -246,8 +429,8 @@ inline std::ostream& operator<<(std::ostream& out, const set::Empty& x) {
 }
 
 namespace set {
-template<typename T>
-inline std::ostream& operator<<(std::ostream& out, const Iterator<T>& x) {
+template<typename T, bool U>
+inline std::ostream& operator<<(std::ostream& out, const Iterator<T, U>& x) {
     out << to_string(x);
     return out;
 }
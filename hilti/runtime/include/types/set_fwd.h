@@ -3,6 +3,10 @@
 #pragma once
 
 namespace hilti::rt {
-template<typename T>
+template<typename T, bool Unordered = false>
 class Set;
+
+/** Alias for a `Set` that's backed by a hash table. */
+template<typename T>
+using UnorderedSet = Set<T, true>;
 } // namespace hilti::rt
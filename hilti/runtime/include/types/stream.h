@@ -105,7 +105,8 @@ struct Gap {
  * A chunk may or may not own its data. The former is the default for
  * construction and extension, unless specified explicitly otherwise. When
  * non-owning, the creator needs to ensure the data stays around as long as the
- * chunk does.
+ * chunk does. A chunk may also share immutable data with other chunks, which
+ * then keep it alive jointly through reference counting.
  *
  * All public methods of Chunk are constant. Modifications can be done only
  * be through the owning Chain (so that we can track changes there).
@@ -121,11 +122,23 @@ public:
     // Constructs a chunk that does not own its data.
     Chunk(const Offset& o, const Byte* b, size_t size, NonOwning) : _offset(o), _size(size), _data(b) {}
 
+    // Constructs a chunk that shares its data with others, without copying.
+    Chunk(const Offset& o, std::shared_ptr<const Bytes> data)
+        : _offset(o),
+          _size(data->size()),
+          _data(reinterpret_cast<const Byte*>(data->data())),
+          _shared(std::move(data)) {}
+
     // Constructs a gap chunk which signifies empty data.
     Chunk(const Offset& o, size_t len) : _offset(o), _size(len) { assert(_size > 0); }
 
     Chunk(const Chunk& other)
-        : _offset(other._offset), _size(other._size), _data(other._data), _chain(other._chain), _next(nullptr) {
+        : _offset(other._offset),
+          _size(other._size),
+          _data(other._data),
+          _shared(other._shared),
+          _chain(other._chain),
+          _next(nullptr) {
         if ( other.isOwning() )
             makeOwning();
     }
@@ -135,6 +148,7 @@ public:
           _size(other._size),
           _allocated(other._allocated),
           _data(other._data),
+          _shared(std::move(other._shared)),
           _chain(other._chain),
           _next(std::move(other._next)) {
         other._size = 0;
@@ -152,6 +166,7 @@ public:
         _size = other._size;
         _data = other._data;
         _allocated = 0;
+        _shared = other._shared;
         _chain = other._chain;
         _next = nullptr;
 
@@ -169,6 +184,7 @@ public:
         _size = other._size;
         _allocated = other._allocated;
         _data = other._data;
+        _shared = std::move(other._shared);
         _chain = other._chain;
         _next = std::move(other._next);
 
@@ -184,7 +200,8 @@ public:
     Offset offset() const { return _offset; }
     Offset endOffset() const { return _offset + size(); }
     bool isGap() const { return _data == nullptr; };
-    bool isOwning() const { return _allocated > 0; }
+    bool isOwning() const { return _allocated > 0 || _shared; }
+    bool isShared() const { return _shared != nullptr; }
     bool inRange(const Offset& offset) const { return offset >= _offset && offset < endOffset(); }
 
     const Byte* data() const {
@@ -229,7 +246,7 @@ public:
     // Creates a new copy of the data internally if the chunk is currently not
     // owning it. On return, is guaranteed to now own the data.
     void makeOwning() {
-        if ( _size == 0 || _allocated > 0 || ! _data )
+        if ( _size == 0 || isOwning() || ! _data )
             return;
 
         auto data = std::make_unique<Byte[]>(_size);
@@ -305,6 +322,8 @@ private:
     size_t _size = 0;              // size of payload or gap
     size_t _allocated = 0;         // size of memory allocated for data, which can be more than its size
     const Byte* _data = nullptr;   // chunk's payload, or null for gap chunks
+    // Keeps the payload alive if shared with other chunks, with `_allocated` being zero then.
+    std::shared_ptr<const Bytes> _shared;
     const Chain* _chain = nullptr; // chain this chunk is part of, or null if not linked to a chain yet (non-owning;
                                    // will stay valid at least as long as the current chunk does)
     std::unique_ptr<Chunk> _next = nullptr; // next chunk in chain, or null if last
@@ -327,6 +346,7 @@ public:
     /** Moves a chunk and all its successors into a new chain. */
     Chain(std::unique_ptr<Chunk> head) : _head(std::move(head)), _tail(_head->last()) {
         _head->setChain(this);
+        _indexChunks(_head.get());
 
         if ( auto size = _head->size() ) {
             if ( _head->isGap() ) {
@@ -386,6 +406,9 @@ public:
     // Appends a new chunk to the end, moving the data.
     void append(Bytes&& data);
 
+    // Appends a new chunk to the end, sharing the data.
+    void append(std::shared_ptr<const Bytes> data);
+
     // Appends another chain to the end.
     void append(Chain&& other);
 
@@ -406,6 +429,8 @@ public:
         _head.reset();
         _head_offset = 0;
         _tail = nullptr;
+        _index.clear();
+        _index_begin = 0;
         _statistics = {};
     }
 
@@ -415,6 +440,8 @@ public:
         _head.reset();
         _head_offset = 0;
         _tail = nullptr;
+        _index.clear();
+        _index_begin = 0;
         _statistics = {};
     }
 
@@ -446,6 +473,32 @@ private:
             throw Frozen("stream object can no longer be modified");
     }
 
+    // Adds a chunk and all its successors to the end of the offset index.
+    void _indexChunks(Chunk* c) {
+        for ( ; c; c = c->next() )
+            _index.push_back(c);
+    }
+
+    // Removes the first chunk from the offset index. We only advance the
+    // index' start position here and compact the storage once the unused
+    // prefix dominates, so that trimming remains amortized O(1).
+    void _unindexHead() {
+        assert(_index_begin < _index.size());
+
+        if ( ++_index_begin == _index.size() ) {
+            _index.clear();
+            _index_begin = 0;
+        }
+        else if ( _index_begin >= 32 && _index_begin * 2 >= _index.size() ) {
+            _index.erase(_index.begin(), _index.begin() + static_cast<std::ptrdiff_t>(_index_begin));
+            _index_begin = 0;
+        }
+    }
+
+    // Finds the chunk containing *offset* through a binary search of the
+    // offset index. Returns null if not found.
+    const Chunk* _lookupChunk(const Offset& offset) const;
+
     enum class State {
         Mutable, // content can be expanded an trimmed
         Frozen,  // content cannot be changed
@@ -468,6 +521,12 @@ private:
     // is empty; non-owning
     Chunk* _tail = nullptr;
 
+    // Index of all chunks reachable from *head*, in chain order, for
+    // logarithmic lookup of offsets. Entries before *_index_begin* have been
+    // trimmed off already and are pending removal; non-owning.
+    std::vector<Chunk*> _index;
+    size_t _index_begin = 0;
+
     // Tracks statistics as new data comes in.
     stream::Statistics _statistics;
 
@@ -1095,11 +1154,22 @@ inline void Chain::trim(const SafeConstIterator& i) {
 
 inline void Chain::trim(const UnsafeConstIterator& i) { trim(i.offset()); }
 
+inline const Chunk* Chain::_lookupChunk(const Offset& offset) const {
+    auto begin = _index.begin() + static_cast<std::ptrdiff_t>(_index_begin);
+    auto end = _index.end();
+
+    // Find the last chunk starting at or before the offset.
+    auto i = std::upper_bound(begin, end, offset, [](const Offset& o, const Chunk* c) { return o < c->offset(); });
+    if ( i == begin )
+        return nullptr;
+
+    const auto* c = *(i - 1);
+    return c->inRange(offset) ? c : nullptr;
+}
+
 inline const Chunk* Chain::findChunk(const Offset& offset, const Chunk* hint_prev) const {
     _ensureValid();
 
-    const Chunk* c = _head.get();
-
     // A very common way this function gets called without `hint_prev` is
     // `Stream::unsafeEnd` via `Chain::unsafeEnd` in construction of an
     // `UnsafeConstIterator` from a `SafeConstIterator`; in this case the chunk
@@ -1108,32 +1178,22 @@ inline const Chunk* Chain::findChunk(const Offset& offset, const Chunk* hint_pre
     if ( ! hint_prev )
         hint_prev = _tail;
 
-    if ( hint_prev && hint_prev->offset() <= offset )
-        c = hint_prev;
-
-    while ( c && ! c->inRange(offset) )
-        c = c->next();
+    // Fast-path for sequential access: the target is either inside the
+    // hinted chunk or in its immediate successor.
+    if ( hint_prev && hint_prev->offset() <= offset ) {
+        if ( hint_prev->inRange(offset) )
+            return hint_prev;
 
-    if ( c && ! c->inRange(offset) )
-        return nullptr;
+        if ( const auto* next = hint_prev->next(); next && next->inRange(offset) )
+            return next;
+    }
 
-    return c;
+    return _lookupChunk(offset);
 }
 
 inline Chunk* Chain::findChunk(const Offset& offset, Chunk* hint_prev) {
-    _ensureValid();
-
-    Chunk* c = _head.get();
-
-    // See comment above.
-    if ( ! hint_prev )
-        hint_prev = _tail;
-
-    if ( hint_prev && hint_prev->offset() <= offset )
-        c = hint_prev;
-
-    while ( c && ! c->inRange(offset) )
-        c = c->next();
+    // Cast is safe because we own all the chunks.
+    auto* c = const_cast<Chunk*>(std::as_const(*this).findChunk(offset, static_cast<const Chunk*>(hint_prev)));
 
     if ( _tail && offset > _tail->endOffset() )
         return _tail;
@@ -1614,6 +1674,10 @@ private:
     // Common backend for forward searching.
     Tuple<bool, UnsafeConstIterator> _findForward(const Bytes& v, UnsafeConstIterator n) const;
 
+    // Returns the offset where forward searches need to stop, which is the
+    // view's end capped by the data currently available.
+    Offset _searchEndOffset() const;
+
     SafeConstIterator _begin;
     std::optional<SafeConstIterator> _end;
 };
@@ -1800,6 +1864,16 @@ public:
      */
     void append(const char* data, size_t len, stream::NonOwning);
 
+    /**
+     * Appends the content of a bytes instance that's shared with other
+     * streams, *not* copying the data. The data remains alive as long as
+     * any stream still references it. This function does not invalidate
+     * iterators.
+     *
+     * @param data `Bytes` to append
+     */
+    void append(std::shared_ptr<const Bytes> data);
+
     /**
      * Cuts off the beginning of the data up to, but excluding, a given
      * iterator. All existing iterators pointing beyond that point will
@@ -4,6 +4,7 @@
 
 #include <arpa/inet.h>
 
+#include <functional>
 #include <limits>
 #include <string>
 
@@ -97,6 +98,20 @@ private:
 namespace time {
 extern Time current_time();
 extern Time mktime(uint64_t y, uint64_t m, uint64_t d, uint64_t H, uint64_t M, uint64_t S);
+
+/**
+ * Returns the current network time. Network time is driven by the host
+ * application, which advances it through `set_network_time()`, usually based
+ * on packet timestamps. It remains at zero if never set.
+ */
+extern Time network_time();
+
+/**
+ * Sets the current network time.
+ *
+ * @param t new network time
+ */
+extern void set_network_time(Time t);
 } // namespace time
 
 namespace detail::adl {
@@ -109,3 +124,8 @@ inline std::ostream& operator<<(std::ostream& out, const Time& x) {
 }
 
 } // namespace hilti::rt
+
+template<>
+struct std::hash<hilti::rt::Time> {
+    std::size_t operator()(const hilti::rt::Time& x) const { return std::hash<uint64_t>()(x.nanoseconds()); }
+};
@@ -211,10 +211,11 @@ std::string join_to_string(T&& x, const std::string& separator) {
 /** Corresponds to `hilti::printTuple`. */
 template<typename... Ts>
 void print(const Tuple<Ts...>& x, bool newline = true) {
-    if ( ! configuration::get().cout )
+    auto* out = configuration::detail::printStream();
+    if ( ! out )
         return;
 
-    auto& cout = configuration::get().cout->get();
+    auto& cout = *out;
 
     auto y = map_tuple(x, [](const auto& elem) {
         if ( elem )
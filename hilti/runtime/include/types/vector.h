@@ -101,7 +101,7 @@ class Iterator {
     using V = Vector<T, Allocator>;
     friend V;
 
-    std::weak_ptr<V*> _control;
+    typename V::C _control;
     typename V::size_type _index = 0;
 
 public:
@@ -113,8 +113,8 @@ public:
     using iterator_category = typename V::V::iterator::iterator_category;
 
     Iterator() = default;
-    Iterator(typename V::size_type&& index, const typename V::C& control)
-        : _control(control), _index(std::move(index)) {}
+    Iterator(typename V::size_type&& index, typename V::C control)
+        : _control(std::move(control)), _index(std::move(index)) {}
 
     reference operator*();
     const_reference operator*() const;
@@ -131,7 +131,7 @@ public:
     }
 
     friend bool operator==(const Iterator& a, const Iterator& b) {
-        if ( a._control.lock() != b._control.lock() )
+        if ( a._control.get() != b._control.get() )
             throw InvalidArgument("cannot compare iterators into different vectors");
         return a._index == b._index;
     }
@@ -139,31 +139,31 @@ public:
     friend bool operator!=(const Iterator& a, const Iterator& b) { return ! (a == b); }
 
     friend auto operator<(const Iterator& a, const Iterator& b) {
-        if ( a._control.lock() != b._control.lock() )
+        if ( a._control.get() != b._control.get() )
             throw InvalidArgument("cannot compare iterators into different vectors");
         return a._index < b._index;
     }
 
     friend auto operator<=(const Iterator& a, const Iterator& b) {
-        if ( a._control.lock() != b._control.lock() )
+        if ( a._control.get() != b._control.get() )
             throw InvalidArgument("cannot compare iterators into different vectors");
         return a._index <= b._index;
     }
 
     friend auto operator>(const Iterator& a, const Iterator& b) {
-        if ( a._control.lock() != b._control.lock() )
+        if ( a._control.get() != b._control.get() )
             throw InvalidArgument("cannot compare iterators into different vectors");
         return a._index > b._index;
     }
 
     friend auto operator>=(const Iterator& a, const Iterator& b) {
-        if ( a._control.lock() != b._control.lock() )
+        if ( a._control.get() != b._control.get() )
             throw InvalidArgument("cannot compare iterators into different vectors");
         return a._index >= b._index;
     }
 
     friend difference_type operator-(const Iterator& a, const Iterator& b) {
-        if ( a._control.lock() != b._control.lock() )
+        if ( a._control.get() != b._control.get() )
             throw InvalidArgument("cannot perform arithmetic with iterators into different vectors");
         return a._index - b._index;
     }
@@ -178,7 +178,7 @@ template<typename T, typename Allocator>
 class ConstIterator {
     using V = Vector<T, Allocator>;
 
-    std::weak_ptr<Vector<T, Allocator>*> _control;
+    typename V::C _control;
     typename V::size_type _index = 0;
 
 public:
@@ -190,8 +190,8 @@ public:
     using iterator_category = typename V::V::const_iterator::iterator_category;
 
     ConstIterator() = default;
-    ConstIterator(typename V::size_type&& index, const typename V::C& control)
-        : _control(control), _index(std::move(index)) {}
+    ConstIterator(typename V::size_type&& index, typename V::C control)
+        : _control(std::move(control)), _index(std::move(index)) {}
 
     const_reference operator*() const;
 
@@ -207,7 +207,7 @@ public:
     }
 
     friend bool operator==(const ConstIterator& a, const ConstIterator& b) {
-        if ( a._control.lock() != b._control.lock() )
+        if ( a._control.get() != b._control.get() )
             throw InvalidArgument("cannot compare iterators into different vectors");
         return a._index == b._index;
     }
@@ -215,31 +215,31 @@ public:
     friend bool operator!=(const ConstIterator& a, const ConstIterator& b) { return ! (a == b); }
 
     friend auto operator<(const ConstIterator& a, const ConstIterator& b) {
-        if ( a._control.lock() != b._control.lock() )
+        if ( a._control.get() != b._control.get() )
             throw InvalidArgument("cannot compare iterators into different vectors");
         return a._index < b._index;
     }
 
     friend auto operator<=(const ConstIterator& a, const ConstIterator& b) {
-        if ( a._control.lock() != b._control.lock() )
+        if ( a._control.get() != b._control.get() )
             throw InvalidArgument("cannot compare iterators into different vectors");
         return a._index <= b._index;
     }
 
     friend auto operator>(const ConstIterator& a, const ConstIterator& b) {
-        if ( a._control.lock() != b._control.lock() )
+        if ( a._control.get() != b._control.get() )
             throw InvalidArgument("cannot compare iterators into different vectors");
         return a._index > b._index;
     }
 
     friend auto operator>=(const ConstIterator& a, const ConstIterator& b) {
-        if ( a._control.lock() != b._control.lock() )
+        if ( a._control.get() != b._control.get() )
             throw InvalidArgument("cannot compare iterators into different vectors");
         return a._index >= b._index;
     }
 
     friend difference_type operator-(const ConstIterator& a, const ConstIterator& b) {
-        if ( a._control.lock() != b._control.lock() )
+        if ( a._control.get() != b._control.get() )
             throw InvalidArgument("cannot perform arithmetic with iterators into different vectors");
         return a._index - b._index;
     }
@@ -278,7 +278,7 @@ public:
     using iterator = vector::Iterator<T, Allocator>;
     using const_iterator = vector::ConstIterator<T, Allocator>;
 
-    using C = std::shared_ptr<Vector*>;
+    using C = rt::iterator::detail::ControlRef<Vector>;
 
     Vector() = default;
 
@@ -533,14 +533,9 @@ public:
     }
 
 private:
-    const C& getControl() const {
-        if ( ! _control )
-            _control = std::make_shared<Vector<T, Allocator>*>(const_cast<Vector<T, Allocator>*>(this));
+    C getControl() const { return _control.ref(this); }
 
-        return _control;
-    }
-
-    mutable C _control;
+    rt::iterator::detail::Control<Vector> _control;
 };
 
 namespace vector {
@@ -671,9 +666,8 @@ inline std::ostream& operator<<(std::ostream& out, const vector::ConstIterator<T
 
 template<typename T, typename Allocator>
 std::optional<std::reference_wrapper<Vector<T, Allocator>>> vector::Iterator<T, Allocator>::_container() const {
-    if ( auto l = _control.lock() ) {
-        return {std::ref(**l)};
-    }
+    if ( auto* c = _control.get() )
+        return {std::ref(*c)};
 
     return std::nullopt;
 }
@@ -695,9 +689,8 @@ typename vector::ConstIterator<T, Allocator>::const_reference vector::ConstItera
 
 template<typename T, typename Allocator>
 std::optional<std::reference_wrapper<Vector<T, Allocator>>> vector::ConstIterator<T, Allocator>::_container() const {
-    if ( auto l = _control.lock() ) {
-        return {std::ref(**l)};
-    }
+    if ( auto* c = _control.get() )
+        return {std::ref(*c)};
 
     return std::nullopt;
 }
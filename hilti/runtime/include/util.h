@@ -406,6 +406,9 @@ constexpr auto transform_result_value(const C&) {
     else if constexpr ( std::is_same_v<C, Set<X>> ) {
         return Set<Y>();
     }
+    else if constexpr ( std::is_same_v<C, UnorderedSet<X>> ) {
+        return UnorderedSet<Y>();
+    }
     else
         return std::vector<Y>(); // fallback
 }
@@ -6,11 +6,13 @@
 #pragma GCC diagnostic pop
 
 #include <cstdlib>
+#include <string>
 
 #include <hilti/rt/configuration.h>
 #include <hilti/rt/fiber.h>
 #include <hilti/rt/init.h>
 #include <hilti/rt/result.h>
+#include <hilti/rt/types/stream.h>
 
 static void execute_one(benchmark::State& state) {
     hilti::rt::init();
@@ -167,6 +169,43 @@ static void execute_many_resume(benchmark::State& state) {
     hilti::rt::done();
 }
 
+// Mimics the wrapper that the code generator emits for an externally visible
+// parsing function, processing one packet of frozen input per iteration.
+// Depending on the argument, the function runs either inside a fiber, or
+// directly on the caller's stack.
+static void execute_packet(benchmark::State& state) {
+    hilti::rt::init();
+    hilti::rt::detail::Fiber::primeCache();
+
+    auto direct = state.range(0);
+
+    auto data = hilti::rt::ValueReference<hilti::rt::Stream>();
+    data->append(std::string(1500, 'x').data(), 1500);
+    data->freeze();
+
+    auto parse = [](hilti::rt::ValueReference<hilti::rt::Stream>& data) -> hilti::rt::any {
+        return static_cast<uint64_t>(data->view().size());
+    };
+
+    for ( auto _ : state ) {
+        (void)_;
+
+        hilti::rt::Resumable r;
+
+        if ( direct && hilti::rt::resumable::detail::isInputFrozen(data) )
+            r = hilti::rt::Resumable::runDirectly([&](hilti::rt::resumable::Handle* h) { return parse(data); });
+        else {
+            r = hilti::rt::Resumable([&](hilti::rt::resumable::Handle* h) { return parse(data); });
+            r.run();
+        }
+
+        assert(r); // must have finished
+        benchmark::DoNotOptimize(r.get<uint64_t>());
+    }
+
+    hilti::rt::done();
+}
+
 const auto addl_stack_usage =
     static_cast<int64_t>(static_cast<double>(hilti::rt::configuration::get().fiber_min_stack_size) * 0.9);
 
@@ -175,5 +214,6 @@ BENCHMARK(execute_one_yield)->ArgName("addl_stack_usage")->Range(1, addl_stack_u
 BENCHMARK(execute_yield_to_other)->ArgName("addl_stack_usage")->Range(1, addl_stack_usage);
 BENCHMARK(execute_many)->ArgNames({"addl_stack_usage", "fibers"})->Ranges({{1, addl_stack_usage}, {1, 4096}});
 BENCHMARK(execute_many_resume)->ArgNames({"addl_stack_usage", "fibers"})->Ranges({{1, addl_stack_usage}, {1, 4096}});
+BENCHMARK(execute_packet)->ArgName("direct")->Arg(0)->Arg(1);
 
 BENCHMARK_MAIN();
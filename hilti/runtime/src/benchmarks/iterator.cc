@@ -0,0 +1,113 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#include <benchmark/benchmark.h>
+#pragma GCC diagnostic pop
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <hilti/rt/types/map.h>
+#include <hilti/rt/types/set.h>
+#include <hilti/rt/types/vector.h>
+
+using namespace hilti::rt;
+
+// Plain `std::vector` iteration, as a lower bound.
+static void std_vector(benchmark::State& state) {
+    std::vector<uint64_t> v(state.range(0), 1);
+
+    for ( auto _ : state ) {
+        (void)_;
+        uint64_t sum = 0;
+        for ( const auto& x : v )
+            sum += x;
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * v.size()));
+}
+
+// Iteration checking a `std::weak_ptr` control block on each comparison and
+// dereference, as safe iterators used to do, for comparison.
+static void weak_ptr_control(benchmark::State& state) {
+    std::vector<uint64_t> v(state.range(0), 1);
+    auto control = std::make_shared<std::vector<uint64_t>*>(&v);
+
+    for ( auto _ : state ) {
+        (void)_;
+        uint64_t sum = 0;
+        std::weak_ptr<std::vector<uint64_t>*> it = control;
+        std::weak_ptr<std::vector<uint64_t>*> end = control;
+
+        for ( size_t i = 0; it.lock() == end.lock() && i < v.size(); ++i ) {
+            if ( auto l = it.lock() )
+                sum += (**l)[i];
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * v.size()));
+}
+
+static void hilti_vector(benchmark::State& state) {
+    Vector<uint64_t> v;
+    v.resize(state.range(0), 1);
+
+    for ( auto _ : state ) {
+        (void)_;
+        uint64_t sum = 0;
+        for ( const auto& x : v )
+            sum += x;
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * v.size()));
+}
+
+static void hilti_map(benchmark::State& state) {
+    Map<uint64_t, uint64_t> m;
+    for ( int64_t i = 0; i < state.range(0); ++i )
+        m.index_assign(i, 1);
+
+    for ( auto _ : state ) {
+        (void)_;
+        uint64_t sum = 0;
+        for ( const auto& x : m )
+            sum += x.second;
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * m.size()));
+}
+
+static void hilti_set(benchmark::State& state) {
+    Set<uint64_t> s;
+    for ( int64_t i = 0; i < state.range(0); ++i )
+        s.insert(i);
+
+    for ( auto _ : state ) {
+        (void)_;
+        uint64_t sum = 0;
+        for ( const auto& x : s )
+            sum += x;
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * s.size()));
+}
+
+BENCHMARK(std_vector)->ArgName("size")->RangeMultiplier(32)->Range(32, 32 << 10);
+BENCHMARK(weak_ptr_control)->ArgName("size")->RangeMultiplier(32)->Range(32, 32 << 10);
+BENCHMARK(hilti_vector)->ArgName("size")->RangeMultiplier(32)->Range(32, 32 << 10);
+BENCHMARK(hilti_map)->ArgName("size")->RangeMultiplier(32)->Range(32, 32 << 10);
+BENCHMARK(hilti_set)->ArgName("size")->RangeMultiplier(32)->Range(32, 32 << 10);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,108 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#include <benchmark/benchmark.h>
+#pragma GCC diagnostic pop
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <hilti/rt/fmt.h>
+#include <hilti/rt/types/address.h>
+#include <hilti/rt/types/bytes.h>
+#include <hilti/rt/types/map.h>
+#include <hilti/rt/types/port.h>
+#include <hilti/rt/types/tuple.h>
+
+using namespace hilti::rt;
+
+using ConnID = Tuple<Address, Port>;
+
+// Returns `n` distinct connection-style keys.
+static std::vector<ConnID> make_conn_ids(int64_t n) {
+    std::vector<ConnID> keys;
+    keys.reserve(n);
+
+    for ( int64_t i = 0; i < n; ++i ) {
+        auto a = Address(fmt("10.%d.%d.%d", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff));
+        keys.push_back(tuple::make(a, Port(static_cast<uint16_t>(i % 65536), Protocol::TCP)));
+    }
+
+    return keys;
+}
+
+// Returns `n` distinct byte keys of the length typical for names or tokens.
+static std::vector<Bytes> make_bytes(int64_t n) {
+    std::vector<Bytes> keys;
+    keys.reserve(n);
+
+    for ( int64_t i = 0; i < n; ++i )
+        keys.emplace_back(fmt("key-%016d", i));
+
+    return keys;
+}
+
+template<typename M, typename K>
+static void insert(benchmark::State& state, const std::vector<K>& keys) {
+    for ( auto _ : state ) {
+        (void)_;
+        M m;
+        for ( const auto& k : keys )
+            m.index_assign(k, 1U);
+
+        benchmark::DoNotOptimize(m);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size()));
+}
+
+template<typename M, typename K>
+static void lookup(benchmark::State& state, const std::vector<K>& keys) {
+    M m;
+    for ( const auto& k : keys )
+        m.index_assign(k, 1U);
+
+    for ( auto _ : state ) {
+        (void)_;
+        uint64_t sum = 0;
+        for ( const auto& k : keys )
+            sum += m.get(k);
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size()));
+}
+
+static void insert_conn_id(benchmark::State& state) {
+    insert<Map<ConnID, uint64_t>>(state, make_conn_ids(state.range(0)));
+}
+
+static void insert_conn_id_unordered(benchmark::State& state) {
+    insert<UnorderedMap<ConnID, uint64_t>>(state, make_conn_ids(state.range(0)));
+}
+
+static void lookup_conn_id(benchmark::State& state) {
+    lookup<Map<ConnID, uint64_t>>(state, make_conn_ids(state.range(0)));
+}
+
+static void lookup_conn_id_unordered(benchmark::State& state) {
+    lookup<UnorderedMap<ConnID, uint64_t>>(state, make_conn_ids(state.range(0)));
+}
+
+static void lookup_bytes(benchmark::State& state) { lookup<Map<Bytes, uint64_t>>(state, make_bytes(state.range(0))); }
+
+static void lookup_bytes_unordered(benchmark::State& state) {
+    lookup<UnorderedMap<Bytes, uint64_t>>(state, make_bytes(state.range(0)));
+}
+
+BENCHMARK(insert_conn_id)->ArgName("size")->RangeMultiplier(16)->Range(16, 1 << 16);
+BENCHMARK(insert_conn_id_unordered)->ArgName("size")->RangeMultiplier(16)->Range(16, 1 << 16);
+BENCHMARK(lookup_conn_id)->ArgName("size")->RangeMultiplier(16)->Range(16, 1 << 16);
+BENCHMARK(lookup_conn_id_unordered)->ArgName("size")->RangeMultiplier(16)->Range(16, 1 << 16);
+BENCHMARK(lookup_bytes)->ArgName("size")->RangeMultiplier(16)->Range(16, 1 << 16);
+BENCHMARK(lookup_bytes_unordered)->ArgName("size")->RangeMultiplier(16)->Range(16, 1 << 16);
+
+BENCHMARK_MAIN();
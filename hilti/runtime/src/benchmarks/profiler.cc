@@ -0,0 +1,73 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#include <benchmark/benchmark.h>
+#pragma GCC diagnostic pop
+
+#include <hilti/rt/global-state.h>
+#include <hilti/rt/init.h>
+#include <hilti/rt/profiler.h>
+
+using namespace hilti::rt;
+
+// Measures the overhead of a start/stop pair for a pre-interned tag, which is
+// what generated code uses. Set HILTI_PROFILER_CYCLES to measure with the CPU's
+// cycle counter instead of the system clock.
+static void start_stop_tag(benchmark::State& state) {
+    hilti::rt::init();
+    detail::globalState()->profiling_enabled = true;
+
+    auto tag = profiler::tag("benchmark/tag");
+
+    for ( auto _ : state ) {
+        (void)_;
+        auto p = profiler::start(tag);
+        profiler::stop(p);
+    }
+
+    detail::globalState()->profiling_enabled = false;
+    hilti::rt::done();
+}
+
+// Measures the overhead of a start/stop pair when looking up tags by name.
+static void start_stop_name(benchmark::State& state) {
+    hilti::rt::init();
+    detail::globalState()->profiling_enabled = true;
+
+    for ( auto _ : state ) {
+        (void)_;
+        auto p = profiler::start("benchmark/name");
+        profiler::stop(p);
+    }
+
+    detail::globalState()->profiling_enabled = false;
+    hilti::rt::done();
+}
+
+// Measures start/stop pairs from multiple threads concurrently.
+static void start_stop_threads(benchmark::State& state) {
+    if ( state.thread_index() == 0 ) {
+        hilti::rt::init();
+        detail::globalState()->profiling_enabled = true;
+    }
+
+    auto tag = profiler::tag("benchmark/threads");
+
+    for ( auto _ : state ) {
+        (void)_;
+        auto p = profiler::start(tag);
+        profiler::stop(p);
+    }
+
+    if ( state.thread_index() == 0 ) {
+        detail::globalState()->profiling_enabled = false;
+        hilti::rt::done();
+    }
+}
+
+BENCHMARK(start_stop_tag);
+BENCHMARK(start_stop_name);
+BENCHMARK(start_stop_threads)->ThreadRange(1, 8);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,82 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#include <benchmark/benchmark.h>
+#pragma GCC diagnostic pop
+
+#include <cstdint>
+#include <string>
+
+#include <hilti/rt/init.h>
+#include <hilti/rt/types/bytes.h>
+#include <hilti/rt/types/regexp.h>
+#include <hilti/rt/types/stream.h>
+
+using namespace hilti::rt;
+using namespace hilti::rt::bytes::literals;
+
+// Look-ahead token set as a parser would use it for dispatching on a request method.
+static const regexp::Patterns Methods = {{"GET", false, 1},  {"POST", false, 2},    {"PUT", false, 3},
+                                         {"HEAD", false, 4}, {"DELETE", false, 5}, {"OPTIONS", false, 6}};
+
+// Matches a token set against input starting with one of its literals.
+static void token_set_accept(benchmark::State& state) {
+    hilti::rt::init();
+
+    const auto re = RegExp(Methods, regexp::Flags{.no_sub = true});
+    const auto s = Stream("OPTIONS /index.html HTTP/1.1\r\n"_b);
+    const auto v = s.view();
+
+    for ( auto _ : state ) {
+        (void)_;
+        benchmark::DoNotOptimize(re.tokenMatcher().advance(v));
+    }
+
+    hilti::rt::done();
+}
+
+// Matches a token set against input that none of its patterns can match,
+// which the prefilter rejects without running the regexp engine.
+static void token_set_reject(benchmark::State& state) {
+    hilti::rt::init();
+
+    const auto re = RegExp(Methods, regexp::Flags{.no_sub = true});
+    const auto s = Stream("PATCH /index.html HTTP/1.1\r\n"_b);
+    const auto v = s.view();
+
+    for ( auto _ : state ) {
+        (void)_;
+        benchmark::DoNotOptimize(re.tokenMatcher().advance(v));
+    }
+
+    hilti::rt::done();
+}
+
+// Searches for a pattern with a literal prefix at the end of `size` bytes of
+// data, which tries a match at every position.
+static void find(benchmark::State& state) {
+    hilti::rt::init();
+
+    const auto re = RegExp(regexp::Pattern("HTTP/1\\.[01]"), regexp::Flags{.no_sub = true});
+
+    std::string data;
+    for ( int64_t i = 0; i < state.range(0); ++i )
+        data.push_back("GET /index.html "[i % 16]);
+
+    const auto b = Bytes(data + "HTTP/1.1");
+
+    for ( auto _ : state ) {
+        (void)_;
+        benchmark::DoNotOptimize(re.find(b));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * b.size()));
+    hilti::rt::done();
+}
+
+BENCHMARK(token_set_accept);
+BENCHMARK(token_set_reject);
+BENCHMARK(find)->ArgName("size")->RangeMultiplier(8)->Range(64, 1 << 12);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,123 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#include <benchmark/benchmark.h>
+#pragma GCC diagnostic pop
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#include <hilti/rt/init.h>
+#include <hilti/rt/search.h>
+#include <hilti/rt/types/bytes.h>
+#include <hilti/rt/types/stream.h>
+
+using namespace hilti::rt;
+
+// Returns `size` bytes of filler data followed by the needle we search for.
+static std::string make_haystack(int64_t size, const std::string& needle) {
+    std::string data;
+    data.reserve(size + needle.size());
+
+    // Use bytes that frequently match the needle's first byte to exercise
+    // candidate verification, not just the scan.
+    for ( int64_t i = 0; i < size; ++i )
+        data.push_back(static_cast<char>("abcdefghijklmnop"[i % 16]));
+
+    return data + needle;
+}
+
+static const std::string Needle = "abcdefghijklmnoX";
+
+// Byte-by-byte search, as previously done for views, as a baseline.
+static void naive(benchmark::State& state) {
+    auto data = make_haystack(state.range(0), Needle);
+
+    for ( auto _ : state ) {
+        (void)_;
+        benchmark::DoNotOptimize(std::search(data.begin(), data.end(), Needle.begin(), Needle.end()));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+
+// Contiguous search through the vectorized search primitive.
+static void search_forward(benchmark::State& state) {
+    auto data = make_haystack(state.range(0), Needle);
+    state.SetLabel(search::implementation());
+
+    const auto* h = reinterpret_cast<const uint8_t*>(data.data());
+    const auto* n = reinterpret_cast<const uint8_t*>(Needle.data());
+
+    for ( auto _ : state ) {
+        (void)_;
+        benchmark::DoNotOptimize(search::forward(h, data.size(), n, Needle.size()));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+
+// Backward search for a needle located at the very beginning.
+static void search_backward(benchmark::State& state) {
+    auto data = Needle + make_haystack(state.range(0), "");
+    state.SetLabel(search::implementation());
+
+    const auto* h = reinterpret_cast<const uint8_t*>(data.data());
+    const auto* n = reinterpret_cast<const uint8_t*>(Needle.data());
+
+    for ( auto _ : state ) {
+        (void)_;
+        benchmark::DoNotOptimize(search::backward(h, data.size(), n, Needle.size()));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+
+static void bytes_find(benchmark::State& state) {
+    hilti::rt::init();
+
+    auto b = Bytes(make_haystack(state.range(0), Needle));
+    auto n = Bytes(Needle);
+
+    for ( auto _ : state ) {
+        (void)_;
+        benchmark::DoNotOptimize(b.find(n));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * b.size().Ref()));
+    hilti::rt::done();
+}
+
+// Searches a stream made of chunks of 1500 bytes each, so that matches
+// may straddle chunk boundaries.
+static void view_find(benchmark::State& state) {
+    hilti::rt::init();
+
+    auto data = make_haystack(state.range(0), Needle);
+
+    Stream s;
+    for ( size_t i = 0; i < data.size(); i += 1500 )
+        s.append(data.data() + i, std::min<size_t>(1500, data.size() - i));
+
+    s.freeze();
+    auto v = s.view();
+    auto n = Bytes(Needle);
+
+    for ( auto _ : state ) {
+        (void)_;
+        benchmark::DoNotOptimize(v.find(n));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+    hilti::rt::done();
+}
+
+BENCHMARK(naive)->ArgName("size")->RangeMultiplier(16)->Range(64, 1 << 20);
+BENCHMARK(search_forward)->ArgName("size")->RangeMultiplier(16)->Range(64, 1 << 20);
+BENCHMARK(search_backward)->ArgName("size")->RangeMultiplier(16)->Range(64, 1 << 20);
+BENCHMARK(bytes_find)->ArgName("size")->RangeMultiplier(16)->Range(64, 1 << 20);
+BENCHMARK(view_find)->ArgName("size")->RangeMultiplier(16)->Range(64, 1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,90 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#include <benchmark/benchmark.h>
+#pragma GCC diagnostic pop
+
+#include <cstdint>
+
+#include <hilti/rt/init.h>
+#include <hilti/rt/types/stream.h>
+
+using namespace hilti::rt;
+
+// Builds a stream consisting of `num_chunks` chunks of `chunk_size` bytes each.
+static Stream make_stream(int64_t num_chunks, int64_t chunk_size) {
+    Stream s;
+    auto chunk = std::string(chunk_size, 'x');
+
+    for ( int64_t i = 0; i < num_chunks; ++i )
+        s.append(chunk.data(), chunk.size());
+
+    return s;
+}
+
+// Random access into a stream through `Stream::at()`.
+static void random_access(benchmark::State& state) {
+    hilti::rt::init();
+
+    auto num_chunks = state.range(0);
+    auto s = make_stream(num_chunks, 16);
+    auto size = s.size().Ref();
+
+    uint64_t offset = 0;
+    for ( auto _ : state ) {
+        (void)_;
+        offset = (offset + 7919) % size; // Jump around pseudo-randomly.
+        benchmark::DoNotOptimize(*s.at(offset));
+    }
+
+    state.SetComplexityN(num_chunks);
+    hilti::rt::done();
+}
+
+// Moves an iterator backwards across chunk boundaries, as done by backward searches.
+static void backward_jump(benchmark::State& state) {
+    hilti::rt::init();
+
+    auto num_chunks = state.range(0);
+    auto s = make_stream(num_chunks, 16);
+    auto size = s.size().Ref();
+
+    for ( auto _ : state ) {
+        (void)_;
+        state.PauseTiming();
+        auto i = s.end();
+        state.ResumeTiming();
+
+        while ( i.offset() >= 33 ) {
+            i -= 33;
+            benchmark::DoNotOptimize(*i);
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (size / 33)));
+    hilti::rt::done();
+}
+
+// Sequential forward iteration, which should remain unaffected by the chain size.
+static void forward_iteration(benchmark::State& state) {
+    hilti::rt::init();
+
+    auto num_chunks = state.range(0);
+    auto s = make_stream(num_chunks, 16);
+
+    for ( auto _ : state ) {
+        (void)_;
+        for ( auto i = s.begin(); i != s.end(); ++i )
+            benchmark::DoNotOptimize(*i);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * s.size().Ref()));
+    hilti::rt::done();
+}
+
+BENCHMARK(random_access)->ArgName("chunks")->RangeMultiplier(4)->Range(1, 65536)->Complexity();
+BENCHMARK(backward_jump)->ArgName("chunks")->RangeMultiplier(4)->Range(4, 16384);
+BENCHMARK(forward_iteration)->ArgName("chunks")->RangeMultiplier(4)->Range(4, 16384);
+
+BENCHMARK_MAIN();
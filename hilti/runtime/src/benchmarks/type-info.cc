@@ -0,0 +1,64 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#include <benchmark/benchmark.h>
+#pragma GCC diagnostic pop
+
+#include <cstdint>
+
+#include <hilti/rt/type-info.h>
+#include <hilti/rt/types/vector.h>
+
+using namespace hilti::rt;
+
+using Int = integer::safe<uint64_t>;
+
+static const TypeInfo vector_ti = {"V", "V", nullptr,
+                                   new type_info::Vector(&type_info::uint64, type_info::Vector::accessor<Int>())};
+
+// Converts all elements of a vector through type information, as a host
+// application exporting parsed data would, by visiting them with `iterate()`.
+static void iterate(benchmark::State& state) {
+    auto x = StrongReference<Vector<Int>>(Vector<Int>());
+    x->resize(state.range(0), 1);
+
+    auto p = type_info::value::Parent(x);
+    auto v = type_info::Value(&*x, &vector_ti, p);
+
+    for ( auto _ : state ) {
+        (void)_;
+        uint64_t sum = 0;
+        for ( auto e : vector_ti.vector->iterate(v) )
+            sum += e.type().unsigned_integer_uint64->get(e);
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * x->size()));
+}
+
+// Same as `iterate`, but visiting elements with `forEach()`.
+static void for_each(benchmark::State& state) {
+    auto x = StrongReference<Vector<Int>>(Vector<Int>());
+    x->resize(state.range(0), 1);
+
+    auto p = type_info::value::Parent(x);
+    auto v = type_info::Value(&*x, &vector_ti, p);
+
+    for ( auto _ : state ) {
+        (void)_;
+        uint64_t sum = 0;
+        vector_ti.vector->forEach(v,
+                                  [&](const type_info::Value& e) { sum += e.type().unsigned_integer_uint64->get(e); });
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * x->size()));
+}
+
+BENCHMARK(iterate)->ArgName("size")->Arg(1 << 20);
+BENCHMARK(for_each)->ArgName("size")->Arg(1 << 20);
+
+BENCHMARK_MAIN();
@@ -5,6 +5,7 @@
 
 #include <hilti/rt/autogen/config.h>
 #include <hilti/rt/configuration.h>
+#include <hilti/rt/context.h>
 #include <hilti/rt/global-state.h>
 #include <hilti/rt/init.h>
 #include <hilti/rt/logging.h>
@@ -17,9 +18,20 @@ std::unique_ptr<hilti::rt::Configuration> configuration::detail::__configuration
 Configuration::Configuration() {
     auto* x = ::getenv("HILTI_DEBUG");
     debug_streams = (x ? x : "");
+    profiling_use_cycle_counter = (::getenv("HILTI_PROFILER_CYCLES") != nullptr);
     cout = std::cout;
 }
 
+std::ostream* configuration::detail::printStream() {
+    if ( const auto* ctx = context::detail::get(true); ctx && ctx->cout )
+        return ctx->cout;
+
+    if ( const auto& cout = configuration::get().cout )
+        return &cout->get();
+
+    return nullptr;
+}
+
 void configuration::set(Configuration cfg) {
     if ( isInitialized() )
         hilti::rt::fatalError("attempt to change configuration after library has already been initialized");
@@ -34,10 +34,19 @@ Context::Context(vthread::ID vid) : vid(vid) {
         return;
     }
 
+    // The modules' initialization code operates on the current context.
+    auto* previous = context::detail::set(this);
+
     for ( const auto& m : globalState()->hilti_modules ) {
-        if ( m.init_globals )
+        // Modules compiled without dynamic globals keep their globals in
+        // process-wide variables that the master context has already
+        // initialized; re-initializing them here would clobber state that
+        // other contexts may be using concurrently.
+        if ( m.init_globals && m.globals_idx )
             (*m.init_globals)(this);
     }
+
+    context::detail::set(previous);
 }
 
 Context::~Context() {
@@ -1,6 +1,9 @@
 // Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
 
+#include <array>
+#include <deque>
 #include <type_traits>
+#include <unordered_map>
 
 #include <hilti/rt/logging.h>
 #include <hilti/rt/util.h>
@@ -15,21 +18,77 @@ using namespace hilti::rt::detail;
 
 using namespace hilti::rt;
 
+namespace {
+// Process-wide registry assigning IDs to stream names in order of first use.
+struct StreamRegistry {
+    std::mutex mutex;
+    std::deque<std::string> names; // deque keeps addresses stable as we add names
+    std::unordered_map<std::string_view, uint64_t> ids;
+};
+
+StreamRegistry& streamRegistry() {
+    // Never destroyed so that debug output remains functional during shutdown.
+    static auto* registry = new StreamRegistry();
+    return *registry;
+}
+} // namespace
+
+debug::Stream::Stream(std::string_view name) {
+    struct CacheEntry {
+        const char* data = nullptr;
+        std::string_view name;
+        uint64_t id = 0;
+    };
+
+    // Names passed in are usually string literals, so we look them up by
+    // address first. We still compare the content in case the memory has
+    // been reused for a different name.
+    static thread_local std::array<CacheEntry, 64> cache;
+    auto& entry = cache[(reinterpret_cast<uintptr_t>(name.data()) >> 3) % cache.size()];
+
+    if ( entry.data != name.data() || entry.name != name ) {
+        auto& registry = streamRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        auto i = registry.ids.find(name);
+        if ( i == registry.ids.end() ) {
+            const auto& n = registry.names.emplace_back(name);
+            i = registry.ids.emplace(n, registry.names.size() - 1).first;
+        }
+
+        entry = CacheEntry{name.data(), i->first, i->second};
+    }
+
+    _id = entry.id;
+    _name = entry.name;
+}
+
 detail::DebugLogger::DebugLogger(hilti::rt::filesystem::path output) : _path(std::move(output)) {}
 
 void detail::DebugLogger::enable(std::string_view streams) {
-    for ( auto s : split(streams, ":") )
-        _streams[trim(s)] = 0;
+    for ( auto s : split(streams, ":") ) {
+        auto stream = debug::Stream(trim(s));
+        auto word = stream.id() / 64;
+
+        if ( word >= _enabled.size() )
+            _enabled.resize(word + 1);
+
+        if ( stream.id() >= _indent.size() )
+            _indent.resize(stream.id() + 1);
+
+        _enabled[word] |= (uint64_t(1) << (stream.id() % 64));
+    }
 }
 
-void detail::DebugLogger::print(std::string_view stream, std::string_view msg) {
+void detail::DebugLogger::print(const debug::Stream& stream, std::string_view msg) {
     if ( _path.empty() )
         return;
 
-    auto i = _streams.find(stream);
-    if ( i == _streams.end() )
+    if ( ! isEnabled(stream) )
         return;
 
+    std::lock_guard<std::mutex> lock(_mutex);
+
     if ( ! _output ) {
         if ( _path == "/dev/stdout" )
             _output = &std::cout;
@@ -48,8 +107,9 @@ void detail::DebugLogger::print(std::string_view stream, std::string_view msg) {
     // would have already run into trouble elsewhere (e.g., giant strings from
     // huge ident widths). Instead perform the computation with overflow which
     // for unsigned integers is defined and wraps around.
-    static_assert(std::is_unsigned_v<std::remove_reference_t<decltype(i->second.Ref())>>);
-    auto indent = std::string(i->second.Ref() * 2, ' ');
-    (*_output) << fmt("[%s] %s%s", stream, indent, msg) << '\n';
+    auto& level = _indent[stream.id()];
+    static_assert(std::is_unsigned_v<std::remove_reference_t<decltype(level.Ref())>>);
+    auto indent = std::string(level.Ref() * 2, ' ');
+    (*_output) << fmt("[%s] %s%s", stream.name(), indent, msg) << '\n';
     _output->flush();
 }
@@ -47,15 +47,24 @@ static const auto FiberGuardFlags = 0; // leak sanitizer may abort with "Tracer
 
 #endif
 
-// Pre-allocate this so that we don't need to create a std::string on the fly
-// when HILTI_RT_FIBER_DEBUG executes. That avoids a false positive with
-// ASAN during fiber switching when using GCC/libc++.
-static const std::string debug_stream_fibers = "fibers";
+// Resolve this upfront so that we don't need to look up the stream on the
+// fly when HILTI_RT_FIBER_DEBUG executes. That also avoids a false positive
+// with ASAN during fiber switching when using GCC/libc++.
+static const debug::Stream debug_stream_fibers("fibers");
+
+// Raises an atomic statistics counter to a new value if that's larger than
+// its current one.
+static void updateMaximum(std::atomic<uint64_t>* max, uint64_t value) {
+    auto current = max->load(std::memory_order_relaxed);
+    while ( value > current && ! max->compare_exchange_weak(current, value, std::memory_order_relaxed) )
+        ;
+}
 
 // Wrapper similar to HILTI_RT_DEBUG that adds the current fiber to the message.
 #define HILTI_RT_FIBER_DEBUG(tag, msg)                                                                                 \
     {                                                                                                                  \
-        if ( ::hilti::rt::detail::unsafeGlobalState()->debug_logger &&                                                 \
+        if ( ! ::hilti::rt::debug::detail::isCompiledOut("fibers") &&                                                  \
+             ::hilti::rt::detail::unsafeGlobalState()->debug_logger &&                                                 \
              ::hilti::rt::detail::unsafeGlobalState()->debug_logger->isEnabled(debug_stream_fibers) )                  \
             ::hilti::rt::debug::detail::print(debug_stream_fibers,                                                     \
                                               fmt("[%s/%s] %s", *context::detail::get()->fiber.current, tag, msg));    \
@@ -63,7 +72,8 @@ static const std::string debug_stream_fibers = "fibers";
 
 #define HILTI_RT_FIBER_DEBUG_NO_CONTEXT(tag, msg)                                                                      \
     {                                                                                                                  \
-        if ( ::hilti::rt::detail::unsafeGlobalState()->debug_logger &&                                                 \
+        if ( ! ::hilti::rt::debug::detail::isCompiledOut("fibers") &&                                                  \
+             ::hilti::rt::detail::unsafeGlobalState()->debug_logger &&                                                 \
              ::hilti::rt::detail::unsafeGlobalState()->debug_logger->isEnabled(debug_stream_fibers) )                  \
             ::hilti::rt::debug::detail::print(debug_stream_fibers, fmt("[none/%s] %s", tag, msg));                     \
     }
@@ -243,11 +253,7 @@ detail::Fiber::Fiber(Type type) : _type(type), _fiber(std::make_unique<::Fiber>(
         case Type::IndividualStack: {
             // We do bookkeeping only for the "real" fibers with payload.
             ++_total_fibers;
-            ++_current_fibers;
-
-            // NOLINTNEXTLINE(readability-use-std-min-max)
-            if ( _current_fibers > _max_fibers )
-                _max_fibers = _current_fibers;
+            updateMaximum(&_max_fibers, ++_current_fibers);
         }
 
         case Type::SwitchTrampoline:
@@ -683,6 +689,14 @@ void detail::yield() {
     context::detail::get()->resumable = r;
 }
 
+detail::DirectExecutionScope::DirectExecutionScope() {
+    _previous = context::detail::get()->resumable;
+    context::detail::get()->resumable = nullptr;
+    HILTI_RT_FIBER_DEBUG("direct", "executing function directly on current stack");
+}
+
+detail::DirectExecutionScope::~DirectExecutionScope() { context::detail::get()->resumable = _previous; }
+
 void detail::trackStack() {
     auto* fiber = context::detail::get()->fiber.current;
 
@@ -690,9 +704,7 @@ void detail::trackStack() {
         return;
 
     if ( fiber->type() == Fiber::Type::IndividualStack || fiber->type() == Fiber::Type::SharedStack ) {
-        // NOLINTNEXTLINE(readability-use-std-min-max)
-        if ( auto size = fiber->stackBuffer().activeSize(); size > detail::Fiber::_max_stack_size )
-            detail::Fiber::_max_stack_size = size;
+        updateMaximum(&detail::Fiber::_max_stack_size, fiber->stackBuffer().activeSize());
     }
 }
 
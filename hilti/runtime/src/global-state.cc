@@ -4,6 +4,7 @@
 #include <hilti/rt/context.h>
 #include <hilti/rt/global-state.h>
 #include <hilti/rt/logging.h>
+#include <hilti/rt/types/regexp.h>
 
 using namespace hilti::rt;
 using namespace hilti::rt::detail;
@@ -14,6 +15,7 @@ GlobalState* detail::__global_state = nullptr;
 
 GlobalState* detail::createGlobalState() {
     __global_state = new GlobalState(); // NOLINT (cppcoreguidelines-owning-memory)
+    __global_state->regexp_cache = std::make_unique<regexp::detail::Cache>();
     __global_state->c_locale = newlocale(LC_ALL_MASK, "C", nullptr);
 
     if ( ! __global_state->c_locale )
@@ -1,7 +1,16 @@
 // Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
 
 #include <cinttypes>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 #include <hilti/rt/configuration.h>
 #include <hilti/rt/logging.h>
@@ -11,6 +20,93 @@
 using namespace hilti::rt;
 using namespace hilti::rt::profiler;
 
+namespace {
+
+// Measurements recorded by a single thread, indexed by tag. Only the owning
+// thread updates a slab, so recording doesn't need any synchronization.
+// Growing `states` happens under the registry's lock so that reporting can
+// safely walk all slabs.
+struct Slab {
+    std::vector<profiler::detail::MeasurementState> states;
+    std::unordered_map<std::string_view, Tag> tags; // per-thread cache of interned names
+};
+
+// Process-wide registry of interned tag names and of all threads' slabs.
+// Slabs are never released so that measurements from terminated threads
+// still show up in the final report.
+struct Registry {
+    std::mutex mutex;
+    std::deque<std::string> names;                  // indexed by tag; deque keeps references stable
+    std::unordered_map<std::string_view, Tag> tags; // keys point into `names`
+    std::vector<std::unique_ptr<Slab>> slabs;
+    Measurement total; // snapshot at initialization time, and then total time at termination
+};
+
+// Intentionally leaked so that it remains valid for any late thread-local accesses.
+Registry* registry() {
+    static auto* r = new Registry();
+    return r;
+}
+
+HILTI_THREAD_LOCAL Slab* __slab = nullptr;
+
+// True to take time measurements through the CPU's cycle counter.
+bool __use_cycle_counter = false;
+
+Slab* slab() {
+    if ( ! __slab ) {
+        auto* r = registry();
+        std::lock_guard<std::mutex> lock(r->mutex);
+        __slab = r->slabs.emplace_back(std::make_unique<Slab>()).get();
+    }
+
+    return __slab;
+}
+
+profiler::detail::MeasurementState& state(Tag tag) {
+    auto* s = slab();
+
+    if ( tag >= s->states.size() ) {
+        std::lock_guard<std::mutex> lock(registry()->mutex);
+        s->states.resize(tag + 1);
+    }
+
+    return s->states[tag];
+}
+
+// Returns true if profiling has been enabled. Unlike going through
+// `globalState()`, this neither creates the global state if it doesn't exist
+// yet nor requires it to, so profilers may run before `init()`.
+bool profilingEnabled() {
+    const auto* s = hilti::rt::detail::__global_state;
+    return s && s->profiling_enabled;
+}
+
+// Aggregates measurements for a tag across all threads. Must be called with
+// the registry's lock held. Slabs are updated without synchronization, so
+// this must also not run concurrently with any other thread recording
+// measurements; see `profiler::get()` and `profiler::report()`.
+std::optional<Measurement> aggregate(const Registry& r, Tag tag) {
+    std::optional<Measurement> m;
+
+    for ( const auto& s : r.slabs ) {
+        if ( tag >= s->states.size() )
+            continue;
+
+        const auto& x = s->states[tag].m;
+
+        if ( ! m )
+            m = Measurement();
+
+        m->count += x.count;
+        *m += x;
+    }
+
+    return m;
+}
+
+} // namespace
+
 // Helper to get a platform-specific, monotonic high-resolution clock.
 inline static uint64_t _getClock() {
 #if defined(__APPLE__)
@@ -28,62 +124,114 @@ inline static uint64_t _getClock() {
 #endif
 }
 
-void Profiler::_register() const { ++detail::globalState()->profilers[_name].instances; }
+// Helper to read the CPU's cycle counter, if available. This is much cheaper
+// than going through the system clock, but measures in cycles instead of
+// nanoseconds. Falls back to the system clock on other platforms.
+inline static uint64_t _getCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t t;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(t));
+    return t;
+#else
+    return _getClock();
+#endif
+}
+
+Tag profiler::tag(std::string_view name) {
+    auto* s = slab();
+
+    if ( auto i = s->tags.find(name); i != s->tags.end() )
+        return i->second;
+
+    auto* r = registry();
+    std::lock_guard<std::mutex> lock(r->mutex);
+
+    auto i = r->tags.find(name);
+    if ( i == r->tags.end() ) {
+        const auto& n = r->names.emplace_back(name);
+        i = r->tags.emplace(n, static_cast<Tag>(r->names.size() - 1)).first;
+    }
+
+    s->tags.emplace(i->first, i->second);
+    return i->second;
+}
+
+void Profiler::_register() const { ++state(*_tag).instances; }
 
 profiler::Measurement Profiler::snapshot(std::optional<uint64_t> volume) {
-    if ( ! detail::globalState()->profiling_enabled )
+    if ( ! profilingEnabled() )
         return Measurement();
 
     Measurement m;
-    m.time = _getClock();
+    m.time = (__use_cycle_counter ? _getCycles() : _getClock());
     m.volume = volume;
     return m;
 }
 
 void Profiler::record(const Measurement& end) {
-    if ( ! detail::globalState()->profiling_enabled )
+    if ( ! profilingEnabled() )
         return;
 
     if ( ! *this )
         return; // already recorded
 
-    auto& p = detail::globalState()->profilers[_name];
-    assert(p.instances > 0);
+    auto& p = state(*_tag);
 
-    ++p.m.count;
+    // A profiler started before `init()` reset the state won't find an instance.
+    if ( p.instances > 0 ) {
+        ++p.m.count;
 
-    // With recursive calls, we only time the top-level.
-    if ( p.instances-- == 1 )
-        p.m += (end - _start);
+        // With recursive calls, we only time the top-level.
+        if ( p.instances-- == 1 )
+            p.m += (end - _start);
+    }
 
-    _name.clear();
+    _tag.reset();
 }
 
 void profiler::detail::init() {
     if ( ! configuration::get().enable_profiling )
         return;
 
-    rt::detail::globalState()->profiling_enabled = true;
+    __use_cycle_counter = configuration::get().profiling_use_cycle_counter;
+
+    auto* r = registry();
+
+    {
+        std::lock_guard<std::mutex> lock(r->mutex);
 
-    auto& p = rt::detail::globalState()->profilers["hilti/total"];
-    p.m = Profiler::snapshot();
+        for ( auto& s : r->slabs ) {
+            for ( auto& p : s->states )
+                p = {};
+        }
+    }
+
+    rt::detail::globalState()->profiling_enabled = true;
+    r->total = Profiler::snapshot();
 }
 
 void profiler::detail::done() {
     if ( ! rt::detail::globalState()->profiling_enabled )
         return;
 
-    auto& p = rt::detail::globalState()->profilers["hilti/total"];
-    p.m = (Profiler::snapshot() - p.m);
-    ++p.m.count;
+    auto* r = registry();
+    r->total = (Profiler::snapshot() - r->total);
+    r->total.count = 1;
 
     report();
 }
 
 std::optional<Measurement> profiler::get(const std::string& name) {
-    const auto& profilers = rt::detail::globalState()->profilers;
-    if ( auto i = profilers.find(name); i != profilers.end() )
-        return i->second.m;
+    auto* r = registry();
+    std::lock_guard<std::mutex> lock(r->mutex);
+
+    if ( name == "hilti/total" )
+        return r->total;
+
+    if ( auto i = r->tags.find(name); i != r->tags.end() )
+        return aggregate(*r, i->second);
     else
         return {};
 }
@@ -92,20 +240,23 @@ void profiler::report() {
     static const auto* const fmt_header = "#%-49s %10s %10s %10s %10s %15s\n";
     static const auto* const fmt_data = "%-50s %10" PRIu64 " %10" PRIu64 " %10.2f %10.2f %15s\n";
 
-    const auto& profilers = rt::detail::globalState()->profilers;
+    auto* r = registry();
+    std::lock_guard<std::mutex> lock(r->mutex);
 
-    std::cerr << "#\n# Profiling results\n#\n";
-    std::cerr << fmt(fmt_header, "name", "count", "time", "avg-%", "total-%", "volume");
+    std::map<std::string_view, Measurement> profilers;
+    profilers.emplace("hilti/total", r->total);
 
-    std::set<std::string> names;
-    for ( const auto& [name, _] : profilers )
-        names.insert(name);
+    for ( const auto& [name, tag] : r->tags ) {
+        if ( auto m = aggregate(*r, tag) )
+            profilers.emplace(name, *m);
+    }
 
-    auto total_time = static_cast<double>(profilers.at("hilti/total").m.time);
+    std::cerr << "#\n# Profiling results\n#\n";
+    std::cerr << fmt(fmt_header, "name", "count", "time", "avg-%", "total-%", "volume");
 
-    for ( const auto& name : names ) {
-        const auto& p = profilers.at(name).m;
+    auto total_time = static_cast<double>(r->total.time);
 
+    for ( const auto& [name, p] : profilers ) {
         if ( p.count == 0 )
             continue;
 
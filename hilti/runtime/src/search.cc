@@ -0,0 +1,212 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+#include <cstring>
+
+#include <hilti/rt/search.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HILTI_RT_SEARCH_X86
+#endif
+
+using namespace hilti::rt;
+
+namespace {
+
+// Returns true if the inner bytes of a candidate match at `x` are identical to
+// those of the needle `p` of size `m`. The first and last bytes are expected
+// to have been checked already.
+inline bool verify(const uint8_t* x, const uint8_t* p, size_t m) { return m <= 2 || memcmp(x + 1, p + 1, m - 2) == 0; }
+
+// Scalar forward search, starting at position `i`. Expects `1 <= m <= n`.
+const uint8_t* forwardScalar(const uint8_t* h, size_t n, const uint8_t* p, size_t m, size_t i) {
+    const auto last = n - m; // last possible start position
+
+    while ( i <= last ) {
+        const auto* x = reinterpret_cast<const uint8_t*>(memchr(h + i, p[0], last - i + 1));
+        if ( ! x )
+            return nullptr;
+
+        if ( x[m - 1] == p[m - 1] && verify(x, p, m) )
+            return x;
+
+        i = (x - h) + 1;
+    }
+
+    return nullptr;
+}
+
+// Scalar backward search, considering start positions `i` and below. Expects
+// `1 <= m <= n` and `i <= n - m`.
+const uint8_t* backwardScalar(const uint8_t* h, size_t n, const uint8_t* p, size_t m, size_t i) {
+    for ( ;; ) {
+        if ( h[i] == p[0] && h[i + m - 1] == p[m - 1] && verify(h + i, p, m) )
+            return h + i;
+
+        if ( i-- == 0 )
+            return nullptr;
+    }
+}
+
+#ifdef HILTI_RT_SEARCH_X86
+
+// The SIMD versions compare blocks of candidate start positions against the
+// needle's first byte, and the blocks shifted by `m - 1` against the needle's
+// last byte. Only positions where both match get verified with a full
+// comparison. Remaining positions that don't fill a complete block are
+// handled by the scalar versions.
+
+__attribute__((target("sse2"))) const uint8_t* forwardSSE2(const uint8_t* h, size_t n, const uint8_t* p, size_t m) {
+    const auto first = _mm_set1_epi8(static_cast<char>(p[0]));
+    const auto last = _mm_set1_epi8(static_cast<char>(p[m - 1]));
+
+    size_t i = 0;
+    for ( ; i + m - 1 + 16 <= n; i += 16 ) {
+        const auto bf = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+        const auto bl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + m - 1));
+        auto mask = static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(bf, first), _mm_cmpeq_epi8(bl, last))));
+
+        while ( mask ) {
+            auto bit = static_cast<size_t>(__builtin_ctz(mask));
+            if ( verify(h + i + bit, p, m) )
+                return h + i + bit;
+
+            mask &= mask - 1;
+        }
+    }
+
+    return forwardScalar(h, n, p, m, i);
+}
+
+__attribute__((target("sse2"))) const uint8_t* backwardSSE2(const uint8_t* h, size_t n, const uint8_t* p, size_t m) {
+    const auto first = _mm_set1_epi8(static_cast<char>(p[0]));
+    const auto last = _mm_set1_epi8(static_cast<char>(p[m - 1]));
+
+    // `end` is one past the highest start position not yet examined.
+    size_t end = n - m + 1;
+    for ( ; end >= 16; end -= 16 ) {
+        const auto i = end - 16;
+        const auto bf = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+        const auto bl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + m - 1));
+        auto mask = static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(bf, first), _mm_cmpeq_epi8(bl, last))));
+
+        while ( mask ) {
+            auto bit = static_cast<size_t>(31 - __builtin_clz(mask));
+            if ( verify(h + i + bit, p, m) )
+                return h + i + bit;
+
+            mask &= ~(1U << bit);
+        }
+    }
+
+    return end > 0 ? backwardScalar(h, n, p, m, end - 1) : nullptr;
+}
+
+__attribute__((target("avx2"))) const uint8_t* forwardAVX2(const uint8_t* h, size_t n, const uint8_t* p, size_t m) {
+    const auto first = _mm256_set1_epi8(static_cast<char>(p[0]));
+    const auto last = _mm256_set1_epi8(static_cast<char>(p[m - 1]));
+
+    size_t i = 0;
+    for ( ; i + m - 1 + 32 <= n; i += 32 ) {
+        const auto bf = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i));
+        const auto bl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i + m - 1));
+        auto mask = static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(bf, first), _mm256_cmpeq_epi8(bl, last))));
+
+        while ( mask ) {
+            auto bit = static_cast<size_t>(__builtin_ctz(mask));
+            if ( verify(h + i + bit, p, m) )
+                return h + i + bit;
+
+            mask &= mask - 1;
+        }
+    }
+
+    return forwardScalar(h, n, p, m, i);
+}
+
+__attribute__((target("avx2"))) const uint8_t* backwardAVX2(const uint8_t* h, size_t n, const uint8_t* p, size_t m) {
+    const auto first = _mm256_set1_epi8(static_cast<char>(p[0]));
+    const auto last = _mm256_set1_epi8(static_cast<char>(p[m - 1]));
+
+    size_t end = n - m + 1;
+    for ( ; end >= 32; end -= 32 ) {
+        const auto i = end - 32;
+        const auto bf = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i));
+        const auto bl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i + m - 1));
+        auto mask = static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(bf, first), _mm256_cmpeq_epi8(bl, last))));
+
+        while ( mask ) {
+            auto bit = static_cast<size_t>(31 - __builtin_clz(mask));
+            if ( verify(h + i + bit, p, m) )
+                return h + i + bit;
+
+            mask &= ~(1U << bit);
+        }
+    }
+
+    return end > 0 ? backwardScalar(h, n, p, m, end - 1) : nullptr;
+}
+
+#endif
+
+using SearchFunction = const uint8_t* (*)(const uint8_t*, size_t, const uint8_t*, size_t);
+
+struct Implementation {
+    const char* name;
+    SearchFunction forward;
+    SearchFunction backward;
+};
+
+Implementation selectImplementation() {
+#ifdef HILTI_RT_SEARCH_X86
+    __builtin_cpu_init();
+
+    if ( __builtin_cpu_supports("avx2") )
+        return {"avx2", forwardAVX2, backwardAVX2};
+
+    if ( __builtin_cpu_supports("sse2") )
+        return {"sse2", forwardSSE2, backwardSSE2};
+#endif
+
+    return {"scalar",
+            [](const uint8_t* h, size_t n, const uint8_t* p, size_t m) { return forwardScalar(h, n, p, m, 0); },
+            [](const uint8_t* h, size_t n, const uint8_t* p, size_t m) { return backwardScalar(h, n, p, m, n - m); }};
+}
+
+const Implementation& selected() {
+    static const Implementation impl = selectImplementation();
+    return impl;
+}
+
+} // namespace
+
+const uint8_t* search::forward(const uint8_t* haystack, size_t haystack_size, const uint8_t* needle,
+                               size_t needle_size) {
+    if ( needle_size == 0 )
+        return haystack;
+
+    if ( needle_size > haystack_size )
+        return nullptr;
+
+    if ( needle_size == 1 )
+        return reinterpret_cast<const uint8_t*>(memchr(haystack, needle[0], haystack_size));
+
+    return selected().forward(haystack, haystack_size, needle, needle_size);
+}
+
+const uint8_t* search::backward(const uint8_t* haystack, size_t haystack_size, const uint8_t* needle,
+                                size_t needle_size) {
+    if ( needle_size == 0 )
+        return haystack + haystack_size;
+
+    if ( needle_size > haystack_size )
+        return nullptr;
+
+    return selected().backward(haystack, haystack_size, needle, needle_size);
+}
+
+const char* search::implementation() { return selected().name; }
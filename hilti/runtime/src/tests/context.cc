@@ -4,6 +4,7 @@
 
 #include <hilti/rt/context.h>
 #include <hilti/rt/doctest.h>
+#include <hilti/rt/global-state.h>
 #include <hilti/rt/init.h>
 #include <hilti/rt/test/utils.h>
 #include <hilti/rt/threading.h>
@@ -46,6 +47,35 @@ TEST_CASE("CookieSetter") {
     CHECK_EQ(context::cookie(), nullptr);
 }
 
+static unsigned int num_init_globals = 0;
+
+static void initGlobals(Context* ctx) {
+    CHECK_EQ(context::detail::current(), ctx);
+    ++num_init_globals;
+}
+
+TEST_CASE("init globals") {
+    init(); // Noop if already initialized.
+
+    unsigned int idx = 0;
+    detail::registerModule({.name = "dynamic", .id = "dynamic", .init_globals = initGlobals, .globals_idx = &idx});
+    detail::registerModule({.name = "static", .id = "static", .init_globals = initGlobals});
+
+    num_init_globals = 0;
+    auto* previous = context::detail::current();
+
+    {
+        Context context(42);
+
+        // Modules without dynamic globals share the master's globals.
+        CHECK_EQ(num_init_globals, 1U);
+    }
+
+    CHECK_EQ(context::detail::current(), previous);
+
+    done(); // Unregister the modules again.
+}
+
 TEST_CASE("execute") {
     init(); // Noop if already initialized.
 
@@ -103,4 +103,54 @@ TEST_CASE("print") {
     CHECK_EQ(output.lines(), std::vector<std::string>({"[FOO] foo", "[BAR] bar"}));
 }
 
+TEST_CASE("stream") {
+    const auto foo = debug::Stream("FOO");
+    CHECK_EQ(foo.name(), "FOO");
+
+    // Same name maps to same ID no matter where the name is stored.
+    const auto name = std::string("FOO");
+    CHECK_EQ(debug::Stream(name).id(), foo.id());
+    CHECK_EQ(debug::Stream(std::string_view(name)).id(), foo.id());
+
+    const auto bar = debug::Stream("BAR");
+    CHECK_NE(bar.id(), foo.id());
+    CHECK_EQ(bar.name(), "BAR");
+
+    // Memory that is reused for another name resolves to the new name.
+    auto buffer = std::string("FOO");
+    CHECK_EQ(debug::Stream(std::string_view(buffer)).id(), foo.id());
+    buffer = "BAR";
+    CHECK_EQ(debug::Stream(std::string_view(buffer)).id(), bar.id());
+}
+
+TEST_CASE("many streams") {
+    auto output = TemporaryFile();
+    auto logger = detail::DebugLogger(output.path());
+
+    std::vector<std::string> names;
+    for ( int i = 0; i < 200; i++ )
+        names.emplace_back(fmt("stream-%d", i));
+
+    logger.enable(fmt("%s:%s", names[3], names[150]));
+
+    for ( const auto& n : names )
+        CHECK_EQ(logger.isEnabled(n), (n == names[3] || n == names[150]));
+
+    logger.print(names[150], "foo");
+    logger.print(names[151], "bar");
+    CHECK_EQ(output.lines(), std::vector<std::string>({"[stream-150] foo"}));
+}
+
+TEST_CASE("compiled out") {
+    CHECK_FALSE(debug::detail::isCompiledOut("FOO", ""));
+    CHECK(debug::detail::isCompiledOut("FOO", "FOO"));
+    CHECK(debug::detail::isCompiledOut("FOO", "BAR:FOO"));
+    CHECK(debug::detail::isCompiledOut("FOO", "FOO:BAR"));
+    CHECK_FALSE(debug::detail::isCompiledOut("FOO", "FOOBAR:BAR"));
+    CHECK_FALSE(debug::detail::isCompiledOut("FOO", "FO:"));
+
+    static_assert(debug::detail::isCompiledOut("spicy-verbose", "spicy:spicy-verbose"));
+    static_assert(! debug::detail::isCompiledOut("spicy", "spicy-verbose"));
+}
+
 TEST_SUITE_END();
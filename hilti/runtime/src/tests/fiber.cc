@@ -13,6 +13,7 @@
 #include <hilti/rt/init.h>
 #include <hilti/rt/logging.h>
 #include <hilti/rt/result.h>
+#include <hilti/rt/types/stream.h>
 
 class TestDtor { //NOLINT
 public:
@@ -309,6 +310,78 @@ TEST_CASE("copy-arg") {
     CHECK_EQ(std::get<1>(*args_on_heap)->data(), s2->data());
 }
 
+TEST_CASE("run-directly") {
+    hilti::rt::init();
+
+    auto total = hilti::rt::detail::Fiber::statistics().total;
+
+    SUBCASE("result") {
+        std::string c;
+
+        auto f = [&](hilti::rt::resumable::Handle* r) {
+            TestDtor t(c);
+            CHECK_EQ(r, nullptr);
+            return std::string("Hello from caller's stack!");
+        };
+
+        auto r = hilti::rt::Resumable::runDirectly(f);
+        REQUIRE(r);
+        CHECK(r.hasResult());
+        CHECK_EQ(r.get<std::string>(), "Hello from caller's stack!");
+        CHECK_EQ(c, "ctordtor");
+
+        // Executing directly must not have set up any fibers.
+        CHECK_EQ(hilti::rt::detail::Fiber::statistics().total, total);
+    }
+
+    SUBCASE("exception") {
+        auto f = [&](hilti::rt::resumable::Handle* r) -> hilti::rt::Nothing {
+            throw hilti::rt::RuntimeError("kaputt");
+        };
+
+        CHECK_THROWS_WITH_AS(hilti::rt::Resumable::runDirectly(f), "kaputt", const hilti::rt::RuntimeError&);
+    }
+
+    SUBCASE("cannot yield") {
+        auto f = [&](hilti::rt::resumable::Handle* r) {
+            hilti::rt::detail::yield();
+            return hilti::rt::Nothing();
+        };
+
+        CHECK_THROWS_WITH_AS(hilti::rt::Resumable::runDirectly(f), "'yield' in non-suspendable context",
+                             const hilti::rt::RuntimeError&);
+    }
+
+    SUBCASE("nested inside fiber") {
+        auto f = [&](hilti::rt::resumable::Handle* r) {
+            auto inner = hilti::rt::Resumable::runDirectly(
+                [&](hilti::rt::resumable::Handle* r) { return hilti::rt::Nothing(); });
+            CHECK(inner);
+
+            // Yielding the outer function still works afterwards.
+            hilti::rt::detail::yield();
+            return hilti::rt::Nothing();
+        };
+
+        auto r = hilti::rt::fiber::execute(f);
+        CHECK(! r);
+        r.resume();
+        CHECK(r);
+    }
+}
+
+TEST_CASE("input-frozen") {
+    auto s = hilti::rt::ValueReference<hilti::rt::Stream>();
+    auto x = hilti::rt::ValueReference<std::string>("string");
+
+    CHECK(hilti::rt::resumable::detail::isInputFrozen());
+    CHECK(hilti::rt::resumable::detail::isInputFrozen(x, 42));
+    CHECK_FALSE(hilti::rt::resumable::detail::isInputFrozen(s, x));
+
+    s->freeze();
+    CHECK(hilti::rt::resumable::detail::isInputFrozen(s, x));
+}
+
 void X() {}
 
 static int fibo(int i) {
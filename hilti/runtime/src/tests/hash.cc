@@ -0,0 +1,72 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <tuple>
+
+#include <hilti/rt/doctest.h>
+#include <hilti/rt/hash.h>
+#include <hilti/rt/types/address.h>
+#include <hilti/rt/types/bool.h>
+#include <hilti/rt/types/bytes.h>
+#include <hilti/rt/types/integer.h>
+#include <hilti/rt/types/interval.h>
+#include <hilti/rt/types/network.h>
+#include <hilti/rt/types/port.h>
+#include <hilti/rt/types/time.h>
+#include <hilti/rt/types/tuple.h>
+
+using namespace hilti::rt;
+using namespace hilti::rt::bytes::literals;
+
+TEST_SUITE_BEGIN("Hash");
+
+template<typename T>
+static auto hash_of(const T& x) {
+    return Hash<T>()(x);
+}
+
+TEST_CASE("atomic types") {
+    CHECK_EQ(hash_of(integer::safe<uint64_t>(42)), hash_of(integer::safe<uint64_t>(42)));
+    CHECK_EQ(hash_of(Bool(true)), hash_of(Bool(true)));
+    CHECK_EQ(hash_of("abc"_b), hash_of(Bytes("abc")));
+    CHECK_NE(hash_of("abc"_b), hash_of("abd"_b));
+    CHECK_EQ(hash_of(Port(53, Protocol::UDP)), hash_of(Port("53/udp")));
+    CHECK_NE(hash_of(Port(53, Protocol::UDP)), hash_of(Port(53, Protocol::TCP)));
+    CHECK_EQ(hash_of(Network("10.0.0.0", 8)), hash_of(Network("10.1.2.3", 8)));
+    CHECK_EQ(hash_of(Time(1, Time::SecondTag())), hash_of(Time(1, Time::SecondTag())));
+    CHECK_EQ(hash_of(Interval(1, Interval::SecondTag())), hash_of(Interval(1, Interval::SecondTag())));
+}
+
+TEST_CASE("address") {
+    // Equal addresses hash the same even if their families differ.
+    auto a = Address("1.2.3.4");
+    auto b = Address("::1.2.3.4");
+    REQUIRE_EQ(a, b);
+    CHECK_EQ(hash_of(a), hash_of(b));
+    CHECK_NE(hash_of(a), hash_of(Address("1.2.3.5")));
+}
+
+TEST_CASE("enum") {
+    CHECK_EQ(hash_of(Protocol(Protocol::TCP)), hash_of(Protocol(Protocol::TCP)));
+    CHECK_NE(hash_of(Protocol(Protocol::TCP)), hash_of(Protocol(Protocol::UDP)));
+}
+
+TEST_CASE("tuple") {
+    using T = Tuple<integer::safe<uint32_t>, Bytes>;
+
+    auto t1 = T(std::make_optional(integer::safe<uint32_t>(1)), std::make_optional("a"_b));
+    auto t2 = T(std::make_optional(integer::safe<uint32_t>(1)), std::make_optional("a"_b));
+    auto t3 = T(std::make_optional(integer::safe<uint32_t>(1)), std::make_optional("b"_b));
+    auto t4 = T(std::make_optional(integer::safe<uint32_t>(1)), std::nullopt);
+
+    CHECK_EQ(hash_of(t1), hash_of(t2));
+    CHECK_NE(hash_of(t1), hash_of(t3));
+    CHECK_NE(hash_of(t1), hash_of(t4));
+
+    // The order of elements matters.
+    CHECK_NE(hash_of(std::make_tuple(1, 2)), hash_of(std::make_tuple(2, 1)));
+}
+
+TEST_SUITE_END();
@@ -1,12 +1,15 @@
 // Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
 
 #include <memory>
+#include <sstream>
 #include <utility>
 
 #include <hilti/rt/configuration.h>
+#include <hilti/rt/context.h>
 #include <hilti/rt/doctest.h>
 #include <hilti/rt/global-state.h>
 #include <hilti/rt/hilti.h>
+#include <hilti/rt/test/utils.h>
 #include <hilti/rt/types/bytes.h>
 #include <hilti/rt/types/real.h>
 
@@ -46,6 +49,19 @@ TEST_CASE("print") {
         print(0.5, nullptr, false);
         CHECK_EQ(cout.str(), "\\x00\\x010.5");
     }
+
+    SUBCASE("w/ context stream") {
+        TestCout cout;
+        std::stringstream out;
+
+        Context context(42);
+        context.cout = &out;
+        test::TestContext _(&context);
+
+        print(0.5, nullptr, true);
+        CHECK_EQ(out.str(), "0.5\n");
+        CHECK_EQ(cout.str(), "");
+    }
 }
 
 TEST_SUITE_END();
@@ -217,4 +217,20 @@ TEST_CASE("unpack") {
              Result64(std::make_tuple(0x0102030405060708, ""_b)));
 }
 
+TEST_CASE("unchecked") {
+    const auto a = integer::safe<uint8_t>(200);
+    const auto b = integer::safe<uint8_t>(50);
+
+    CHECK_EQ(integer::sum_unchecked<uint16_t>(a, b), integer::safe<uint16_t>(250));
+    CHECK_EQ(integer::difference_unchecked<uint8_t>(a, b), integer::safe<uint8_t>(150));
+    CHECK_EQ(integer::product_unchecked<uint16_t>(a, b), integer::safe<uint16_t>(10000));
+
+    CHECK_EQ(integer::sum_unchecked<int64_t>(integer::safe<int64_t>(-5), integer::safe<int64_t>(3)),
+             integer::safe<int64_t>(-2));
+    CHECK_EQ(integer::difference_unchecked<int32_t>(integer::safe<int32_t>(-5), integer::safe<int32_t>(3)),
+             integer::safe<int32_t>(-8));
+    CHECK_EQ(integer::product_unchecked<int8_t>(integer::safe<int8_t>(-5), integer::safe<int8_t>(3)),
+             integer::safe<int8_t>(-15));
+}
+
 TEST_SUITE_END();
@@ -1,6 +1,9 @@
 // Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
 
+#include <memory>
+#include <thread>
 #include <type_traits>
+#include <vector>
 
 #include <hilti/rt/doctest.h>
 #include <hilti/rt/iterator.h>
@@ -24,4 +27,67 @@ TEST_CASE("range") {
     CHECK_EQ(unroll(range(arr)), std::vector{1, 2, 3});
 }
 
+TEST_CASE("control") {
+    struct Container {
+        iterator::detail::Control<Container> control;
+    };
+
+    auto c = std::make_unique<Container>();
+    auto r1 = c->control.ref(c.get());
+    auto r2 = r1;
+    CHECK_EQ(r1.get(), c.get());
+    CHECK_EQ(r2.get(), c.get());
+    CHECK_FALSE(iterator::detail::ControlRef<Container>());
+
+    SUBCASE("invalidate") {
+        c->control.invalidate();
+        CHECK_FALSE(r1);
+        CHECK_FALSE(r2);
+
+        // New references remain valid.
+        auto r3 = c->control.ref(c.get());
+        CHECK_EQ(r3.get(), c.get());
+    }
+
+    SUBCASE("destroy") {
+        c.reset();
+        CHECK_FALSE(r1);
+        CHECK_FALSE(r2);
+    }
+
+    SUBCASE("copy") {
+        auto c2 = std::make_unique<Container>(*c);
+        auto r3 = c2->control.ref(c2.get());
+        CHECK_EQ(r3.get(), c2.get());
+        CHECK_EQ(r1.get(), c.get());
+
+        // Assigning invalidates the target's references.
+        *c2 = *c;
+        CHECK_FALSE(r3);
+        CHECK_EQ(r1.get(), c.get());
+    }
+
+    SUBCASE("threads") {
+        // Constant containers may be iterated from multiple threads at once.
+        Container shared;
+        std::vector<std::thread> threads;
+        std::vector<int> failures(4, 0);
+
+        for ( size_t i = 0; i < failures.size(); ++i )
+            threads.emplace_back([&, i]() {
+                for ( int j = 0; j < 10000; ++j ) {
+                    auto r = shared.control.ref(&shared);
+                    auto r_ = r;
+                    if ( r_.get() != &shared )
+                        ++failures[i];
+                }
+            });
+
+        for ( auto& t : threads )
+            t.join();
+
+        CHECK_EQ(failures, std::vector<int>(failures.size(), 0));
+    }
+}
+
 TEST_SUITE_END();
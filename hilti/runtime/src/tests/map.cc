@@ -1,13 +1,17 @@
 // Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
 
 #include <string>
+#include <vector>
 
 #include <hilti/rt/doctest.h>
 #include <hilti/rt/fmt.h>
+#include <hilti/rt/types/bytes.h>
 #include <hilti/rt/types/integer.h>
 #include <hilti/rt/types/map.h>
+#include <hilti/rt/types/time.h>
 
 using namespace hilti::rt;
+using namespace hilti::rt::bytes::literals;
 
 TEST_SUITE_BEGIN("Map");
 
@@ -183,4 +187,260 @@ TEST_CASE("index_assign") {
     CHECK_THROWS_WITH_AS(*begin, "iterator is invalid", const IndexError&);
 }
 
+TEST_CASE("unordered") {
+    UnorderedMap<Bytes, integer::safe<uint64_t>> m;
+    CHECK_EQ(m.size(), 0U);
+
+    m.index_assign("a"_b, 1U);
+    m.index_assign("b"_b, 2U);
+    m.index_assign("a"_b, 3U);
+
+    CHECK_EQ(m.size(), 2U);
+    CHECK(m.contains("a"_b));
+    CHECK_FALSE(m.contains("c"_b));
+    CHECK_EQ(m.get("a"_b), 3U);
+    CHECK_EQ(m.get_optional("c"_b), std::nullopt);
+    CHECK_THROWS_WITH_AS(m.get("c"_b), "key is unset", const IndexError&);
+
+    CHECK_EQ(m, UnorderedMap<Bytes, integer::safe<uint64_t>>({{"b"_b, 2U}, {"a"_b, 3U}}));
+
+    SUBCASE("iteration") {
+        uint64_t sum = 0;
+        for ( const auto& [k, v] : m )
+            sum += v;
+
+        CHECK_EQ(sum, 5U);
+    }
+
+    SUBCASE("references remain stable") {
+        const auto& a = m.get("a"_b);
+
+        for ( uint64_t i = 0; i < 1000; i++ )
+            m.index_assign(Bytes(std::to_string(i)), i);
+
+        CHECK_EQ(a, 3U);
+    }
+
+    SUBCASE("invalidation") {
+        auto it = m.begin();
+        REQUIRE_NOTHROW(*it);
+
+        // Modifying an existing element does not invalidate iterators.
+        m.index_assign("a"_b, 4U);
+        CHECK_NOTHROW(*it);
+
+        // Inserting new elements does, as it may rehash.
+        m.index_assign("c"_b, 5U);
+        CHECK_THROWS_WITH_AS(*it, "iterator is invalid", const IndexError&);
+
+        it = m.begin();
+        CHECK_EQ(m.erase("c"_b), 1U);
+        CHECK_THROWS_WITH_AS(*it, "iterator is invalid", const IndexError&);
+    }
+
+    SUBCASE("stringification") {
+        CHECK_EQ(to_string(UnorderedMap<int, int>({{1, 11}})), "{1: 11}");
+        CHECK_EQ(to_string(UnorderedMap<int, int>({{1, 11}}).begin()), "<map iterator>");
+    }
+}
+
+TEST_CASE("expiration") {
+    auto secs = [](double x) { return Time(x, Time::SecondTag()); };
+    auto policy = expiration::Policy{Interval(10, Interval::SecondTag()), true, true, expiration::Clock::Network};
+
+    time::set_network_time(secs(100));
+
+    Map<int, int> m;
+    m.index_assign(1, 1);
+    m.setExpiration(policy);
+
+    SUBCASE("after creation") {
+        policy.refresh_on_read = false;
+        policy.refresh_on_write = false;
+        m.setExpiration(policy);
+
+        m.index_assign(2, 2);
+        time::set_network_time(secs(105));
+        m.index_assign(1, 11);
+        CHECK_EQ(m.get(1), 11);
+
+        time::set_network_time(secs(110));
+        CHECK_FALSE(m.contains(1));
+        CHECK_FALSE(m.get_optional(2));
+        CHECK_THROWS_WITH_AS(m.get(1), "key is unset", const IndexError&);
+
+        // Expired elements stay around until removed.
+        CHECK_EQ(m.numExpired(), 0U);
+        CHECK_EQ(m.expire(), 2U);
+        CHECK_EQ(m.size(), 0U);
+        CHECK_EQ(m.numExpired(), 2U);
+    }
+
+    SUBCASE("size") {
+        m.index_assign(2, 2);
+        time::set_network_time(secs(110));
+        CHECK_EQ(m.size(), 0U);
+        CHECK_EQ(m.numExpired(), 2U);
+    }
+
+    SUBCASE("iteration") {
+        time::set_network_time(secs(105));
+        m.index_assign(2, 2);
+
+        time::set_network_time(secs(110));
+        std::vector<int> keys;
+        for ( const auto& [k, v] : m )
+            keys.push_back(k);
+
+        CHECK_EQ(keys, std::vector<int>{2});
+        CHECK_EQ(m.numExpired(), 1U);
+    }
+
+    SUBCASE("enable twice") {
+        time::set_network_time(secs(105));
+        m.setExpiration(policy);
+
+        // Existing deadlines remain in place.
+        time::set_network_time(secs(110));
+        CHECK_FALSE(m.contains(1));
+    }
+
+    SUBCASE("repeated re-insert") {
+        for ( auto i = 0; i < 1000; i++ ) {
+            m.erase(1);
+            m.index_assign(1, i);
+        }
+
+        time::set_network_time(secs(109));
+        CHECK_EQ(m.expire(), 0U);
+        CHECK_EQ(m.get(1), 999);
+
+        time::set_network_time(secs(110));
+        CHECK_EQ(m.expire(), 1U);
+    }
+
+    SUBCASE("after write") {
+        policy.refresh_on_read = false;
+        m.setExpiration(policy);
+
+        time::set_network_time(secs(105));
+        CHECK_EQ(m.get(1), 1);
+        m.index_assign(2, 2);
+
+        time::set_network_time(secs(110));
+        CHECK_FALSE(m.contains(1));
+        CHECK(m.contains(2));
+
+        m.index_assign(2, 22);
+        time::set_network_time(secs(119));
+        CHECK_EQ(m.expire(), 1U);
+        CHECK_EQ(m.get(2), 22);
+
+        time::set_network_time(secs(120));
+        CHECK_EQ(m.expire(), 1U);
+        CHECK_EQ(m.size(), 0U);
+    }
+
+    SUBCASE("after access") {
+        for ( auto t = 105; t < 200; t += 5 ) {
+            time::set_network_time(secs(t));
+            CHECK_EQ(m.get(1), 1);
+            CHECK_EQ(m.expire(), 0U);
+        }
+
+        time::set_network_time(secs(300));
+        CHECK_EQ(m.expire(), 1U);
+    }
+
+    SUBCASE("re-insert after expiration") {
+        time::set_network_time(secs(110));
+        CHECK_FALSE(m.contains(1));
+
+        m.index_assign(1, 2);
+        CHECK_EQ(m.get(1), 2);
+        CHECK_EQ(m.numExpired(), 1U);
+
+        time::set_network_time(secs(115));
+        CHECK_EQ(m.expire(), 0U);
+        CHECK_EQ(m.get(1), 2);
+    }
+
+    SUBCASE("re-insert after erase") {
+        m.erase(1);
+        time::set_network_time(secs(105));
+        m.index_assign(1, 2);
+
+        time::set_network_time(secs(110));
+        CHECK_EQ(m.expire(), 0U);
+        CHECK_EQ(m.get(1), 2);
+    }
+
+    SUBCASE("removal during insertion") {
+        for ( auto i = 0; i < 100; i++ ) {
+            time::set_network_time(secs(100 + i));
+            m.index_assign(i, i);
+        }
+
+        // Only elements younger than the timeout remain.
+        CHECK_EQ(m.size(), 10U);
+        CHECK_EQ(m.numExpired(), 90U);
+    }
+
+    SUBCASE("invalidation") {
+        auto it = m.begin();
+        CHECK_EQ(m.expire(), 0U);
+        CHECK_NOTHROW(*it);
+
+        time::set_network_time(secs(110));
+        CHECK_EQ(m.expire(), 1U);
+        CHECK_THROWS_WITH_AS(*it, "iterator is invalid", const IndexError&);
+    }
+
+    SUBCASE("callback") {
+        std::vector<std::pair<int, int>> expired;
+        m.setExpirationCallback([&](const int& k, const int& v) {
+            CHECK_FALSE(m.contains(k));
+            expired.emplace_back(k, v);
+        });
+
+        m.index_assign(2, 22);
+        time::set_network_time(secs(110));
+        m.index_assign(3, 33);
+        CHECK_EQ(expired, std::vector<std::pair<int, int>>{{1, 1}, {2, 22}});
+    }
+
+    SUBCASE("copy") {
+        auto m2 = m;
+        time::set_network_time(secs(110));
+        CHECK_EQ(m.expire(), 1U);
+        CHECK_EQ(m2.numExpired(), 0U);
+        CHECK_EQ(m2.expire(), 1U);
+    }
+
+    SUBCASE("clear") {
+        m.clear();
+        time::set_network_time(secs(110));
+        CHECK_EQ(m.expire(), 0U);
+    }
+
+    SUBCASE("unordered") {
+        UnorderedMap<Bytes, int> um;
+        um.setExpiration(policy);
+        um.index_assign("a"_b, 1);
+
+        time::set_network_time(secs(110));
+        CHECK_FALSE(um.contains("a"_b));
+        um.index_assign("b"_b, 1);
+        CHECK_EQ(um.size(), 1U);
+        CHECK_EQ(um.numExpired(), 1U);
+    }
+
+    SUBCASE("callback requires expiration") {
+        Map<int, int> m2;
+        CHECK_THROWS_WITH_AS(m2.setExpirationCallback({}), "expiration is not enabled for map", const InvalidArgument&);
+    }
+
+    time::set_network_time(Time());
+}
+
 TEST_SUITE_END();
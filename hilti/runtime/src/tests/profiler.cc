@@ -3,6 +3,9 @@
 #include <unistd.h>
 
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <hilti/rt/configuration.h>
 #include <hilti/rt/doctest.h>
@@ -42,4 +45,71 @@ TEST_CASE("measurement") {
     detail::globalState()->profiling_enabled = old_profiling;
 }
 
+TEST_CASE("tag") {
+    auto t1 = profiler::tag("tag/a");
+    auto t2 = profiler::tag("tag/b");
+    CHECK_NE(t1, t2);
+    CHECK_EQ(profiler::tag("tag/a"), t1);
+    CHECK_EQ(profiler::tag(std::string("tag/") + "b"), t2);
+
+    // Tags are the same across threads.
+    profiler::Tag t3;
+    std::thread([&]() { t3 = profiler::tag("tag/a"); }).join();
+    CHECK_EQ(t3, t1);
+}
+
+TEST_CASE("move") {
+    auto old_profiling = hilti::rt::detail::globalState()->profiling_enabled;
+    detail::globalState()->profiling_enabled = true;
+
+    auto p1 = profiler::start(profiler::tag("move"));
+    REQUIRE(p1);
+    CHECK(static_cast<bool>(*p1));
+
+    auto p2 = std::move(*p1);
+    CHECK_FALSE(static_cast<bool>(*p1));
+    CHECK(static_cast<bool>(p2));
+
+    p1.reset(); // must not record anything
+    CHECK_EQ(profiler::get("move")->count, 0);
+
+    p2.record(Profiler::snapshot());
+    CHECK_FALSE(static_cast<bool>(p2));
+    CHECK_EQ(profiler::get("move")->count, 1);
+
+    detail::globalState()->profiling_enabled = old_profiling;
+}
+
+TEST_CASE("threads") {
+    auto old_profiling = hilti::rt::detail::globalState()->profiling_enabled;
+    detail::globalState()->profiling_enabled = true;
+
+    constexpr int Threads = 4;
+    constexpr int Iterations = 1000;
+
+    std::vector<std::thread> threads;
+    for ( int i = 0; i < Threads; i++ )
+        threads.emplace_back([]() {
+            auto tag = profiler::tag("threads");
+            for ( int j = 0; j < Iterations; j++ ) {
+                auto p = profiler::start(tag, 1);
+                profiler::stop(p, 2);
+            }
+        });
+
+    for ( auto& t : threads )
+        t.join();
+
+    // Measurements of all threads get aggregated, even once they have terminated.
+    auto m = profiler::get("threads");
+    REQUIRE(m);
+    CHECK_EQ(m->count, Threads * Iterations);
+    REQUIRE(m->volume);
+    CHECK_EQ(*m->volume, Threads * Iterations);
+
+    CHECK_FALSE(profiler::get("does-not-exist"));
+
+    detail::globalState()->profiling_enabled = old_profiling;
+}
+
 TEST_SUITE_END();
@@ -1,6 +1,8 @@
 // Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
 
+#include <thread>
 #include <tuple>
+#include <vector>
 
 #include <hilti/rt/doctest.h>
 #include <hilti/rt/exception.h>
@@ -199,6 +201,94 @@ TEST_CASE("binary data") {
     CHECK_GT(RegExp("\\\\xFF\\\\xFF"_p).match("\\xFF\\xFF"_b), 0);
 }
 
+TEST_CASE("prefilter") {
+    auto may_match = [](const regexp::Patterns& patterns, std::string_view data) {
+        return regexp::detail::Prefilter(patterns).mayMatch(data.data(), data.size());
+    };
+
+    auto is_enabled = [](const regexp::Patterns& patterns) { return regexp::detail::Prefilter(patterns).isEnabled(); };
+
+    SUBCASE("literal prefixes") {
+        const auto methods = regexp::Patterns({"GET"_p, "POST"_p, "PUT"_p});
+        CHECK(is_enabled(methods));
+        CHECK(may_match(methods, "GET /index.html"));
+        CHECK(may_match(methods, "P"));
+        CHECK(may_match(methods, "PO"));
+        CHECK(may_match(methods, "PUT"));
+        CHECK_FALSE(may_match(methods, "PA"));
+        CHECK_FALSE(may_match(methods, "HEAD"));
+        CHECK_FALSE(may_match(methods, "get"));
+
+        CHECK(may_match({"^abc"_p}, "abc"));
+        CHECK_FALSE(may_match({"^abc"_p}, "abd"));
+        CHECK(may_match({"ab+c"_p}, "abbbc"));
+        CHECK_FALSE(may_match({"ab+c"_p}, "ac"));
+        CHECK(may_match({"ab?c"_p}, "ac"));
+        CHECK_FALSE(may_match({"ab?c"_p}, "bc"));
+        CHECK(may_match({"ab{2}c"_p}, "abbc"));
+        CHECK_FALSE(may_match({"ab{2}c"_p}, "bc"));
+        CHECK(may_match({"\\.com"_p}, ".com"));
+        CHECK_FALSE(may_match({"\\.com"_p}, "xcom"));
+        CHECK_FALSE(may_match({"foo|bar"_p}, "baz"));
+        CHECK(may_match({"foo|bar"_p}, "bar"));
+    }
+
+    SUBCASE("first bytes") {
+        CHECK(may_match({"(GET|POST) "_p}, "GX"));
+        CHECK_FALSE(may_match({"(GET|POST) "_p}, "X"));
+        CHECK(may_match({"(a|b)?c"_p}, "c"));
+        CHECK(may_match({"(a|b)?c"_p}, "b"));
+        CHECK_FALSE(may_match({"(a|b)?c"_p}, "d"));
+        CHECK(may_match({"a{0,2}b"_p}, "b"));
+        CHECK_FALSE(may_match({"a{0,2}b"_p}, "c"));
+        CHECK(may_match({"[a-c]x"_p}, "bx"));
+        CHECK_FALSE(may_match({"[a-c]x"_p}, "dx"));
+        CHECK(may_match({"[]a]"_p}, "]"));
+        CHECK_FALSE(may_match({"[]a]"_p}, "b"));
+        CHECK(may_match({"[^a-c]"_p}, "d"));
+        CHECK_FALSE(may_match({"[^a-c]"_p}, "a"));
+        CHECK(may_match({"[0-9]+|x"_p}, "x"));
+        CHECK_FALSE(may_match({"[0-9]+|x"_p}, "y"));
+        CHECK(may_match({"\\d+|x"_p}, "y")); // escaped letters are not decoded
+    }
+
+    SUBCASE("case-insensitive") {
+        const auto patterns = regexp::Patterns({regexp::Pattern("get", true), regexp::Pattern("[x-z]A", true)});
+        CHECK(is_enabled(patterns));
+        CHECK(may_match(patterns, "GeT"));
+        CHECK(may_match(patterns, "Ya"));
+        CHECK_FALSE(may_match(patterns, "GX"));
+        CHECK_FALSE(may_match(patterns, "w"));
+    }
+
+    SUBCASE("disabled") {
+        CHECK_FALSE(is_enabled({}));
+        CHECK_FALSE(is_enabled({""_p}));
+        CHECK_FALSE(is_enabled({"a*"_p}));
+        CHECK_FALSE(is_enabled({"a|"_p}));
+        CHECK_FALSE(is_enabled({"abc"_p, "x?"_p}));
+        CHECK_FALSE(is_enabled({"(a|b)*"_p}));
+        CHECK_FALSE(is_enabled({".*abc"_p}));
+        CHECK_FALSE(is_enabled({"[[:alpha:]]+"_p}));
+        CHECK_FALSE(is_enabled({"[ \\t]+"_p}));
+        CHECK_FALSE(is_enabled({"(?i)abc"_p}));
+        CHECK_FALSE(is_enabled({"a{x}"_p}));
+        CHECK_FALSE(is_enabled({"(abc"_p}));
+        CHECK_FALSE(is_enabled({"abc)"_p}));
+        CHECK_FALSE(is_enabled({"*abc"_p}));
+
+        CHECK(may_match({"a*"_p}, "x"));
+    }
+
+    SUBCASE("rejecting input") {
+        const auto re = RegExp({"GET"_p, "POST"_p});
+        CHECK_EQ(re.match("HEAD"_b), 0);
+        CHECK_EQ(re.tokenMatcher().advance("HEAD"_b, false), std::make_tuple(0, 0));
+        CHECK_EQ(tuple::get<0>(re.tokenMatcher().advance(Stream("PUT"_b).view())), 0);
+        CHECK_EQ(re.find("HEAD PUT"_b), std::make_tuple(-1, ""_b));
+    }
+}
+
 TEST_SUITE_END();
 
 TEST_SUITE_BEGIN("MatchState");
@@ -458,3 +548,43 @@ TEST_CASE("caching") {
     CHECK_NE(re1a.jrx(), re3.jrx());
     CHECK_NE(re1a.jrx(), re4.jrx());
 }
+
+TEST_CASE("caching statistics") {
+    const auto before = regexp::cacheStatistics();
+
+    const auto re1a = RegExp("statistics-1"_p);
+    const auto re1b = RegExp("statistics-1"_p);
+    const auto re2 = RegExp("statistics-1"_p, {.use_std = true});
+    const auto re3 = RegExp(regexp::Pattern("statistics-1", true));
+
+    const auto after = regexp::cacheStatistics();
+    CHECK_EQ(after.misses - before.misses, 3U);
+    CHECK_EQ(after.hits - before.hits, 1U);
+    CHECK_EQ(after.size - before.size, 3U);
+
+    // Failed compilations do not get cached.
+    CHECK_THROWS_AS(RegExp("(xxx"_p), const PatternError&);
+    CHECK_EQ(regexp::cacheStatistics().size, after.size);
+}
+
+TEST_CASE("caching across threads") {
+    constexpr auto NumThreads = 8;
+    constexpr auto NumPatterns = 32;
+
+    std::vector<std::vector<const jrx_regex_t*>> results(NumThreads);
+    std::vector<std::thread> threads;
+
+    for ( auto t = 0; t < NumThreads; ++t ) {
+        threads.emplace_back([t, &results]() {
+            for ( auto i = 0; i < NumPatterns; ++i )
+                results[t].push_back(RegExp(regexp::Pattern(fmt("threads-%d", i))).jrx());
+        });
+    }
+
+    for ( auto& t : threads )
+        t.join();
+
+    // All threads must have ended up with the same compiled expressions.
+    for ( auto t = 1; t < NumThreads; ++t )
+        CHECK_EQ(results[t], results[0]);
+}
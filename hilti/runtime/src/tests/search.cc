@@ -0,0 +1,93 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include <hilti/rt/doctest.h>
+#include <hilti/rt/search.h>
+
+using namespace hilti::rt;
+
+TEST_SUITE_BEGIN("search");
+
+namespace {
+// Wrappers returning the position of a match inside the haystack, or `npos`.
+size_t forward(std::string_view haystack, std::string_view needle) {
+    const auto* h = reinterpret_cast<const uint8_t*>(haystack.data());
+    const auto* x = search::forward(h, haystack.size(), reinterpret_cast<const uint8_t*>(needle.data()), needle.size());
+    return x ? static_cast<size_t>(x - h) : std::string_view::npos;
+}
+
+size_t backward(std::string_view haystack, std::string_view needle) {
+    const auto* h = reinterpret_cast<const uint8_t*>(haystack.data());
+    const auto* x =
+        search::backward(h, haystack.size(), reinterpret_cast<const uint8_t*>(needle.data()), needle.size());
+    return x ? static_cast<size_t>(x - h) : std::string_view::npos;
+}
+} // namespace
+
+TEST_CASE("implementation") { CHECK_NE(std::string(search::implementation()), ""); }
+
+TEST_CASE("forward") {
+    CHECK_EQ(forward("", ""), 0U);
+    CHECK_EQ(forward("abc", ""), 0U);
+    CHECK_EQ(forward("", "a"), std::string_view::npos);
+    CHECK_EQ(forward("ab", "abc"), std::string_view::npos);
+    CHECK_EQ(forward("abc", "c"), 2U);
+    CHECK_EQ(forward("abcabc", "bc"), 1U);
+    CHECK_EQ(forward("abcabc", "abd"), std::string_view::npos);
+
+    auto long_ = std::string(100, 'x') + "needle" + std::string(100, 'x') + "needle";
+    CHECK_EQ(forward(long_, "needle"), 100U);
+    CHECK_EQ(forward(long_, "needlex"), 100U);
+    CHECK_EQ(forward(long_, "xneedle"), 99U);
+    CHECK_EQ(forward(long_, "needles"), std::string_view::npos);
+}
+
+TEST_CASE("backward") {
+    CHECK_EQ(backward("", ""), 0U);
+    CHECK_EQ(backward("abc", ""), 3U);
+    CHECK_EQ(backward("", "a"), std::string_view::npos);
+    CHECK_EQ(backward("ab", "abc"), std::string_view::npos);
+    CHECK_EQ(backward("abc", "a"), 0U);
+    CHECK_EQ(backward("abcabc", "bc"), 4U);
+    CHECK_EQ(backward("abcabc", "abd"), std::string_view::npos);
+
+    auto long_ = std::string("needle") + std::string(100, 'x') + "needle" + std::string(100, 'x');
+    CHECK_EQ(backward(long_, "needle"), 106U);
+    CHECK_EQ(backward(long_, "needlex"), 106U);
+    CHECK_EQ(backward(long_, "xneedle"), 105U);
+    CHECK_EQ(backward(long_, "needles"), std::string_view::npos);
+}
+
+TEST_CASE("randomized") {
+    // Compare against `std::string_view` across sizes that exercise both the
+    // vectorized blocks and the scalar remainders.
+    std::mt19937 rng(42); // NOLINT(cert-msc51-cpp)
+    std::uniform_int_distribution<int> byte('a', 'c');
+
+    for ( auto n = 0; n < 200; n += 3 ) {
+        for ( auto m = 1; m < 40 && m <= n + 1; m += 2 ) {
+            std::string haystack;
+            std::string needle;
+
+            for ( auto i = 0; i < n; i++ )
+                haystack.push_back(static_cast<char>(byte(rng)));
+
+            if ( m <= n && rng() % 2 )
+                // Pick a needle that's guaranteed to be found.
+                needle = haystack.substr(rng() % (n - m + 1), m);
+            else {
+                for ( auto i = 0; i < m; i++ )
+                    needle.push_back(static_cast<char>(byte(rng)));
+            }
+
+            CHECK_EQ(forward(haystack, needle), std::string_view(haystack).find(needle));
+            CHECK_EQ(backward(haystack, needle), std::string_view(haystack).rfind(needle));
+        }
+    }
+}
+
+TEST_SUITE_END();
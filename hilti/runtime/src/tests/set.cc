@@ -1,8 +1,13 @@
 // Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
 
+#include <type_traits>
+#include <vector>
+
 #include <hilti/rt/doctest.h>
 #include <hilti/rt/types/integer.h>
+#include <hilti/rt/types/port.h>
 #include <hilti/rt/types/set.h>
+#include <hilti/rt/types/time.h>
 #include <hilti/rt/types/vector.h>
 
 using namespace hilti::rt;
@@ -89,6 +94,10 @@ TEST_CASE("erase") {
     CHECK_THROWS_WITH_AS(++it2, "iterator is invalid", const IndexError&);
     CHECK_THROWS_WITH_AS(it2++, "iterator is invalid", const IndexError&);
     CHECK_THROWS_WITH_AS(*it2, "iterator is invalid", const IndexError&);
+
+    // New iterators are valid again.
+    CHECK_EQ(*s.begin(), 2);
+    CHECK_EQ(++(++s.begin()), s.end());
 }
 
 TEST_CASE("clear") {
@@ -139,4 +148,166 @@ TEST_CASE("iterator") {
     CHECK_THROWS_WITH_AS(*it, "iterator is invalid", const IndexError&);
 }
 
+TEST_CASE("unordered") {
+    UnorderedSet<Port> s({Port(53, Protocol::UDP), Port(53, Protocol::TCP)});
+
+    CHECK_EQ(s.size(), 2U);
+    CHECK(s.contains(Port(53, Protocol::UDP)));
+    CHECK_FALSE(s.contains(Port(80, Protocol::TCP)));
+    CHECK_EQ(s, UnorderedSet<Port>({Port(53, Protocol::TCP), Port(53, Protocol::UDP)}));
+    CHECK_NE(s, set::Empty());
+
+    SUBCASE("insert") {
+        auto it = s.begin();
+
+        // Inserting an existing element does not rehash.
+        CHECK_FALSE(s.insert(Port(53, Protocol::UDP)).second);
+        CHECK_NOTHROW(*it);
+
+        // Growing the set eventually rehashes, which invalidates iterators.
+        for ( uint16_t i = 0; i < 1000; i++ )
+            s.insert(Port(i, Protocol::TCP));
+
+        CHECK_EQ(s.size(), 1001U);
+        CHECK_THROWS_WITH_AS(*it, "iterator is invalid", const IndexError&);
+    }
+
+    SUBCASE("erase") {
+        auto it = s.begin();
+        CHECK_EQ(s.erase(Port(53, Protocol::UDP)), 1U);
+        CHECK_THROWS_WITH_AS(*it, "iterator is invalid", const IndexError&);
+    }
+
+    SUBCASE("transform") {
+        auto t = transform(s, [](const Port& p) { return p.protocol(); });
+        static_assert(std::is_same_v<decltype(t), UnorderedSet<Protocol>>);
+        CHECK_EQ(t.size(), 2U);
+    }
+}
+
+TEST_CASE("expiration") {
+    auto secs = [](double x) { return Time(x, Time::SecondTag()); };
+    auto policy = expiration::Policy{Interval(10, Interval::SecondTag()), true, true, expiration::Clock::Network};
+
+    time::set_network_time(secs(100));
+
+    Set<int> s({1});
+    s.setExpiration(policy);
+
+    SUBCASE("after creation") {
+        policy.refresh_on_read = false;
+        policy.refresh_on_write = false;
+        s.setExpiration(policy);
+
+        time::set_network_time(secs(105));
+        CHECK(s.contains(1));
+        s.insert(1);
+
+        time::set_network_time(secs(110));
+        CHECK_FALSE(s.contains(1));
+        CHECK_EQ(s.expire(), 1U);
+        CHECK_EQ(s.size(), 0U);
+        CHECK_EQ(s.numExpired(), 1U);
+    }
+
+    SUBCASE("size and iteration") {
+        time::set_network_time(secs(105));
+        s.insert(2);
+
+        time::set_network_time(secs(110));
+        CHECK_EQ(s.size(), 1U);
+        CHECK_EQ(s.numExpired(), 1U);
+
+        std::vector<int> elems;
+        for ( const auto& x : s )
+            elems.push_back(x);
+
+        CHECK_EQ(elems, std::vector<int>{2});
+
+        time::set_network_time(secs(115));
+        CHECK(s.empty());
+        CHECK(s.begin() == s.end());
+    }
+
+    SUBCASE("enable twice") {
+        time::set_network_time(secs(105));
+        s.setExpiration(policy);
+
+        // Existing deadlines remain in place.
+        time::set_network_time(secs(110));
+        CHECK_FALSE(s.contains(1));
+    }
+
+    SUBCASE("after write") {
+        policy.refresh_on_read = false;
+        s.setExpiration(policy);
+
+        time::set_network_time(secs(105));
+        CHECK(s.contains(1));
+        time::set_network_time(secs(110));
+        CHECK_FALSE(s.contains(1));
+
+        // Inserting an expired element replaces it.
+        s.insert(1);
+        CHECK(s.contains(1));
+        CHECK_EQ(s.numExpired(), 1U);
+
+        time::set_network_time(secs(119));
+        s.insert(1);
+        time::set_network_time(secs(120));
+        CHECK(s.contains(1));
+    }
+
+    SUBCASE("after access") {
+        for ( auto t = 105; t < 200; t += 5 ) {
+            time::set_network_time(secs(t));
+            CHECK(s.contains(1));
+            CHECK_EQ(s.expire(), 0U);
+        }
+
+        time::set_network_time(secs(300));
+        CHECK_EQ(s.expire(), 1U);
+    }
+
+    SUBCASE("removal during insertion") {
+        for ( auto i = 0; i < 100; i++ ) {
+            time::set_network_time(secs(100 + i));
+            s.insert(s.begin(), i);
+        }
+
+        CHECK_EQ(s.size(), 10U);
+        CHECK_EQ(s.numExpired(), 90U);
+    }
+
+    SUBCASE("invalidation") {
+        auto it = s.begin();
+        time::set_network_time(secs(110));
+        CHECK_EQ(s.expire(), 1U);
+        CHECK_THROWS_WITH_AS(*it, "iterator is invalid", const IndexError&);
+    }
+
+    SUBCASE("callback") {
+        std::vector<int> expired;
+        s.setExpirationCallback([&](const int& x) { expired.push_back(x); });
+
+        s.insert(2);
+        time::set_network_time(secs(110));
+        s.insert(3);
+        CHECK_EQ(expired, std::vector<int>{1, 2});
+    }
+
+    SUBCASE("unordered") {
+        UnorderedSet<Port> us;
+        us.setExpiration(policy);
+        us.insert(Port(80, Protocol::TCP));
+
+        time::set_network_time(secs(110));
+        us.insert(Port(53, Protocol::UDP));
+        CHECK_EQ(us.size(), 1U);
+        CHECK_EQ(us.numExpired(), 1U);
+    }
+
+    time::set_network_time(Time());
+}
+
 TEST_SUITE_END();
@@ -285,6 +285,62 @@ TEST_CASE("append") {
         CHECK_EQ(s.statistics().num_data_bytes, 6);
         CHECK_EQ(s.statistics().num_data_chunks, 2);
     }
+
+    SUBCASE("shared Bytes") {
+        s.append(std::make_shared<const Bytes>(empty));
+        CHECK_EQ(s, "123"_b);
+        CHECK_EQ(s.size(), 3);
+        CHECK_EQ(s.numberOfChunks(), 1);
+
+        s.append(std::make_shared<const Bytes>(xs));
+        CHECK_EQ(s, "123456"_b);
+        CHECK_EQ(s.size(), 6);
+        CHECK_EQ(s.numberOfChunks(), 2);
+
+        s.freeze();
+        CHECK_NOTHROW(s.append(std::make_shared<const Bytes>(empty)));
+        CHECK_THROWS_WITH_AS(s.append(std::make_shared<const Bytes>(xs)), "stream object can no longer be modified",
+                             const Frozen&);
+
+        CHECK_EQ(s.statistics().num_data_bytes, 6);
+        CHECK_EQ(s.statistics().num_data_chunks, 2);
+    }
+}
+
+TEST_CASE("append shared") {
+    auto data = std::make_shared<const Bytes>("456"_b);
+    const auto* raw = reinterpret_cast<const stream::Byte*>(data->data());
+
+    auto s1 = Stream("123"_b);
+    auto s2 = Stream();
+    s1.append(data);
+    s2.append(data);
+    CHECK_EQ(data.use_count(), 3);
+
+    // Both streams reference the same data without copying it.
+    CHECK_EQ(s1.view().sub(3, 6).firstBlock()->start, raw);
+    CHECK_EQ(s2.view().firstBlock()->start, raw);
+
+    // The data remains valid after the original reference is gone.
+    data.reset();
+    CHECK_EQ(s1, "123456"_b);
+    CHECK_EQ(s2, "456"_b);
+
+    // Appending further data keeps sharing the already appended chunk.
+    s2.append("789"_b);
+    CHECK_EQ(s2.view().firstBlock()->start, raw);
+    CHECK_EQ(s2, "456789"_b);
+
+    // Copies of a stream share the data as well.
+    auto s3 = s2;
+    CHECK_EQ(s3.view().firstBlock()->start, raw);
+
+    // Trimming releases the reference.
+    s1.trim(s1.at(6));
+    s2.trim(s2.at(3));
+    CHECK_EQ(s3, "456789"_b);
+    CHECK_EQ(s1.size(), 0);
+    CHECK_EQ(s2, "789"_b);
 }
 
 TEST_CASE("iteration") {
@@ -814,6 +870,50 @@ TEST_CASE("Trim empty") {
     CHECK_EQ(x.numberOfChunks(), 0);
 }
 
+TEST_CASE("Random access with many chunks") {
+    Stream x;
+    std::string data;
+
+    for ( auto i = 0; i < 1000; ++i ) {
+        auto chunk = std::string(1 + i % 7, static_cast<char>('a' + i % 26));
+        x.append(Bytes(chunk));
+        data += chunk;
+    }
+
+    REQUIRE_EQ(x.numberOfChunks(), 1000);
+    REQUIRE_EQ(x.size(), data.size());
+
+    SUBCASE("at") {
+        for ( auto i = 0U; i < data.size(); i += 13 )
+            CHECK_EQ(*x.at(i), static_cast<Byte>(data[i]));
+    }
+
+    SUBCASE("decrement") {
+        auto i = x.end();
+        for ( auto j = data.size(); j > 0; --j )
+            CHECK_EQ(*--i, static_cast<Byte>(data[j - 1]));
+    }
+
+    SUBCASE("backwards jumps") {
+        auto i = x.end() - 1;
+        for ( auto j = data.size() - 1; j >= 97; j -= 97 ) {
+            CHECK_EQ(*i, static_cast<Byte>(data[j]));
+            i -= 97;
+        }
+    }
+
+    SUBCASE("trim") {
+        x.trim(x.at(2000));
+        x.append("XYZ"_b);
+
+        for ( auto i = 2000U; i < data.size(); i += 3 )
+            CHECK_EQ(*x.at(i), static_cast<Byte>(data[i]));
+
+        CHECK_EQ(*x.at(data.size() + 1), 'Y');
+        CHECK_THROWS_AS(*x.at(1000), InvalidIterator);
+    }
+}
+
 TEST_CASE("Block iteration") {
     auto content = [](auto b, auto s) -> bool { return memcmp(b->start, s, strlen(s)) == 0; };
 
@@ -1501,6 +1601,68 @@ TEST_CASE("View") {
             CHECK_EQ(std::get<1>(x), v.at(21));
         }
     }
+
+    SUBCASE("find - across chunks") {
+        // Long enough for vectorized search inside chunks, with matches straddling chunk boundaries.
+        auto data = std::string(40, 'x') + "needle" + std::string(40, 'x') + "needle" + std::string(40, 'x');
+
+        for ( auto chunk_size : {1, 3, 7, 43, 1000} ) {
+            CAPTURE(chunk_size);
+
+            Stream s;
+            for ( auto i = 0U; i < data.size(); i += chunk_size )
+                s.append(Bytes(data.substr(i, chunk_size)));
+
+            auto v = s.view();
+
+            auto x = v.find("needle"_b);
+            CHECK_EQ(std::get<0>(x), true);
+            CHECK_EQ(std::get<1>(x), v.at(40));
+
+            x = v.find("needle"_b, v.at(41));
+            CHECK_EQ(std::get<0>(x), true);
+            CHECK_EQ(std::get<1>(x), v.at(86));
+
+            x = v.find("needle"_b, hilti::rt::stream::Direction::Backward);
+            CHECK_EQ(std::get<0>(x), true);
+            CHECK_EQ(std::get<1>(x), v.at(86));
+
+            x = v.find("needle"_b, v.at(90), hilti::rt::stream::Direction::Backward);
+            CHECK_EQ(std::get<0>(x), true);
+            CHECK_EQ(std::get<1>(x), v.at(40));
+
+            x = v.find("needles"_b);
+            CHECK_EQ(std::get<0>(x), false);
+            CHECK_EQ(std::get<1>(x), v.end());
+
+            // Partial match at the end of the view.
+            auto w = v.sub(v.at(43));
+            x = w.find("needle"_b, w.at(38));
+            CHECK_EQ(std::get<0>(x), false);
+            CHECK_EQ(std::get<1>(x), w.at(40));
+
+            CHECK_EQ(v.find('n'), v.at(40));
+            CHECK_EQ(v.find('n', v.at(41)), v.at(86));
+            CHECK_EQ(v.find('Z'), v.end());
+        }
+    }
+
+    SUBCASE("find - gaps") {
+        Stream s;
+        s.append("0123456789"_b);
+        s.append(nullptr, 5);
+        s.append("abcdef"_b);
+
+        auto v = s.view();
+
+        CHECK_EQ(std::get<1>(v.find("234"_b)), v.at(2));
+        CHECK_EQ(v.find('5'), v.at(5));
+        CHECK_THROWS_AS(v.find("abc"_b), MissingData);
+        CHECK_THROWS_AS(v.find('a'), MissingData);
+        CHECK_EQ(std::get<1>(v.find("bcd"_b, v.at(15))), v.at(16));
+        CHECK_EQ(std::get<1>(v.find("bcd"_b, hilti::rt::stream::Direction::Backward)), v.at(16));
+        CHECK_THROWS_AS(v.find("234"_b, hilti::rt::stream::Direction::Backward), MissingData);
+    }
 }
 
 TEST_SUITE_END();
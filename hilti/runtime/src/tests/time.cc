@@ -36,6 +36,15 @@ TEST_CASE("mktime") {
 
 TEST_SUITE_BEGIN("Time");
 
+TEST_CASE("network_time") {
+    CHECK_EQ(time::network_time(), Time());
+
+    time::set_network_time(Time(42, Time::SecondTag()));
+    CHECK_EQ(time::network_time(), Time(42, Time::SecondTag()));
+
+    time::set_network_time(Time());
+}
+
 TEST_CASE("comparisons") {
     const auto t0 = Time(0, Time::NanosecondTag{});
     const auto t1 = Time(1, Time::NanosecondTag{});
@@ -100,6 +100,24 @@ TEST_CASE("traverse structs") {
     CHECK(xi == x.end());
 }
 
+TEST_CASE("access struct field") {
+    auto sx = StrongReference<Test::X>({42, "foo", Test::Y{true, 3.14}});
+    auto p = type_info::value::Parent(sx);
+    auto v = type_info::Value(&*sx, &__hlt::type_info::__ti_Test_X, p);
+
+    const auto* x = type_info::value::auxType<type_info::Struct>(v);
+    const auto fields = x->fields();
+    REQUIRE_EQ(fields.size(), 3);
+
+    auto s = x->value(v, fields[1]);
+    CHECK_EQ(type_info::value::auxType<type_info::String>(s)->get(s), "foo");
+
+    auto y = x->value(v, fields[2]);
+    const auto* y_ = type_info::value::auxType<type_info::Struct>(y);
+    auto r = y_->value(y, y_->fields()[1]);
+    CHECK_EQ(type_info::value::auxType<type_info::Real>(r)->get(r), 3.14);
+}
+
 TEST_CASE("life-time") {
     // Check that we catch when values become inaccessible because of the
     // associated parent going away.
@@ -176,4 +194,59 @@ TEST_CASE("anonymous fields") {
     CHECK(s->fields()[0].get().isAnonymous());
 }
 
+TEST_CASE("for each element") {
+    using Int = integer::safe<int32_t>;
+
+    SUBCASE("vector") {
+        const TypeInfo ti = {"V", "V", nullptr,
+                             new type_info::Vector(&type_info::int32, type_info::Vector::accessor<Int>())};
+
+        auto x = StrongReference<Vector<Int>>(Vector<Int>({1, 2, 3}));
+        auto p = type_info::value::Parent(x);
+        auto v = type_info::Value(&*x, &ti, p);
+
+        std::vector<int32_t> elements;
+        auto collect = [&](const type_info::Value& e) { elements.push_back(e.type().signed_integer_int32->get(e)); };
+
+        ti.vector->forEach(v, collect);
+        CHECK_EQ(elements, std::vector<int32_t>({1, 2, 3}));
+
+        x->clear();
+        elements.clear();
+        ti.vector->forEach(v, collect);
+        CHECK(elements.empty());
+    }
+
+    SUBCASE("set") {
+        const TypeInfo ti = {"S", "S", nullptr, new type_info::Set(&type_info::int32, type_info::Set::accessor<Int>())};
+
+        auto x = StrongReference<Set<Int>>(Set<Int>({3, 1, 2}));
+        auto p = type_info::value::Parent(x);
+        auto v = type_info::Value(&*x, &ti, p);
+
+        std::vector<int32_t> elements;
+        auto collect = [&](const type_info::Value& e) { elements.push_back(e.type().signed_integer_int32->get(e)); };
+
+        ti.set->forEach(v, collect);
+        CHECK_EQ(elements, std::vector<int32_t>({1, 2, 3}));
+    }
+
+    SUBCASE("map") {
+        const TypeInfo ti = {"M", "M", nullptr,
+                             new type_info::Map(&type_info::int32, &type_info::string,
+                                                type_info::Map::accessor<Int, std::string>())};
+
+        auto x = StrongReference<Map<Int, std::string>>(Map<Int, std::string>({{2, "b"}, {1, "a"}}));
+        auto p = type_info::value::Parent(x);
+        auto v = type_info::Value(&*x, &ti, p);
+
+        std::vector<std::pair<int32_t, std::string>> elements;
+        ti.map->forEach(v, [&](const type_info::Value& key, const type_info::Value& value) {
+            elements.emplace_back(key.type().signed_integer_int32->get(key), value.type().string->get(value));
+        });
+
+        CHECK_EQ(elements, std::vector<std::pair<int32_t, std::string>>({{1, "a"}, {2, "b"}}));
+    }
+}
+
 TEST_SUITE_END();
@@ -9,6 +9,7 @@
 #include <string_view>
 #include <utility>
 
+#include <hilti/rt/search.h>
 #include <hilti/rt/types/bytes.h>
 #include <hilti/rt/types/integer.h>
 #include <hilti/rt/types/regexp.h>
@@ -79,30 +80,29 @@ Tuple<bool, Bytes::const_iterator> Bytes::find(const Bytes& needle, const const_
     if ( needle.isEmpty() )
         return {true, start ? start : b};
 
-    auto bv = needle.unsafeBegin();
-    auto first = *bv;
+    const auto& s = str();
+    size_t first = start ? static_cast<size_t>(start - b) : 0;
 
-    for ( auto i = const_iterator(start ? start : b); true; ++i ) {
-        if ( i == end() )
-            return {false, i};
+    if ( first >= s.size() )
+        return {false, start ? start : b};
 
-        if ( *i != first )
-            continue;
+    const auto* haystack = reinterpret_cast<const uint8_t*>(s.data()) + first;
+    const auto* n = reinterpret_cast<const uint8_t*>(needle.data());
+    const auto haystack_size = s.size() - first;
+    const auto needle_size = needle.str().size();
 
-        auto x = i;
-        auto y = bv;
+    if ( const auto* x = search::forward(haystack, haystack_size, n, needle_size) )
+        return {true, b + (first + (x - haystack))};
 
-        for ( ;; ) {
-            if ( x == end() )
-                return {false, i};
-
-            if ( *x++ != *y++ )
-                break;
-
-            if ( y == needle.unsafeEnd() )
-                return {true, i};
-        }
+    // Not found; locate the earliest position where the remaining data is
+    // a prefix of the needle.
+    auto i = (haystack_size >= needle_size ? haystack_size - needle_size + 1 : 0);
+    for ( ; i < haystack_size; ++i ) {
+        if ( memcmp(haystack + i, n, haystack_size - i) == 0 )
+            break;
     }
+
+    return {false, b + (first + i)};
 }
 
 std::string Bytes::decode(unicode::Charset cs, unicode::DecodeErrorStrategy errors) const try {
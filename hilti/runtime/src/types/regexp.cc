@@ -3,6 +3,10 @@
 // Note: We don't run clang-tidy on this file. The use of the JRX's C
 // interface triggers all kinds of warnings.
 
+#include <algorithm>
+#include <cctype>
+#include <optional>
+#include <string_view>
 #include <utility>
 
 #include <hilti/rt/global-state.h>
@@ -149,6 +153,16 @@ std::pair<int32_t, int64_t> regexp::MatchState::_advance(const stream::View& dat
         return std::make_pair(is_final ? _pimpl->_acc : -1, 0);
     }
 
+    if ( first & JRX_ASSERTION_BOD ) {
+        // Starting a new match, see if we can rule it out upfront.
+        const auto& prefilter = _pimpl->_re->prefilter();
+        auto block = data.firstBlock();
+
+        if ( block && block->size > 0 &&
+             ! prefilter.mayMatch(reinterpret_cast<const char*>(block->start), block->size) )
+            return std::make_pair(0, 0);
+    }
+
     jrx_accept_id rc = 0;
     auto use_std_matcher = _use_std_matcher(_pimpl->_re->jrx(), &_pimpl->_ms);
     auto start_ms_offset = _pimpl->_ms.offset;
@@ -220,6 +234,348 @@ regexp::Captures regexp::MatchState::captures(const stream::View& data) const {
     return captures;
 }
 
+namespace {
+// Conservative syntax analysis of a pattern for the prefilter. Each parsing
+// method consumes one syntactic level, returning the bytes a match of it may
+// start with, and whether it may match the empty string. Whenever unsure, we
+// err on the side of more bytes. Syntax we do not understand at all throws
+// `Unsupported`, which disables the prefilter.
+class PatternAnalyzer {
+public:
+    struct Result {
+        std::bitset<256> first;
+        bool nullable = true;
+    };
+
+    struct Unsupported {};
+
+    PatternAnalyzer(std::string_view pattern) : _p(pattern) {}
+
+    // Returns the pattern's top-level alternatives along with their analysis.
+    std::vector<std::pair<std::string_view, Result>> branches() {
+        std::vector<std::pair<std::string_view, Result>> branches;
+
+        while ( true ) {
+            auto start = _pos;
+            auto r = sequence();
+            branches.emplace_back(_p.substr(start, _pos - start), r);
+
+            if ( _pos == _p.size() )
+                return branches;
+
+            if ( _p[_pos] != '|' )
+                throw Unsupported(); // unbalanced parenthesis
+
+            ++_pos;
+        }
+    }
+
+private:
+    static Result any() {
+        Result r;
+        r.first.set();
+        r.nullable = false;
+        return r;
+    }
+
+    static Result byte(unsigned char c) {
+        Result r;
+        r.first.set(c);
+        r.nullable = false;
+        return r;
+    }
+
+    std::optional<char> peek(size_t ahead = 0) const {
+        if ( _pos + ahead < _p.size() )
+            return _p[_pos + ahead];
+        else
+            return {};
+    }
+
+    Result alternation() {
+        auto r = sequence();
+
+        while ( peek() == '|' ) {
+            ++_pos;
+            auto s = sequence();
+            r.first |= s.first;
+            r.nullable = r.nullable || s.nullable;
+        }
+
+        return r;
+    }
+
+    Result sequence() {
+        Result r;
+
+        while ( _pos < _p.size() && _p[_pos] != '|' && _p[_pos] != ')' ) {
+            auto a = quantified();
+
+            if ( r.nullable )
+                r.first |= a.first;
+
+            r.nullable = r.nullable && a.nullable;
+        }
+
+        return r;
+    }
+
+    Result quantified() {
+        auto r = atom();
+
+        while ( auto c = peek() ) {
+            if ( *c == '*' || *c == '?' ) {
+                r.nullable = true;
+                ++_pos;
+            }
+            else if ( *c == '+' )
+                ++_pos;
+            else if ( *c == '{' ) {
+                if ( minRepetitions() == 0 )
+                    r.nullable = true;
+            }
+            else
+                break;
+        }
+
+        return r;
+    }
+
+    // Parses a `{n}`, `{n,}`, or `{n,m}` quantifier, returning `n`.
+    uint64_t minRepetitions() {
+        auto close = _p.find('}', _pos);
+        if ( close == std::string_view::npos )
+            throw Unsupported();
+
+        auto bounds = _p.substr(_pos + 1, close - _pos - 1);
+        if ( bounds.empty() || ! std::isdigit(static_cast<unsigned char>(bounds[0])) ||
+             bounds.find_first_not_of("0123456789,") != std::string_view::npos )
+            throw Unsupported();
+
+        uint64_t n = 0;
+        for ( auto i = 0U; i < bounds.size() && bounds[i] != ',' && n < 1000; i++ )
+            n = n * 10 + (bounds[i] - '0');
+
+        _pos = close + 1;
+        return n;
+    }
+
+    Result atom() {
+        auto c = _p[_pos++];
+
+        switch ( c ) {
+            case '(': {
+                if ( peek() == '?' )
+                    throw Unsupported();
+
+                auto r = alternation();
+                if ( peek() != ')' )
+                    throw Unsupported();
+
+                ++_pos;
+                return r;
+            }
+
+            case '[': return bracket();
+
+            case '.': return any();
+
+            case '^':
+            case '$': return Result(); // assertions, not consuming anything
+
+            case '\\': {
+                auto e = peek();
+                if ( ! e )
+                    throw Unsupported();
+
+                ++_pos;
+
+                // Escaped letters and digits may denote classes, assertions,
+                // or encoded bytes; we don't try to decode those.
+                if ( std::isalnum(static_cast<unsigned char>(*e)) )
+                    return any();
+
+                return byte(*e);
+            }
+
+            case '*':
+            case '+':
+            case '?':
+            case '{': throw Unsupported(); // quantifier without expression
+
+            default: return byte(c);
+        }
+    }
+
+    Result bracket() {
+        std::bitset<256> set;
+        bool negate = false;
+        bool unsure = false;
+
+        if ( peek() == '^' ) {
+            negate = true;
+            ++_pos;
+        }
+
+        for ( bool leading = true;; leading = false ) {
+            auto c = peek();
+            if ( ! c )
+                throw Unsupported();
+
+            if ( *c == ']' && ! leading ) {
+                ++_pos;
+                break;
+            }
+
+            if ( *c == '[' && peek(1) && (*peek(1) == ':' || *peek(1) == '=' || *peek(1) == '.') ) {
+                // Character class, equivalence class, or collating symbol.
+                auto close = _p.find(std::string{*peek(1), ']'}, _pos + 2);
+                if ( close == std::string_view::npos )
+                    throw Unsupported();
+
+                unsure = true;
+                _pos = close + 2;
+                continue;
+            }
+
+            if ( *c == '\\' ) {
+                unsure = true;
+                _pos += 2;
+                continue;
+            }
+
+            auto lo = static_cast<unsigned char>(*c);
+            ++_pos;
+
+            if ( peek() == '-' && peek(1) && *peek(1) != ']' ) {
+                auto hi = static_cast<unsigned char>(*peek(1));
+                if ( hi == '[' || hi == '\\' || hi < lo )
+                    throw Unsupported();
+
+                _pos += 2;
+
+                for ( auto i = static_cast<unsigned int>(lo); i <= hi; i++ )
+                    set.set(i);
+            }
+            else
+                set.set(lo);
+        }
+
+        Result r;
+        r.nullable = false;
+
+        if ( unsure )
+            r.first.set(); // we have only a subset, so cannot negate it either
+        else
+            r.first = (negate ? ~set : set);
+
+        return r;
+    }
+
+    std::string_view _p;
+    size_t _pos = 0;
+};
+
+unsigned char lower(unsigned char c) { return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c; }
+
+// Returns the literal that any match of a pattern alternative must start with.
+std::string literalPrefix(std::string_view p) {
+    std::string prefix;
+    size_t i = 0;
+
+    while ( i < p.size() && p[i] == '^' )
+        ++i;
+
+    while ( i < p.size() ) {
+        auto c = p[i];
+
+        if ( std::string_view(".[()|*+?{^$").find(c) != std::string_view::npos )
+            break;
+
+        auto len = 1;
+
+        if ( c == '\\' ) {
+            if ( i + 1 == p.size() || std::isalnum(static_cast<unsigned char>(p[i + 1])) )
+                break;
+
+            c = p[i + 1];
+            len = 2;
+        }
+
+        i += len;
+
+        if ( i < p.size() && (p[i] == '*' || p[i] == '?' || p[i] == '{') )
+            break; // character is optional, or repeated an unknown number of times
+
+        prefix += c;
+
+        if ( i < p.size() && p[i] == '+' )
+            break;
+    }
+
+    return prefix;
+}
+} // namespace
+
+regexp::detail::Prefilter::Prefilter(const regexp::Patterns& patterns) {
+    std::vector<Branch> branches;
+    std::bitset<256> first;
+    bool useful = false;
+
+    for ( const auto& p : patterns ) {
+        std::vector<std::pair<std::string_view, PatternAnalyzer::Result>> results;
+
+        try {
+            results = PatternAnalyzer(p.value()).branches();
+        } catch ( const PatternAnalyzer::Unsupported& ) {
+            return;
+        }
+
+        for ( auto& [text, r] : results ) {
+            if ( r.nullable )
+                return; // matches anything
+
+            Branch b;
+            b.first = r.first;
+            b.prefix = literalPrefix(text);
+            b.case_insensitive = p.isCaseInsensitive();
+
+            if ( b.case_insensitive ) {
+                for ( auto c = 'a'; c <= 'z'; c++ ) {
+                    auto upper = c - 'a' + 'A';
+                    if ( b.first.test(c) || b.first.test(upper) ) {
+                        b.first.set(c);
+                        b.first.set(upper);
+                    }
+                }
+
+                std::transform(b.prefix.begin(), b.prefix.end(), b.prefix.begin(), lower);
+            }
+
+            first |= b.first;
+            useful = useful || b.prefix.size() > 1;
+            branches.push_back(std::move(b));
+        }
+    }
+
+    if ( branches.empty() || (first.all() && ! useful) )
+        return;
+
+    _enabled = true;
+    _first = first;
+    _branches = std::move(branches);
+}
+
+bool regexp::detail::Prefilter::Branch::matchesPrefix(const char* data, size_t len) const {
+    auto n = std::min(len, prefix.size());
+
+    if ( case_insensitive )
+        return std::equal(prefix.begin(), prefix.begin() + n, data,
+                          [](char a, char b) { return a == static_cast<char>(lower(b)); });
+    else
+        return std::equal(prefix.begin(), prefix.begin() + n, data);
+}
+
 void regexp::detail::CompiledRegExp::RegFree::operator()(jrx_regex_t* j) {
     jrx_regfree(j);
     delete j;
@@ -237,6 +593,7 @@ regexp::detail::CompiledRegExp::CompiledRegExp(const regexp::Patterns& patterns,
         _compileOne(p, idx++);
 
     jrx_regset_finalize(jrx());
+    _prefilter = Prefilter(_patterns);
 }
 
 void regexp::detail::CompiledRegExp::_newJrx() {
@@ -261,7 +618,7 @@ void regexp::detail::CompiledRegExp::_compileOne(regexp::Pattern pattern, int id
     auto id = static_cast<jrx_accept_id>(pattern.matchID());
 
     if ( auto rc = jrx_regset_add2(_jrx.get(), regexp.c_str(), regexp.size(), cflags, id); rc != REG_OK ) {
-        static char err[256];
+        char err[256];
         jrx_regerror(rc, _jrx.get(), err, sizeof(err));
         throw PatternError(fmt("error compiling pattern '%s': %s", pattern, err));
     }
@@ -269,23 +626,94 @@ void regexp::detail::CompiledRegExp::_compileOne(regexp::Pattern pattern, int id
     _patterns.push_back(std::move(pattern));
 }
 
-RegExp::RegExp(const regexp::Patterns& patterns, regexp::Flags flags) {
-    const auto& key = (patterns.empty() ? std::string() :
-                                          join(transform(patterns, [](const auto& p) { return to_string(p); }), "|") +
-                                              "|" + flags.cacheKey());
-    auto& ptr = detail::globalState()->regexp_cache[key];
+namespace {
+size_t hashPatterns(const regexp::Patterns& patterns, regexp::Flags flags) {
+    size_t h = hashCombine(std::hash<bool>{}(flags.no_sub), std::hash<bool>{}(flags.use_std));
+
+    for ( const auto& p : patterns )
+        h = hashCombine(h, std::hash<std::string>{}(p.value()), std::hash<bool>{}(p.isCaseInsensitive()),
+                        std::hash<uint64_t>{}(p.matchID()));
+
+    return h;
+}
+
+bool samePatterns(const regexp::detail::CompiledRegExp& re, const regexp::Patterns& patterns,
+                  regexp::Flags flags) {
+    const auto& flags_ = re.flags();
+    if ( flags_.no_sub != flags.no_sub || flags_.use_std != flags.use_std )
+        return false;
+
+    return std::equal(re.patterns().begin(), re.patterns().end(), patterns.begin(), patterns.end(),
+                      [](const auto& a, const auto& b) {
+                          return a.value() == b.value() && a.isCaseInsensitive() == b.isCaseInsensitive() &&
+                                 a.matchID() == b.matchID();
+                      });
+}
+} // namespace
+
+std::shared_ptr<regexp::detail::CompiledRegExp> regexp::detail::Cache::get(const regexp::Patterns& patterns,
+                                                                          regexp::Flags flags) {
+    const auto hash = hashPatterns(patterns, flags);
+    auto& shard = _shards[hash % NumShards];
+
+    auto lookup = [&]() -> std::shared_ptr<CompiledRegExp> {
+        auto [begin, end] = shard.entries.equal_range(hash);
+        for ( auto i = begin; i != end; ++i ) {
+            if ( samePatterns(*i->second, patterns, flags) )
+                return i->second;
+        }
+
+        return nullptr;
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if ( auto re = lookup() ) {
+            ++_hits;
+            return re;
+        }
+    }
+
+    // Compile without holding the lock since this can be expensive. If
+    // another thread compiled the same patterns concurrently, we use
+    // whichever got inserted first.
+    auto re = std::make_shared<CompiledRegExp>(patterns, flags);
+    ++_misses;
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if ( auto existing = lookup() )
+        return existing;
+
+    shard.entries.emplace(hash, re);
+    return re;
+}
+
+regexp::CacheStatistics regexp::detail::Cache::statistics() const {
+    CacheStatistics stats;
+    stats.hits = _hits;
+    stats.misses = _misses;
 
-    if ( ! ptr )
-        ptr = std::make_shared<regexp::detail::CompiledRegExp>(patterns, flags);
+    for ( const auto& shard : _shards ) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.size += shard.entries.size();
+    }
 
-    _re = ptr;
+    return stats;
 }
 
+regexp::CacheStatistics regexp::cacheStatistics() { return hilti::rt::detail::globalState()->regexp_cache->statistics(); }
+
+RegExp::RegExp(const regexp::Patterns& patterns, regexp::Flags flags)
+    : _re(detail::globalState()->regexp_cache->get(patterns, flags)) {}
+
 RegExp::RegExp(regexp::Pattern pattern, regexp::Flags flags) : RegExp(regexp::Patterns{{std::move(pattern)}}, flags) {}
 
 RegExp::RegExp() : RegExp(regexp::Patterns{}, regexp::Flags{}) {}
 
 int32_t RegExp::match(const Bytes& data) const {
+    if ( ! data.isEmpty() && ! _re->prefilter().mayMatch(data.data(), data.size()) )
+        return 0;
+
     jrx_match_state ms;
     jrx_accept_id acc = _search_pattern(&ms, data.data(), data.size(), nullptr, nullptr);
     jrx_match_state_done(&ms);
@@ -308,13 +736,16 @@ Vector<Bytes> RegExp::matchGroups(const Bytes& data) const {
     if ( _re->_flags.no_sub )
         throw NotSupported("cannot capture groups when compiled with &nosub");
 
+    Vector<Bytes> groups;
+
+    if ( ! data.isEmpty() && ! _re->prefilter().mayMatch(data.data(), data.size()) )
+        return groups;
+
     jrx_offset so = -1;
     jrx_offset eo = -1;
     jrx_match_state ms;
     auto rc = _search_pattern(&ms, data.data(), data.size(), &so, &eo);
 
-    Vector<Bytes> groups;
-
     if ( rc > 0 ) {
         groups.emplace_back(_subslice(data, so, eo));
 
@@ -341,7 +772,12 @@ Tuple<int32_t, Bytes> RegExp::find(const Bytes& data) const {
     jrx_offset cur_so = -1;
     jrx_offset cur_eo = -1;
 
+    const auto& prefilter = _re->prefilter();
+
     for ( const auto* cur = startp; cur < endp; cur++ ) {
+        if ( ! prefilter.mayMatch(cur, endp - cur) )
+            continue;
+
         jrx_offset so = -1; // just initialize with something, will be set by search_pattern to >=0 on match
         jrx_offset eo = -1; // likewise
         jrx_match_state ms;
@@ -2,6 +2,7 @@
 
 #include <hilti/rt/exception.h>
 #include <hilti/rt/extension-points.h>
+#include <hilti/rt/search.h>
 #include <hilti/rt/types/bytes.h>
 #include <hilti/rt/types/stream.h>
 #include <hilti/rt/util.h>
@@ -20,6 +21,8 @@ void Chunk::destroy() {
     if ( _allocated > 0 )
         delete[] _data;
 
+    _shared = nullptr;
+
     // The default dtr would turn deletion the list behind `_next` into a
     // recursive list traversal. For very long lists this could lead to stack
     // overflows. Traverse the list in a loop instead. This is adapted from
@@ -105,6 +108,13 @@ void Chain::append(Bytes&& data) {
         append(std::make_unique<Chunk>(0, std::move(data).str()));
 }
 
+void Chain::append(std::shared_ptr<const Bytes> data) {
+    if ( data->size() == 0 )
+        return;
+
+    append(std::make_unique<Chunk>(0, std::move(data)));
+}
+
 void Chain::append(std::unique_ptr<Chunk> chunk) {
     _ensureValid();
     _ensureMutable();
@@ -120,6 +130,7 @@ void Chain::append(std::unique_ptr<Chunk> chunk) {
 
     if ( _tail ) {
         _tail->setNext(std::move(chunk));
+        _indexChunks(_tail->next());
         _tail = _tail->last();
     }
     else {
@@ -127,6 +138,7 @@ void Chain::append(std::unique_ptr<Chunk> chunk) {
         chunk->setOffset(_head_offset);
         chunk->setChain(this);
         _head = std::move(chunk);
+        _indexChunks(_head.get());
         _tail = _head->last();
     }
 }
@@ -142,6 +154,8 @@ void Chain::append(Chain&& other) {
     _statistics += other._statistics;
 
     _tail->setNext(std::move(other._head));
+    _index.insert(_index.end(), other._index.begin() + static_cast<std::ptrdiff_t>(other._index_begin),
+                  other._index.end());
     _tail = other._tail;
     other.reset();
 }
@@ -171,17 +185,19 @@ void Chain::trim(const Offset& offset) {
 
             auto next = std::move(_head->_next);
 
-            if ( ! _head->isGap() &&
+            if ( ! _head->isGap() && ! _head->isShared() &&
                  (! _cached || (! _head->isOwning() || _head->allocated() > _cached->allocated())) ) {
                 // Cache chunk for later reuse. If we already have cached one,
                 // we prefer the one that's larger. Note that the chunk may be
                 // non-owning, we account for that when checking if we can
-                // reuse.
+                // reuse. We don't cache shared chunks as that would keep their
+                // data alive.
                 _cached = std::move(_head);
                 _cached->detach();
             }
 
             _head = std::move(next); // deletes chunk if not cached
+            _unindexHead();
 
             if ( ! _head || _head->isLast() )
                 _tail = _head.get();
@@ -286,9 +302,23 @@ UnsafeConstIterator View::find(Byte b, UnsafeConstIterator n) const {
     if ( ! n )
         n = unsafeBegin();
 
-    for ( auto i = n; i != unsafeEnd(); ++i ) {
-        if ( *i == b )
-            return i;
+    const auto* chain = n.chain();
+    auto end_offset = _searchEndOffset();
+    auto cur = n.offset();
+    const auto* c = chain->findChunk(cur, n.chunk());
+
+    while ( cur < end_offset && c ) {
+        if ( c->isGap() )
+            throw MissingData("data is missing");
+
+        auto limit = std::min(c->endOffset(), end_offset);
+        const auto* p = c->data(cur);
+
+        if ( const auto* x = reinterpret_cast<const Byte*>(memchr(p, b, (limit - cur).Ref())) )
+            return UnsafeConstIterator(chain, cur + (x - p), c);
+
+        cur = limit;
+        c = c->next();
     }
 
     return unsafeEnd();
@@ -326,6 +356,55 @@ Tuple<bool, UnsafeConstIterator> View::find(const View& v, UnsafeConstIterator n
     }
 }
 
+namespace {
+// Result of comparing a needle against stream data starting at a given offset.
+enum class Match {
+    Full,    // the needle matches completely
+    Partial, // the data ends before the needle does, but all available bytes match
+    None     // the data does not match the needle
+};
+
+// Compares a needle against stream data starting at offset `o` inside chunk
+// `c`, following the chain across chunk boundaries. Data at or beyond offset
+// `end` is considered unavailable. Throws `MissingData` if the comparison runs
+// into a gap.
+Match matchAcross(const Chunk* c, Offset o, const Byte* needle, size_t needle_size, const Offset& end) {
+    size_t k = 0;
+
+    while ( k < needle_size ) {
+        if ( ! c || o >= end )
+            return Match::Partial;
+
+        if ( o >= c->endOffset() ) {
+            c = c->next();
+            continue;
+        }
+
+        if ( c->isGap() )
+            throw MissingData("data is missing");
+
+        auto n = std::min(static_cast<uint64_t>(needle_size - k), (std::min(c->endOffset(), end) - o).Ref());
+        if ( memcmp(c->data(o), needle + k, n) != 0 )
+            return Match::None;
+
+        k += n;
+        o += n;
+    }
+
+    return Match::Full;
+}
+} // namespace
+
+Offset View::_searchEndOffset() const {
+    const auto* chain = _begin.chain();
+    assert(chain);
+
+    if ( _end )
+        return std::min(_end->offset(), chain->endOffset());
+    else
+        return chain->endOffset();
+}
+
 Tuple<bool, UnsafeConstIterator> View::_findForward(const Bytes& v, UnsafeConstIterator n) const {
     if ( ! n )
         n = UnsafeConstIterator(_begin);
@@ -333,29 +412,60 @@ Tuple<bool, UnsafeConstIterator> View::_findForward(const Bytes& v, UnsafeConstI
     if ( v.isEmpty() )
         return {true, n};
 
-    auto first = *v.unsafeBegin();
+    const auto* needle = reinterpret_cast<const Byte*>(v.data());
+    const auto needle_size = v.size().Ref();
 
-    for ( auto i = n; true; ++i ) {
-        if ( i == unsafeEnd() )
-            return {false, i};
+    const auto* chain = n.chain();
+    auto end_offset = _searchEndOffset();
+    auto cur = n.offset();
 
-        if ( *i != first )
-            continue;
+    if ( cur >= end_offset )
+        return {false, n};
 
-        auto x = i;
-        auto y = v.unsafeBegin();
+    // We search each chunk's contiguous data separately. Inside a chunk, we
+    // use the vectorized search for all matches fitting in completely. For
+    // the final positions of a chunk, where a match would straddle a chunk
+    // boundary (or the end of the view), we compare byte-wise across chunks.
+    const auto* c = chain->findChunk(cur, n.chunk());
 
-        for ( ;; ) {
-            if ( x == unsafeEnd() )
-                return {false, i};
+    while ( cur < end_offset ) {
+        if ( ! c )
+            throw InvalidIterator("stream iterator outside of valid range");
 
-            if ( *x++ != *y++ )
+        if ( c->isGap() )
+            throw MissingData("data is missing");
+
+        auto limit = std::min(c->endOffset(), end_offset);
+        const auto* begin = c->data(cur);
+        const auto size = (limit - cur).Ref();
+
+        if ( const auto* x = search::forward(begin, size, needle, needle_size) )
+            return {true, UnsafeConstIterator(chain, cur + (x - begin), c)};
+
+        auto straddle = (size >= needle_size ? limit - (needle_size - 1) : cur);
+
+        while ( straddle < limit ) {
+            const auto* p = c->data(straddle);
+            const auto* x = reinterpret_cast<const Byte*>(memchr(p, needle[0], (limit - straddle).Ref()));
+            if ( ! x )
                 break;
 
-            if ( y == v.unsafeEnd() )
-                return {true, i};
+            straddle += (x - p);
+
+            switch ( matchAcross(c, straddle, needle, needle_size, end_offset) ) {
+                case Match::Full: return {true, UnsafeConstIterator(chain, straddle, c)};
+                case Match::Partial: return {false, UnsafeConstIterator(chain, straddle, c)};
+                case Match::None: break;
+            }
+
+            ++straddle;
         }
+
+        cur = limit;
+        c = c->next();
     }
+
+    return {false, n + (end_offset - n.offset())};
 }
 
 Tuple<bool, UnsafeConstIterator> View::_findBackward(const Bytes& needle, UnsafeConstIterator i) const {
@@ -382,28 +492,63 @@ Tuple<bool, UnsafeConstIterator> View::_findBackward(const Bytes& needle, Unsafe
     if ( needle.size() > (i.offset() - offset()) )
         return {false, UnsafeConstIterator()};
 
-    i -= (needle.size() - 1).Ref(); // this is safe now, get us 1st position where initial character may match
+    const auto* p = reinterpret_cast<const Byte*>(needle.data());
+    const auto needle_size = needle.size().Ref();
+    const auto* chain = i.chain();
 
-    auto first = *needle.unsafeBegin();
+    // Highest and lowest start positions where a match may begin. Matches
+    // cannot extend beyond the available data.
+    auto lowest = offset();
+    auto highest = i.offset() - (needle_size - 1);
 
-    // The following is not the most efficient way to search backwards, but
-    // it'll do for now.
-    for ( auto j = i; true; --j ) {
-        if ( *j == first ) {
-            auto x = j;
-            auto y = needle.unsafeBegin();
+    if ( highest + needle_size > chain->endOffset() ) {
+        if ( chain->endOffset() < lowest + needle_size )
+            return {false, unsafeBegin()};
 
-            for ( ;; ) {
-                if ( *x++ != *y++ )
-                    break;
+        highest = chain->endOffset() - needle_size;
+    }
 
-                if ( y == needle.unsafeEnd() )
-                    return {true, j};
-            }
+    // We walk the chunks backwards. For each chunk, we first check the
+    // positions where a match would straddle into the next chunk, then
+    // search the chunk's own data with the vectorized search.
+    const auto* c = chain->findChunk(highest);
+
+    for ( ;; ) {
+        if ( ! c )
+            throw InvalidIterator("stream iterator outside of valid range");
+
+        if ( c->isGap() )
+            throw MissingData("data is missing");
+
+        auto chunk_begin = std::max(c->offset(), lowest);
+
+        // Positions [straddle, highest] don't fit into the chunk completely.
+        auto straddle = (c->size() >= needle_size ? c->endOffset() - (needle_size - 1) : c->offset());
+        straddle = std::max(straddle, chunk_begin);
+
+        for ( auto j = highest + 1; j > straddle; ) {
+            --j;
+
+            if ( *c->data(j) == p[0] &&
+                 matchAcross(c, j, p, needle_size, chain->endOffset()) == Match::Full )
+                return {true, UnsafeConstIterator(chain, j, c)};
+        }
+
+        if ( straddle > chunk_begin ) {
+            // Start positions [chunk_begin, straddle) fit into the chunk.
+            auto top = std::min(highest + 1, straddle);
+            const auto* begin = c->data(chunk_begin);
+            const auto size = (top - chunk_begin).Ref() + needle_size - 1;
+
+            if ( const auto* x = search::backward(begin, size, p, needle_size) )
+                return {true, UnsafeConstIterator(chain, chunk_begin + (x - begin), c)};
         }
 
-        if ( j == unsafeBegin() )
-            return {false, j};
+        if ( chunk_begin == lowest )
+            return {false, unsafeBegin()};
+
+        highest = c->offset() - 1;
+        c = chain->findChunk(highest);
     }
 }
 
@@ -501,6 +646,8 @@ void Stream::append(const Bytes& data) { _chain->append(reinterpret_cast<const B
 
 void Stream::append(Bytes&& data) { _chain->append(std::move(data)); }
 
+void Stream::append(std::shared_ptr<const Bytes> data) { _chain->append(std::move(data)); }
+
 void Stream::append(const char* data, size_t len) {
     if ( data )
         _chain->append(reinterpret_cast<const Byte*>(data), len);
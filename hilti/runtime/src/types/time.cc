@@ -4,6 +4,7 @@
 
 #include <ctime>
 
+#include <hilti/rt/global-state.h>
 #include <hilti/rt/types/time.h>
 #include <hilti/rt/util.h>
 
@@ -18,6 +19,10 @@ Time time::current_time() {
     return Time(t, Time::SecondTag());
 }
 
+Time time::network_time() { return detail::globalState()->network_time; }
+
+void time::set_network_time(Time t) { detail::globalState()->network_time = t; }
+
 Time time::mktime(uint64_t y, uint64_t m, uint64_t d, uint64_t H, uint64_t M, uint64_t S) {
     if ( y < 1970 || (m < 1 || m > 12) || (d < 1 || d > 31) || H > 23 || M > 59 || S > 59 )
         throw InvalidValue("value out of range");
@@ -4,9 +4,11 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -214,6 +216,25 @@ public:
      */
     Driver* driver() const { return _driver; }
 
+    /**
+     * During AST resolving, returns the modules that the resolver needs to
+     * visit in the current round. After an initial round visiting all
+     * modules, subsequent rounds visit only modules that the previous round
+     * modified, along with any modules importing them. Outside of resolving,
+     * this returns all modules.
+     */
+    std::vector<declaration::Module*> modulesToResolve() const;
+
+    /**
+     * Records that a mutating visitor has modified the AST at a given node.
+     * This marks the node's module for revisiting during the next round of
+     * AST resolving.
+     *
+     * @param n node that was modified; if it's not part of any module, all
+     * modules will be marked
+     */
+    void recordModification(const Node* n);
+
     /**
      * Returns direct & indirect dependencies that a module imports. This
      * information will be available only once the AST has been processed
@@ -426,6 +447,7 @@ private:
     Result<Nothing> _resolve(Builder* builder, const Plugin& plugin);
     Result<Nothing> _resolveUnresolvedNodes(bool* modified, Builder* builder, const Plugin& plugin);
     Result<Nothing> _resolveRoot(bool* modified, Builder* builder, const Plugin& plugin);
+    uint64_t _selectModulesToResolve(bool all);
     Result<Nothing> _validate(Builder* builder, const Plugin& plugin, bool pre_resolver);
     Result<Nothing> _transform(Builder* builder, const Plugin& plugin);
     Result<Nothing> _collectErrors();
@@ -473,6 +495,13 @@ private:
 
     uint64_t _total_rounds = 0; // total number of rounds of AST processing
 
+    // State for incremental AST resolving.
+    std::optional<std::unordered_set<const declaration::Module*>>
+        _resolver_selected; // modules to visit in the current round; unset to visit all
+    std::unordered_set<const declaration::Module*>
+        _resolver_modified; // modules modified since the current round started
+    bool _resolver_modified_all = false; // true if a modification couldn't be attributed to a module
+
     std::unordered_map<declaration::module::UID, node::RetainedPtr<declaration::Module>>
         _modules_by_uid; // all known modules indexed by UID
 
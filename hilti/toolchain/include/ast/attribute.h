@@ -96,6 +96,7 @@ const Kind Optional("&optional");
 const Kind Priority("&priority");
 const Kind RequiresTypeFeature("&requires-type-feature");
 const Kind Static("&static");
+const Kind SuspendsOnlyForInput("&suspends-only-for-input");
 
 } // namespace kind
 } // namespace attribute
@@ -39,6 +39,16 @@ public:
 
     std::string printSignature() const { return operator_::detail::printSignature(kind(), operands(), meta()); }
 
+    /**
+     * Returns true if the optimizer has proven that the operator's result
+     * always fits into its integer type. Code generation can then skip
+     * checking for overflows.
+     */
+    bool isOverflowSafe() const { return _overflow_safe; }
+
+    /** Marks the operator's result as proven to fit into its integer type. */
+    void setOverflowSafe() { _overflow_safe = true; }
+
     node::Properties properties() const override {
         auto p = node::Properties{{"kind", to_string(_operator->kind())}};
         return Expression::properties() + std::move(p);
@@ -53,6 +63,7 @@ protected:
 
 private:
     const Operator* _operator = nullptr;
+    bool _overflow_safe = false;
 };
 
 } // namespace hilti::expression
@@ -286,6 +286,8 @@ class IndexAssign;
 class Get;
 class GetOptional;
 class Clear;
+class SetExpiration;
+class NumExpired;
 
 } // namespace map
 
@@ -385,6 +387,8 @@ class In;
 class Add;
 class Delete;
 class Clear;
+class SetExpiration;
+class NumExpired;
 
 } // namespace set
 
@@ -300,6 +300,8 @@ constexpr Tag IndexNonConst = 1907;
 constexpr Tag Size = 1908;
 constexpr Tag Unequal = 1909;
 constexpr Tag GetOptional = 1910;
+constexpr Tag SetExpiration = 1911;
+constexpr Tag NumExpired = 1912;
 
 namespace iterator {
 constexpr Tag Deref = 2000;
@@ -379,6 +381,8 @@ constexpr Tag Equal = 2803;
 constexpr Tag In = 2804;
 constexpr Tag Size = 2805;
 constexpr Tag Unequal = 2806;
+constexpr Tag SetExpiration = 2807;
+constexpr Tag NumExpired = 2808;
 
 namespace iterator {
 constexpr Tag Deref = 2900;
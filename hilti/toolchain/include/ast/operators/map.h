@@ -25,5 +25,7 @@ HILTI_NODE_OPERATOR(map, IndexAssign)
 HILTI_NODE_OPERATOR(map, Get)
 HILTI_NODE_OPERATOR(map, GetOptional)
 HILTI_NODE_OPERATOR(map, Clear)
+HILTI_NODE_OPERATOR(map, SetExpiration)
+HILTI_NODE_OPERATOR(map, NumExpired)
 
 } // namespace hilti::operator_
@@ -21,5 +21,7 @@ HILTI_NODE_OPERATOR(set, In)
 HILTI_NODE_OPERATOR(set, Add)
 HILTI_NODE_OPERATOR(set, Delete)
 HILTI_NODE_OPERATOR(set, Clear)
+HILTI_NODE_OPERATOR(set, SetExpiration)
+HILTI_NODE_OPERATOR(set, NumExpired)
 
 } // namespace hilti::operator_
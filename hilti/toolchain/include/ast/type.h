@@ -292,6 +292,9 @@ public:
     /** Returns true for HILTI types that can be compared for ordering at runtime. */
     virtual bool isSortable() const { return false; }
 
+    /** Returns true for HILTI types that can be hashed at runtime, as needed for keys of unordered containers. */
+    virtual bool isHashable() const { return false; }
+
     /**
      * For internal use. Called when an unqualified type has been embedded into
      * a qualified type, allowing the former to adjust for constness if
@@ -18,6 +18,7 @@ public:
 
     bool isAllocable() const final { return true; }
     bool isSortable() const final { return true; }
+    bool isHashable() const final { return true; }
 
 protected:
     Address(ASTContext* ctx, Meta meta) : UnqualifiedType(ctx, NodeTags, {"address"}, std::move(meta)) {}
@@ -18,6 +18,7 @@ public:
 
     bool isAllocable() const override { return true; }
     bool isSortable() const override { return true; }
+    bool isHashable() const override { return true; }
 
 protected:
     // We create this as no-match type because we handle matching against `any` explicitly.
@@ -53,6 +53,7 @@ public:
     bool isAllocable() const final { return true; }
     bool isMutable() const final { return true; }
     bool isSortable() const final { return true; }
+    bool isHashable() const final { return true; }
 
 protected:
     Bytes(ASTContext* ctx, Nodes children, Meta meta)
@@ -84,6 +84,7 @@ public:
 
     bool isAllocable() const final { return true; }
     bool isSortable() const final { return true; }
+    bool isHashable() const final { return true; }
     bool isNameType() const final { return true; }
 
     static auto create(ASTContext* ctx, enum_::Labels labels, Meta meta = {}) {
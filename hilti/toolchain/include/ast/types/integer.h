@@ -17,6 +17,7 @@ public:
 
     bool isAllocable() const final { return true; }
     bool isSortable() const final { return true; }
+    bool isHashable() const final { return true; }
 
     node::Properties properties() const final {
         auto p = node::Properties{{"width", _width}};
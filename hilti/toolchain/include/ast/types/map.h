@@ -26,6 +26,17 @@ public:
     bool isAllocable() const final { return true; }
     bool isMutable() const final { return true; }
 
+    /** Returns true if this iterates over a map backed by a hash table. */
+    bool isUnordered() const { return _unordered; }
+
+    /** Sets whether this iterates over a map backed by a hash table. */
+    void setUnordered(bool unordered) { _unordered = unordered; }
+
+    node::Properties properties() const final {
+        auto p = node::Properties{{"unordered", _unordered}};
+        return UnqualifiedType::properties() + std::move(p);
+    }
+
     static auto create(ASTContext* ctx, QualifiedType* ktype, QualifiedType* vtype, const Meta& meta = {}) {
         return ctx->make<Iterator>(ctx,
                                    {QualifiedType::create(ctx, type::Tuple::create(ctx, QualifiedTypes{ktype, vtype}),
@@ -57,6 +68,9 @@ protected:
     }
 
     HILTI_NODE_1(type::map::Iterator, UnqualifiedType, final);
+
+private:
+    bool _unordered = false;
 };
 
 } // namespace map
@@ -76,6 +90,23 @@ public:
     bool isMutable() const final { return true; }
     bool isResolved(node::CycleDetector* cd) const final { return iteratorType()->isResolved(cd); }
 
+    /**
+     * Returns true if the map is backed by a hash table, as requested
+     * through `&unordered`. Iteration order is unspecified then.
+     */
+    bool isUnordered() const { return _unordered; }
+
+    /** Sets whether the map is backed by a hash table. */
+    void setUnordered(bool unordered) {
+        _unordered = unordered;
+        iteratorType()->type()->as<map::Iterator>()->setUnordered(unordered);
+    }
+
+    node::Properties properties() const final {
+        auto p = node::Properties{{"unordered", _unordered}};
+        return UnqualifiedType::properties() + std::move(p);
+    }
+
     static auto create(ASTContext* ctx, QualifiedType* ktype, QualifiedType* vtype, const Meta& meta = {}) {
         return ctx->make<Map>(ctx,
                               {QualifiedType::create(ctx, map::Iterator::create(ctx, ktype, vtype, meta),
@@ -103,6 +134,9 @@ protected:
     }
 
     HILTI_NODE_1(type::Map, UnqualifiedType, final);
+
+private:
+    bool _unordered = false;
 };
 
 } // namespace hilti::type
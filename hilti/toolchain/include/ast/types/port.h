@@ -16,6 +16,7 @@ public:
 
     bool isAllocable() const final { return true; }
     bool isSortable() const final { return true; }
+    bool isHashable() const final { return true; }
 
     static auto create(ASTContext* ctx, Meta meta = {}) { return ctx->make<Port>(ctx, std::move(meta)); }
 
@@ -24,6 +24,17 @@ public:
     bool isMutable() const final { return true; }
     bool isResolved(node::CycleDetector* cd) const final { return dereferencedType()->isResolved(cd); }
 
+    /** Returns true if this iterates over a set backed by a hash table. */
+    bool isUnordered() const { return _unordered; }
+
+    /** Sets whether this iterates over a set backed by a hash table. */
+    void setUnordered(bool unordered) { _unordered = unordered; }
+
+    node::Properties properties() const final {
+        auto p = node::Properties{{"unordered", _unordered}};
+        return UnqualifiedType::properties() + std::move(p);
+    }
+
     static auto create(ASTContext* ctx, QualifiedType* etype, Meta meta = {}) {
         return ctx->make<Iterator>(ctx, {etype}, std::move(meta));
     }
@@ -41,6 +52,9 @@ protected:
 
 
     HILTI_NODE_1(type::set::Iterator, UnqualifiedType, final);
+
+private:
+    bool _unordered = false;
 };
 
 } // namespace set
@@ -57,6 +71,23 @@ public:
     bool isMutable() const override { return true; }
     bool isResolved(node::CycleDetector* cd) const final { return iteratorType()->isResolved(cd); }
 
+    /**
+     * Returns true if the set is backed by a hash table, as requested
+     * through `&unordered`. Iteration order is unspecified then.
+     */
+    bool isUnordered() const { return _unordered; }
+
+    /** Sets whether the set is backed by a hash table. */
+    void setUnordered(bool unordered) {
+        _unordered = unordered;
+        iteratorType()->type()->as<set::Iterator>()->setUnordered(unordered);
+    }
+
+    node::Properties properties() const final {
+        auto p = node::Properties{{"unordered", _unordered}};
+        return UnqualifiedType::properties() + std::move(p);
+    }
+
     static auto create(ASTContext* ctx, QualifiedType* t, const Meta& meta = {}) {
         return ctx->make<Set>(ctx,
                               {QualifiedType::create(ctx, set::Iterator::create(ctx, t, meta), Constness::Mutable)},
@@ -80,6 +111,9 @@ protected:
     void newlyQualified(const QualifiedType* qtype) const final { elementType()->setConst(qtype->constness()); }
 
     HILTI_NODE_1(type::Set, UnqualifiedType, final);
+
+private:
+    bool _unordered = false;
 };
 
 } // namespace hilti::type
@@ -78,6 +78,7 @@ public:
     bool isAllocable() const final { return true; }
     bool isResolved(node::CycleDetector* cd) const final;
     bool isSortable() const final { return true; }
+    bool isHashable() const final { return true; }
 
     static auto create(ASTContext* ctx, const type::tuple::Elements& elements, Meta meta = {}) {
         return ctx->make<Tuple>(ctx, elements, std::move(meta));
@@ -226,6 +226,8 @@ public:
     virtual void operator()(hilti::operator_::map::Get* n) {}
     virtual void operator()(hilti::operator_::map::GetOptional* n) {}
     virtual void operator()(hilti::operator_::map::Clear* n) {}
+    virtual void operator()(hilti::operator_::map::SetExpiration* n) {}
+    virtual void operator()(hilti::operator_::map::NumExpired* n) {}
     virtual void operator()(hilti::operator_::network::Equal* n) {}
     virtual void operator()(hilti::operator_::network::Unequal* n) {}
     virtual void operator()(hilti::operator_::network::In* n) {}
@@ -287,6 +289,8 @@ public:
     virtual void operator()(hilti::operator_::set::Add* n) {}
     virtual void operator()(hilti::operator_::set::Delete* n) {}
     virtual void operator()(hilti::operator_::set::Clear* n) {}
+    virtual void operator()(hilti::operator_::set::SetExpiration* n) {}
+    virtual void operator()(hilti::operator_::set::NumExpired* n) {}
     virtual void operator()(hilti::operator_::signed_integer::DecrPostfix* n) {}
     virtual void operator()(hilti::operator_::signed_integer::DecrPrefix* n) {}
     virtual void operator()(hilti::operator_::signed_integer::IncrPostfix* n) {}
@@ -6,7 +6,9 @@
 
 #include <cassert>
 #include <chrono>
+#include <cstdint>
 #include <list>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -39,6 +41,13 @@ public:
      */
     static std::shared_ptr<Manager> singleton();
 
+    /**
+     * Adds to a named counter that will be reported as part of the summary.
+     * Counters complement timing measurements with further statistics, such
+     * as the amount of work performed by a code area.
+     */
+    void count(const std::string& name, uint64_t n) { _counters[name] += n; }
+
 protected:
     friend Collector;
     friend Ledger;
@@ -53,12 +62,21 @@ private:
     Time _created;
     std::unordered_map<std::string, Ledger*> _all_ledgers;
     std::list<Ledger> _our_ledgers;
+    std::map<std::string, uint64_t> _counters;
 };
 
 } // namespace detail
 
 inline void summary(std::ostream& out) { detail::Manager::summary(out); }
 
+/**
+ * Adds to a named counter that will be reported as part of the summary.
+ *
+ * @param name name of the counter
+ * @param n value to add to the counter
+ */
+inline void count(const std::string& name, uint64_t n) { detail::Manager::singleton()->count(name, n); }
+
 /** Maintains measurements of execution time and frequency for one code area. */
 class Ledger {
 public:
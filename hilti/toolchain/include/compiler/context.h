@@ -4,7 +4,9 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
@@ -36,6 +38,8 @@ struct Options {
         false; /**< if true, generate code to log statements to debug stream "hilti-trace" (requires *debug*, too) */
     bool debug_flow = false; /**< if true, generate code to log function calls and returns to debug stream "hilti-flow"
                                 (requires *debug*, too) */
+    std::vector<std::string>
+        disabled_debug_streams; /**< debug streams for which not to generate any debug output (requires *debug*) */
     bool track_location = true;   /**< if true, generate code to record current source code location during execution */
     bool skip_validation = false; /**< if true, skip AST validation; for debugging only, things may go downhill
                                      quickly if an AST is not well-formed  */
@@ -47,9 +51,20 @@ struct Options {
     std::vector<hilti::rt::filesystem::path>
         cxx_include_paths;             /**< additional C++ directories to search for #include files */
     bool keep_tmps = false;            /**< if true, do not remove generated files on exit */
+    std::optional<hilti::rt::filesystem::path>
+        jit_cache; /**< directory for caching JIT results across runs; if unset, `HILTI_JIT_CACHE` is consulted */
+    uint64_t jit_cache_max_size = 1024U * 1024U * 1024U; /**< maximum size of the JIT cache in bytes */
     std::vector<std::string> cxx_link; /**< additional static archives or shared libraries to link during JIT */
+    std::optional<hilti::rt::filesystem::path>
+        pgo_generate; /**< if set, instrument JIT-compiled code to record execution profiles into this directory */
+    std::optional<hilti::rt::filesystem::path>
+        pgo_use; /**< if set, optimize JIT-compiled code using profiles previously recorded into this directory */
+    bool cxx_lto =
+        false; /**< if true, link JIT-compiled code with link-time optimization against the runtime library */
     bool cxx_enable_dynamic_globals =
         false; /**< if true, allocate globals dynamically at runtime for (future) thread safety */
+    uint64_t cxx_split_units = 1; /**< number of C++ files to spread each module's function implementations across, so
+                                     that the JIT can compile them in parallel */
     bool global_optimizations = true;    /**< whether to run global HILTI optimizations on the generated code. */
     bool import_standard_modules = true; /**< automatically import standard modules into the global namespace. this is
                                            required, turn off only for debugging. */
@@ -95,6 +110,12 @@ struct Options {
      */
     Result<Nothing> parseDebugAddl(const std::string& flags);
 
+    /**
+     * Returns true if generated code should not log to a given debug stream
+     * because the stream is part of `disabled_debug_streams`.
+     */
+    bool isDebugStreamDisabled(std::string_view stream) const;
+
     /** Prints out a humand-readable version of the current options. */
     void print(std::ostream& out) const;
 
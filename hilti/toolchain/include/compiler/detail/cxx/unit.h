@@ -89,13 +89,19 @@ public:
     void addInitialization(cxx::Block block) { _init_module.appendFromBlock(std::move(block)); }
     void addPreInitialization(cxx::Block block) { _preinit_module.appendFromBlock(std::move(block)); }
 
+    // If `Options::cxx_split_units` is larger than one, this moves function
+    // implementations into additional C++ files ("shards") that repeat all
+    // the unit's declarations, so that they can be compiled in parallel.
+    //
     // @param include_all_implementations if true, do not filter out function
     // implementations that aren't within the module's own namespace.
     Result<Nothing> finalize(bool include_all_implementations = false);
 
-    Result<Nothing> print(std::ostream& out) const;      // only after finalize
-    Result<Nothing> createPrototypes(std::ostream& out); // only after finalize
-    Result<linker::MetaData> linkerMetaData() const;     // only after finalize
+    Result<Nothing> print(std::ostream& out) const;                // only after finalize
+    Result<Nothing> createPrototypes(std::ostream& out);           // only after finalize
+    Result<linker::MetaData> linkerMetaData() const;               // only after finalize
+    size_t numShards() const { return _cxx_shards.size(); }        // only after finalize
+    Result<Nothing> printShard(size_t i, std::ostream& out) const; // only after finalize
 
     std::shared_ptr<Context> context() const { return _context.lock(); }
 
@@ -114,15 +120,17 @@ private:
         Globals,
         Functions,
         TypeInfos,
-        Implementations
+        Implementations,
+        SplitImplementations
     };
 
     using cxxDeclaration = std::variant<declaration::IncludeFile, declaration::Global, declaration::Constant,
                                         declaration::Type, declaration::Function>;
 
-    void _generateCode(Formatter& f, bool prototypes_only, bool include_all_implementations);
+    void _generateCode(Formatter& f, bool prototypes_only, bool include_all_implementations, bool shard = false);
     void _emitDeclarations(const cxxDeclaration& decl, Formatter& f, Phase phase, bool prototypes_only,
-                           bool include_all_implementations);
+                           bool include_all_implementations, bool shard = false);
+    void _splitImplementations(const std::string& prelude, bool include_all_implementations);
     void _addHeader(Formatter& f);
     void _addModuleInitFunction();
 
@@ -133,8 +141,10 @@ private:
     hilti::rt::filesystem::path _module_path;
     bool _no_linker_meta_data = false;
     bool _uses_globals = false;
+    bool _split = false; // true if function implementations are spread across multiple C++ files
 
     std::optional<std::string> _cxx_code;
+    std::vector<std::string> _cxx_shards; // additional C++ files holding function implementations if split
 
     std::vector<std::pair<ID, cxxDeclaration>> _declarations; // maintains order of insertion
     std::multimap<ID, cxxDeclaration> _declarations_by_id;    // index into declarations by their ID
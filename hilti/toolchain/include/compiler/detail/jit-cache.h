@@ -0,0 +1,114 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <hilti/rt/filesystem.h>
+
+#include <hilti/base/result.h>
+
+namespace hilti::detail::jit {
+
+/**
+ * Persistent, content-addressed on-disk cache for artifacts produced during
+ * JIT compilation (object files and HLTO libraries).
+ *
+ * Entries are stored under a key derived from everything that determines
+ * their content (i.e., source code, compiler invocation, toolchain version),
+ * so they never need to be invalidated explicitly. Multiple processes may
+ * share a cache directory: entries are written to private temporary files
+ * first and then atomically moved into place, and readers treat entries
+ * vanishing underneath them as cache misses. The cache's total size is
+ * bounded by evicting least recently used entries.
+ */
+class Cache {
+public:
+    /** Counters summarizing cache activity of the current process. */
+    struct Statistics {
+        uint64_t hits = 0;      /**< number of lookups that found an entry */
+        uint64_t misses = 0;    /**< number of lookups that did not find an entry */
+        uint64_t stores = 0;    /**< number of entries added */
+        uint64_t evictions = 0; /**< number of entries removed to stay within the size limit */
+    };
+
+    /**
+     * Opens a cache residing in a given directory, creating the directory
+     * if it doesn't exist yet.
+     *
+     * @param directory directory to store cache entries in
+     * @param max_size maximum total size of all entries in bytes; a value of
+     * zero disables eviction
+     * @return the cache, or an error if the directory could not be created
+     */
+    static Result<Cache> open(hilti::rt::filesystem::path directory, uint64_t max_size);
+
+    /**
+     * Computes a cache key from a list of strings. Changing any of the
+     * strings, or their order, yields a different key.
+     *
+     * @param material all inputs determining the content of the cached entry
+     * @return a key suitable for `retrieve()` and `store()`
+     */
+    static std::string key(const std::vector<std::string_view>& material);
+
+    /**
+     * Computes a cache key from the content of a file, for including it into
+     * the material of another key.
+     *
+     * @param path file to read
+     * @return the key, or an error if the file could not be read
+     */
+    static Result<std::string> fileKey(const hilti::rt::filesystem::path& path);
+
+    /**
+     * Copies a cache entry into a file. Updates the entry's access time on
+     * success so that it will be evicted last.
+     *
+     * @param key key of the entry to look up
+     * @param extension file extension of the entry, including the dot
+     * @param dst path to copy the entry to; will be overwritten if it exists
+     * @return true if the entry was found and copied
+     */
+    bool retrieve(const std::string& key, const std::string& extension, const hilti::rt::filesystem::path& dst);
+
+    /**
+     * Adds a file to the cache, replacing any existing entry for the same
+     * key. Failures are logged but otherwise ignored since the cache is
+     * merely an optimization.
+     *
+     * @param key key to store the entry under
+     * @param extension file extension of the entry, including the dot
+     * @param src file to copy into the cache
+     */
+    void store(const std::string& key, const std::string& extension, const hilti::rt::filesystem::path& src);
+
+    /**
+     * Removes least recently used entries until the total size of the cache
+     * drops below its maximum size. This also cleans up temporary files left
+     * behind by processes that terminated while storing entries.
+     */
+    void evict();
+
+    /** Returns the directory the cache is stored in. */
+    const auto& directory() const { return _directory; }
+
+    /** Returns counters summarizing cache activity. */
+    const auto& statistics() const { return _statistics; }
+
+private:
+    Cache(hilti::rt::filesystem::path directory, uint64_t max_size)
+        : _directory(std::move(directory)), _max_size(max_size) {}
+
+    hilti::rt::filesystem::path _path(const std::string& key, const std::string& extension) const;
+
+    hilti::rt::filesystem::path _directory;
+    uint64_t _max_size;
+    Statistics _statistics;
+};
+
+} // namespace hilti::detail::jit
@@ -6,6 +6,7 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -16,6 +17,7 @@
 #include <hilti/base/util.h>
 #include <hilti/compiler/context.h>
 #include <hilti/compiler/detail/cxx/unit.h>
+#include <hilti/compiler/detail/jit-cache.h>
 
 namespace reproc {
 class process;
@@ -170,16 +172,52 @@ public:
     /** Returns the compiler options in use. */
     auto options() const { return context()->options(); }
 
+    /**
+     * Returns statistics on the use of the persistent JIT cache during
+     * `build()`, or nothing if caching is disabled.
+     */
+    std::optional<detail::jit::Cache::Statistics> cacheStatistics() const {
+        if ( _cache )
+            return _cache->statistics();
+        else
+            return {};
+    }
+
 private:
     // Check if we have a working compiler.
     hilti::Result<Nothing> _checkCompiler();
 
+    // Open the persistent cache if enabled.
+    void _openCache();
+
     // Compile C++ to object files.
     hilti::Result<Nothing> _compile();
 
     // Link object files into shared library.
     hilti::Result<std::shared_ptr<const Library>> _link();
 
+    // Returns the arguments for linking object files into a shared library,
+    // except for the output file.
+    std::vector<std::string> _linkArgs(const std::vector<hilti::rt::filesystem::path>& objects) const;
+
+    // Returns true if code is to be compiled and linked with link-time
+    // optimization against the runtime library.
+    bool _lto() const;
+
+    // Settings for compiling code with profile-guided optimization.
+    struct PGO {
+        hilti::rt::filesystem::path directory; // directory holding the profiles for the code being compiled
+        std::vector<std::string> args;         // additional compiler arguments
+    };
+
+    // Returns the settings for compiling all in-memory code with
+    // profile-guided optimization, or nothing if not enabled or no profile
+    // is available.
+    Result<std::optional<PGO>> _pgo();
+
+    // Creates a new, empty temporary file with a unique name derived from a `mkstemp` template.
+    static std::string _tempFile(const std::string& template_);
+
     // Clean up after compilation.
     void _finish();
 
@@ -190,6 +228,10 @@ private:
     std::vector<CxxCode> _codes;                     // all C++ code units to be compiled
     std::vector<hilti::rt::filesystem::path> _objects;
 
+    std::optional<detail::jit::Cache> _cache;                   // persistent cache, if enabled
+    std::optional<std::string> _library_key;                    // cache key for the linked library, if cacheable
+    std::optional<hilti::rt::filesystem::path> _cached_library; // library retrieved from cache, if any
+
     struct Job {
         std::unique_ptr<reproc::process> process;
         std::string stdout_;
@@ -96,6 +96,17 @@ public:
      */
     Result<CxxCode> cxxCode() const;
 
+    /**
+     * Returns any additional C++ code that the unit's function
+     * implementations have been split off into, per
+     * `Options::cxx_split_units`. Each piece needs to be compiled alongside
+     * the code that `cxxCode()` returns. Must be called only after
+     * `compile()` was successful.
+     *
+     * @return code wrapped into the JIT's container class, one per C++ file
+     */
+    Result<std::vector<CxxCode>> cxxCodeShards() const;
+
     /**
      * Returns the unit's meta data for the internal HILTI linker.
      *
@@ -237,6 +237,7 @@ void ASTContext::clear() {
     _modules_by_uid.clear();
     _modules_by_path.clear();
     _modules_by_id_and_scope.clear();
+    _resolver_modified.clear();
 
     operator_::registry().clear(); // make sure there are no operators left using any of our nodes, because their
                                    // storage will go away
@@ -529,6 +530,7 @@ declaration::module::UID ASTContext::_addModuleToAST(declaration::Module* module
     _modules_by_id_and_scope[std::make_pair(uid.id, module->scopePath())] = module;
 
     _root->addChild(this, module);
+    _resolver_modified.insert(module); // make sure the resolver visits it
     return uid;
 }
 
@@ -709,19 +711,106 @@ Result<Nothing> ASTContext::_resolveRoot(bool* modified, Builder* builder, const
     return _runHook(modified, plugin, &Plugin::ast_resolve, "resolving AST", builder, _root);
 }
 
+std::vector<declaration::Module*> ASTContext::modulesToResolve() const {
+    std::vector<declaration::Module*> modules;
+
+    for ( auto* n : _root->children() ) {
+        auto* m = n->tryAs<declaration::Module>();
+        if ( m && (! _resolver_selected || _resolver_selected->find(m) != _resolver_selected->end()) )
+            modules.push_back(m);
+    }
+
+    return modules;
+}
+
+void ASTContext::recordModification(const Node* n) {
+    if ( _resolver_modified_all )
+        return;
+
+    const auto* m = n->tryAs<declaration::Module>();
+    if ( ! m )
+        m = n->parent<declaration::Module>();
+
+    if ( m )
+        _resolver_modified.insert(m);
+    else
+        _resolver_modified_all = true;
+}
+
+uint64_t ASTContext::_selectModulesToResolve(bool all) {
+    if ( all || _resolver_modified_all )
+        _resolver_selected.reset();
+
+    else {
+        // Revisit the modified modules, plus any modules importing them
+        // because their resolving may depend on what has changed.
+        std::unordered_set<const declaration::Module*> selected;
+        bool selected_all = true;
+
+        for ( auto* n : _root->children() ) {
+            auto* m = n->tryAs<declaration::Module>();
+            if ( ! m )
+                continue;
+
+            auto select = (_resolver_modified.find(m) != _resolver_modified.end());
+
+            for ( auto i = m->dependencies().begin(); ! select && i != m->dependencies().end(); ++i )
+                select = (_resolver_modified.find(module(*i)) != _resolver_modified.end());
+
+            if ( select )
+                selected.insert(m);
+            else
+                selected_all = false;
+        }
+
+        if ( selected_all )
+            _resolver_selected.reset();
+        else
+            _resolver_selected = std::move(selected);
+    }
+
+    _resolver_modified.clear();
+    _resolver_modified_all = false;
+
+    if ( ! (_driver && _driver->driverOptions().report_times) )
+        return 0;
+
+    // Counting nodes is relatively expensive, so we do it only when requested.
+    uint64_t nodes = 0;
+    for ( auto* m : modulesToResolve() ) {
+        for ( [[maybe_unused]] auto* n : visitor::range(visitor::PreOrder(), m, {}) )
+            ++nodes;
+    }
+
+    return nodes;
+}
+
 Result<Nothing> ASTContext::_resolve(Builder* builder, const Plugin& plugin) {
     HILTI_DEBUG(logging::debug::Compiler, fmt("resolving units with plugin %s", plugin.component))
 
     logging::DebugPushIndent _(logging::debug::Compiler);
 
     int round = 1;
+    bool full_round = true;
 
     _saveIterationAST(plugin, "AST before first iteration", 0);
 
     while ( true ) {
+        auto nodes = _selectModulesToResolve(full_round);
+        full_round = ! _resolver_selected;
+
         HILTI_DEBUG(logging::debug::Compiler, fmt("processing ASTs, round %d", round));
         logging::DebugPushIndent _(logging::debug::Compiler);
 
+        if ( _resolver_selected )
+            HILTI_DEBUG(logging::debug::AstStats,
+                        fmt("- # modules to resolve in round %d: %zu", round, _resolver_selected->size()));
+
+        if ( nodes )
+            util::timing::count(fmt("%s/compiler/ast/resolver/round-%02d/visited-nodes",
+                                    util::tolower(plugin.component), round),
+                                nodes);
+
         ++_total_rounds;
 
         _checkAST(false);
@@ -738,13 +827,27 @@ Result<Nothing> ASTContext::_resolve(Builder* builder, const Plugin& plugin) {
 
         _saveIterationAST(plugin, "AST after resolving", round);
 
-        if ( ! modified )
+        if ( modified )
+            full_round = false;
+
+        else if ( full_round )
             break;
 
+        else {
+            // The modules we visited didn't change anymore. Confirm with a
+            // final round across all modules that we have reached a fixed
+            // point, in case there are dependencies we didn't track.
+            full_round = true;
+            ++round;
+            continue;
+        }
+
         if ( ++round >= 50 )
             logger().internalError("hilti::Unit::compile() didn't terminate, AST keeps changing");
     }
 
+    _resolver_selected.reset();
+
     _dumpAST(logging::debug::AstResolved, plugin, "AST after resolving", static_cast<int>(_total_rounds));
     _dumpStats(logging::debug::AstStats, plugin.component);
     _dumpDeclarations(logging::debug::AstDeclarations, plugin);
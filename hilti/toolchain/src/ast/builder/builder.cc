@@ -63,7 +63,8 @@ Expression* Builder::addTmp(const std::string& prefix, QualifiedType* t, Express
 }
 
 void Builder::addDebugMsg(std::string_view stream, std::string_view fmt, Expressions args) {
-    if ( ! context()->driver()->options().debug )
+    if ( const auto& options = context()->driver()->options();
+         ! options.debug || options.isDebugStreamDisabled(stream) )
         return;
 
     Expression* call_ = nullptr;
@@ -83,7 +84,8 @@ void Builder::addDebugMsg(std::string_view stream, std::string_view fmt, Express
 }
 
 void Builder::addDebugIndent(std::string_view stream) {
-    if ( ! context()->driver()->options().debug )
+    if ( const auto& options = context()->driver()->options();
+         ! options.debug || options.isDebugStreamDisabled(stream) )
         return;
 
     auto* call_ = call("hilti::debugIndent", {stringLiteral(stream)});
@@ -91,7 +93,8 @@ void Builder::addDebugIndent(std::string_view stream) {
 }
 
 void Builder::addDebugDedent(std::string_view stream) {
-    if ( ! context()->driver()->options().debug )
+    if ( const auto& options = context()->driver()->options();
+         ! options.debug || options.isDebugStreamDisabled(stream) )
         return;
 
     auto* call_ = call("hilti::debugDedent", {stringLiteral(stream)});
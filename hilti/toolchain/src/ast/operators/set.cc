@@ -3,6 +3,7 @@
 #include <hilti/ast/builder/builder.h>
 #include <hilti/ast/types/bool.h>
 #include <hilti/ast/types/integer.h>
+#include <hilti/ast/types/interval.h>
 #include <hilti/ast/types/set.h>
 #include <hilti/ast/types/void.h>
 #include <hilti/base/util.h>
@@ -266,5 +267,74 @@ Removes all elements from the set.
 };
 HILTI_OPERATOR_IMPLEMENTATION(Clear);
 
+class SetExpiration : public BuiltInMemberCall {
+public:
+    Signature signature(Builder* builder) const final {
+        return Signature{
+            .kind = Kind::MemberCall,
+            .self = {parameter::Kind::InOut, builder->typeSet(type::Wildcard())},
+            .member = "set_expiration",
+            .param0 =
+                {
+                    .name = "timeout",
+                    .type = {parameter::Kind::In, builder->typeInterval()},
+                },
+            .param1 =
+                {
+                    .name = "refresh_on_write",
+                    .type = {parameter::Kind::In, builder->typeBool()},
+                    .default_ = builder->expressionCtor(builder->ctorBool(true)),
+                },
+            .param2 =
+                {
+                    .name = "refresh_on_read",
+                    .type = {parameter::Kind::In, builder->typeBool()},
+                    .default_ = builder->expressionCtor(builder->ctorBool(true)),
+                },
+            .param3 =
+                {
+                    .name = "network_time",
+                    .type = {parameter::Kind::In, builder->typeBool()},
+                    .default_ = builder->expressionCtor(builder->ctorBool(false)),
+                },
+            .result = {Constness::Const, builder->typeVoid()},
+            .ns = "set",
+            .doc = R"(
+Enables automatic expiration of the set's elements. An element expires once
+*timeout* has passed since it was added. If *refresh_on_write* is true,
+updating an existing element restarts its timeout; if *refresh_on_read* is
+true, looking it up does so as well. If *network_time* is true, the timeout
+refers to network time as advanced by the host application; otherwise, it
+refers to wall clock time. Expired elements disappear from lookups right
+away, and are removed from the set incrementally as new elements get
+inserted.
+)",
+        };
+    }
+
+    HILTI_OPERATOR(hilti, set::SetExpiration);
+};
+HILTI_OPERATOR_IMPLEMENTATION(SetExpiration);
+
+class NumExpired : public BuiltInMemberCall {
+public:
+    Signature signature(Builder* builder) const final {
+        return Signature{
+            .kind = Kind::MemberCall,
+            .self = {parameter::Kind::In, builder->typeSet(type::Wildcard())},
+            .member = "num_expired",
+            .result = {Constness::Const, builder->typeUnsignedInteger(64)},
+            .ns = "set",
+            .doc = R"(
+Returns the number of elements that have been removed from the set because
+they expired.
+)",
+        };
+    }
+
+    HILTI_OPERATOR(hilti, set::NumExpired);
+};
+HILTI_OPERATOR_IMPLEMENTATION(NumExpired);
+
 } // namespace set
 } // namespace
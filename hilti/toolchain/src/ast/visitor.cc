@@ -22,6 +22,8 @@ void visitor::MutatingVisitorBase::replaceNode(Node* old, Node* new_, const std:
         HILTI_DEBUG(_dbg, util::fmt("%s%s \"%s\" -> null%s", location, old->typename_(), old->printRaw(), msg_))
 
     assert(old->parent());
+    _context->recordModification(old);
+
     if ( new_ && new_->parent() )
         new_->parent()->removeChild(new_);
 
@@ -38,17 +40,20 @@ void visitor::MutatingVisitorBase::recordChange(const Node* old, Node* changed,
 
     HILTI_DEBUG(_dbg, util::fmt("%s%s \"%s\" -> %s \"%s\"%s", location, old->typename_(), old->printRaw(),
                                 changed->typename_(), *changed, msg_))
+    _context->recordModification(old);
     _modified = true;
 }
 
 void visitor::MutatingVisitorBase::recordChange(const Node* old, const std::string& msg) {
     auto location = util::fmt("[%s] ", old->location().dump(true));
     HILTI_DEBUG(_dbg, util::fmt("%s%s \"%s\" -> %s", location, old->typename_(), old->printRaw(), msg))
+    _context->recordModification(old);
     _modified = true;
 }
 
 void visitor::MutatingVisitorBase::recordChange(const std::string& msg) {
     HILTI_DEBUG(_dbg, msg);
+    _context->recordModification(_context->root());
     _modified = true;
 }
 
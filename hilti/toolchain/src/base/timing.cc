@@ -96,4 +96,13 @@ void Manager::summary(std::ostream& out) {
 
     out << "\nTotal time: " << prettyTime(total_time) << "\n";
     out << '\n';
+
+    if ( ! mgr->_counters.empty() ) {
+        out << "=== Counters ===\n\n";
+
+        for ( const auto& [name, n] : mgr->_counters )
+            out << fmt("%12" PRIu64, n) << "   " << name << "\n";
+
+        out << '\n';
+    }
 }
@@ -511,6 +511,27 @@ struct GlobalsVisitor : hilti::visitor::PostOrder {
             auto body = cxx::Block();
             auto cb = cxx::Block();
 
+            if ( f->attributes()->has(attribute::kind::SuspendsOnlyForInput) ) {
+                // If the function's input has been frozen already, it won't
+                // ever need to suspend. We then skip the fiber and run it
+                // directly on the caller's stack.
+                auto args = util::join(util::transform(cxx_func.args, [](auto& x) { return std::string(x.id); }), ", ");
+                auto direct = cxx::Block();
+                auto direct_cb = cxx::Block();
+
+                if ( ! ft->result()->type()->isA<type::Void>() )
+                    direct_cb.addReturn(fmt("%s(%s)", d.id, args));
+                else {
+                    direct_cb.addStatement(fmt("%s(%s)", d.id, args));
+                    direct_cb.addReturn("::hilti::rt::Nothing()");
+                }
+
+                direct.addLambda("cb", "[&](::hilti::rt::resumable::Handle* r) -> ::hilti::rt::any",
+                                 std::move(direct_cb));
+                direct.addReturn("::hilti::rt::Resumable::runDirectly(std::move(cb))");
+                body.addIf(fmt("::hilti::rt::resumable::detail::isInputFrozen(%s)", args), std::move(direct));
+            }
+
             auto outer_args =
                 util::join(util::transform(cxx_func.args,
                                            [](auto& x) {
@@ -838,8 +859,14 @@ cxx::Expression CodeGen::startProfiler(const std::string& name, cxx::Block* bloc
 
     assert(block);
     pushCxxBlock(block);
+    // Intern the tag once at load time so that starting the profiler doesn't need to look up the name.
+    auto tag = cxx::ID(options().cxx_namespace_intern, unit()->cxxModuleID(),
+                       fmt("__profiler_tag_%s", util::toIdentifier(name)));
+    unit()->add(cxx::declaration::Global(tag, "::hilti::rt::profiler::Tag", {},
+                                         cxx::Expression(fmt("::hilti::rt::profiler::tag(\"%s\")", name)), "static"));
+
     auto id = addTmp("profiler", cxx::Type("std::optional<::hilti::rt::Profiler>"));
-    auto stmt = cxx::Expression(fmt("%s = ::hilti::rt::profiler::start(\"%s\")", id, name));
+    auto stmt = cxx::Expression(fmt("%s = ::hilti::rt::profiler::start(%s)", id, tag));
 
     if ( insert_at_front )
         cxxBlock()->addStatementAtFront(stmt);
@@ -76,8 +76,13 @@ struct Visitor : public hilti::visitor::PreOrder {
     }
 
     void operator()(type::List* n) final {
-        if ( dst->type()->isA<type::Set>() )
-            result = fmt("::hilti::rt::Set(%s)", expr);
+        if ( auto* s = dst->type()->tryAs<type::Set>() ) {
+            if ( s->isUnordered() )
+                result = fmt("::hilti::rt::UnorderedSet<%s>(%s)",
+                             cg->compile(s->elementType(), codegen::TypeUsage::Storage), expr);
+            else
+                result = fmt("::hilti::rt::Set(%s)", expr);
+        }
 
         else if ( dst->type()->isA<type::Vector>() ) {
             assert(type::same(n->elementType(), dst->type()->as<type::Vector>()->elementType()));
@@ -143,6 +143,7 @@ struct Visitor : hilti::visitor::PreOrder {
 
         auto k = cg->compile(n->keyType(), codegen::TypeUsage::Storage);
         auto v = cg->compile(n->valueType(), codegen::TypeUsage::Storage);
+        const auto* m = (n->type()->type()->as<type::Map>()->isUnordered() ? "UnorderedMap" : "Map");
 
         if ( const auto size = n->value().size(); size > ThresholdBigContainerCtrUnroll ) {
             auto elems = util::join(node::transform(n->value(),
@@ -158,11 +159,12 @@ struct Visitor : hilti::visitor::PreOrder {
             // other `const` variables which since they are non-locals as well
             // can be referenced without capturing.
             const auto* captures = (cg->cxxBlock() == nullptr) ? "" : "&";
-            result = fmt("[%s]() { auto __xs = ::hilti::rt::Map<%s, %s>(); %s return __xs; }()", captures, k, v, elems);
+            result =
+                fmt("[%s]() { auto __xs = ::hilti::rt::%s<%s, %s>(); %s return __xs; }()", captures, m, k, v, elems);
         }
 
         else
-            result = fmt("::hilti::rt::Map<%s, %s>({%s})", k, v,
+            result = fmt("::hilti::rt::%s<%s, %s>({%s})", m, k, v,
                          util::join(node::transform(n->value(),
                                                     [this](const auto& e) {
                                                         return fmt("{%s, %s}", cg->compile(e->key()),
@@ -239,6 +241,7 @@ struct Visitor : hilti::visitor::PreOrder {
         }
 
         const auto k = cg->compile(n->elementType(), codegen::TypeUsage::Storage);
+        const auto* s = (n->type()->type()->as<type::Set>()->isUnordered() ? "UnorderedSet" : "Set");
 
         if ( const auto size = n->value().size(); size > ThresholdBigContainerCtrUnroll ) {
             auto elems =
@@ -252,12 +255,12 @@ struct Visitor : hilti::visitor::PreOrder {
             // other `const` variables which since they are non-locals as well
             // can be referenced without capturing.
             const auto* captures = (cg->cxxBlock() == nullptr) ? "" : "&";
-            result = fmt("[%s]() { auto __xs = ::hilti::rt::Set<%s>(); %s return __xs; }()", captures, k, elems);
+            result = fmt("[%s]() { auto __xs = ::hilti::rt::%s<%s>(); %s return __xs; }()", captures, s, k, elems);
         }
 
         else
             result =
-                fmt("::hilti::rt::Set<%s>({%s})", k,
+                fmt("::hilti::rt::%s<%s>({%s})", s, k,
                     util::join(node::transform(n->value(), [this](const auto& e) { return fmt("%s", cg->compile(e)); }),
                                ", "));
     }
@@ -35,6 +35,23 @@ struct Visitor : hilti::visitor::PreOrder {
         return fmt("%s %s %s", op0(o), x, op1(o));
     }
 
+    // Compiles integer arithmetic. If the optimizer has proven that the
+    // result cannot overflow, this uses the given runtime function to skip
+    // the checks; otherwise it uses the checked operator `x`.
+    cxx::Expression arithmetic(const expression::ResolvedOperator* o, const std::string& x,
+                               const std::string& unchecked) {
+        if ( ! o->isOverflowSafe() )
+            return binary(o, x);
+
+        std::string t;
+        if ( auto* i = o->result()->type()->tryAs<type::SignedInteger>() )
+            t = fmt("std::int%u_t", i->width());
+        else
+            t = fmt("std::uint%u_t", o->result()->type()->as<type::UnsignedInteger>()->width());
+
+        return fmt("::hilti::rt::integer::%s<%s>(%s, %s)", unchecked, t, op0(o), op1(o));
+    }
+
     auto compileExpressions(const Expressions& exprs) {
         return util::transform(exprs, [&](auto e) { return cg->compile(e); });
     }
@@ -462,6 +479,19 @@ struct Visitor : hilti::visitor::PreOrder {
         result = fmt("%s.clear()", self);
     }
 
+    void operator()(operator_::map::SetExpiration* n) final {
+        auto [self, args] = methodArguments(n);
+        auto clock = fmt("(%s ? ::hilti::rt::expiration::Clock::Network : ::hilti::rt::expiration::Clock::Wall)",
+                         args[3]);
+        result = fmt("%s.setExpiration(::hilti::rt::expiration::Policy{%s, %s, %s, %s})", self, args[0], args[1],
+                     args[2], clock);
+    }
+
+    void operator()(operator_::map::NumExpired* n) final {
+        auto [self, args] = methodArguments(n);
+        result = fmt("::hilti::rt::integer::safe<uint64_t>(%s.numExpired())", self);
+    }
+
     /// Network
 
     void operator()(operator_::network::Equal* n) final { result = binary(n, "=="); }
@@ -638,6 +668,19 @@ struct Visitor : hilti::visitor::PreOrder {
         result = fmt("%s.clear()", self);
     }
 
+    void operator()(operator_::set::SetExpiration* n) final {
+        auto [self, args] = methodArguments(n);
+        auto clock = fmt("(%s ? ::hilti::rt::expiration::Clock::Network : ::hilti::rt::expiration::Clock::Wall)",
+                         args[3]);
+        result = fmt("%s.setExpiration(::hilti::rt::expiration::Policy{%s, %s, %s, %s})", self, args[0], args[1],
+                     args[2], clock);
+    }
+
+    void operator()(operator_::set::NumExpired* n) final {
+        auto [self, args] = methodArguments(n);
+        result = fmt("::hilti::rt::integer::safe<uint64_t>(%s.numExpired())", self);
+    }
+
     /// stream::Iterator
 
     void operator()(operator_::stream::iterator::Deref* n) final { result = {fmt("*%s", op0(n)), Side::LHS}; }
@@ -980,7 +1023,9 @@ struct Visitor : hilti::visitor::PreOrder {
     }
     void operator()(operator_::signed_integer::DecrPostfix* n) final { result = fmt("%s--", op0(n)); }
     void operator()(operator_::signed_integer::DecrPrefix* n) final { result = fmt("--%s", op0(n)); }
-    void operator()(operator_::signed_integer::Difference* n) final { result = fmt("%s - %s", op0(n), op1(n)); }
+    void operator()(operator_::signed_integer::Difference* n) final {
+        result = arithmetic(n, "-", "difference_unchecked");
+    }
     void operator()(operator_::signed_integer::DifferenceAssign* n) final { result = fmt("%s -= %s", op0(n), op1(n)); }
     void operator()(operator_::signed_integer::Division* n) final { result = fmt("%s / %s", op0(n), op1(n)); }
     void operator()(operator_::signed_integer::DivisionAssign* n) final { result = fmt("%s /= %s", op0(n), op1(n)); }
@@ -992,13 +1037,13 @@ struct Visitor : hilti::visitor::PreOrder {
     void operator()(operator_::signed_integer::Lower* n) final { result = fmt("%s < %s", op0(n), op1(n)); }
     void operator()(operator_::signed_integer::LowerEqual* n) final { result = fmt("%s <= %s", op0(n), op1(n)); }
     void operator()(operator_::signed_integer::Modulo* n) final { result = fmt("%s %% %s", op0(n), op1(n)); }
-    void operator()(operator_::signed_integer::Multiple* n) final { result = fmt("%s * %s", op0(n), op1(n)); }
+    void operator()(operator_::signed_integer::Multiple* n) final { result = arithmetic(n, "*", "product_unchecked"); }
     void operator()(operator_::signed_integer::MultipleAssign* n) final { result = fmt("%s *= %s", op0(n), op1(n)); }
     void operator()(operator_::signed_integer::Power* n) final {
         result = fmt("::hilti::rt::pow(%s, %s)", op0(n), op1(n));
     }
     void operator()(operator_::signed_integer::SignNeg* n) final { result = fmt("(-%s)", op0(n)); }
-    void operator()(operator_::signed_integer::Sum* n) final { result = fmt("%s + %s", op0(n), op1(n)); }
+    void operator()(operator_::signed_integer::Sum* n) final { result = arithmetic(n, "+", "sum_unchecked"); }
     void operator()(operator_::signed_integer::SumAssign* n) final { result = fmt("%s += %s", op0(n), op1(n)); }
     void operator()(operator_::signed_integer::Unequal* n) final { result = fmt("%s != %s", op0(n), op1(n)); }
 
@@ -1141,7 +1186,9 @@ struct Visitor : hilti::visitor::PreOrder {
     }
     void operator()(operator_::unsigned_integer::DecrPostfix* n) final { result = fmt("%s--", op0(n)); }
     void operator()(operator_::unsigned_integer::DecrPrefix* n) final { result = fmt("--%s", op0(n)); }
-    void operator()(operator_::unsigned_integer::Difference* n) final { result = fmt("%s - %s", op0(n), op1(n)); }
+    void operator()(operator_::unsigned_integer::Difference* n) final {
+        result = arithmetic(n, "-", "difference_unchecked");
+    }
     void operator()(operator_::unsigned_integer::DifferenceAssign* n) final {
         result = fmt("%s -= %s", op0(n), op1(n));
     }
@@ -1155,7 +1202,9 @@ struct Visitor : hilti::visitor::PreOrder {
     void operator()(operator_::unsigned_integer::Lower* n) final { result = fmt("%s < %s", op0(n), op1(n)); }
     void operator()(operator_::unsigned_integer::LowerEqual* n) final { result = fmt("%s <= %s", op0(n), op1(n)); }
     void operator()(operator_::unsigned_integer::Modulo* n) final { result = fmt("%s %% %s", op0(n), op1(n)); }
-    void operator()(operator_::unsigned_integer::Multiple* n) final { result = fmt("%s * %s", op0(n), op1(n)); }
+    void operator()(operator_::unsigned_integer::Multiple* n) final {
+        result = arithmetic(n, "*", "product_unchecked");
+    }
     void operator()(operator_::unsigned_integer::MultipleAssign* n) final { result = fmt("%s *= %s", op0(n), op1(n)); }
     void operator()(operator_::unsigned_integer::Negate* n) final { result = fmt("~%s", op0(n)); }
     void operator()(operator_::unsigned_integer::Power* n) final {
@@ -1164,7 +1213,7 @@ struct Visitor : hilti::visitor::PreOrder {
     void operator()(operator_::unsigned_integer::ShiftLeft* n) final { result = fmt("(%s << %s)", op0(n), op1(n)); }
     void operator()(operator_::unsigned_integer::ShiftRight* n) final { result = fmt("(%s >> %s)", op0(n), op1(n)); }
     void operator()(operator_::unsigned_integer::SignNeg* n) final { result = fmt("(-%s)", op0(n)); }
-    void operator()(operator_::unsigned_integer::Sum* n) final { result = fmt("%s + %s", op0(n), op1(n)); }
+    void operator()(operator_::unsigned_integer::Sum* n) final { result = arithmetic(n, "+", "sum_unchecked"); }
     void operator()(operator_::unsigned_integer::SumAssign* n) final { result = fmt("%s += %s", op0(n), op1(n)); }
     void operator()(operator_::unsigned_integer::Unequal* n) final { result = fmt("%s != %s", op0(n), op1(n)); }
 
@@ -1,12 +1,33 @@
 // Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
 
+#include <limits>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <hilti/ast/ctors/bytes.h>
+#include <hilti/ast/ctors/coerced.h>
+#include <hilti/ast/ctors/enum.h>
+#include <hilti/ast/ctors/integer.h>
 #include <hilti/ast/ctors/string.h>
+#include <hilti/ast/declarations/constant.h>
 #include <hilti/ast/declarations/local-variable.h>
+#include <hilti/ast/expressions/coerced.h>
 #include <hilti/ast/expressions/ctor.h>
+#include <hilti/ast/expressions/grouping.h>
+#include <hilti/ast/expressions/name.h>
 #include <hilti/ast/statements/all.h>
+#include <hilti/ast/types/bytes.h>
+#include <hilti/ast/types/enum.h>
+#include <hilti/ast/types/integer.h>
+#include <hilti/ast/types/string.h>
 #include <hilti/ast/types/struct.h>
 #include <hilti/base/logger.h>
 #include <hilti/compiler/detail/codegen/codegen.h>
+#include <hilti/compiler/detail/constant-folder.h>
 #include <hilti/compiler/detail/cxx/all.h>
 
 using namespace hilti;
@@ -230,10 +251,300 @@ struct Visitor : hilti::visitor::PreOrder {
         block->addStatement(fmt("__location__(\"%s\")", location));
     }
 
+    // Returns the constant value of a case expression, or null if it's not
+    // a constant we know how to dispatch on.
+    Ctor* caseConstant(Expression* e) {
+        while ( true ) {
+            if ( auto* x = e->tryAs<expression::Coerced>() )
+                e = x->expression();
+
+            else if ( auto* x = e->tryAs<expression::Grouping>() )
+                e = x->expression();
+
+            else if ( auto* x = e->tryAs<expression::Name>() ) {
+                if ( ! x->resolvedDeclarationIndex() )
+                    return nullptr;
+
+                auto* const_ = x->resolvedDeclaration()->tryAs<declaration::Constant>();
+                if ( ! const_ )
+                    return nullptr;
+
+                e = const_->value();
+            }
+
+            else if ( auto* x = e->tryAs<expression::Ctor>() ) {
+                if ( auto* coerced = x->ctor()->tryAs<ctor::Coerced>() )
+                    return coerced->coercedCtor();
+                else
+                    return x->ctor();
+            }
+
+            else if ( auto ctor = constant_folder::fold(cg->builder(), e); ctor && *ctor )
+                return *ctor;
+
+            else
+                return nullptr;
+        }
+    }
+
+    // Returns true if a case body contains a `break` leaving an outer loop,
+    // which a C++ `switch` would capture instead.
+    static bool hasBreak(Statement* body) {
+        for ( auto* n : visitor::range(visitor::PreOrder(), body, {}) ) {
+            if ( ! n->isA<statement::Break>() )
+                continue;
+
+            auto* p = n->parent();
+            while ( p && p != body && ! p->isA<statement::While>() && ! p->isA<statement::For>() )
+                p = p->parent();
+
+            if ( p == body || ! p )
+                return true;
+        }
+
+        return false;
+    }
+
+    // Compiles a switch statement over integers or enums into a native C++
+    // `switch`, if all its cases are constants. Returns false if not
+    // possible, without generating any code.
+    bool compileIntegerSwitch(statement::Switch* n, const cxx::ID& cxx_id, cxx::Block* wrapper) {
+        auto* t = n->condition()->type()->type();
+
+        std::string cast;
+        if ( t->isA<type::SignedInteger>() )
+            cast = fmt("static_cast<int64_t>(%s)", cxx_id);
+        else if ( t->isA<type::UnsignedInteger>() )
+            cast = fmt("static_cast<uint64_t>(%s)", cxx_id);
+        else if ( t->isA<type::Enum>() )
+            cast = fmt("%s.value()", cxx_id);
+        else
+            return false;
+
+        auto is_signed = ! t->isA<type::UnsignedInteger>();
+
+        // Collect labels first, so that we don't generate any code if we
+        // need to bail out. A value appearing multiple times belongs to the
+        // first case listing it, as with an if-else chain.
+        std::vector<std::pair<std::vector<cxx::Expression>, statement::switch_::Case*>> cases;
+        std::set<uint64_t> seen; // values as seen by the C++ switch, which are all signed or all unsigned
+
+        for ( const auto& c : n->cases() ) {
+            // This includes the default case, which ends up inside the C++
+            // `switch` as well.
+            if ( hasBreak(c->body()) )
+                return false;
+
+            if ( c->isDefault() )
+                continue;
+
+            std::vector<cxx::Expression> labels;
+
+            for ( auto* e : c->expressions() ) {
+                auto* ctor = caseConstant(e);
+                if ( ! ctor )
+                    return false;
+
+                std::string label;
+                uint64_t value = 0;
+
+                if ( auto* x = ctor->tryAs<ctor::SignedInteger>() ) {
+                    if ( ! is_signed && x->value() < 0 )
+                        return false;
+
+                    if ( x->value() == std::numeric_limits<int64_t>::min() )
+                        label = "std::numeric_limits<int64_t>::min()";
+                    else
+                        label = fmt("%d", x->value());
+
+                    value = static_cast<uint64_t>(x->value());
+                }
+
+                else if ( auto* x = ctor->tryAs<ctor::UnsignedInteger>() ) {
+                    if ( is_signed && x->value() > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) )
+                        return false;
+
+                    label = fmt("%dU", x->value());
+                    value = x->value();
+                }
+
+                else if ( auto* x = ctor->tryAs<ctor::Enum>() ) {
+                    label = fmt("%d", x->value()->value());
+                    value = static_cast<uint64_t>(x->value()->value());
+                }
+
+                else
+                    return false;
+
+                if ( ! seen.insert(value).second )
+                    continue;
+
+                labels.emplace_back(std::move(label));
+            }
+
+            if ( ! labels.empty() )
+                cases.emplace_back(std::move(labels), c);
+        }
+
+        std::vector<std::pair<std::vector<cxx::Expression>, cxx::Block>> cxx_cases;
+
+        for ( auto& [labels, c] : cases ) {
+            auto body = cg->compile(c->body());
+            body.addStatement("break");
+            cxx_cases.emplace_back(std::move(labels), std::move(body));
+        }
+
+        wrapper->addSwitch(cast, cxx_cases, defaultCase(n, std::string(cxx_id)));
+        return true;
+    }
+
+    // Compiles a switch statement over bytes or strings into a dispatch on
+    // the value's length, followed by a perfect hash on a single character
+    // position where possible, if all its cases are constants. Returns false
+    // if not possible, without generating any code.
+    bool compileStringSwitch(statement::Switch* n, const cxx::ID& cxx_id, cxx::Block* wrapper) {
+        auto* t = n->condition()->type()->type();
+
+        std::string data;
+        if ( t->isA<type::Bytes>() )
+            data = fmt("%s.str()", cxx_id);
+        else if ( t->isA<type::String>() )
+            data = std::string(cxx_id);
+        else
+            return false;
+
+        // Our locals share their scope with the case bodies, so derive their
+        // names from the condition's ID to keep them from clashing with IDs
+        // that the bodies use (e.g., Spicy's `__data`).
+        auto data_id = cxx::ID(fmt("__switch_data_%s", cxx_id));
+        auto case_id = cxx::ID(fmt("__switch_case_%s", cxx_id));
+
+        // Maps each length to the values of that length, along with the index of their case.
+        std::map<size_t, std::vector<std::pair<std::string, size_t>>> by_length;
+        std::set<std::string> seen;
+        std::vector<statement::switch_::Case*> cases;
+
+        for ( const auto& c : n->cases() ) {
+            // This includes the default case, which ends up inside the C++
+            // `switch` as well.
+            if ( hasBreak(c->body()) )
+                return false;
+
+            if ( c->isDefault() )
+                continue;
+
+            bool used = false;
+
+            for ( auto* e : c->expressions() ) {
+                auto* ctor = caseConstant(e);
+                if ( ! ctor )
+                    return false;
+
+                std::string value;
+
+                if ( auto* x = ctor->tryAs<ctor::Bytes>() )
+                    value = x->value();
+                else if ( auto* x = ctor->tryAs<ctor::String>() )
+                    value = x->value();
+                else
+                    return false;
+
+                if ( ! seen.insert(value).second )
+                    continue;
+
+                by_length[value.size()].emplace_back(value, cases.size());
+                used = true;
+            }
+
+            if ( used )
+                cases.emplace_back(c);
+        }
+
+        auto match = [&](const std::string& value, size_t idx) {
+            auto b = cxx::Block();
+            b.addIf(fmt(R"(%s == std::string_view("%s", %zu))", data_id, util::escapeBytesForCxx(value),
+                        value.size()),
+                    cxx::Block({fmt("%s = %zu", case_id, idx)}));
+            return b;
+        };
+
+        std::vector<std::pair<cxx::Expression, cxx::Block>> length_cases;
+
+        for ( const auto& [len, values] : by_length ) {
+            auto b = cxx::Block();
+
+            if ( len == 0 )
+                // Length alone determines the value.
+                b.addStatement(fmt("%s = %zu", case_id, values.front().second));
+
+            else if ( values.size() == 1 )
+                b.appendFromBlock(match(values.front().first, values.front().second));
+
+            else {
+                // Look for a position where all values differ, so that the
+                // character there identifies the only candidate.
+                std::optional<size_t> pos;
+
+                for ( size_t i = 0; i < len && ! pos; i++ ) {
+                    std::set<char> chars;
+                    for ( const auto& [value, idx] : values )
+                        chars.insert(value[i]);
+
+                    if ( chars.size() == values.size() )
+                        pos = i;
+                }
+
+                if ( pos ) {
+                    std::vector<std::pair<cxx::Expression, cxx::Block>> char_cases;
+
+                    for ( const auto& [value, idx] : values ) {
+                        auto m = match(value, idx);
+                        m.addStatement("break");
+                        char_cases.emplace_back(fmt("%u", static_cast<unsigned char>(value[*pos])), std::move(m));
+                    }
+
+                    b.addSwitch(fmt("static_cast<unsigned char>(%s[%zu])", data_id, *pos), char_cases);
+                }
+                else {
+                    for ( const auto& [value, idx] : values )
+                        b.appendFromBlock(match(value, idx));
+                }
+            }
+
+            b.addStatement("break");
+            length_cases.emplace_back(fmt("%zu", len), std::move(b));
+        }
+
+        std::vector<std::pair<cxx::Expression, cxx::Block>> cxx_cases;
+
+        for ( const auto&& [idx, c] : util::enumerate(cases) ) {
+            auto body = cg->compile(c->body());
+            body.addStatement("break");
+            cxx_cases.emplace_back(fmt("%zu", idx), std::move(body));
+        }
+
+        wrapper->addLocal({data_id, "const std::string_view", {}, fmt("std::string_view(%s)", data)});
+        wrapper->addLocal({case_id, "size_t", {}, "std::numeric_limits<size_t>::max()"});
+        wrapper->addSwitch(fmt("%s.size()", data_id), length_cases);
+        wrapper->addSwitch(std::string(case_id), cxx_cases, defaultCase(n, std::string(cxx_id)));
+        return true;
+    }
+
+    // Returns the code for the default case of a switch statement.
+    cxx::Block defaultCase(statement::Switch* n, const cxx::Expression& value) {
+        cxx::Block default_;
+
+        if ( auto* d = n->default_() )
+            default_ = cg->compile(d->body());
+        else
+            default_.addStatement(
+                fmt("throw ::hilti::rt::UnhandledSwitchCase(::hilti::rt::to_string_for_print(%s), \"%s\")", value,
+                    n->meta().location()));
+
+        return default_;
+    }
+
     void operator()(statement::Switch* n) final {
-        // TODO(robin): We generate if-else chain here. We could optimize the case
-        // where all expressions are integers and go with a "real" switch in
-        // that case.
         cxx::ID cxx_id;
         std::string cxx_type;
         std::string cxx_init;
@@ -243,6 +554,17 @@ struct Visitor : hilti::visitor::PreOrder {
         cxx_id = cxx::ID(cond->id());
         cxx_init = cg->compile(cond->init());
 
+        // If all cases are constants, we can dispatch through a native C++
+        // `switch` instead of an if-else chain.
+        auto wrapper = cxx::Block();
+        wrapper.addLocal({cxx_id, cxx_type, {}, cxx_init});
+
+        if ( compileIntegerSwitch(n, cxx_id, &wrapper) || compileStringSwitch(n, cxx_id, &wrapper) ) {
+            wrapper.setEnsureBracesforBlock();
+            block->addBlock(std::move(wrapper));
+            return;
+        }
+
         bool first = true;
         for ( const auto& c : n->cases() ) {
             if ( c->isDefault() )
@@ -267,14 +589,7 @@ struct Visitor : hilti::visitor::PreOrder {
                 block->addElseIf(std::move(cond), std::move(body));
         }
 
-        cxx::Block default_;
-
-        if ( auto* d = n->default_() )
-            default_ = cg->compile(d->body());
-        else
-            default_.addStatement(
-                fmt("throw ::hilti::rt::UnhandledSwitchCase(::hilti::rt::to_string_for_print(%s), \"%s\")",
-                    (first ? std::move(cxx_init) : std::move(cxx_id)), n->meta().location()));
+        auto default_ = defaultCase(n, (first ? cxx_init : std::string(cxx_id)));
 
         if ( first )
             block->addBlock(std::move(default_));
@@ -473,7 +473,7 @@ struct VisitorStorage : hilti::visitor::PreOrder {
         auto k = cg->compile(n->keyType(), codegen::TypeUsage::Storage);
         auto v = cg->compile(n->valueType(), codegen::TypeUsage::Storage);
 
-        auto t = fmt("::hilti::rt::Map<%s, %s>::%s", k, v, i);
+        auto t = fmt("::hilti::rt::%s<%s, %s>::%s", (n->isUnordered() ? "UnorderedMap" : "Map"), k, v, i);
         result = CxxTypes{.base_type = fmt("%s", t)};
     }
 
@@ -481,7 +481,7 @@ struct VisitorStorage : hilti::visitor::PreOrder {
         const auto* i = (n->dereferencedType()->isConstant() ? "const_iterator" : "iterator");
         auto x = cg->compile(n->dereferencedType(), codegen::TypeUsage::Storage);
 
-        auto t = fmt("::hilti::rt::Set<%s>::%s", x, i);
+        auto t = fmt("::hilti::rt::%s<%s>::%s", (n->isUnordered() ? "UnorderedSet" : "Set"), x, i);
         result = CxxTypes{.base_type = fmt("%s", t)};
     }
 
@@ -515,7 +515,7 @@ struct VisitorStorage : hilti::visitor::PreOrder {
         else {
             auto k = cg->compile(n->keyType(), codegen::TypeUsage::Storage);
             auto v = cg->compile(n->elementType(), codegen::TypeUsage::Storage);
-            t = fmt("::hilti::rt::Map<%s, %s>", k, v);
+            t = fmt("::hilti::rt::%s<%s, %s>", (n->isUnordered() ? "UnorderedMap" : "Map"), k, v);
         }
 
         result = CxxTypes{.base_type = fmt("%s", t)};
@@ -551,7 +551,7 @@ struct VisitorStorage : hilti::visitor::PreOrder {
             t = "::hilti::rt::set::Empty";
         else {
             auto x = cg->compile(n->elementType(), codegen::TypeUsage::Storage);
-            t = fmt("::hilti::rt::Set<%s>", x);
+            t = fmt("::hilti::rt::%s<%s>", (n->isUnordered() ? "UnorderedSet" : "Set"), x);
         }
 
         result = CxxTypes{.base_type = fmt("%s", t)};
@@ -860,18 +860,19 @@ struct VisitorTypeInfoDynamic : hilti::visitor::PreOrder {
     void operator()(type::Map* n) final {
         auto ktype = cg->compile(n->keyType(), codegen::TypeUsage::Storage);
         auto vtype = cg->compile(n->elementType(), codegen::TypeUsage::Storage);
-        result = fmt("::hilti::rt::type_info::Map(%s, %s, ::hilti::rt::type_info::Map::accessor<%s, %s>())",
+        result = fmt("::hilti::rt::type_info::Map(%s, %s, ::hilti::rt::type_info::Map::accessor<%s, %s%s>())",
                      cg->typeInfo(n->keyType()), cg->typeInfo(n->elementType()),
                      cg->compile(n->keyType(), codegen::TypeUsage::Storage),
-                     cg->compile(n->elementType(), codegen::TypeUsage::Storage));
+                     cg->compile(n->elementType(), codegen::TypeUsage::Storage), (n->isUnordered() ? ", true" : ""));
     }
 
     void operator()(type::map::Iterator* n) final {
         result =
-            fmt("::hilti::rt::type_info::MapIterator(%s, %s, ::hilti::rt::type_info::MapIterator::accessor<%s, %s>())",
+            fmt("::hilti::rt::type_info::MapIterator(%s, %s, "
+                "::hilti::rt::type_info::MapIterator::accessor<%s, %s%s>())",
                 cg->typeInfo(n->keyType()), cg->typeInfo(n->valueType()),
                 cg->compile(n->keyType(), codegen::TypeUsage::Storage),
-                cg->compile(n->valueType(), codegen::TypeUsage::Storage));
+                cg->compile(n->valueType(), codegen::TypeUsage::Storage), (n->isUnordered() ? ", true" : ""));
     }
 
     void operator()(type::Optional* n) final {
@@ -890,14 +891,16 @@ struct VisitorTypeInfoDynamic : hilti::visitor::PreOrder {
     }
 
     void operator()(type::Set* n) final {
-        result = fmt("::hilti::rt::type_info::Set(%s, ::hilti::rt::type_info::Set::accessor<%s>())",
-                     cg->typeInfo(n->elementType()), cg->compile(n->elementType(), codegen::TypeUsage::Storage));
+        result = fmt("::hilti::rt::type_info::Set(%s, ::hilti::rt::type_info::Set::accessor<%s%s>())",
+                     cg->typeInfo(n->elementType()), cg->compile(n->elementType(), codegen::TypeUsage::Storage),
+                     (n->isUnordered() ? ", true" : ""));
     }
 
     void operator()(type::set::Iterator* n) final {
         result =
-            fmt("::hilti::rt::type_info::SetIterator(%s, ::hilti::rt::type_info::SetIterator::accessor<%s>())",
-                cg->typeInfo(n->dereferencedType()), cg->compile(n->dereferencedType(), codegen::TypeUsage::Storage));
+            fmt("::hilti::rt::type_info::SetIterator(%s, ::hilti::rt::type_info::SetIterator::accessor<%s%s>())",
+                cg->typeInfo(n->dereferencedType()), cg->compile(n->dereferencedType(), codegen::TypeUsage::Storage),
+                (n->isUnordered() ? ", true" : ""));
     }
 
     void operator()(type::Struct* n) final {
@@ -60,7 +60,9 @@ struct VisitorCtor : visitor::PreOrder {
                     return;
             }
 
-            result = builder->ctorMap(t->keyType(), t->elementType(), std::move(nelemns), n->meta());
+            auto* m = builder->ctorMap(t->keyType(), t->elementType(), std::move(nelemns), n->meta());
+            m->type()->type()->as<type::Map>()->setUnordered(t->isUnordered());
+            result = m;
         }
     }
 
@@ -122,7 +124,9 @@ struct VisitorCtor : visitor::PreOrder {
                 else
                     return;
             }
-            result = builder->ctorSet(dt, std::move(nexprs), n->meta());
+            auto* s = builder->ctorSet(dt, std::move(nexprs), n->meta());
+            s->type()->type()->as<type::Set>()->setUnordered(t->isUnordered());
+            result = s;
         }
     }
 
@@ -190,7 +194,9 @@ struct VisitorCtor : visitor::PreOrder {
                 else
                     return;
             }
-            result = builder->ctorSet(t->elementType(), std::move(nexprs), n->meta());
+            auto* s = builder->ctorSet(t->elementType(), std::move(nexprs), n->meta());
+            s->type()->type()->as<type::Set>()->setUnordered(t->isUnordered());
+            result = s;
         }
     }
 
@@ -1,5 +1,7 @@
 // Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
 
+#include <algorithm>
+
 #include <hilti/ast/ast-context.h>
 #include <hilti/ast/operator-registry.h>
 #include <hilti/compiler/context.h>
@@ -31,6 +33,11 @@ Result<Nothing> Options::parseDebugAddl(const std::string& flags) {
     return Nothing();
 }
 
+bool Options::isDebugStreamDisabled(std::string_view stream) const {
+    return std::find(disabled_debug_streams.begin(), disabled_debug_streams.end(), stream) !=
+           disabled_debug_streams.end();
+}
+
 void Options::print(std::ostream& out) const {
     auto print_one = [&](const char* label, const auto& x) { out << util::fmt("  %25s   %s", label, x) << std::endl; };
     auto print_list = [&](const char* label, const auto& x) {
@@ -49,12 +56,14 @@ void Options::print(std::ostream& out) const {
     print_one("debug", debug);
     print_one("debug_trace", debug_trace);
     print_one("debug_flow", debug_flow);
+    print_list("disabled_debug_streams", disabled_debug_streams);
     print_one("track_location", track_location);
     print_one("skip_validation", skip_validation);
     print_list("addl library_paths", library_paths);
     print_one("cxx_namespace_extern", cxx_namespace_extern);
     print_one("cxx_namespace_intern", cxx_namespace_intern);
     print_list("addl cxx_include_paths", cxx_include_paths);
+    print_one("cxx_split_units", cxx_split_units);
 
     out << "\n";
 }
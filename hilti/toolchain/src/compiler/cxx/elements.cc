@@ -312,6 +312,23 @@ void cxx::Block::addSwitch(const Expression& cond, const std::vector<std::pair<E
 
     _stmts.emplace_back(fmt("switch ( %s )", cond), std::move(x), flags::AddSeparatorAfter);
 }
+
+void cxx::Block::addSwitch(const Expression& cond,
+                           const std::vector<std::pair<std::vector<Expression>, Block>>& cases_,
+                           std::optional<Block> default_) {
+    auto x = Block();
+
+    for ( const auto& c : cases_ ) {
+        auto labels = util::join(util::transform(c.first, [](const auto& l) { return fmt("case %s:", l); }), " ");
+        x._stmts.emplace_back(std::move(labels), c.second, 0);
+    }
+
+    if ( default_ )
+        x._stmts.emplace_back("default:", *default_, 0);
+
+    _stmts.emplace_back(fmt("switch ( %s )", cond), std::move(x), flags::AddSeparatorAfter);
+}
+
 void cxx::Block::addTry(Block body, std::vector<std::pair<declaration::Argument, Block>> catches) {
     body.setEnsureBracesforBlock();
     _stmts.emplace_back("try", std::move(body), flags::NoSeparator);
@@ -1,6 +1,9 @@
 // Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
 
+#include <algorithm>
+#include <numeric>
 #include <utility>
+#include <vector>
 
 #include <hilti/base/logger.h>
 #include <hilti/base/util.h>
@@ -89,16 +92,17 @@ void Unit::_addModuleInitFunction() {
 }
 
 void Unit::_emitDeclarations(const cxxDeclaration& decl, Formatter& f, Phase phase, bool prototypes_only,
-                             bool include_all_implementations) {
+                             bool include_all_implementations, bool shard) {
     struct Visitor {
         Visitor(Context* ctx, Unit* unit, Formatter& f, Phase phase, bool prototypes_only,
-                bool include_all_implementations)
+                bool include_all_implementations, bool shard)
             : ctx(ctx),
               unit(unit),
               f(f),
               phase(phase),
               prototypes_only(prototypes_only),
-              include_all_implementations(include_all_implementations) {}
+              include_all_implementations(include_all_implementations),
+              shard(shard) {}
 
         Context* ctx;
         Unit* unit;
@@ -106,11 +110,18 @@ void Unit::_emitDeclarations(const cxxDeclaration& decl, Formatter& f, Phase pha
         Phase phase;
         bool prototypes_only;
         bool include_all_implementations;
+        bool shard;
 
         bool isTypeInfo(const cxx::ID& id) {
             return id.namespace_() == cxx::ID(ctx->options().cxx_namespace_intern, "type_info::");
         }
 
+        // When splitting the unit, definitions that the unit would normally
+        // keep private must become accessible from the other C++ files.
+        bool needsExternalLinkage(const Linkage& linkage) {
+            return unit->_split && ! prototypes_only && (! linkage || linkage == "static");
+        }
+
         void operator()(const declaration::IncludeFile& d) {
             if ( phase == Phase::Includes )
                 f << d;
@@ -118,7 +129,22 @@ void Unit::_emitDeclarations(const cxxDeclaration& decl, Formatter& f, Phase pha
 
         void operator()(const declaration::Global& d) {
             if ( phase == Phase::Globals ) {
-                f << d;
+                if ( needsExternalLinkage(d.linkage) ) {
+                    auto x = d;
+
+                    if ( shard ) {
+                        // Just reference the primary file's instance.
+                        x.linkage = "extern";
+                        x.args.clear();
+                        x.init.reset();
+                    }
+                    else
+                        x.linkage = "";
+
+                    f << x;
+                }
+                else
+                    f << d;
             }
         }
 
@@ -127,7 +153,16 @@ void Unit::_emitDeclarations(const cxxDeclaration& decl, Formatter& f, Phase pha
                 if ( phase == Phase::TypeInfos ) {
                     // We split these out because creating the type information
                     // needs access to all other types.
-                    f << d;
+                    if ( shard && d.init ) {
+                        // Just reference the primary file's instance.
+                        auto x = d;
+                        x.linkage = "extern";
+                        x.init.reset();
+                        f << x;
+                    }
+                    else
+                        f << d;
+
                     return;
                 }
             }
@@ -167,7 +202,7 @@ void Unit::_emitDeclarations(const cxxDeclaration& decl, Formatter& f, Phase pha
             }
 
             else if ( phase == Phase::Functions ) {
-                if ( d.code.size() && ! prototypes_only ) {
+                if ( d.code.size() && ! prototypes_only && ! shard ) {
                     f << d.code << eol();
                 }
             }
@@ -181,28 +216,48 @@ void Unit::_emitDeclarations(const cxxDeclaration& decl, Formatter& f, Phase pha
 
                 auto x = d;
                 x.body.reset(); // just output the header
+
+                if ( d.linkage == "static" && ! d.inline_body && needsExternalLinkage(d.linkage) )
+                    x.linkage = "extern"; // may be implemented in a different file
+
                 f << x;
             }
-            else if ( phase == Phase::Implementations ) {
+            else if ( phase == Phase::Implementations || phase == Phase::SplitImplementations ) {
                 if ( ! d.body )
                     return;
 
-                if ( include_all_implementations || d.id.sub(0, 2) == unit->cxxInternalNamespace() ||
-                     d.id.sub(0, 2) == unit->cxxExternalNamespace() || d.linkage == "inline" )
+                if ( ! (include_all_implementations || d.id.sub(0, 2) == unit->cxxInternalNamespace() ||
+                        d.id.sub(0, 2) == unit->cxxExternalNamespace() || d.linkage == "inline") )
+                    return;
+
+                // If splitting, inline functions need to go into all files
+                // using them, everything else gets distributed.
+                auto split = (unit->_split && d.linkage != "inline");
+
+                if ( phase == Phase::Implementations && ! split )
                     f << separator() << d;
+
+                else if ( phase == Phase::SplitImplementations && split ) {
+                    auto x = d;
+
+                    if ( x.linkage == "static" )
+                        x.linkage = "extern";
+
+                    f << separator() << x;
+                }
             }
         }
     };
 
-    std::visit(Visitor(context().get(), this, f, phase, prototypes_only, include_all_implementations), decl);
+    std::visit(Visitor(context().get(), this, f, phase, prototypes_only, include_all_implementations, shard), decl);
 }
 
-void Unit::_generateCode(Formatter& f, bool prototypes_only, bool include_all_implementations) {
+void Unit::_generateCode(Formatter& f, bool prototypes_only, bool include_all_implementations, bool shard) {
     const Phase phases[] = {Phase::Forwards,      Phase::Enums,   Phase::Types,     Phase::Constants,
                             Phase::PublicAliases, Phase::Globals, Phase::Functions, Phase::TypeInfos};
 
     for ( const auto& [_, decl] : _declarations )
-        _emitDeclarations(decl, f, Phase::Includes, prototypes_only, include_all_implementations);
+        _emitDeclarations(decl, f, Phase::Includes, prototypes_only, include_all_implementations, shard);
 
     // First output all declarations that are not in a namespace. These should
     // be only low-level, internal stuff that doesn't require further
@@ -210,7 +265,7 @@ void Unit::_generateCode(Formatter& f, bool prototypes_only, bool include_all_im
     for ( auto phase : phases ) {
         for ( const auto& [id, decl] : _declarations ) {
             if ( ! id.namespace_() )
-                _emitDeclarations(decl, f, phase, prototypes_only, include_all_implementations);
+                _emitDeclarations(decl, f, phase, prototypes_only, include_all_implementations, shard);
         }
     }
 
@@ -220,7 +275,7 @@ void Unit::_generateCode(Formatter& f, bool prototypes_only, bool include_all_im
     for ( auto phase : phases ) {
         for ( const auto& [id, decl] : _declarations )
             if ( id.namespace_() )
-                _emitDeclarations(decl, f, phase, prototypes_only, include_all_implementations);
+                _emitDeclarations(decl, f, phase, prototypes_only, include_all_implementations, shard);
     }
 
     f.leaveNamespace();
@@ -228,14 +283,65 @@ void Unit::_generateCode(Formatter& f, bool prototypes_only, bool include_all_im
     if ( prototypes_only )
         return;
 
-    for ( const auto& s : _statements )
-        f.printString(s + "\n");
+    if ( ! shard ) {
+        for ( const auto& s : _statements )
+            f.printString(s + "\n");
 
-    if ( _statements.size() )
-        f << separator();
+        if ( _statements.size() )
+            f << separator();
+    }
 
     for ( const auto& [id_, decl] : _declarations_by_id ) // iterate by ID to sort them alphabetically
-        _emitDeclarations(decl, f, Phase::Implementations, prototypes_only, include_all_implementations);
+        _emitDeclarations(decl, f, Phase::Implementations, prototypes_only, include_all_implementations, shard);
+}
+
+void Unit::_splitImplementations(const std::string& prelude, bool include_all_implementations) {
+    std::vector<std::string> impls;
+
+    for ( const auto& [id_, decl] : _declarations_by_id ) { // iterate by ID to sort them alphabetically
+        auto f = Formatter();
+        _emitDeclarations(decl, f, Phase::SplitImplementations, false, include_all_implementations);
+
+        if ( auto impl = f.str(); ! impl.empty() )
+            impls.emplace_back(std::move(impl));
+    }
+
+    // Distribute the implementations across the files, always adding the
+    // next largest one to the file that's currently smallest. The primary
+    // file (index 0) starts out with the code it already has.
+    auto num_files = std::min<size_t>(context()->options().cxx_split_units, impls.size() + 1);
+    std::vector<size_t> sizes(num_files, 0);
+    std::vector<std::vector<size_t>> files(num_files);
+
+    if ( _cxx_code->size() > prelude.size() )
+        sizes[0] = _cxx_code->size() - prelude.size();
+
+    std::vector<size_t> order(impls.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](auto a, auto b) { return impls[a].size() > impls[b].size(); });
+
+    for ( auto i : order ) {
+        auto n = std::min_element(sizes.begin(), sizes.end()) - sizes.begin();
+        sizes[n] += impls[i].size();
+        files[n].push_back(i);
+    }
+
+    for ( size_t n = 0; n < files.size(); n++ ) {
+        auto& indices = files[n];
+
+        // Retain the alphabetical order inside each file.
+        std::sort(indices.begin(), indices.end());
+
+        std::string code = (n == 0 ? std::string() : prelude);
+
+        for ( auto i : indices )
+            code += impls[i];
+
+        if ( n == 0 )
+            *_cxx_code += code;
+        else if ( ! indices.empty() )
+            _cxx_shards.emplace_back(std::move(code));
+    }
 }
 
 hilti::Result<hilti::Nothing> Unit::finalize(bool include_all_implementations) {
@@ -257,8 +363,19 @@ hilti::Result<hilti::Nothing> Unit::finalize(bool include_all_implementations) {
         f << separator();
     }
 
+    // Units created from existing code, like the linker's, are never split.
+    _split = (_module && context()->options().cxx_split_units > 1);
+
     _generateCode(f, false, include_all_implementations);
     _cxx_code = f.str();
+
+    if ( _split ) {
+        auto prelude = Formatter();
+        _addHeader(prelude);
+        _generateCode(prelude, false, include_all_implementations, true);
+        _splitImplementations(prelude.str(), include_all_implementations);
+    }
+
     return Nothing();
 }
 
@@ -270,6 +387,14 @@ hilti::Result<hilti::Nothing> Unit::print(std::ostream& out) const {
     return Nothing();
 }
 
+hilti::Result<hilti::Nothing> Unit::printShard(size_t i, std::ostream& out) const {
+    if ( i >= _cxx_shards.size() )
+        return result::Error("unit does not have the requested C++ shard");
+
+    out << _cxx_shards[i];
+    return Nothing();
+}
+
 hilti::Result<hilti::Nothing> Unit::createPrototypes(std::ostream& out) {
     if ( ! (_module_id && _cxx_code) )
         return result::Error("cannot generate prototypes for module");
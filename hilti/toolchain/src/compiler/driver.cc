@@ -3,6 +3,7 @@
 #include <dlfcn.h>
 #include <getopt.h>
 
+#include <cinttypes>
 #include <exception>
 #include <fstream>
 #include <iostream>
@@ -33,6 +34,12 @@ inline const DebugStream Driver("driver");
 constexpr int OptCxxLink = 1000;
 constexpr int OptCxxEnableDynamicGlobals = 1001;
 constexpr int OptSkipStdImports = 1002;
+constexpr int OptJitCache = 1003;
+constexpr int OptDisableDebugStreams = 1004;
+constexpr int OptCxxSplitUnits = 1005;
+constexpr int OptPgoGenerate = 1006;
+constexpr int OptPgoUse = 1007;
+constexpr int OptLto = 1008;
 
 static struct option long_driver_options[] = {{"abort-on-exceptions", required_argument, nullptr, 'A'},
                                               {"show-backtraces", no_argument, nullptr, 'B'},
@@ -40,22 +47,29 @@ static struct option long_driver_options[] = {{"abort-on-exceptions", required_a
                                               {"cxx-enable-dynamic-globals", no_argument, nullptr,
                                                OptCxxEnableDynamicGlobals},
                                               {"cxx-link", required_argument, nullptr, OptCxxLink},
+                                              {"cxx-split-units", required_argument, nullptr, OptCxxSplitUnits},
                                               {"debug", no_argument, nullptr, 'd'},
                                               {"debug-addl", required_argument, nullptr, 'X'},
+                                              {"disable-debug-streams", required_argument, nullptr,
+                                               OptDisableDebugStreams},
                                               {"disable-optimizations", no_argument, nullptr, 'g'},
                                               {"enable-profiling", no_argument, nullptr, 'Z'},
                                               {"dump-code", no_argument, nullptr, 'C'},
                                               {"help", no_argument, nullptr, 'h'},
                                               {"keep-tmps", no_argument, nullptr, 'T'},
                                               {"library-path", required_argument, nullptr, 'L'},
+                                              {"lto", no_argument, nullptr, OptLto},
                                               {"output", required_argument, nullptr, 'o'},
                                               {"output-c++", no_argument, nullptr, 'c'},
                                               {"output-c++-files", no_argument, nullptr, 'x'},
                                               {"output-hilti", no_argument, nullptr, 'p'},
                                               {"execute-code", no_argument, nullptr, 'j'},
+                                              {"jit-cache", required_argument, nullptr, OptJitCache},
                                               {"output-linker", no_argument, nullptr, 'l'},
                                               {"output-prototypes", required_argument, nullptr, 'P'},
                                               {"output-all-dependencies", no_argument, nullptr, 'e'},
+                                              {"pgo-generate", required_argument, nullptr, OptPgoGenerate},
+                                              {"pgo-use", required_argument, nullptr, OptPgoUse},
                                               {"output-code-dependencies", no_argument, nullptr, 'E'},
                                               {"report-times", required_argument, nullptr, 'R'},
                                               {"skip-validation", no_argument, nullptr, 'V'},
@@ -130,6 +144,15 @@ void Driver::usage() {
            "  -Z | --enable-profiling           Report profiling statistics after execution.\n"
            "       --cxx-link <lib>             Link specified static archive or shared library during JIT or to "
            "produced HLTO file. Can be given multiple times.\n"
+           "       --cxx-split-units <n>        Spread each module's generated C++ code across <n> files to compile "
+           "them in parallel.\n"
+           "       --disable-debug-streams <streams>  Do not generate debug output for the given runtime debug streams "
+           "(colon-separated).\n"
+           "       --jit-cache <dir>            Cache compiled code in <dir> to reuse it across runs.\n"
+           "       --lto                        Link compiled code with link-time optimization against the runtime "
+           "library.\n"
+           "       --pgo-generate <dir>         Instrument compiled code to record execution profiles into <dir>.\n"
+           "       --pgo-use <dir>              Optimize compiled code using execution profiles recorded into <dir>.\n"
            "       --skip-standard-imports      Do not automatically import standard library modules (for debugging "
            "only).\n"
         << addl_usage
@@ -250,6 +273,17 @@ void Driver::dumpUnit(const Unit& unit) {
             HILTI_DEBUG(logging::debug::Driver, fmt("saving C++ code for module %s to %s", id, output_path));
             cxx->save(*out);
         }
+
+        if ( auto shards = unit.cxxCodeShards() ) {
+            for ( const auto& shard : *shards ) {
+                auto output_path = util::fmt("dbg.%s.cc", shard.id());
+                if ( auto out = openOutput(output_path) ) {
+                    HILTI_DEBUG(logging::debug::Driver,
+                                fmt("saving C++ code for module %s to %s", shard.id(), output_path));
+                    shard.save(*out);
+                }
+            }
+        }
     }
 }
 
@@ -427,8 +461,31 @@ Result<Nothing> Driver::parseOptions(int argc, char** argv) {
 
             case OptCxxEnableDynamicGlobals: _compiler_options.cxx_enable_dynamic_globals = true; break;
 
+            case OptCxxSplitUnits: {
+                bool valid = true;
+                auto n = util::charsToUInt64(optarg, 10, [&]() { valid = false; });
+                if ( ! valid || n == 0 )
+                    return error(fmt("expected positive integer for --cxx-split-units, but received '%s'", optarg));
+
+                _compiler_options.cxx_split_units = n;
+                break;
+            }
+
             case OptSkipStdImports: _compiler_options.import_standard_modules = false; break;
 
+            case OptJitCache: _compiler_options.jit_cache = optarg; break;
+
+            case OptLto: _compiler_options.cxx_lto = true; break;
+
+            case OptPgoGenerate: _compiler_options.pgo_generate = optarg; break;
+
+            case OptPgoUse: _compiler_options.pgo_use = optarg; break;
+
+            case OptDisableDebugStreams:
+                for ( const auto& s : util::split(optarg, ":") )
+                    _compiler_options.disabled_debug_streams.emplace_back(util::trim(s));
+                break;
+
             case 'h': usage(); return Nothing();
 
             case '?':
@@ -462,6 +519,15 @@ Result<Nothing> Driver::parseOptions(int argc, char** argv) {
             return error("must use --debug with --cgdebug");
     }
 
+    if ( _compiler_options.pgo_generate && _compiler_options.pgo_use )
+        return error("cannot use --pgo-generate and --pgo-use together");
+
+    // Each shard repeats its module's declarations, so they cannot all go
+    // into a single output file.
+    if ( _compiler_options.cxx_split_units > 1 && _driver_options.output_cxx &&
+         _driver_options.output_cxx_prefix.empty() )
+        return error("--cxx-split-units requires --output-c++-files when writing out C++ code");
+
     if ( _driver_options.execute_code and ! _driver_options.output_path.empty() ) {
         if ( ! util::endsWith(_driver_options.output_path, ".hlto") )
             return error("output will be a precompiled object file and must have '.hlto' extension");
@@ -852,27 +918,37 @@ Result<Nothing> Driver::outputUnits() {
             continue;
 
         if ( auto cxx = unit->cxxCode() ) {
-            if ( _driver_options.output_cxx ) {
-                auto cxx_path = output_path;
+            auto shards = unit->cxxCodeShards();
+            if ( ! shards )
+                return error(fmt("error for module %s: %s", unit->uid().str(), shards.error()));
 
-                if ( _driver_options.output_cxx_prefix.size() ) {
-                    assert(cxx->id().size());
-
-                    if ( util::endsWith(_driver_options.output_cxx_prefix, "/") ) {
-                        hilti::rt::filesystem::create_directory(_driver_options.output_cxx_prefix);
-                        cxx_path = fmt("%s%s.cc", _driver_options.output_cxx_prefix, cxx->id());
+            if ( _driver_options.output_cxx ) {
+                std::vector<const CxxCode*> codes = {&*cxx};
+                for ( const auto& s : *shards )
+                    codes.push_back(&s);
+
+                for ( const auto* code : codes ) {
+                    auto cxx_path = output_path;
+
+                    if ( _driver_options.output_cxx_prefix.size() ) {
+                        assert(code->id().size());
+
+                        if ( util::endsWith(_driver_options.output_cxx_prefix, "/") ) {
+                            hilti::rt::filesystem::create_directory(_driver_options.output_cxx_prefix);
+                            cxx_path = fmt("%s%s.cc", _driver_options.output_cxx_prefix, code->id());
+                        }
+                        else
+                            cxx_path = fmt("%s_%s.cc", _driver_options.output_cxx_prefix, code->id());
                     }
-                    else
-                        cxx_path = fmt("%s_%s.cc", _driver_options.output_cxx_prefix, cxx->id());
-                }
 
-                auto output = openOutput(cxx_path, false, append);
-                if ( ! output )
-                    return output.error();
+                    auto output = openOutput(cxx_path, false, append);
+                    if ( ! output )
+                        return output.error();
 
-                HILTI_DEBUG(logging::debug::Driver,
-                            fmt("saving C++ code for module %s to %s", unit->uid().str(), cxx_path));
-                cxx->save(*output);
+                    HILTI_DEBUG(logging::debug::Driver,
+                                fmt("saving C++ code for module %s to %s", unit->uid().str(), cxx_path));
+                    code->save(*output);
+                }
             }
 
             if ( _driver_options.output_prototypes ) {
@@ -887,6 +963,9 @@ Result<Nothing> Driver::outputUnits() {
 
             _generated_cxxs.push_back(std::move(*cxx));
 
+            for ( auto& s : *shards )
+                _generated_cxxs.push_back(std::move(s));
+
             // Append further code to same output file if we aren't
             // individually prefixing names.
             append = _driver_options.output_cxx_prefix.empty();
@@ -928,6 +1007,10 @@ Result<Nothing> Driver::jitUnits() {
     if ( ! lib )
         return lib.error();
 
+    if ( auto stats = jit->cacheStatistics(); stats && _driver_options.report_times )
+        std::cerr << fmt("JIT cache: %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64 " stored, %" PRIu64 " evicted\n",
+                         stats->hits, stats->misses, stats->stores, stats->evictions);
+
     _library = std::move(*lib);
     return Nothing();
 }
@@ -0,0 +1,194 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <tuple>
+
+#include <hilti/base/logger.h>
+#include <hilti/base/util.h>
+#include <hilti/compiler/detail/jit-cache.h>
+#include <hilti/compiler/jit.h>
+
+using namespace hilti;
+using namespace hilti::detail;
+
+namespace {
+
+// Prefix for temporary files created while storing entries.
+constexpr const char* TmpPrefix = ".tmp-";
+
+// Temporary files older than this are assumed to be left over from processes
+// that did not finish storing their entries.
+constexpr auto StaleTmpAge = std::chrono::hours(1);
+
+// 64-bit FNV-1a, used alongside `std::hash` to derive 128-bit keys.
+uint64_t fnv1a(uint64_t h, std::string_view data) {
+    for ( auto c : data ) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 0x100000001b3ULL;
+    }
+
+    return h;
+}
+
+} // namespace
+
+Result<jit::Cache> jit::Cache::open(hilti::rt::filesystem::path directory, uint64_t max_size) {
+    std::error_code ec;
+    hilti::rt::filesystem::create_directories(directory, ec);
+    if ( ec )
+        return result::Error(util::fmt("cannot create JIT cache directory %s: %s", directory, ec.message()));
+
+    return Cache(std::move(directory), max_size);
+}
+
+std::string jit::Cache::key(const std::vector<std::string_view>& material) {
+    uint64_t h1 = 0;
+    uint64_t h2 = 0xcbf29ce484222325ULL;
+
+    for ( const auto& m : material ) {
+        // Include each string's length so that moving data between adjacent
+        // strings changes the key.
+        auto size = std::to_string(m.size());
+        h1 = rt::hashCombine(h1, std::hash<std::string_view>{}(size), std::hash<std::string_view>{}(m));
+        h2 = fnv1a(fnv1a(h2, size), m);
+    }
+
+    return util::fmt("%016" PRIx64 "%016" PRIx64, h1, h2);
+}
+
+Result<std::string> jit::Cache::fileKey(const hilti::rt::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    if ( ! in )
+        return result::Error(util::fmt("cannot open %s", path));
+
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if ( in.bad() )
+        return result::Error(util::fmt("cannot read %s", path));
+
+    return key({content});
+}
+
+hilti::rt::filesystem::path jit::Cache::_path(const std::string& key, const std::string& extension) const {
+    return _directory / (key + extension);
+}
+
+bool jit::Cache::retrieve(const std::string& key, const std::string& extension,
+                          const hilti::rt::filesystem::path& dst) {
+    auto entry = _path(key, extension);
+
+    // Another process may evict the entry at any time, so we do not check
+    // for existence first but just attempt the copy.
+    std::error_code ec;
+    hilti::rt::filesystem::copy_file(entry, dst, hilti::rt::filesystem::copy_options::overwrite_existing, ec);
+
+    if ( ec ) {
+        HILTI_DEBUG(logging::debug::Jit, util::fmt("cache miss for %s", entry.filename().native()));
+        ++_statistics.misses;
+        return false;
+    }
+
+    HILTI_DEBUG(logging::debug::Jit, util::fmt("cache hit for %s", entry.filename().native()));
+    ++_statistics.hits;
+
+    // Record the access for LRU eviction; ignore errors.
+    hilti::rt::filesystem::last_write_time(entry, hilti::rt::filesystem::file_time_type::clock::now(), ec);
+    return true;
+}
+
+void jit::Cache::store(const std::string& key, const std::string& extension, const hilti::rt::filesystem::path& src) {
+    auto entry = _path(key, extension);
+
+    // Write into a private temporary file in the cache directory first so we
+    // can atomically move it into place; concurrent readers will then only
+    // ever see complete entries.
+    std::string tmp = _directory / util::fmt("%sXXXXXXXXXXXX", TmpPrefix);
+    if ( auto fd = ::mkstemp(tmp.data()); fd == -1 ) {
+        HILTI_DEBUG(logging::debug::Jit, util::fmt("could not create temporary file in JIT cache: %s", strerror(errno)));
+        return;
+    }
+    else
+        ::close(fd);
+
+    std::error_code ec;
+    hilti::rt::filesystem::copy_file(src, tmp, hilti::rt::filesystem::copy_options::overwrite_existing, ec);
+
+    if ( ! ec )
+        hilti::rt::filesystem::rename(tmp, entry, ec);
+
+    if ( ec ) {
+        HILTI_DEBUG(logging::debug::Jit, util::fmt("could not store %s in JIT cache: %s", src, ec.message()));
+        hilti::rt::filesystem::remove(tmp, ec);
+        return;
+    }
+
+    HILTI_DEBUG(logging::debug::Jit, util::fmt("stored %s in JIT cache as %s", src.filename().native(),
+                                               entry.filename().native()));
+    ++_statistics.stores;
+}
+
+void jit::Cache::evict() {
+    std::vector<std::tuple<hilti::rt::filesystem::file_time_type, uint64_t, hilti::rt::filesystem::path>> entries;
+    uint64_t total = 0;
+
+    const auto now = hilti::rt::filesystem::file_time_type::clock::now();
+
+    std::error_code ec;
+    for ( const auto& i : hilti::rt::filesystem::directory_iterator(_directory, ec) ) {
+        std::error_code ec_;
+        if ( ! i.is_regular_file(ec_) )
+            continue;
+
+        // Entries may disappear while we iterate if other processes evict
+        // concurrently, so skip anything we cannot stat.
+        auto size = i.file_size(ec_);
+        if ( ec_ )
+            continue;
+
+        auto time = i.last_write_time(ec_);
+        if ( ec_ )
+            continue;
+
+        if ( util::startsWith(i.path().filename().native(), TmpPrefix) ) {
+            if ( now - time > StaleTmpAge )
+                hilti::rt::filesystem::remove(i.path(), ec_);
+
+            continue;
+        }
+
+        total += size;
+        entries.emplace_back(time, size, i.path());
+    }
+
+    if ( ec ) {
+        HILTI_DEBUG(logging::debug::Jit, util::fmt("could not scan JIT cache directory: %s", ec.message()));
+        return;
+    }
+
+    if ( _max_size == 0 || total <= _max_size )
+        return;
+
+    std::sort(entries.begin(), entries.end());
+
+    for ( const auto& [time, size, path] : entries ) {
+        if ( total <= _max_size )
+            break;
+
+        HILTI_DEBUG(logging::debug::Jit, util::fmt("evicting %s from JIT cache", path.filename().native()));
+
+        // Count the entry as gone even if removal fails; most likely another
+        // process evicted it first.
+        std::error_code ec_;
+        if ( hilti::rt::filesystem::remove(path, ec_) )
+            ++_statistics.evictions;
+
+        total -= size;
+    }
+}
@@ -82,6 +82,17 @@ hilti::rt::filesystem::path save(const CxxCode& code, const hilti::rt::filesyste
     return cc1;
 }
 
+// Returns the directory holding execution profiles for a set of generated
+// code. Its name is a hash of the code so that we won't use profiles recorded
+// for a different version of it.
+hilti::rt::filesystem::path pgoDirectory(const hilti::rt::filesystem::path& base, const std::vector<CxxCode>& codes) {
+    std::vector<std::string_view> material;
+    for ( const auto& code : codes )
+        material.emplace_back(code.code() ? std::string_view(*code.code()) : std::string_view());
+
+    return hilti::rt::filesystem::absolute(base) / detail::jit::Cache::key(material);
+}
+
 // An RAII helper which removes all files added to it on destruction.
 class FileGuard {
 public:
@@ -199,11 +210,17 @@ hilti::Result<std::shared_ptr<const Library>> JIT::build() {
     if ( auto rc = _checkCompiler(); ! rc )
         return rc.error();
 
+    _openCache();
+
     if ( auto rc = _compile(); ! rc )
         return rc.error();
 
     auto library = _link();
     _finish(); // clean up no matter if successful
+
+    if ( _cache )
+        _cache->evict();
+
     return library;
 }
 
@@ -255,23 +272,177 @@ void JIT::_finish() {
 
     _objects.clear();
 
+    if ( _cached_library ) {
+        // Only left behind if we failed before linking.
+        std::error_code ec;
+        hilti::rt::filesystem::remove(*_cached_library, ec);
+        _cached_library.reset();
+    }
+
+    _library_key.reset();
+
     _runner.finish();
 }
 
+void JIT::_openCache() {
+    auto directory = options().jit_cache;
+    auto max_size = options().jit_cache_max_size;
+
+    if ( options().pgo_generate || options().pgo_use ) {
+        // Profiles change independent of the code, so don't cache anything.
+        HILTI_DEBUG(logging::debug::Jit, "not using JIT cache with profile-guided optimization");
+        return;
+    }
+
+    if ( ! directory ) {
+        if ( auto e = hilti::rt::getenv("HILTI_JIT_CACHE"); e && ! e->empty() )
+            directory = *e;
+    }
+
+    if ( ! directory )
+        return;
+
+    if ( auto e = hilti::rt::getenv("HILTI_JIT_CACHE_SIZE") )
+        max_size = util::charsToUInt64(e->c_str(), 10, [&]() {
+            rt::fatalError(util::fmt("expected unsigned integer but received '%s' for HILTI_JIT_CACHE_SIZE", *e));
+        });
+
+    // The cache is just an optimization, so carry on without it if it's not available.
+    auto cache = detail::jit::Cache::open(*directory, max_size);
+    if ( ! cache ) {
+        logger().warning(util::fmt("JIT cache disabled: %s", cache.error()));
+        return;
+    }
+
+    HILTI_DEBUG(logging::debug::Jit, util::fmt("using JIT cache in %s", cache->directory()));
+    _cache = std::move(*cache);
+}
+
 hilti::Result<Nothing> JIT::_compile() {
     util::timing::Collector _("hilti/jit/compile");
 
     if ( ! hasInputs() )
         return Nothing();
 
-    auto cc_files = _files;
+    std::vector<std::string> args = {"-c"};
+
+    if ( options().debug )
+        args = hilti::util::concat(args, hilti::configuration().hlto_cxx_flags_debug);
+    else
+        args = hilti::util::concat(args, hilti::configuration().hlto_cxx_flags_release);
+
+    // For debug output on compilation:
+    // args.push_back("-v");
+    // args.push_back("-###");
+
+    for ( const auto& i : options().cxx_include_paths ) {
+        args.emplace_back("-I");
+        args.push_back(i);
+    }
+
+    if ( auto path = hilti::rt::getenv("HILTI_CXX_INCLUDE_DIRS") ) {
+        for ( auto&& dir : hilti::rt::split(*path, ":") ) {
+            if ( ! dir.empty() ) {
+                args.insert(args.begin(), {"-I", std::string(dir)});
+            }
+        }
+    }
+
+    if ( auto flags_ = hilti::rt::getenv("HILTI_CXX_FLAGS") ) {
+        if ( auto flags = util::split_shell_unsafe(*flags_) )
+            args.insert(args.end(), std::make_move_iterator(flags->begin()), std::make_move_iterator(flags->end()));
+        else
+            return {util::fmt("invalid HILTI_CXX_FLAGS '%s': %s", *flags_, flags.error().description())};
+    }
+
+    if ( options().cxx_lto && ! options().debug && hilti::configuration().hlto_ld_flags_lto.empty() )
+        logger().warning("runtime library has not been built with LTO support, ignoring --lto");
+
+    if ( _lto() )
+        args.emplace_back("-flto");
+
+    // Compute cache keys for all in-memory code. We do not cache external
+    // C++ files since we cannot track changes to headers they may include.
+    std::vector<std::string> keys;
+
+    if ( _cache ) {
+        const auto& cxx = hilti::configuration().cxx;
+        const auto& version = hilti::configuration().version_string_long;
+
+        for ( const auto& code : _codes ) {
+            std::vector<std::string_view> material = {version, cxx.native()};
+            material.insert(material.end(), args.begin(), args.end());
+            material.emplace_back(code.code() ? *code.code() : std::string_view());
+            keys.push_back(detail::jit::Cache::key(material));
+        }
+
+        // If all code is cacheable, we can reuse a previously linked library
+        // directly without even looking at individual object files.
+        if ( _files.empty() ) {
+            std::vector<std::string_view> material = {version, cxx.native()};
+            material.insert(material.end(), keys.begin(), keys.end());
+
+            auto link_args = _linkArgs({});
+            material.insert(material.end(), link_args.begin(), link_args.end());
+
+            // Include the content of any additional libraries we link, so
+            // that we don't reuse a library linked against a previous
+            // version of them. If we cannot read one, we don't cache.
+            std::vector<std::string> link_keys;
+            bool cacheable = true;
+
+            for ( const auto& lib : options().cxx_link ) {
+                if ( lib.empty() )
+                    continue;
+
+                auto key = detail::jit::Cache::fileKey(lib);
+                if ( ! key ) {
+                    HILTI_DEBUG(logging::debug::Jit, util::fmt("not caching library: %s", key.error()));
+                    cacheable = false;
+                    break;
+                }
+
+                link_keys.push_back(std::move(*key));
+            }
+
+            material.insert(material.end(), link_keys.begin(), link_keys.end());
+
+            if ( cacheable ) {
+                _library_key = detail::jit::Cache::key(material);
+
+                auto lib = _tempFile("spicy-jit-hlto-XXXXXXXXXXXX");
+                if ( _cache->retrieve(*_library_key, ".hlto", lib) ) {
+                    _cached_library = std::move(lib);
+                    return Nothing();
+                }
+
+                std::error_code ec;
+                hilti::rt::filesystem::remove(lib, ec);
+            }
+        }
+    }
 
     // Remember generated files and remove them on all exit paths.
     bool keep_tmps = options().keep_tmps;
     FileGuard cc_files_generated;
 
+    auto pgo = _pgo();
+    if ( ! pgo )
+        return pgo.error();
+
+    // C++ files to compile, along with their cache keys if cacheable, and
+    // the object files to create if those need to be at a specific place.
+    std::vector<std::tuple<hilti::rt::filesystem::path, std::optional<std::string>,
+                           std::optional<hilti::rt::filesystem::path>>>
+        cc_files;
+
+    for ( const auto& path : _files )
+        cc_files.emplace_back(path, std::nullopt, std::nullopt);
+
     // Write all in-memory code into temporary files.
-    for ( const auto& code : _codes ) {
+    for ( size_t i = 0; i < _codes.size(); ++i ) {
+        const auto& code = _codes[i];
+
         std::string id = hilti::rt::filesystem::path(code.id());
         if ( id.empty() )
             id = "code"; // dummy name
@@ -288,66 +459,57 @@ hilti::Result<Nothing> JIT::_compile() {
                                         ec); // will save into current directory; ignore errors
         }
 
-        cc_files.push_back(cc);
+        // With profile-guided optimization, the object file's path must
+        // remain the same across runs because GCC derives the name of the
+        // profile from it.
+        std::optional<hilti::rt::filesystem::path> obj;
+        if ( *pgo )
+            obj = (*pgo)->directory / util::fmt("%u-%s.o", i, util::toIdentifier(id));
+
+        cc_files.emplace_back(cc, _cache ? std::make_optional(keys[i]) : std::nullopt, std::move(obj));
         if ( ! keep_tmps )
             cc_files_generated.add(std::move(cc));
     }
 
-    // Compile all C++ files.
+    // Compile all C++ files, unless we find their object files in the cache.
     std::vector<result::Error> errors;
-    for ( const auto& path : cc_files ) {
-        HILTI_DEBUG(logging::debug::Jit, util::fmt("compiling %s", path.filename().native()));
+    std::vector<std::pair<hilti::rt::filesystem::path, std::string>> objects_to_cache;
 
-        std::vector<std::string> args = {"-c"};
-
-        if ( options().debug )
-            args = hilti::util::concat(args, hilti::configuration().hlto_cxx_flags_debug);
-        else
-            args = hilti::util::concat(args, hilti::configuration().hlto_cxx_flags_release);
+    for ( const auto& [path, key, obj_] : cc_files ) {
+        // Unless told otherwise, we explicitly create the object file in the
+        // temporary directory. This ensures that we use a temp path for
+        // object files created for C++ files added by users as well.
+        auto obj = obj_ ? *obj_ :
+                          hilti::rt::filesystem::temp_directory_path() /
+                              util::fmt("%s_%" PRIx64 ".o", path.filename().c_str(), _hash);
 
-        // For debug output on compilation:
-        // args.push_back("-v");
-        // args.push_back("-###");
+        _objects.push_back(obj);
 
-        for ( const auto& i : options().cxx_include_paths ) {
-            args.emplace_back("-I");
-            args.push_back(i);
-        }
+        if ( key ) {
+            if ( _cache->retrieve(*key, ".o", obj) )
+                continue;
 
-        if ( auto path = hilti::rt::getenv("HILTI_CXX_INCLUDE_DIRS") ) {
-            for ( auto&& dir : hilti::rt::split(*path, ":") ) {
-                if ( ! dir.empty() ) {
-                    args.insert(args.begin(), {"-I", std::string(dir)});
-                }
-            }
+            objects_to_cache.emplace_back(obj, *key);
         }
 
-        if ( auto flags_ = hilti::rt::getenv("HILTI_CXX_FLAGS") ) {
-            if ( auto flags = util::split_shell_unsafe(*flags_) )
-                args.insert(args.end(), std::make_move_iterator(flags->begin()), std::make_move_iterator(flags->end()));
-            else
-                return {util::fmt("invalid HILTI_CXX_FLAGS '%s': %s", *flags_, flags.error().description())};
-        }
+        HILTI_DEBUG(logging::debug::Jit, util::fmt("compiling %s", path.filename().native()));
 
-        // We explicitly create the object file in the temporary directory.
-        // This ensures that we use a temp path for object files created for
-        // C++ files added by users as well.
-        auto obj = hilti::rt::filesystem::temp_directory_path() /
-                   util::fmt("%s_%" PRIx64 ".o", path.filename().c_str(), _hash);
+        auto cmdline = args;
 
-        args.emplace_back("-o");
-        args.push_back(obj);
-        _objects.push_back(std::move(obj));
+        if ( obj_ )
+            cmdline.insert(cmdline.end(), (*pgo)->args.begin(), (*pgo)->args.end());
 
-        args.push_back(hilti::rt::filesystem::canonical(path));
+        cmdline.emplace_back("-o");
+        cmdline.push_back(obj);
+        cmdline.push_back(hilti::rt::filesystem::canonical(path));
 
         auto cxx = hilti::configuration().cxx;
         if ( const auto& launcher = hilti::configuration().cxx_launcher; launcher && ! launcher->empty() ) {
-            args.insert(args.begin(), cxx);
+            cmdline.insert(cmdline.begin(), cxx);
             cxx = *launcher;
         }
 
-        if ( auto rc = _runner._scheduleJob(cxx, std::move(args)); ! rc )
+        if ( auto rc = _runner._scheduleJob(cxx, std::move(cmdline)); ! rc )
             errors.push_back(rc.error());
     }
 
@@ -357,17 +519,13 @@ hilti::Result<Nothing> JIT::_compile() {
     if ( ! errors.empty() )
         return errors.front();
 
+    for ( const auto& [obj, key] : objects_to_cache )
+        _cache->store(key, ".o", obj);
+
     return Nothing();
 }
 
-hilti::Result<std::shared_ptr<const Library>> JIT::_link() {
-    util::timing::Collector _("hilti/jit/link");
-    HILTI_DEBUG(logging::debug::Jit, "linking object files");
-
-    if ( _objects.empty() )
-        return result::Error("no object code to link");
-
-    // Link all object files together into a shared library.
+std::vector<std::string> JIT::_linkArgs(const std::vector<hilti::rt::filesystem::path>& objects) const {
     std::vector<std::string> args;
 
     if ( options().debug )
@@ -375,54 +533,187 @@ hilti::Result<std::shared_ptr<const Library>> JIT::_link() {
     else
         args = hilti::configuration().hlto_ld_flags_release;
 
+    for ( const auto& path : objects )
+        args.push_back(path);
+
+    if ( options().pgo_generate )
+        // Pulls in the compiler's profiling runtime.
+        args.emplace_back("-fprofile-generate");
+
+    if ( _lto() )
+        // Pulls in the runtime's LTO archives for the optimizer to inline from.
+        args = hilti::util::concat(args, hilti::configuration().hlto_ld_flags_lto);
+
+    // Add additional shared libraries or static archives to the link. This needs to happen
+    // after we added the objects to make sure we pull in symbols used in the objects.
+    for ( const auto& lib : options().cxx_link )
+        if ( ! lib.empty() )
+            args.emplace_back(lib);
+
+    return args;
+}
+
+bool JIT::_lto() const {
+    // Debug builds don't optimize anyways.
+    return options().cxx_lto && ! options().debug && ! hilti::configuration().hlto_ld_flags_lto.empty();
+}
+
+hilti::Result<std::optional<JIT::PGO>> JIT::_pgo() {
+    if ( _codes.empty() )
+        return {std::nullopt};
+
+    if ( const auto& base = options().pgo_generate ) {
+        auto dir = pgoDirectory(*base, _codes);
+
+        std::error_code ec;
+        hilti::rt::filesystem::create_directories(dir, ec);
+        if ( ec )
+            return result::Error(util::fmt("cannot create profile directory %s: %s", dir, ec.message()));
+
+        return {PGO{dir, {util::fmt("-fprofile-generate=%s", dir.native())}}};
+    }
+
+    if ( const auto& base = options().pgo_use ) {
+        auto dir = pgoDirectory(*base, _codes);
+
+        if ( ! hilti::rt::filesystem::is_directory(dir) ) {
+            // See if there's a profile for a previous version of the code.
+            std::error_code ec;
+            if ( hilti::rt::filesystem::is_directory(*base) && ! hilti::rt::filesystem::is_empty(*base, ec) )
+                logger().warning(
+                    util::fmt("profiles in %s are stale because the generated code has changed, ignoring them",
+                              *base));
+            else
+                logger().warning(util::fmt("no profiles available in %s", *base));
+
+            return {std::nullopt};
+        }
+
+        std::vector<std::string> raw_profiles;
+        bool have_gcda = false;
+
+        std::error_code ec;
+        for ( const auto& e : hilti::rt::filesystem::directory_iterator(dir, ec) ) {
+            if ( e.path().extension() == ".profraw" )
+                raw_profiles.emplace_back(e.path());
+
+            else if ( e.path().extension() == ".gcda" )
+                have_gcda = true;
+        }
+
+        if ( have_gcda )
+            // Recorded by GCC, which finds the profiles by itself.
+            return {PGO{dir, {util::fmt("-fprofile-use=%s", dir.native()), "-Wno-missing-profile"}}};
+
+        auto profile = dir / "default.profdata";
+
+        if ( ! raw_profiles.empty() ) {
+            // Recorded by clang, which needs the raw profiles merged first.
+            // We always merge all of them, so that repeated builds get the
+            // same result.
+            hilti::rt::filesystem::path merge = "llvm-profdata";
+
+            if ( auto e = hilti::rt::getenv("HILTI_LLVM_PROFDATA") )
+                merge = *e;
+            else if ( auto p = hilti::configuration().cxx.parent_path() / "llvm-profdata";
+                      hilti::rt::filesystem::exists(p) )
+                merge = p;
+
+            std::vector<std::string> args = {"merge", "-o", profile};
+            args.insert(args.end(), raw_profiles.begin(), raw_profiles.end());
+
+            Result<Nothing> rc = Nothing();
+            if ( auto job = _runner._scheduleJob(merge, std::move(args)); ! job )
+                rc = job.error();
+            else
+                rc = _runner._waitForJobs();
+
+            if ( ! rc ) {
+                logger().warning(util::fmt("cannot merge profiles in %s, ignoring them: %s", dir, rc.error()));
+                return {std::nullopt};
+            }
+        }
+
+        if ( ! hilti::rt::filesystem::exists(profile) ) {
+            logger().warning(util::fmt("no profiles recorded in %s yet", dir));
+            return {std::nullopt};
+        }
+
+        return {PGO{dir, {util::fmt("-fprofile-use=%s", profile.native())}}};
+    }
+
+    return {std::nullopt};
+}
+
+std::string JIT::_tempFile(const std::string& template_) {
     // Create a random temporary file owned only by us so we are not racing
     // with other processes attempting to create the same output file.
-    //
-    // We create this file in the same location as the final file so we can
-    // perform an atomic move below.
-    std::string lib0 = hilti::rt::filesystem::temp_directory_path() / "spicy-jit-hlto-XXXXXXXXXXXX";
-    if ( auto fd = ::mkstemp(lib0.data()); fd == -1 )
+    std::string path = hilti::rt::filesystem::temp_directory_path() / template_;
+    if ( auto fd = ::mkstemp(path.data()); fd == -1 )
         rt::fatalError(util::fmt("could not create temporary file: %s", strerror(errno)));
     else
         ::close(fd);
 
-    args.emplace_back("-o");
-    args.push_back(lib0);
+    return path;
+}
 
-    for ( const auto& path : _objects ) {
-        HILTI_DEBUG(logging::debug::Jit, util::fmt("  - %s", path.native()));
+hilti::Result<std::shared_ptr<const Library>> JIT::_link() {
+    util::timing::Collector _("hilti/jit/link");
 
-        // Double check that we really got the file.
-        if ( ! hilti::rt::filesystem::exists(path) )
-            return result::Error(
-                util::fmt("missing object file %s, C++ compiler is probably not working", path.native()));
+    std::string lib0;
 
-        args.push_back(path);
+    if ( _cached_library ) {
+        HILTI_DEBUG(logging::debug::Jit, "using cached library");
+        lib0 = *_cached_library;
+        _cached_library.reset();
+    }
 
-        if ( _dump_code ) {
-            // Logging to driver because that's where all the other "saving to ..." messages go.
-            auto dbg = util::fmt("dbg.%s", path.native());
-            HILTI_DEBUG(logging::debug::Driver, util::fmt("saving object file to %s", dbg));
+    else {
+        HILTI_DEBUG(logging::debug::Jit, "linking object files");
 
-            std::error_code ec;
-            hilti::rt::filesystem::copy(path, dbg, hilti::rt::filesystem::copy_options::overwrite_existing,
-                                        ec); // will save into current directory; ignore errors
+        if ( _objects.empty() )
+            return result::Error("no object code to link");
+
+        for ( const auto& path : _objects ) {
+            HILTI_DEBUG(logging::debug::Jit, util::fmt("  - %s", path.native()));
+
+            // Double check that we really got the file.
+            if ( ! hilti::rt::filesystem::exists(path) )
+                return result::Error(
+                    util::fmt("missing object file %s, C++ compiler is probably not working", path.native()));
+
+            if ( _dump_code ) {
+                // Logging to driver because that's where all the other "saving to ..." messages go.
+                auto dbg = util::fmt("dbg.%s", path.native());
+                HILTI_DEBUG(logging::debug::Driver, util::fmt("saving object file to %s", dbg));
+
+                std::error_code ec;
+                hilti::rt::filesystem::copy(path, dbg, hilti::rt::filesystem::copy_options::overwrite_existing,
+                                            ec); // will save into current directory; ignore errors
+            }
         }
-    }
 
-    // Add additional shared libraries or static archives to the link. This needs to happen
-    // after we added the objects to make sure we pull in symbols used in the objects.
-    for ( const auto& lib : options().cxx_link )
-        if ( ! lib.empty() )
-            args.emplace_back(lib);
+        // Link all object files together into a shared library.
+        //
+        // We create the output file in the same location as the final file
+        // so we can perform an atomic move below.
+        lib0 = _tempFile("spicy-jit-hlto-XXXXXXXXXXXX");
 
-    // We are using the compiler as a linker here, no need to use a compiler launcher.
-    // Since we are writing to a random temporary file non of this would cache anyway.
-    if ( auto rc = _runner._scheduleJob(hilti::configuration().cxx, std::move(args)); ! rc )
-        return rc.error();
+        auto args = _linkArgs(_objects);
+        args.emplace_back("-o");
+        args.push_back(lib0);
 
-    if ( auto rc = _runner._waitForJobs(); ! rc )
-        return rc.error();
+        // We are using the compiler as a linker here, no need to use a compiler launcher.
+        // Since we are writing to a random temporary file non of this would cache anyway.
+        if ( auto rc = _runner._scheduleJob(hilti::configuration().cxx, std::move(args)); ! rc )
+            return rc.error();
+
+        if ( auto rc = _runner._waitForJobs(); ! rc )
+            return rc.error();
+
+        if ( _library_key )
+            _cache->store(*_library_key, ".hlto", lib0);
+    }
 
     // Atomically move the temporary file to its final location. With that
     // even with concurrent saves to the same final path other processes should
@@ -2,6 +2,9 @@
 
 #include "hilti/compiler/detail/optimizer.h"
 
+#include <algorithm>
+#include <cinttypes>
+#include <map>
 #include <numeric>
 #include <optional>
 #include <string>
@@ -11,25 +14,33 @@
 #include <hilti/rt/util.h>
 
 #include <hilti/ast/builder/builder.h>
+#include <hilti/ast/ctors/coerced.h>
 #include <hilti/ast/ctors/default.h>
+#include <hilti/ast/ctors/integer.h>
 #include <hilti/ast/declaration.h>
 #include <hilti/ast/declarations/constant.h>
 #include <hilti/ast/declarations/function.h>
 #include <hilti/ast/declarations/imported-module.h>
+#include <hilti/ast/expressions/coerced.h>
 #include <hilti/ast/expressions/ctor.h>
+#include <hilti/ast/expressions/grouping.h>
 #include <hilti/ast/expressions/logical-and.h>
 #include <hilti/ast/expressions/logical-not.h>
 #include <hilti/ast/expressions/logical-or.h>
 #include <hilti/ast/expressions/member.h>
 #include <hilti/ast/expressions/name.h>
+#include <hilti/ast/expressions/resolved-operator.h>
 #include <hilti/ast/expressions/ternary.h>
 #include <hilti/ast/node.h>
+#include <hilti/ast/operators/generic.h>
+#include <hilti/ast/operators/integer.h>
 #include <hilti/ast/scope-lookup.h>
 #include <hilti/ast/statements/block.h>
 #include <hilti/ast/statements/while.h>
 #include <hilti/ast/type.h>
 #include <hilti/ast/types/bool.h>
 #include <hilti/ast/types/enum.h>
+#include <hilti/ast/types/integer.h>
 #include <hilti/ast/types/reference.h>
 #include <hilti/ast/types/struct.h>
 #include <hilti/ast/visitor.h>
@@ -42,6 +53,7 @@ namespace hilti {
 namespace logging::debug {
 inline const DebugStream Optimizer("optimizer");
 inline const DebugStream OptimizerCollect("optimizer-collect");
+inline const DebugStream OptimizerRanges("optimizer-ranges");
 } // namespace logging::debug
 
 // Helper function to extract innermost type, removing any wrapping in reference or container types.
@@ -1557,6 +1569,201 @@ struct MemberVisitor : OptimizerVisitor {
     }
 };
 
+/**
+ * Visitor running on the final, optimized AST to determine value ranges of
+ * integer expressions. Where it can prove that the result of an addition,
+ * subtraction, or multiplication always fits into its type, it marks the
+ * operator so that code generation can skip the overflow checks.
+ *
+ * The analysis is local to each expression: it starts from the ranges
+ * implied by integer types and constants, and propagates them through
+ * coercions and arithmetic. Anything it cannot reason about is assumed to
+ * span the full range of its type.
+ */
+struct IntegerRangeVisitor : visitor::PreOrder {
+    // Wide enough to compute any result of 64-bit operands without overflowing.
+    using Int = __int128;
+
+    struct Range {
+        Int lower;
+        Int upper;
+
+        bool contains(const Range& other) const { return lower <= other.lower && other.upper <= upper; }
+    };
+
+    std::map<Expression*, Range> _ranges; // cache of ranges computed so far
+    uint64_t _num_elided = 0;             // number of overflow checks elided
+
+    // Returns the range of values representable by an integer type.
+    static std::optional<Range> typeRange(QualifiedType* t) {
+        if ( auto* i = t->type()->tryAs<type::SignedInteger>() ) {
+            auto bound = static_cast<Int>(1) << (i->width() - 1);
+            return Range{-bound, bound - 1};
+        }
+
+        if ( auto* i = t->type()->tryAs<type::UnsignedInteger>() )
+            return Range{0, (static_cast<Int>(1) << i->width()) - 1};
+
+        return {};
+    }
+
+    // Returns the number of bits needed to represent the magnitude of any value inside a range.
+    static int magnitudeBits(const Range& r) {
+        auto x = std::max(r.lower < 0 ? -r.lower : r.lower, r.upper < 0 ? -r.upper : r.upper);
+
+        int bits = 0;
+        for ( ; x > 0; x >>= 1 )
+            ++bits;
+
+        return bits;
+    }
+
+    static std::optional<Range> ctorRange(Ctor* c) {
+        if ( auto* coerced = c->tryAs<ctor::Coerced>() )
+            return ctorRange(coerced->coercedCtor());
+
+        if ( auto* i = c->tryAs<ctor::SignedInteger>() )
+            return Range{i->value(), i->value()};
+
+        if ( auto* i = c->tryAs<ctor::UnsignedInteger>() )
+            return Range{i->value(), i->value()};
+
+        return {};
+    }
+
+    // Returns true for integer operators that check their results for overflows.
+    static bool isCheckedArithmetic(expression::ResolvedOperator* n) {
+        return n->isA<operator_::signed_integer::Sum>() || n->isA<operator_::unsigned_integer::Sum>() ||
+               n->isA<operator_::signed_integer::Difference>() || n->isA<operator_::unsigned_integer::Difference>() ||
+               n->isA<operator_::signed_integer::Multiple>() || n->isA<operator_::unsigned_integer::Multiple>();
+    }
+
+    // Computes the range of a binary arithmetic operation, if it fits into the result type.
+    std::optional<Range> arithmeticRange(expression::ResolvedOperator* n, const Range& full) {
+        auto a = range(n->op0());
+        auto b = range(n->op1());
+        if ( ! (a && b) )
+            return {};
+
+        Range r{};
+
+        switch ( n->kind() ) {
+            case operator_::Kind::Sum: r = Range{a->lower + b->lower, a->upper + b->upper}; break;
+
+            case operator_::Kind::Difference: r = Range{a->lower - b->upper, a->upper - b->lower}; break;
+
+            case operator_::Kind::Multiple: {
+                if ( magnitudeBits(*a) + magnitudeBits(*b) > 126 )
+                    return {};
+
+                Int p[] = {a->lower * b->lower, a->lower * b->upper, a->upper * b->lower, a->upper * b->upper};
+                r = Range{*std::min_element(std::begin(p), std::end(p)), *std::max_element(std::begin(p), std::end(p))};
+                break;
+            }
+
+            default: return {};
+        }
+
+        if ( ! full.contains(r) )
+            return {};
+
+        return r;
+    }
+
+    // Computes the range of operators that either preserve the value of
+    // their operand, or can only ever narrow its range.
+    std::optional<Range> derivedRange(expression::ResolvedOperator* n) {
+        if ( n->isA<operator_::signed_integer::CastToSigned>() || n->isA<operator_::signed_integer::CastToUnsigned>() ||
+             n->isA<operator_::unsigned_integer::CastToSigned>() ||
+             n->isA<operator_::unsigned_integer::CastToUnsigned>() || n->isA<operator_::generic::CastedCoercion>() )
+            return range(n->op0());
+
+        if ( ! n->hasOp1() )
+            return {};
+
+        auto a = range(n->op0());
+        auto b = range(n->op1());
+        if ( ! (a && b) )
+            return {};
+
+        if ( n->isA<operator_::unsigned_integer::BitAnd>() )
+            return Range{0, std::min(a->upper, b->upper)};
+
+        if ( n->isA<operator_::unsigned_integer::Modulo>() && b->lower > 0 )
+            return Range{0, std::min(a->upper, b->upper - 1)};
+
+        if ( n->isA<operator_::unsigned_integer::Division>() && b->lower > 0 )
+            return Range{a->lower / b->upper, a->upper / b->lower};
+
+        if ( n->isA<operator_::unsigned_integer::ShiftRight>() && b->lower == b->upper && b->upper < 64 )
+            return Range{a->lower >> static_cast<int>(b->upper), a->upper >> static_cast<int>(b->upper)};
+
+        return {};
+    }
+
+    // Returns the range of values that an integer expression may evaluate to.
+    std::optional<Range> range(Expression* e) {
+        if ( auto i = _ranges.find(e); i != _ranges.end() )
+            return i->second;
+
+        auto full = typeRange(e->type());
+        if ( ! full )
+            return {};
+
+        auto r = *full;
+
+        if ( auto* ctor = e->tryAs<expression::Ctor>() ) {
+            if ( auto x = ctorRange(ctor->ctor()); x && full->contains(*x) )
+                r = *x;
+        }
+
+        else if ( auto* coerced = e->tryAs<expression::Coerced>() ) {
+            if ( auto x = range(coerced->expression()); x && full->contains(*x) )
+                r = *x;
+        }
+
+        else if ( auto* grouping = e->tryAs<expression::Grouping>() ) {
+            if ( auto x = range(grouping->expression()); x && full->contains(*x) )
+                r = *x;
+        }
+
+        else if ( auto* op = e->tryAs<expression::ResolvedOperator>() ) {
+            if ( isCheckedArithmetic(op) ) {
+                if ( auto x = arithmeticRange(op, *full) ) {
+                    r = *x;
+
+                    if ( ! op->isOverflowSafe() ) {
+                        HILTI_DEBUG(logging::debug::OptimizerRanges,
+                                    util::fmt("[%s] eliding overflow check for \"%s\"", op->location().dump(true),
+                                              op->printRaw()));
+                        op->setOverflowSafe();
+                        ++_num_elided;
+                    }
+                }
+            }
+
+            else if ( auto x = derivedRange(op); x && full->contains(*x) )
+                r = *x;
+        }
+
+        else if ( auto* name = e->tryAs<expression::Name>() ) {
+            auto* decl = name->resolvedDeclaration();
+            if ( auto* constant = decl ? decl->tryAs<declaration::Constant>() : nullptr ) {
+                if ( auto x = range(constant->value()); x && full->contains(*x) )
+                    r = *x;
+            }
+        }
+
+        _ranges.emplace(e, r);
+        return r;
+    }
+
+    void operator()(expression::ResolvedOperator* n) final {
+        if ( isCheckedArithmetic(n) )
+            range(n);
+    }
+};
+
 void detail::optimizer::optimize(Builder* builder, ASTRoot* root) {
     util::timing::Collector _("hilti/compiler/optimizer");
 
@@ -1575,6 +1782,9 @@ void detail::optimizer::optimize(Builder* builder, ASTRoot* root) {
         v.transform(root);
     }
 
+    // Range analysis needs to see the final AST, so we run it separately at the end.
+    const bool integer_ranges = (! passes || passes->count("integer_ranges"));
+
     const std::map<std::string, std::unique_ptr<OptimizerVisitor> (*)(Builder* builder)> creators =
         {{"constant_folding",
           [](Builder* builder) -> std::unique_ptr<OptimizerVisitor> {
@@ -1630,6 +1840,13 @@ void detail::optimizer::optimize(Builder* builder, ASTRoot* root) {
             break;
     }
 
+    if ( integer_ranges ) {
+        IntegerRangeVisitor v;
+        visitor::visit(v, root);
+        HILTI_DEBUG(logging::debug::OptimizerRanges, util::fmt("elided %" PRIu64 " overflow checks", v._num_elided));
+        util::timing::count("hilti/compiler/optimizer/elided-overflow-checks", v._num_elided);
+    }
+
     // Clear cached information which might become outdated due to edits.
     auto v = hilti::visitor::PreOrder();
     for ( auto* n : hilti::visitor::range(v, root, {}) )
@@ -232,6 +232,7 @@ static int _field_width = 0;
 %token UINT64 "uint64"
 %token UINT8 "uint8"
 %token UNION "union"
+%token UNORDERED "&unordered"
 %token UNPACK "unpack"
 %token UNSET "unset"
 %token VECTOR "vector"
@@ -615,8 +616,11 @@ base_type_no_attrs
               | VECTOR type_param_begin qtype type_param_end             { $$ = builder->typeVector(std::move($3), __loc__); }
               | SET type_param_begin '*' type_param_end                  { $$ = builder->typeSet(hilti::type::Wildcard(), __loc__); }
               | SET type_param_begin qtype type_param_end                { $$ = builder->typeSet(std::move($3), __loc__); }
+              | SET type_param_begin qtype type_param_end UNORDERED      { auto* t = builder->typeSet(std::move($3), __loc__); t->setUnordered(true); $$ = t; }
               | MAP type_param_begin '*' type_param_end                  { $$ = builder->typeMap(hilti::type::Wildcard(), __loc__); }
               | MAP type_param_begin qtype ',' qtype type_param_end      { $$ = builder->typeMap(std::move($3), std::move($5), __loc__); }
+              | MAP type_param_begin qtype ',' qtype type_param_end UNORDERED
+                                                                         { auto* t = builder->typeMap(std::move($3), std::move($5), __loc__); t->setUnordered(true); $$ = t; }
 
               | EXCEPTION                        { $$ = builder->typeException(__loc__); }
               | '[' EXCEPTION ':' type ']'       { $$ = builder->typeException(std::move($4), __loc__); }
@@ -164,6 +164,7 @@ uint8                 return token::UINT8;
 union                 return token::UNION;
 unpack                return token::UNPACK;
 unset                 return token::UNSET;
+\&unordered           return token::UNORDERED;
 value_ref             return token::VALUE_REF;
 vector                return token::VECTOR;
 view                  return token::VIEW;
@@ -947,7 +947,7 @@ struct Printer : visitor::PreOrder {
         if ( n->isWildcard() )
             _out << "iterator<map<*>>";
         else
-            _out << fmt("iterator<map<%s>>", *n->dereferencedType());
+            _out << fmt("iterator<map<%s>%s>", *n->dereferencedType(), (n->isUnordered() ? " &unordered" : ""));
     }
 
     void operator()(type::Map* n) final {
@@ -955,6 +955,9 @@ struct Printer : visitor::PreOrder {
             _out << "map<*>";
         else {
             _out << "map<" << n->keyType() << ", " << n->valueType() << ">";
+
+            if ( n->isUnordered() )
+                _out << " &unordered";
         }
     }
 
@@ -972,7 +975,7 @@ struct Printer : visitor::PreOrder {
         if ( n->isWildcard() )
             _out << "iterator<set<*>>";
         else
-            _out << fmt("iterator<set<%s>>", *n->dereferencedType());
+            _out << fmt("iterator<set<%s>%s>", *n->dereferencedType(), (n->isUnordered() ? " &unordered" : ""));
     }
 
     void operator()(type::Set* n) final {
@@ -980,6 +983,9 @@ struct Printer : visitor::PreOrder {
             _out << "set<*>";
         else {
             _out << "set<" << n->elementType() << ">";
+
+            if ( n->isUnordered() )
+                _out << " &unordered";
         }
     }
 
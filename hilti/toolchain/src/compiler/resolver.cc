@@ -1659,14 +1659,20 @@ struct VisitorPass3 : visitor::MutatingPostOrder {
 bool detail::resolver::resolve(Builder* builder, Node* root) {
     util::timing::Collector _("hilti/compiler/ast/resolver");
 
+    // Visit only modules that may have changed since the previous round.
+    auto modules = builder->context()->modulesToResolve();
+
     auto v1 = VisitorPass1(builder);
-    hilti::visitor::visit(v1, root);
+    for ( auto* m : modules )
+        hilti::visitor::visit(v1, m);
 
     auto v2 = VisitorPass2(builder, root);
-    hilti::visitor::visit(v2, root);
+    for ( auto* m : modules )
+        hilti::visitor::visit(v2, m);
 
     auto v3 = VisitorPass3(builder, v2);
-    hilti::visitor::visit(v3, root);
+    for ( auto* m : modules )
+        hilti::visitor::visit(v3, m);
 
     return v1.isModified() || v2.isModified() || v3.isModified();
 }
@@ -67,7 +67,7 @@ public:
     }
 
     void operator()(type::Map* n) final {
-        unifier->add("map(");
+        unifier->add(n->isUnordered() ? "unordered-map(" : "map(");
         unifier->add(n->keyType());
         unifier->add("->");
         unifier->add(n->valueType());
@@ -99,7 +99,7 @@ public:
     }
 
     void operator()(type::Set* n) final {
-        unifier->add("set(");
+        unifier->add(n->isUnordered() ? "unordered-set(" : "set(");
         unifier->add(n->elementType());
         unifier->add(")");
     }
@@ -150,7 +150,7 @@ public:
     }
 
     void operator()(type::map::Iterator* n) final {
-        unifier->add("iterator(map(");
+        unifier->add(n->isUnordered() ? "iterator(unordered-map(" : "iterator(map(");
         unifier->add(n->keyType());
         unifier->add("->");
         unifier->add(n->valueType());
@@ -158,7 +158,7 @@ public:
     }
 
     void operator()(type::set::Iterator* n) final {
-        unifier->add("iterator(set(");
+        unifier->add(n->isUnordered() ? "iterator(unordered-set(" : "iterator(set(");
         unifier->add(n->dereferencedType());
         unifier->add("))");
     }
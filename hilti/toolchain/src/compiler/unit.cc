@@ -116,6 +116,21 @@ Result<CxxCode> Unit::cxxCode() const {
     return CxxCode{_cxx_unit->cxxModuleID(), cxx};
 }
 
+Result<std::vector<CxxCode>> Unit::cxxCodeShards() const {
+    if ( ! _cxx_unit )
+        return result::Error("no C++ code available for unit");
+
+    std::vector<CxxCode> shards;
+
+    for ( size_t i = 0; i < _cxx_unit->numShards(); i++ ) {
+        std::stringstream cxx;
+        _cxx_unit->printShard(i, cxx);
+        shards.emplace_back(fmt("%s__shard%u", _cxx_unit->cxxModuleID(), i + 1), cxx);
+    }
+
+    return shards;
+}
+
 bool Unit::requiresCompilation() {
     if ( _requires_compilation )
         return true;
@@ -68,7 +68,7 @@ using util::fmt;
 static std::unordered_map<node::Tag, std::unordered_set<attribute::Kind>> allowed_attributes{
     {node::tag::Function,
      {attribute::kind::Cxxname, attribute::kind::HavePrototype, attribute::kind::Priority, attribute::kind::Static,
-      attribute::kind::NeededByFeature, attribute::kind::Debug}},
+      attribute::kind::NeededByFeature, attribute::kind::Debug, attribute::kind::SuspendsOnlyForInput}},
     {node::tag::declaration::Parameter, {attribute::kind::RequiresTypeFeature}},
 };
 
@@ -181,6 +181,21 @@ struct VisitorPost : visitor::PreOrder, public validator::VisitorMixIn {
         return Nothing();
     }
 
+    Result<Nothing> isHashable(QualifiedType* t) {
+        if ( ! t->type()->isHashable() )
+            return result::Error(fmt("type '%s' is not hashable", *t));
+
+        // Hashability of tuples requires hashable element types.
+        if ( auto* tt = t->type()->tryAs<type::Tuple>() ) {
+            for ( const auto& e : tt->elements() ) {
+                if ( auto rc = isHashable(e->type()); ! rc )
+                    return rc;
+            }
+        }
+
+        return Nothing();
+    }
+
     // Ensures the declaration's type is a valid type.
     void checkDeclarationType(Declaration* decl, QualifiedType* ty) {
         if ( ty->type()->isA<hilti::type::Struct>() || ty->type()->isA<hilti::type::Enum>() ||
@@ -256,6 +271,10 @@ struct VisitorPost : visitor::PreOrder, public validator::VisitorMixIn {
                     error(x.error(), n);
             }
 
+            if ( attrs->has(hilti::attribute::kind::SuspendsOnlyForInput) &&
+                 n->callingConvention() != function::CallingConvention::Extern )
+                error("only 'extern' functions can be declared with &suspends-only-for-input", n);
+
             if ( ! n->body() && ! is_hook && ! attrs->has(hilti::attribute::kind::Cxxname) )
                 error(fmt("function '%s' must have a body or be declared with &cxxname", n->id()), n);
         }
@@ -724,7 +743,11 @@ struct VisitorPost : visitor::PreOrder, public validator::VisitorMixIn {
 
     void operator()(type::Map* n) final {
         if ( ! n->keyType()->type()->isA<type::Unknown>() ) { // unknown will be reported elsewhere
-            if ( auto rc = isSortable(n->keyType()); ! rc )
+            if ( n->isUnordered() ) {
+                if ( auto rc = isHashable(n->keyType()); ! rc )
+                    error(fmt("type cannot be used as key type for unordered maps (because %s)", rc.error()), n);
+            }
+            else if ( auto rc = isSortable(n->keyType()); ! rc )
                 error(fmt("type cannot be used as key type for maps (because %s)", rc.error()), n);
         }
     }
@@ -738,7 +761,11 @@ struct VisitorPost : visitor::PreOrder, public validator::VisitorMixIn {
 
     void operator()(type::Set* n) final {
         if ( ! n->elementType()->type()->isA<type::Unknown>() ) { // unknown will be reported elsewhere
-            if ( auto rc = isSortable(n->elementType()); ! rc )
+            if ( n->isUnordered() ) {
+                if ( auto rc = isHashable(n->elementType()); ! rc )
+                    error(fmt("type cannot be used as element type for unordered sets (because %s)", rc.error()), n);
+            }
+            else if ( auto rc = isSortable(n->elementType()); ! rc )
                 error(fmt("type cannot be used as element type for sets (because %s)", rc.error()), n);
         }
     }
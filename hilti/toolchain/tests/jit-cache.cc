@@ -0,0 +1,165 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+#include <doctest/doctest.h>
+
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <hilti/rt/filesystem.h>
+
+#include <hilti/compiler/detail/jit-cache.h>
+
+using namespace hilti;
+using Cache = hilti::detail::jit::Cache;
+
+namespace {
+
+// Creates a fresh directory for a test, removing it again on destruction.
+class TemporaryDirectory {
+public:
+    TemporaryDirectory() {
+        std::string path = hilti::rt::filesystem::temp_directory_path() / "hilti-jit-cache-test-XXXXXX";
+        REQUIRE(::mkdtemp(path.data()));
+        _path = path;
+    }
+
+    ~TemporaryDirectory() {
+        std::error_code ec;
+        hilti::rt::filesystem::remove_all(_path, ec);
+    }
+
+    const auto& path() const { return _path; }
+
+private:
+    hilti::rt::filesystem::path _path;
+};
+
+void write(const hilti::rt::filesystem::path& path, const std::string& content) {
+    std::ofstream out(path);
+    out << content;
+}
+
+std::string read(const hilti::rt::filesystem::path& path) {
+    std::ifstream in(path);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+} // namespace
+
+TEST_SUITE_BEGIN("jit-cache");
+
+TEST_CASE("key") {
+    CHECK_EQ(Cache::key({"a", "b"}), Cache::key({"a", "b"}));
+    CHECK_EQ(Cache::key({"a", "b"}).size(), 32U);
+    CHECK_NE(Cache::key({"a", "b"}), Cache::key({"b", "a"}));
+    CHECK_NE(Cache::key({"ab", ""}), Cache::key({"a", "b"}));
+    CHECK_NE(Cache::key({"a"}), Cache::key({"a", ""}));
+}
+
+TEST_CASE("file key") {
+    TemporaryDirectory tmp;
+
+    write(tmp.path() / "a", "content");
+    write(tmp.path() / "b", "content");
+    auto a = Cache::fileKey(tmp.path() / "a");
+    REQUIRE(a);
+    CHECK_EQ(*a, *Cache::fileKey(tmp.path() / "b"));
+
+    write(tmp.path() / "b", "changed");
+    CHECK_NE(*a, *Cache::fileKey(tmp.path() / "b"));
+
+    CHECK_FALSE(Cache::fileKey(tmp.path() / "does-not-exist"));
+}
+
+TEST_CASE("open") {
+    TemporaryDirectory tmp;
+
+    auto cache = Cache::open(tmp.path() / "x" / "y", 0);
+    REQUIRE(cache);
+    CHECK(hilti::rt::filesystem::is_directory(tmp.path() / "x" / "y"));
+
+    write(tmp.path() / "file", "");
+    CHECK_FALSE(Cache::open(tmp.path() / "file" / "y", 0));
+}
+
+TEST_CASE("store and retrieve") {
+    TemporaryDirectory tmp;
+
+    auto cache = Cache::open(tmp.path() / "cache", 0);
+    REQUIRE(cache);
+
+    const auto key = Cache::key({"code"});
+    const auto src = tmp.path() / "src.o";
+    const auto dst = tmp.path() / "dst.o";
+
+    CHECK_FALSE(cache->retrieve(key, ".o", dst));
+    CHECK_FALSE(hilti::rt::filesystem::exists(dst));
+
+    write(src, "object code");
+    cache->store(key, ".o", src);
+
+    CHECK(cache->retrieve(key, ".o", dst));
+    CHECK_EQ(read(dst), "object code");
+
+    // Entries with different extensions are separate.
+    CHECK_FALSE(cache->retrieve(key, ".hlto", dst));
+
+    // Storing again replaces the entry, and retrieval overwrites existing files.
+    write(src, "new object code");
+    cache->store(key, ".o", src);
+    CHECK(cache->retrieve(key, ".o", dst));
+    CHECK_EQ(read(dst), "new object code");
+
+    const auto& stats = cache->statistics();
+    CHECK_EQ(stats.hits, 2U);
+    CHECK_EQ(stats.misses, 2U);
+    CHECK_EQ(stats.stores, 2U);
+    CHECK_EQ(stats.evictions, 0U);
+}
+
+TEST_CASE("evict") {
+    TemporaryDirectory tmp;
+
+    auto cache = Cache::open(tmp.path() / "cache", 25);
+    REQUIRE(cache);
+
+    const auto src = tmp.path() / "src.o";
+    const auto dst = tmp.path() / "dst.o";
+    write(src, "0123456789");
+
+    // Store three entries of 10 bytes each, with distinct access times.
+    const auto now = hilti::rt::filesystem::file_time_type::clock::now();
+    for ( auto i : {1, 2, 3} ) {
+        auto key = Cache::key({std::to_string(i)});
+        cache->store(key, ".o", src);
+        hilti::rt::filesystem::last_write_time(cache->directory() / (key + ".o"), now - std::chrono::minutes(10 - i));
+    }
+
+    // Accessing the oldest entry makes it the most recently used one.
+    CHECK(cache->retrieve(Cache::key({"1"}), ".o", dst));
+
+    cache->evict();
+    CHECK_EQ(cache->statistics().evictions, 1U);
+
+    CHECK(cache->retrieve(Cache::key({"1"}), ".o", dst));
+    CHECK_FALSE(cache->retrieve(Cache::key({"2"}), ".o", dst));
+    CHECK(cache->retrieve(Cache::key({"3"}), ".o", dst));
+
+    // Stale temporary files get cleaned up, but recent ones are left alone
+    // as other processes might be in the middle of writing them.
+    auto stale = cache->directory() / ".tmp-stale";
+    auto fresh = cache->directory() / ".tmp-fresh";
+    write(stale, "");
+    write(fresh, "");
+    hilti::rt::filesystem::last_write_time(stale, now - std::chrono::hours(2));
+
+    cache->evict();
+    CHECK_FALSE(hilti::rt::filesystem::exists(stale));
+    CHECK(hilti::rt::filesystem::exists(fresh));
+}
+
+TEST_SUITE_END();
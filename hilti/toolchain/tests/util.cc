@@ -8,11 +8,13 @@
 #include <doctest/doctest.h>
 
 #include <cstdlib>
+#include <sstream>
 #include <vector>
 
 #include <hilti/rt/filesystem.h>
 
 #include <hilti/autogen/config.h>
+#include <hilti/base/timing.h>
 #include <hilti/base/util.h>
 
 TEST_SUITE_BEGIN("util");
@@ -108,4 +110,19 @@ TEST_CASE("split_shell_unsafe") {
     CHECK(is_unset_or_empty);
 }
 
+TEST_CASE("timing::count") {
+    {
+        hilti::util::timing::Collector _("test/util/timing-count");
+    }
+
+    hilti::util::timing::count("test/util/counter", 2);
+    hilti::util::timing::count("test/util/counter", 3);
+
+    std::stringstream out;
+    hilti::util::timing::summary(out);
+
+    CHECK_NE(out.str().find("=== Counters ==="), std::string::npos);
+    CHECK_NE(out.str().find("           5   test/util/counter\n"), std::string::npos);
+}
+
 TEST_SUITE_END();
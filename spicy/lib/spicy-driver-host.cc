@@ -131,23 +131,23 @@ int main(int argc, char** argv) {
         if ( driver.opt_list_parsers )
             driver.listParsers(std::cout);
 
-        else {
+        else if ( driver.opt_input_is_batch ) {
             std::ifstream in(driver.opt_file, std::ios::in | std::ios::binary);
 
             if ( ! in.is_open() )
                 fatalError(prog, "cannot open input for reading");
 
-            if ( driver.opt_input_is_batch ) {
-                if ( auto x = driver.processPreBatchedInput(in); ! x )
-                    fatalError(prog, x.error());
-            }
-            else {
-                auto parser = driver.lookupParser(driver.opt_parser);
-                if ( ! parser )
-                    fatalError(prog, parser.error());
+            if ( auto x = driver.processPreBatchedInput(in); ! x )
+                fatalError(prog, x.error());
+        }
 
-                driver.processInput(**parser, in, driver.opt_increment);
-            }
+        else {
+            auto parser = driver.lookupParser(driver.opt_parser);
+            if ( ! parser )
+                fatalError(prog, parser.error());
+
+            if ( auto x = driver.processInput(**parser, driver.opt_file, driver.opt_increment); ! x )
+                fatalError(prog, x.error());
         }
 
         spicy::rt::done();
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -34,6 +35,15 @@ public:
     Stream& operator=(const Stream&) = default;
     Stream& operator=(Stream&&) noexcept = default;
 
+    /**
+     * Limits the total amount of data that encoding or decoding may
+     * produce. If exceeded, the operation throws a `Base64Error` and the
+     * stream cannot be used any further.
+     *
+     * @param max_size maximum total number of bytes to produce; zero for no limit
+     */
+    void setLimit(uint64_t max_size);
+
     /**
      * Encode a chunk of data. Each chunk will continue where the previous
      * one left off.
@@ -78,9 +88,22 @@ public:
     hilti::rt::Bytes finish();
 
 private:
+    // Encodes/decodes a block of data, appending the result to the output.
+    void _encode(const char* data, uint64_t size, std::string* encoded);
+    void _decode(const char* data, uint64_t size, std::string* decoded);
+
+    // Accounts for newly produced output, throwing if exceeding the limit.
+    void _checkLimit(uint64_t len);
+
     std::shared_ptr<detail::State> _state;
 };
 
+/** Forwards to the corresponding `Stream` method. */
+inline void set_limit(Stream& stream, // NOLINT(google-runtime-references)
+                      uint64_t max_size) {
+    stream.setLimit(max_size);
+}
+
 /** Forwards to the corresponding `Stream` method. */
 inline hilti::rt::Bytes encode(Stream& stream, // NOLINT(google-runtime-references)
                                const hilti::rt::Bytes& data) {
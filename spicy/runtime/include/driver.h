@@ -2,10 +2,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <optional>
+#include <ostream>
 #include <string>
 #include <utility>
 
+#include <hilti/rt/filesystem.h>
 #include <hilti/rt/result.h>
 
 #include <spicy/rt/parser.h>
@@ -194,6 +197,11 @@ struct ConnectionState {
     ParsingStateForDriver* resp_state = nullptr;
 };
 
+namespace detail {
+struct BatchCommand;
+struct BatchState;
+} // namespace detail
+
 } // namespace driver
 
 /** Exception thrown when a unit type is requested for parsing that isn't useable. */
@@ -242,15 +250,43 @@ public:
     hilti::rt::Result<spicy::rt::ParsedUnit> processInput(const spicy::rt::Parser& parser, std::istream& in,
                                                           int increment = 0);
 
+    /**
+     * Feeds a parser with the content of a file. If the file is a regular
+     * file, this maps it into memory and passes the data to the parser
+     * without copying it. Otherwise, this falls back to reading the file as
+     * a stream.
+     *
+     * @param parser parser to instantiate and feed
+     * @param path file to read input data from
+     * @param increment if non-zero, will feed the data in small chunks at a
+     * time; this is mainly for testing parsers; incremental parsing
+     *
+     * @return error if the input couldn't be fed to the parser (excluding parse errors)
+     * @throws HILTI or Spicy runtime error if the parser into trouble
+     */
+    hilti::rt::Result<spicy::rt::ParsedUnit> processInput(const spicy::rt::Parser& parser,
+                                                          const hilti::rt::filesystem::path& path, int increment = 0);
+
     /**
      * Processes a batch of input data given in Spicy's custom batch
      * format. See the documentation of `spicy-driver` for a reference of the
      * batch format.
      *
+     * With more than one thread, flows and connections are distributed
+     * across worker threads by hashing their IDs, with each worker running
+     * inside its own runtime context. All input for a flow or connection is
+     * processed by the same worker in the order it appears in the batch.
+     * Output is buffered per command and written in input order, so it
+     * remains the same as with sequential processing as long as parsers do
+     * not share state across flows. To give each worker its own set of
+     * globals, code must be compiled with dynamic globals enabled.
+     *
      * @param in an open stream to read the batch from
+     * @param threads number of worker threads to use; with a value of zero
+     * or one, the batch is processed sequentially on the current thread
      * @returns appropriate error if there was a problem processing the batch
      */
-    hilti::rt::Result<hilti::rt::Nothing> processPreBatchedInput(std::istream& in);
+    hilti::rt::Result<hilti::rt::Nothing> processPreBatchedInput(std::istream& in, unsigned int threads = 1);
 
     /** Records a debug message to the `spicy-driver` runtime debug stream. */
     void debug(const std::string& msg);
@@ -259,8 +295,16 @@ private:
     void _debugStats(const hilti::rt::ValueReference<hilti::rt::Stream>& data);
     void _debugStats(size_t current_flows, size_t current_connections);
 
-    uint64_t _total_flows = 0;
-    uint64_t _total_connections = 0;
+    // Feeds the next piece of input into parsing, returning true once parsing has finished.
+    bool _parseInput(const spicy::rt::Parser& parser, hilti::rt::ValueReference<spicy::rt::ParsedUnit>& unit,
+                     hilti::rt::ValueReference<hilti::rt::Stream>& data, std::optional<hilti::rt::Resumable>& r);
+
+    void _executeBatchCommand(driver::detail::BatchState* state, const driver::detail::BatchCommand& cmd,
+                              std::ostream& out);
+    hilti::rt::Result<hilti::rt::Nothing> _processPreBatchedInputConcurrently(std::istream& in, unsigned int threads);
+
+    std::atomic<uint64_t> _total_flows{0};
+    std::atomic<uint64_t> _total_connections{0};
 };
 
 } // namespace spicy::rt
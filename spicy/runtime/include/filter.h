@@ -2,9 +2,13 @@
 
 #pragma once
 
+#include <memory>
+#include <optional>
 #include <utility>
 
 #include <hilti/rt/extension-points.h>
+#include <hilti/rt/fiber.h>
+#include <hilti/rt/types/bytes.h>
 #include <hilti/rt/types/reference.h>
 #include <hilti/rt/types/stream.h>
 
@@ -51,6 +55,12 @@ using Filters = hilti::rt::Vector<OneFilter>;
  */
 using Forward = hilti::rt::Stream;
 
+/** Pseudo-parser object for native filters, providing what `connect()` needs from a filter's parser. */
+struct NativeParser {
+    const char* name;
+    hilti::rt::any parse2;
+};
+
 } // namespace detail
 
 /**
@@ -180,6 +190,83 @@ void connect(UnitType<U>& unit, const hilti::rt::TypeInfo* ti, UnitRef<F> filter
     detail::connect(*unit, filter_unit);
 }
 
+/**
+ * Base class for filters implemented natively in C++ instead of as Spicy
+ * filter units. They get connected through `connect()` just like filter
+ * units, but rather than parsing their input, they process it directly from
+ * the input stream's blocks, and append their output to the destination
+ * stream as new chunks without copying it.
+ *
+ * @tparam F derived class implementing the filter; it must provide a static
+ * `Name` for debug output, a method `hilti::rt::Bytes process(const
+ * hilti::rt::stream::View& data)` transforming the next piece of input, and
+ * a method `hilti::rt::Bytes finish()` returning any final output once the
+ * input has ended
+ */
+template<typename F>
+class Native {
+public:
+    /** Destination for data being forwarded. Set when connecting the filter. */
+    hilti::rt::WeakReference<::spicy::rt::filter::detail::Forward> __forward;
+
+    /** Pseudo-parser object driving the filter. */
+    inline static detail::NativeParser __parser = {F::Name, Parse2Function<F>(&Native::_parse)};
+
+private:
+    static hilti::rt::Resumable _parse(UnitType<F>& filter, hilti::rt::ValueReference<hilti::rt::Stream>& data,
+                                       const std::optional<hilti::rt::stream::View>& cur,
+                                       const std::optional<UnitContext>& /* context */) {
+        // Keep the filter and its input alive while suspended, without
+        // copying them.
+        std::shared_ptr<F> self = filter.asSharedPtr();
+        std::shared_ptr<hilti::rt::Stream> input = data.asSharedPtr();
+        auto view = cur ? *cur : input->view();
+
+        return hilti::rt::fiber::execute([self, input, view](hilti::rt::resumable::Handle* /* r */) {
+            static_cast<Native&>(*self)._run(input.get(), view);
+            return hilti::rt::any(hilti::rt::Nothing());
+        });
+    }
+
+    // Processes input until reaching its end, suspending whenever the
+    // current input has been consumed.
+    void _run(hilti::rt::Stream* input, hilti::rt::stream::View cur) {
+        auto& self = static_cast<F&>(*this);
+
+        while ( true ) {
+            if ( cur.size() ) {
+                _forward(self.process(cur));
+                cur = cur.advance(cur.size());
+                input->trim(cur.begin());
+            }
+
+            if ( cur.isComplete() )
+                break;
+
+            SPICY_RT_DEBUG_VERBOSE(hilti::rt::fmt("- native filter %s [%p] suspending to wait for more input", F::Name,
+                                                  this));
+            hilti::rt::detail::yield();
+        }
+
+        _forward(self.finish());
+
+        if ( __forward ) {
+            SPICY_RT_DEBUG_VERBOSE(hilti::rt::fmt("- native filter %s [%p] is forwarding EOD to stream %p", F::Name,
+                                                  this, __forward.get()));
+            __forward->freeze();
+        }
+    }
+
+    void _forward(hilti::rt::Bytes&& data) {
+        if ( ! __forward )
+            return;
+
+        SPICY_RT_DEBUG_VERBOSE(hilti::rt::fmt("- native filter %s [%p] is forwarding %u bytes to stream %p",
+                                              F::Name, this, data.size(), __forward.get()));
+        __forward->append(std::move(data));
+    }
+};
+
 /**
  * Set up filtering for a unit if any filters have been connected. Must be
  * called before parsing starts.
@@ -246,6 +333,33 @@ inline void forward(UnitType<U>& unit, const hilti::rt::TypeInfo* ti, const hilt
     return forward(*unit, ti, data);
 }
 
+/**
+ * Forward data from a filter unit to the unit it's connected to, taking
+ * ownership of the data. This avoids copying it: the data becomes a new chunk
+ * of the destination stream as is. A noop if the unit isn't connected as a
+ * filter to anything.
+ *
+ * @tparam S type compatible with the attribute's defined by the `State` type.
+ */
+template<typename S>
+inline void forward(S& state, const hilti::rt::TypeInfo* /* ti */, hilti::rt::Bytes&& data) {
+    if ( ! state.__forward ) {
+        SPICY_RT_DEBUG_VERBOSE(
+            hilti::rt::fmt("- filter unit %s [%p] is forwarding \"%s\", but not connected to any unit",
+                           S::__parser.name, &state, data));
+        return;
+    }
+
+    SPICY_RT_DEBUG_VERBOSE(hilti::rt::fmt("- filter unit %s [%p] is forwarding \"%s\" to stream %p", S::__parser.name,
+                                          &state, data, state.__forward.get()));
+    state.__forward->append(std::move(data));
+}
+
+template<typename U>
+inline void forward(UnitType<U>& unit, const hilti::rt::TypeInfo* ti, hilti::rt::Bytes&& data) {
+    return forward(*unit, ti, std::move(data));
+}
+
 /**
  * Signals EOD from a filter unit to the unit it's connected to. A noop if
  * the unit isn't connected as a filter to anything.
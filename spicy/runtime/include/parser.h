@@ -11,6 +11,7 @@
 
 #include <hilti/rt/exception.h>
 #include <hilti/rt/fiber.h>
+#include <hilti/rt/profiler.h>
 #include <hilti/rt/result.h>
 #include <hilti/rt/type-info.h>
 #include <hilti/rt/types/bytes.h>
@@ -249,15 +250,16 @@ struct Parser {
     /** Type-information for puarser's unit. */
     const hilti::rt::TypeInfo* type_info;
 
-    /** Pre-computed profiler tags used by the runtime driver. */
+    /** Pre-interned profiler tags used by the runtime driver. */
     struct {
-        std::string prepare_block = "spicy/prepare/block/";
-        std::string prepare_input = "spicy/prepare/input/";
-        std::string prepare_stream = "spicy/prepare/stream/";
+        hilti::rt::profiler::Tag prepare_block = 0;
+        hilti::rt::profiler::Tag prepare_input = 0;
+        hilti::rt::profiler::Tag prepare_stream = 0;
+        bool initialized = false;
 
         operator bool() const {
             // ensure initialization code has run
-            return ! prepare_input.empty();
+            return initialized;
         }
     } profiler_tags;
 
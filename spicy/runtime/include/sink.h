@@ -2,7 +2,7 @@
 
 #pragma once
 
-#include <list>
+#include <map>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -211,6 +211,18 @@ public:
         _initial_seq = seq;
     }
 
+    /**
+     * Limits the amount of out-of-order data the sink buffers. If more is
+     * pending, the sink skips ahead over any missing data until it's back
+     * within limits. This only takes effect with auto-trimming enabled.
+     *
+     * @param max maximum number of bytes to buffer; zero means unlimited
+     */
+    void set_max_buffer_size(uint64_t max) {
+        _max_buffered = max;
+        _enforceBufferLimit();
+    }
+
     /** Sets the sink's reassembler policy. */
     void set_policy(sink::ReassemblerPolicy policy) { _policy = policy; }
 
@@ -261,7 +273,9 @@ private:
             : data(std::move(data)), rseq(rseq), rupper(rupper) {}
     };
 
-    using ChunkList = std::list<Chunk>;
+    // Buffered chunks indexed by their starting sequence number. Chunks
+    // never overlap, so that this orders them by their end as well.
+    using ChunkMap = std::map<uint64_t, Chunk>;
 
     // Returns true if any input has been passed in already (including gaps).
     bool _haveInput() { return _cur_rseq || _chunks.size(); }
@@ -285,9 +299,18 @@ private:
     // (Re-)initialize instance.
     void _init();
 
-    // Add new data to buffer, beginning search for insert position at given start *c*.
-    ChunkList::iterator _addAndCheck(std::optional<hilti::rt::Bytes> data, uint64_t rseq, uint64_t rupper,
-                                     ChunkList::iterator c);
+    // Add new data to buffer, returning the chunk covering *rseq* afterwards.
+    ChunkMap::iterator _addAndCheck(std::optional<hilti::rt::Bytes> data, uint64_t rseq, uint64_t rupper);
+
+    // Inserts a new chunk into the buffer, with *hint* being the chunk following it.
+    ChunkMap::iterator _insert(ChunkMap::iterator hint, std::optional<hilti::rt::Bytes> data, uint64_t rseq,
+                               uint64_t rupper);
+
+    // Removes a chunk from the buffer, returning the one following it.
+    ChunkMap::iterator _erase(ChunkMap::iterator c);
+
+    // Skips over missing data while buffering more than the configured limit.
+    void _enforceBufferLimit();
 
     // Deliver data to connected parsers. Returns false if the data is empty (i.e., a gap).
     bool _deliver(std::optional<hilti::rt::Bytes> data, uint64_t rseq, uint64_t rupper);
@@ -302,7 +325,7 @@ private:
     void _trim(uint64_t rseq);
 
     // Deliver as much as possible starting at given buffer position.
-    void _tryDeliver(ChunkList::iterator c);
+    void _tryDeliver(ChunkMap::iterator c);
 
     // Trigger various hooks.
     void _reportGap(uint64_t rseq, uint64_t len) const;
@@ -340,7 +363,9 @@ private:
     uint64_t _cur_rseq{};          // Sequence of last delivered byte + 1 (i.e., seq of next)
     uint64_t _last_reassem_rseq{}; // Sequence of last byte reassembled and delivered + 1.
     uint64_t _trim_rseq{};         // Sequence of last byte trimmed so far + 1.
-    ChunkList _chunks;             // Buffered data not yet delivered or trimmed
+    uint64_t _buffered{};          // Number of data bytes currently buffered in `_chunks`.
+    uint64_t _max_buffered{};      // Maximum number of bytes to buffer before skipping ahead; zero for unlimited.
+    ChunkMap _chunks;              // Buffered data not yet delivered or trimmed
 };
 
 } // namespace spicy::rt
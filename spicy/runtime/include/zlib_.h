@@ -2,12 +2,17 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
+#include <hilti/rt/type-info.h>
 #include <hilti/rt/types/bytes.h>
 #include <hilti/rt/types/stream.h>
 
+#include <spicy/rt/filter.h>
+#include <spicy/rt/typedefs.h>
+
 namespace spicy::rt::zlib {
 
 namespace detail {
@@ -39,6 +44,17 @@ public:
     Stream& operator=(const Stream&) = default;
     Stream& operator=(Stream&&) noexcept = default;
 
+    /**
+     * Limits the amount of data that decompression may produce, protecting
+     * against decompression bombs. If decompression exceeds a limit, it
+     * throws a `ZlibError` and the stream cannot be used any further.
+     *
+     * @param max_size maximum total number of bytes to decompress; zero for no limit
+     * @param max_ratio maximum ratio of the total number of decompressed
+     * bytes to the total number of compressed bytes; zero for no limit
+     */
+    void setLimits(uint64_t max_size, uint64_t max_ratio);
+
     /**
      * Decompresses a chunk of data. Each chunk will continue where the
      * previous one left off.
@@ -65,15 +81,79 @@ public:
     hilti::rt::Bytes finish();
 
 private:
+    // Decompresses a block of data, appending the result to `decoded`.
+    void _inflate(const unsigned char* data, uint64_t size, std::string* decoded);
+
     std::shared_ptr<detail::State> _state;
 };
 
+/**
+ * Filter performing zlib decompression natively. In contrast to a filter unit
+ * passing each chunk of input to `Stream::decompress()`, it inflates straight
+ * from the blocks of its input stream, and moves the output into the
+ * destination stream as new chunks.
+ */
+class Filter : public filter::Native<Filter> {
+public:
+    /** Name of the filter for debug output. */
+    static constexpr const char* Name = "zlib::Filter";
+
+    /**
+     * Constructor.
+     *
+     * @param window_bits value corresponding to zlib's `windowBits` parameter
+     * for `inflateInit2`, selecting the input format; the default is the
+     * same as for `Stream`
+     * @param max_size maximum total number of bytes to decompress; zero for no limit
+     * @param max_ratio maximum ratio of the total number of decompressed
+     * bytes to the total number of compressed bytes; zero for no limit
+     */
+    Filter(int64_t window_bits = 15 + 32, uint64_t max_size = 0, uint64_t max_ratio = 0) : _stream(window_bits) {
+        _stream.setLimits(max_size, max_ratio);
+    }
+
+    /** Decompresses the next piece of input. */
+    hilti::rt::Bytes process(const hilti::rt::stream::View& data) { return _stream.decompress(data); }
+
+    /** Signals the end of input, returning any remaining output. */
+    hilti::rt::Bytes finish() { return _stream.finish(); }
+
+private:
+    Stream _stream;
+};
+
+/**
+ * Connects a native zlib decompression filter to a unit. This is an
+ * alternative to connecting one of the zlib filter units that avoids copying
+ * the data; see `Filter`.
+ *
+ * @tparam S type compatible with the attribute's defined by the `filter::State` type
+ */
+template<typename S>
+void connect_filter(S& state, // NOLINT(google-runtime-references)
+                    const hilti::rt::TypeInfo* /* ti */, int64_t window_bits, uint64_t max_size,
+                    uint64_t max_ratio) {
+    filter::detail::connect(state, UnitRef<Filter>(Filter(window_bits, max_size, max_ratio)));
+}
+
+template<typename U>
+void connect_filter(UnitType<U>& unit, // NOLINT(google-runtime-references)
+                    const hilti::rt::TypeInfo* ti, int64_t window_bits, uint64_t max_size, uint64_t max_ratio) {
+    connect_filter(*unit, ti, window_bits, max_size, max_ratio);
+}
+
 /** Instantiates a new `Stream` object, forwarding arguments to its constructor. */
 inline Stream init(int64_t window_bits) // NOLINT(google-runtime-references)
 {
     return Stream(window_bits);
 }
 
+/** Forwards to the corresponding `Stream` method. */
+inline void set_limits(Stream& stream, // NOLINT(google-runtime-references)
+                       uint64_t max_size, uint64_t max_ratio) {
+    stream.setLimits(max_size, max_ratio);
+}
+
 /** Forwards to the corresponding `Stream` method. */
 inline hilti::rt::Bytes decompress(Stream& stream, // NOLINT(google-runtime-references)
                                    const hilti::rt::Bytes& data) {
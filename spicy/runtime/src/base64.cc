@@ -1,5 +1,8 @@
 // Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
 
+#include <string>
+#include <utility>
+
 #include <hilti/rt/types/bytes.h>
 
 #include <spicy/rt/base64.h>
@@ -15,6 +18,8 @@ using namespace spicy::rt::base64;
 struct detail::State {
     base64_encodestate estate;
     base64_decodestate dstate;
+    uint64_t total_out = 0; // total output produced so far
+    uint64_t max_size = 0;  // maximum total output, or zero for no limit
 };
 
 Stream::Stream() {
@@ -31,56 +36,81 @@ Stream::Stream() {
 // It'll eventually be cleaned up.
 Stream::~Stream() = default;
 
+void Stream::setLimit(uint64_t max_size) {
+    if ( ! _state )
+        throw Base64Error("stream already finished");
+
+    _state->max_size = max_size;
+}
+
+void Stream::_encode(const char* data, uint64_t size, std::string* encoded) {
+    // Encoding expands by 4/3, plus line breaks and the final block.
+    auto used = encoded->size();
+    encoded->resize(used + (size * 2) + 4);
+    auto len = base64_encode_block(data, static_cast<int>(size), encoded->data() + used, &_state->estate);
+    encoded->resize(used + len);
+    _checkLimit(len);
+}
+
+void Stream::_decode(const char* data, uint64_t size, std::string* decoded) {
+    // Decoding shrinks by 3/4; the state may carry over up to 3 characters
+    // from the previous block.
+    auto used = decoded->size();
+    decoded->resize(used + ((size + 3) / 4 * 3) + 3);
+    auto len = base64_decode_block(data, static_cast<std::size_t>(size), decoded->data() + used, &_state->dstate);
+    decoded->resize(used + len);
+    _checkLimit(len);
+}
+
+void Stream::_checkLimit(uint64_t len) {
+    _state->total_out += len;
+
+    if ( _state->max_size && _state->total_out > _state->max_size ) {
+        _state = nullptr;
+        throw Base64Error("output exceeds limit");
+    }
+}
+
 hilti::rt::Bytes Stream::encode(const hilti::rt::Bytes& data) {
     if ( ! _state )
         throw Base64Error("encoding already finished");
 
-    std::string buf(static_cast<std::string::size_type>(data.size() * 2), {});
-    auto len = base64_encode_block(data.data(), static_cast<std::size_t>(data.size()), buf.data(), &_state->estate);
-    return hilti::rt::Bytes(buf.data(), len);
+    std::string encoded;
+    _encode(data.data(), data.size(), &encoded);
+    return {std::move(encoded)};
 }
 
 hilti::rt::Bytes Stream::encode(const hilti::rt::stream::View& data) {
     if ( ! _state )
         throw Base64Error("encoding already finished");
 
-    hilti::rt::Bytes encoded;
+    std::string encoded;
 
-    for ( auto block = data.firstBlock(); block; block = data.nextBlock(block) ) {
-        std::string buf(block->size * 2, {});
-        auto len = base64_encode_block(reinterpret_cast<const char*>(block->start), static_cast<int>(block->size),
-                                       buf.data(), &_state->estate);
-        encoded.append(hilti::rt::Bytes(buf.data(), len));
-    }
+    for ( auto block = data.firstBlock(); block; block = data.nextBlock(block) )
+        _encode(reinterpret_cast<const char*>(block->start), block->size, &encoded);
 
-    return encoded;
+    return {std::move(encoded)};
 }
 
 hilti::rt::Bytes Stream::decode(const hilti::rt::Bytes& data) {
     if ( ! _state )
         throw Base64Error("decoding already finished");
 
-    std::string buf(static_cast<std::string::size_type>(data.size() * 2), {});
-    auto len = base64_decode_block(reinterpret_cast<const char*>(data.data()), static_cast<std::size_t>(data.size()),
-                                   buf.data(), &_state->dstate);
-
-    return hilti::rt::Bytes(buf.data(), len);
+    std::string decoded;
+    _decode(data.data(), data.size(), &decoded);
+    return {std::move(decoded)};
 }
 
 hilti::rt::Bytes Stream::decode(const hilti::rt::stream::View& data) {
     if ( ! _state )
         throw Base64Error("decoding already finished");
 
-    hilti::rt::Bytes decoded;
+    std::string decoded;
 
-    for ( auto block = data.firstBlock(); block; block = data.nextBlock(block) ) {
-        std::string buf(block->size * 2, {});
-        auto len = base64_decode_block(reinterpret_cast<const char*>(block->start),
-                                       static_cast<std::size_t>(block->size), buf.data(), &_state->dstate);
-        decoded.append(hilti::rt::Bytes(buf.data(), len));
-    }
+    for ( auto block = data.firstBlock(); block; block = data.nextBlock(block) )
+        _decode(reinterpret_cast<const char*>(block->start), block->size, &decoded);
 
-    return decoded;
+    return {std::move(decoded)};
 }
 
 hilti::rt::Bytes Stream::finish() {
@@ -1,15 +1,31 @@
 // Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
 
+#include <fcntl.h>
 #include <getopt.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <future>
 #include <ios>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include <hilti/rt/configuration.h>
+#include <hilti/rt/context.h>
 #include <hilti/rt/exception.h>
 #include <hilti/rt/fmt.h>
 #include <hilti/rt/init.h>
@@ -156,6 +172,29 @@ Result<Nothing> Driver::listParsers(std::ostream& out, bool verbose) {
     return Nothing();
 }
 
+bool Driver::_parseInput(const spicy::rt::Parser& parser, hilti::rt::ValueReference<spicy::rt::ParsedUnit>& unit,
+                         hilti::rt::ValueReference<hilti::rt::Stream>& data, std::optional<hilti::rt::Resumable>& r) {
+    if ( ! r ) {
+        DRIVER_DEBUG(fmt("beginning parsing input (eod=%s)", data->isFrozen()));
+        r = parser.parse3(unit, data, {}, {});
+    }
+    else {
+        DRIVER_DEBUG(fmt("resuming parsing input (eod=%s)", data->isFrozen()));
+        r->resume();
+    }
+
+    if ( *r ) {
+        DRIVER_DEBUG(fmt("finished parsing input (eod=%s)", data->isFrozen()));
+        DRIVER_DEBUG_STATS(data);
+        return true;
+    }
+    else {
+        DRIVER_DEBUG("parsing yielded");
+        DRIVER_DEBUG_STATS(data);
+        return false;
+    }
+}
+
 Result<spicy::rt::ParsedUnit> Driver::processInput(const spicy::rt::Parser& parser, std::istream& in, int increment) {
     if ( ! hilti::rt::isInitialized() )
         return Error("runtime not initialized");
@@ -182,31 +221,122 @@ Result<spicy::rt::ParsedUnit> Driver::processInput(const spicy::rt::Parser& pars
             auto profiler = hilti::rt::profiler::start(parser.profiler_tags.prepare_input);
 
             if ( auto n = in.gcount() )
-                data->append(hilti::rt::Bytes(buffer, n));
+                data->append(buffer, static_cast<size_t>(n));
 
             if ( in.peek() == EOF )
                 data->freeze();
         }
-        if ( ! r ) {
-            DRIVER_DEBUG(fmt("beginning parsing input (eod=%s)", data->isFrozen()));
-            r = parser.parse3(unit, data, {}, {});
-        }
-        else {
-            DRIVER_DEBUG(fmt("resuming parsing input (eod=%s)", data->isFrozen()));
-            r->resume();
-        }
 
-        if ( *r ) {
-            DRIVER_DEBUG(fmt("finished parsing input (eod=%s)", data->isFrozen()));
-            DRIVER_DEBUG_STATS(data);
+        if ( _parseInput(parser, unit, data, r) )
             break;
+    }
+
+    return std::move(*unit);
+}
+
+namespace {
+
+// Read-only memory mapping of a file's complete content.
+class MappedFile {
+public:
+    ~MappedFile() { ::munmap(_data, _size); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+
+    // Maps a file into memory. Returns null if the file is not a non-empty
+    // regular file, or if it cannot be mapped.
+    static std::unique_ptr<MappedFile> open(const hilti::rt::filesystem::path& path) {
+        auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if ( fd < 0 )
+            return nullptr;
+
+        struct stat st {};
+        void* data = MAP_FAILED;
+
+        if ( ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 )
+            data = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        ::close(fd);
+
+        if ( data == MAP_FAILED )
+            return nullptr;
+
+        // We read the data front to back; this is just a hint, so ignore errors.
+        ::madvise(data, st.st_size, MADV_SEQUENTIAL);
+
+        return std::unique_ptr<MappedFile>(new MappedFile(data, st.st_size));
+    }
+
+    const char* data() const { return static_cast<const char*>(_data); }
+    size_t size() const { return _size; }
+
+private:
+    MappedFile(void* data, size_t size) : _data(data), _size(size) {}
+
+    void* _data;
+    size_t _size;
+};
+
+} // namespace
+
+Result<spicy::rt::ParsedUnit> Driver::processInput(const spicy::rt::Parser& parser,
+                                                   const hilti::rt::filesystem::path& path, int increment) {
+    auto file = MappedFile::open(path);
+
+    if ( ! file ) {
+        std::ifstream in(path, std::ios::in | std::ios::binary);
+
+        if ( ! in.is_open() )
+            return Error("cannot open input for reading");
+
+        return processInput(parser, in, increment);
+    }
+
+    if ( ! hilti::rt::isInitialized() )
+        return Error("runtime not initialized");
+
+    if ( ! parser.parse3 )
+        return Error(
+            fmt("unit type '%s' cannot be used as external entry point because it requires arguments", parser.name));
+
+    DRIVER_DEBUG(fmt("parsing memory-mapped input of %" PRIu64 " bytes", static_cast<uint64_t>(file->size())));
+
+    hilti::rt::ValueReference<hilti::rt::Stream> data;
+    std::optional<hilti::rt::Resumable> r;
+
+    DRIVER_DEBUG_STATS(data);
+
+    hilti::rt::ValueReference<spicy::rt::ParsedUnit> unit;
+
+    // Without an increment, we pass all data in one go as that's the only
+    // way to avoid copying it: a stream can keep only its final chunk
+    // non-owning, so appending further data copies the previous one.
+    const size_t chunk_size = (increment > 0 ? static_cast<size_t>(increment) : file->size());
+
+    for ( size_t offset = 0; offset < file->size(); ) {
+        {
+            assert(parser.profiler_tags);
+            auto profiler = hilti::rt::profiler::start(parser.profiler_tags.prepare_input);
+
+            auto len = std::min(chunk_size, file->size() - offset);
+            data->append(file->data() + offset, len, hilti::rt::stream::NonOwning());
+            offset += len;
+
+            if ( offset == file->size() )
+                data->freeze();
         }
-        else {
-            DRIVER_DEBUG("parsing yielded");
-            DRIVER_DEBUG_STATS(data);
-        }
+
+        if ( _parseInput(parser, unit, data, r) )
+            break;
     }
 
+    // The parsed unit may still be referring to the stream's data, so take
+    // a copy of whatever the stream still holds before unmapping the file.
+    data->makeOwning();
+
     return std::move(*unit);
 }
 
@@ -381,15 +511,127 @@ driver::ParsingState::State driver::ParsingState::_process(size_t size, const ch
     hilti::rt::cannot_be_reached();
 }
 
-Result<hilti::rt::Nothing> Driver::processPreBatchedInput(std::istream& in) {
-    std::string magic;
-    std::getline(in, magic);
+/** A single command read from a batch input. */
+struct driver::detail::BatchCommand {
+    enum Kind { BeginFlow, BeginConn, Data, Gap, EndFlow, EndConn };
 
-    if ( magic != std::string("!spicy-batch v2") )
-        return hilti::rt::result::Error("input is not a v2 Spicy batch file");
+    Kind kind;
+    std::vector<std::string> args; // command arguments, excluding the tag
+    driver::ParsingType type{};    // parsing type for `@begin-*`
+    size_t size = 0;               // size for `@data` and `@gap`
+    std::string data;              // payload for `@data`
+};
 
+/** State for processing batch commands, one instance per thread. */
+struct driver::detail::BatchState {
     std::unordered_map<std::string, driver::ParsingStateForDriver> flows;
     std::unordered_map<std::string, driver::ConnectionState> connections;
+};
+
+// Reads the next command from a batch input, returning an unset optional at
+// end of input.
+static Result<std::optional<driver::detail::BatchCommand>> readBatchCommand(std::istream& in) {
+    using driver::detail::BatchCommand;
+
+    auto parse_type = [](std::string_view type) -> Result<driver::ParsingType> {
+        if ( type == "stream" )
+            return driver::ParsingType::Stream;
+        else if ( type == "block" )
+            return driver::ParsingType::Block;
+        else
+            return hilti::rt::result::Error(hilti::rt::fmt("unknown session type '%s'", type));
+    };
+
+    while ( in.good() && ! in.eof() ) {
+        std::string line;
+        std::getline(in, line);
+        line = hilti::rt::trim(line);
+
+        if ( line.empty() )
+            continue;
+
+        auto m = hilti::rt::split(line);
+
+        BatchCommand cmd;
+        for ( auto i = 1U; i < m.size(); i++ )
+            cmd.args.emplace_back(m[i]);
+
+        if ( m[0] == "@begin-flow" ) {
+            // @begin-flow <id> <parser> <type>
+            if ( m.size() != 4 )
+                return hilti::rt::result::Error("unexpected number of argument for @begin-flow");
+
+            auto type = parse_type(m[2]);
+            if ( ! type )
+                return type.error();
+
+            cmd.kind = BatchCommand::BeginFlow;
+            cmd.type = *type;
+        }
+        else if ( m[0] == "@begin-conn" ) {
+            // @begin-conn <conn-id> <type> <orig-id> <orig-parser> <resp-id> <resp-parser>
+            if ( m.size() != 7 )
+                return hilti::rt::result::Error("unexpected number of argument for @begin-conn");
+
+            auto type = parse_type(m[2]);
+            if ( ! type )
+                return type.error();
+
+            cmd.kind = BatchCommand::BeginConn;
+            cmd.type = *type;
+        }
+        else if ( m[0] == "@data" ) {
+            // @data <id> <size>
+            // [data]\n
+            if ( m.size() != 3 )
+                return hilti::rt::result::Error("unexpected number of argument for @data");
+
+            cmd.kind = BatchCommand::Data;
+            cmd.size = std::stoul(std::string(m[2]));
+            cmd.data = std::string(cmd.size, {});
+            in.read(cmd.data.data(), static_cast<std::streamsize>(cmd.size));
+            in.get(); // Eat newline.
+
+            if ( in.eof() || in.fail() )
+                return hilti::rt::result::Error("premature end of @data");
+        }
+        else if ( m[0] == "@gap" ) {
+            // @gap <id> <size>
+            if ( m.size() != 3 )
+                return hilti::rt::result::Error("unexpected number of argument for @gap");
+
+            cmd.kind = BatchCommand::Gap;
+            cmd.size = std::stoul(std::string(m[2]));
+        }
+        else if ( m[0] == "@end-flow" ) {
+            // @end-flow <id>
+            if ( m.size() != 2 )
+                return hilti::rt::result::Error("unexpected number of argument for @end-flow");
+
+            cmd.kind = BatchCommand::EndFlow;
+        }
+        else if ( m[0] == "@end-conn" ) {
+            // @end-conn <cid>
+            if ( m.size() != 2 )
+                return hilti::rt::result::Error("unexpected number of argument for @end-conn");
+
+            cmd.kind = BatchCommand::EndConn;
+        }
+        else
+            return hilti::rt::result::Error(hilti::rt::fmt("unknown command '%s'", m[0]));
+
+        return std::optional<BatchCommand>(std::move(cmd));
+    }
+
+    return std::optional<BatchCommand>();
+}
+
+void Driver::_executeBatchCommand(driver::detail::BatchState* state, const driver::detail::BatchCommand& cmd,
+                                  std::ostream& out) {
+    using driver::detail::BatchCommand;
+
+    auto& flows = state->flows;
+    auto& connections = state->connections;
 
     // Helper to add flows to the map.
     auto create_state = [&](driver::ParsingType type, const std::string& parser_name, const std::string& id,
@@ -411,59 +653,25 @@ Result<hilti::rt::Nothing> Driver::processPreBatchedInput(std::istream& in) {
         }
     };
 
-    while ( in.good() && ! in.eof() ) {
-        std::string cmd;
-        std::getline(in, cmd);
-        cmd = hilti::rt::trim(cmd);
-
-        if ( cmd.empty() )
-            continue;
-
-        auto m = hilti::rt::split(cmd);
-        if ( m[0] == "@begin-flow" ) {
-            // @begin-flow <id> <parser> <type>
-            if ( m.size() != 4 )
-                return hilti::rt::result::Error("unexpected number of argument for @begin-flow");
-
-            auto id = std::string(m[1]);
-            auto parser_name = std::string(m[3]);
-
-            driver::ParsingType type;
-
-            if ( m[2] == "stream" )
-                type = driver::ParsingType::Stream;
-            else if ( m[2] == "block" )
-                type = driver::ParsingType::Block;
-            else
-                return hilti::rt::result::Error(hilti::rt::fmt("unknown session type '%s'", m[2]));
-
-
-            create_state(type, parser_name, id, {}, {});
+    switch ( cmd.kind ) {
+        case BatchCommand::BeginFlow: {
+            const auto& id = cmd.args[0];
+            const auto& parser_name = cmd.args[2];
+            create_state(cmd.type, parser_name, id, {}, {});
+            break;
         }
-        else if ( m[0] == "@begin-conn" ) {
-            // @begin-conn <conn-id> <type> <orig-id> <orig-parser> <resp-id> <resp-parser>
-            if ( m.size() != 7 )
-                return hilti::rt::result::Error("unexpected number of argument for @begin-conn");
-
-            auto cid = std::string(m[1]);
-            auto orig_id = std::string(m[3]);
-            auto orig_parser_name = std::string(m[4]);
-            auto resp_id = std::string(m[5]);
-            auto resp_parser_name = std::string(m[6]);
 
-            driver::ParsingType type;
-
-            if ( m[2] == "stream" )
-                type = driver::ParsingType::Stream;
-            else if ( m[2] == "block" )
-                type = driver::ParsingType::Block;
-            else
-                return hilti::rt::result::Error(hilti::rt::fmt("unknown session type '%s'", m[2]));
+        case BatchCommand::BeginConn: {
+            const auto& cid = cmd.args[0];
+            const auto& orig_id = cmd.args[2];
+            const auto& orig_parser_name = cmd.args[3];
+            const auto& resp_id = cmd.args[4];
+            const auto& resp_parser_name = cmd.args[5];
 
             if ( connections.find(cid) != connections.end() ) {
                 // already exists, ignore
                 DRIVER_DEBUG(hilti::rt::fmt("connection %s exists, skipping", cid));
-                continue;
+                break;
             }
 
             driver::ParsingStateForDriver* orig_state = nullptr;
@@ -471,12 +679,12 @@ Result<hilti::rt::Nothing> Driver::processPreBatchedInput(std::istream& in) {
 
             std::optional<UnitContext> context;
 
-            if ( auto [x, ctx] = create_state(type, orig_parser_name, orig_id, cid, context); x != flows.end() ) {
+            if ( auto [x, ctx] = create_state(cmd.type, orig_parser_name, orig_id, cid, context); x != flows.end() ) {
                 orig_state = &x->second;
                 context = std::move(ctx);
             }
 
-            if ( auto [x, ctx] = create_state(type, resp_parser_name, resp_id, cid, std::move(context));
+            if ( auto [x, ctx] = create_state(cmd.type, resp_parser_name, resp_id, cid, std::move(context));
                  x != flows.end() )
                 resp_state = &x->second;
 
@@ -484,96 +692,67 @@ Result<hilti::rt::Nothing> Driver::processPreBatchedInput(std::istream& in) {
                 // cannot get parsers, ignore
                 flows.erase(orig_id);
                 flows.erase(resp_id);
-                continue;
+                break;
             }
 
-            connections[cid] = driver::ConnectionState{.orig_id = std::move(orig_id),
-                                                       .resp_id = std::move(resp_id),
+            connections[cid] = driver::ConnectionState{.orig_id = orig_id,
+                                                       .resp_id = resp_id,
                                                        .orig_state = orig_state,
                                                        .resp_state = resp_state};
             _total_connections++;
+            break;
         }
-        else if ( m[0] == "@data" ) {
-            // @data <id> <size>
-            // [data]\n
-            if ( m.size() != 3 )
-                return hilti::rt::result::Error("unexpected number of argument for @data");
 
-            auto id = std::string(m[1]);
-            auto size = std::stoul(std::string(m[2]));
-
-            std::string data(size, {});
-            in.read(data.data(), static_cast<std::streamsize>(size));
-            in.get(); // Eat newline.
-
-            if ( in.eof() || in.fail() )
-                return hilti::rt::result::Error("premature end of @data");
+        case BatchCommand::Data:
+        case BatchCommand::Gap: {
+            const auto& id = cmd.args[0];
 
             auto s = flows.find(id);
             if ( s != flows.end() ) {
                 try {
-                    s->second.process(size, data.data());
+                    s->second.process(cmd.size, cmd.kind == BatchCommand::Data ? cmd.data.data() : nullptr);
                 } catch ( const hilti::rt::Exception& e ) {
-                    std::cout << hilti::rt::fmt("error for ID %s: %s\n", id, e.what());
+                    out << hilti::rt::fmt("error for ID %s: %s\n", id, e.what());
                 }
             }
-        }
-        else if ( m[0] == "@gap" ) {
-            // @gap <id> <size>
-            if ( m.size() != 3 )
-                return hilti::rt::result::Error("unexpected number of argument for @gap");
-
-            auto id = std::string(m[1]);
-            auto size = std::stoul(std::string(m[2]));
 
-            auto s = flows.find(id);
-            if ( s != flows.end() ) {
-                try {
-                    s->second.process(size, nullptr);
-                } catch ( const hilti::rt::Exception& e ) {
-                    std::cout << hilti::rt::fmt("error for ID %s: %s\n", id, e.what());
-                }
-            }
+            break;
         }
-        else if ( m[0] == "@end-flow" ) {
-            // @end-flow <id>
-            if ( m.size() != 2 )
-                return hilti::rt::result::Error("unexpected number of argument for @end-flow");
 
-            auto id = std::string(m[1]);
+        case BatchCommand::EndFlow: {
+            const auto& id = cmd.args[0];
 
             auto s = flows.find(id);
             if ( s != flows.end() ) {
                 try {
                     s->second.finish();
                 } catch ( const hilti::rt::Exception& e ) {
-                    std::cout << hilti::rt::fmt("error for ID %s: %s\n", id, e.what());
+                    out << hilti::rt::fmt("error for ID %s: %s\n", id, e.what());
                 }
 
                 flows.erase(s);
                 DRIVER_DEBUG_STATS(flows.size(), connections.size());
             }
+
+            break;
         }
-        else if ( m[0] == "@end-conn" ) {
-            // @end-conn <cid>
-            if ( m.size() != 2 )
-                return hilti::rt::result::Error("unexpected number of argument for @end-conn");
 
-            auto cid = std::string(m[1]);
+        case BatchCommand::EndConn: {
+            const auto& cid = cmd.args[0];
 
             if ( auto s = connections.find(cid); s != connections.end() ) {
                 try {
                     if ( s->second.orig_state )
                         s->second.orig_state->finish();
                 } catch ( const hilti::rt::Exception& e ) {
-                    std::cout << hilti::rt::fmt("error for ID %s: %s\n", s->second.orig_id, e.what());
+                    out << hilti::rt::fmt("error for ID %s: %s\n", s->second.orig_id, e.what());
                 }
 
                 try {
                     if ( s->second.resp_state )
                         s->second.resp_state->finish();
                 } catch ( const hilti::rt::Exception& e ) {
-                    std::cout << hilti::rt::fmt("error for ID %s: %s\n", s->second.resp_id, e.what());
+                    out << hilti::rt::fmt("error for ID %s: %s\n", s->second.resp_id, e.what());
                 }
 
                 flows.erase(s->second.orig_id);
@@ -581,13 +760,255 @@ Result<hilti::rt::Nothing> Driver::processPreBatchedInput(std::istream& in) {
                 connections.erase(s);
                 DRIVER_DEBUG_STATS(flows.size(), connections.size());
             }
+
+            break;
+        }
+    }
+}
+
+Result<hilti::rt::Nothing> Driver::processPreBatchedInput(std::istream& in, unsigned int threads) {
+    std::string magic;
+    std::getline(in, magic);
+
+    if ( magic != std::string("!spicy-batch v2") )
+        return hilti::rt::result::Error("input is not a v2 Spicy batch file");
+
+    if ( threads > 1 )
+        return _processPreBatchedInputConcurrently(in, threads);
+
+    driver::detail::BatchState state;
+
+    while ( true ) {
+        auto cmd = readBatchCommand(in);
+        if ( ! cmd )
+            return cmd.error();
+
+        if ( ! *cmd )
+            break;
+
+        _executeBatchCommand(&state, **cmd, std::cout);
+    }
+
+    DRIVER_DEBUG_STATS(state.flows.size(), state.connections.size());
+
+    return hilti::rt::Nothing();
+}
+
+namespace {
+
+// Maximum number of commands per worker thread that may be pending output
+// before the reader waits for workers to catch up. This bounds memory usage
+// for buffered input and output.
+constexpr size_t MaxPendingCommandsPerThread = 1024;
+
+// A batch command queued for processing by a worker thread.
+struct BatchTask {
+    driver::detail::BatchCommand cmd;
+    std::promise<std::string> output; // receives everything printed while executing the command
+};
+
+// A worker thread processing a subset of a batch's flows and connections.
+struct BatchWorker {
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::unique_ptr<BatchTask>> queue;
+    bool done = false; // set once no further tasks will be queued
+
+    void push(std::unique_ptr<BatchTask> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(std::move(task));
+        }
+
+        cv.notify_one();
+    }
+
+    // Returns the next task, or null once the queue is empty and `done` is set.
+    std::unique_ptr<BatchTask> pop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this]() { return done || ! queue.empty(); });
+
+        if ( queue.empty() )
+            return nullptr;
+
+        auto task = std::move(queue.front());
+        queue.pop_front();
+        return task;
+    }
+
+    void finish() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+        }
+
+        cv.notify_one();
+    }
+};
+
+// Shuts down worker threads on destruction, including when unwinding due to
+// an exception.
+struct BatchWorkers {
+    std::vector<std::unique_ptr<BatchWorker>> workers;
+
+    ~BatchWorkers() {
+        for ( auto& w : workers )
+            w->finish();
+
+        for ( auto& w : workers ) {
+            if ( w->thread.joinable() )
+                w->thread.join();
         }
-        else
-            return hilti::rt::result::Error(hilti::rt::fmt("unknown command '%s'", m[0]));
     }
+};
+
+} // namespace
+
+Result<hilti::rt::Nothing> Driver::_processPreBatchedInputConcurrently(std::istream& in, unsigned int threads) {
+    using driver::detail::BatchCommand;
+
+    // Only redirect output from `print` if it's not silenced to begin with.
+    const bool capture_print = (hilti::rt::configuration::detail::printStream() != nullptr);
+
+    auto worker_main = [this, capture_print](BatchWorker* worker, hilti::rt::vthread::ID vid) {
+        hilti::rt::Context context(vid);
+        hilti::rt::context::detail::set(&context);
+
+        {
+            // Must be destroyed before the context as parsing state may
+            // hold on to fibers.
+            driver::detail::BatchState state;
+
+            while ( auto task = worker->pop() ) {
+                std::stringstream out;
+                context.cout = (capture_print ? &out : nullptr);
+
+                try {
+                    _executeBatchCommand(&state, task->cmd, out);
+                    task->output.set_value(out.str());
+                } catch ( ... ) {
+                    task->output.set_exception(std::current_exception());
+                }
+
+                context.cout = nullptr;
+            }
+
+            DRIVER_DEBUG_STATS(state.flows.size(), state.connections.size());
+        }
+
+        hilti::rt::context::detail::set(nullptr);
+    };
+
+    BatchWorkers workers;
 
+    for ( auto i = 0U; i < threads; i++ ) {
+        auto& w = workers.workers.emplace_back(std::make_unique<BatchWorker>());
+        w->thread = std::thread(worker_main, w.get(), static_cast<hilti::rt::vthread::ID>(i));
+    }
+
+    // To keep per-flow ordering, all commands for a flow go to the same
+    // worker. For connections, that's the worker chosen for the connection
+    // ID, which then also processes both of its flows.
+    std::unordered_map<std::string, size_t> routes;
+    std::unordered_map<std::string, std::pair<std::string, std::string>> connection_flows;
+
+    auto route = [&](const std::string& id) -> size_t {
+        if ( auto i = routes.find(id); i != routes.end() )
+            return i->second;
+        else
+            return std::hash<std::string>()(id) % threads;
+    };
+
+    // Output gets written in the order of the commands producing it so that
+    // it's the same as with sequential processing.
+    std::deque<std::future<std::string>> pending;
+
+    auto flush = [&](bool wait) {
+        while ( ! pending.empty() ) {
+            auto& next = pending.front();
+
+            if ( ! wait && pending.size() <= MaxPendingCommandsPerThread * threads &&
+                 next.wait_for(std::chrono::seconds(0)) != std::future_status::ready )
+                break;
+
+            std::cout << next.get(); // rethrows any exception from the worker
+            pending.pop_front();
+        }
+    };
+
+    while ( true ) {
+        auto cmd = readBatchCommand(in);
+        if ( ! cmd ) {
+            flush(true);
+            return cmd.error();
+        }
+
+        if ( ! *cmd )
+            break;
+
+        size_t worker = 0;
+
+        switch ( (*cmd)->kind ) {
+            case BatchCommand::BeginFlow: {
+                const auto& id = (*cmd)->args[0];
+                worker = std::hash<std::string>()(id) % threads;
+                routes[id] = worker;
+                break;
+            }
+
+            case BatchCommand::BeginConn: {
+                const auto& cid = (*cmd)->args[0];
+                if ( routes.find(cid) != routes.end() ) {
+                    // Existing connection, the worker will ignore this.
+                    worker = routes[cid];
+                    break;
+                }
+
+                const auto& orig_id = (*cmd)->args[2];
+                const auto& resp_id = (*cmd)->args[4];
+                worker = std::hash<std::string>()(cid) % threads;
+                routes[cid] = worker;
+                routes[orig_id] = worker;
+                routes[resp_id] = worker;
+                connection_flows[cid] = std::make_pair(orig_id, resp_id);
+                break;
+            }
+
+            case BatchCommand::Data:
+            case BatchCommand::Gap: worker = route((*cmd)->args[0]); break;
+
+            case BatchCommand::EndFlow: {
+                const auto& id = (*cmd)->args[0];
+                worker = route(id);
+                routes.erase(id);
+                break;
+            }
+
+            case BatchCommand::EndConn: {
+                const auto& cid = (*cmd)->args[0];
+                worker = route(cid);
+                routes.erase(cid);
+
+                if ( auto i = connection_flows.find(cid); i != connection_flows.end() ) {
+                    routes.erase(i->second.first);
+                    routes.erase(i->second.second);
+                    connection_flows.erase(i);
+                }
+
+                break;
+            }
+        }
+
+        auto task = std::make_unique<BatchTask>();
+        task->cmd = std::move(**cmd);
+        pending.push_back(task->output.get_future());
+        workers.workers[worker]->push(std::move(task));
+
+        flush(false);
+    }
 
-    DRIVER_DEBUG_STATS(flows.size(), connections.size());
+    flush(true);
 
     return hilti::rt::Nothing();
 }
@@ -0,0 +1,13 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+//
+// Parsing exceptions are implemented here rather than in `parser.cc` because
+// the latter goes into the `spicy-rt-lto` archive, which must not define the
+// exceptions' vtables and type information a second time.
+
+#include <spicy/rt/parser.h>
+
+using namespace spicy::rt;
+
+HILTI_EXCEPTION_IMPL(Backtrack)
+HILTI_EXCEPTION_IMPL(MissingData)
+HILTI_EXCEPTION_IMPL(ParseError)
@@ -16,16 +16,13 @@
 using namespace spicy::rt;
 using namespace spicy::rt::detail;
 
-HILTI_EXCEPTION_IMPL(Backtrack)
-HILTI_EXCEPTION_IMPL(MissingData);
-HILTI_EXCEPTION_IMPL(ParseError)
-
 void spicy::rt::Parser::_initProfiling() {
-    // Cache profiler tags to avoid recomputing them frequently.
+    // Intern profiler tags to avoid looking them up frequently.
     assert(! name.empty());
-    profiler_tags.prepare_block.append(name);
-    profiler_tags.prepare_input.append(name);
-    profiler_tags.prepare_stream.append(name);
+    profiler_tags.prepare_block = hilti::rt::profiler::tag(std::string("spicy/prepare/block/").append(name));
+    profiler_tags.prepare_input = hilti::rt::profiler::tag(std::string("spicy/prepare/input/").append(name));
+    profiler_tags.prepare_stream = hilti::rt::profiler::tag(std::string("spicy/prepare/stream/").append(name));
+    profiler_tags.initialized = true;
 }
 
 void spicy::rt::accept_input() {
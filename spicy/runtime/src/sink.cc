@@ -1,5 +1,7 @@
 // Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
 
+#include <memory>
+
 #include <spicy/rt/parser.h>
 #include <spicy/rt/sink.h>
 
@@ -20,46 +22,62 @@ void Sink::_init() {
     _cur_rseq = 0;
     _last_reassem_rseq = 0;
     _trim_rseq = 0;
+    _buffered = 0;
+    _max_buffered = 0;
     _chunks.clear();
 }
 
-Sink::ChunkList::iterator Sink::_addAndCheck(std::optional<hilti::rt::Bytes> data, uint64_t rseq, uint64_t rupper,
-                                             ChunkList::iterator c) {
-    assert(! _chunks.empty());
+Sink::ChunkMap::iterator Sink::_insert(ChunkMap::iterator hint, std::optional<hilti::rt::Bytes> data, uint64_t rseq,
+                                       uint64_t rupper) {
+    if ( data )
+        _buffered += data->size();
+
+    return _chunks.emplace_hint(hint, rseq, Chunk(std::move(data), rseq, rupper));
+}
+
+Sink::ChunkMap::iterator Sink::_erase(ChunkMap::iterator c) {
+    if ( c->second.data )
+        _buffered -= c->second.data->size();
+
+    return _chunks.erase(c);
+}
 
+Sink::ChunkMap::iterator Sink::_addAndCheck(std::optional<hilti::rt::Bytes> data, uint64_t rseq, uint64_t rupper) {
     // Special check for the common case of appending to the end.
-    if ( rseq == _chunks.back().rupper ) {
-        _chunks.emplace_back(std::move(data), rseq, rupper);
-        return std::next(_chunks.end(), -1);
-    }
+    if ( _chunks.empty() || rseq >= _chunks.rbegin()->second.rupper )
+        return _insert(_chunks.end(), std::move(data), rseq, rupper);
 
     // Find the first block that doesn't come completely before the new data.
-    for ( ; c != _chunks.end() && c->rupper <= rseq; c++ )
-        ;
-
-    if ( c == _chunks.end() ) {
-        // c is the last block, and it comes completely before the new block.
-        _chunks.emplace_back(std::move(data), rseq, rupper);
-        return std::next(_chunks.end(), -1);
+    // That's either the last one starting at or before the new data, or the
+    // one following it.
+    auto c = _chunks.upper_bound(rseq);
+    if ( c != _chunks.begin() ) {
+        if ( auto p = std::prev(c); p->second.rupper > rseq )
+            c = p;
     }
 
-    if ( rupper <= c->rseq )
+    // Because of the check above, there must be such a block.
+    assert(c != _chunks.end());
+
+    if ( rupper <= c->second.rseq )
         // The new block comes completely before c.
-        return _chunks.insert(c, Chunk(std::move(data), rseq, rupper));
+        return _insert(c, std::move(data), rseq, rupper);
 
-    ChunkList::iterator new_c;
+    ChunkMap::iterator new_c;
 
     // The blocks overlap, complain & break up.
 
-    if ( rseq < c->rseq ) {
+    if ( rseq < c->second.rseq ) {
         // The new block has a prefix that comes before c.
-        uint64_t prefix_len = c->rseq - rseq;
+        uint64_t prefix_len = c->second.rseq - rseq;
 
         if ( data ) {
             auto prefix = data->sub(data->begin() + prefix_len);
-            new_c = _chunks.insert(c, Chunk(std::move(prefix), rseq, rseq + prefix_len));
+            new_c = _insert(c, std::move(prefix), rseq, rseq + prefix_len);
             data = data->sub(data->begin() + prefix_len, data->end());
         }
+        else
+            new_c = _insert(c, {}, rseq, rseq + prefix_len);
 
         rseq += prefix_len;
     }
@@ -69,14 +87,14 @@ Sink::ChunkList::iterator Sink::_addAndCheck(std::optional<hilti::rt::Bytes> dat
 
     auto overlap_start = rseq;
     auto new_c_len = rupper - rseq;
-    auto c_len = (c->rupper - overlap_start);
+    auto c_len = (c->second.rupper - overlap_start);
     auto overlap_len = (new_c_len < c_len ? new_c_len : c_len);
 
     hilti::rt::Bytes old_data;
     hilti::rt::Bytes new_data;
 
-    if ( c->data )
-        old_data = c->data->sub(overlap_start - c->rseq, overlap_start - c->rseq + overlap_len);
+    if ( c->second.data )
+        old_data = c->second.data->sub(overlap_start - c->second.rseq, overlap_start - c->second.rseq + overlap_len);
 
     if ( data )
         new_data = data->sub(overlap_len);
@@ -89,9 +107,9 @@ Sink::ChunkList::iterator Sink::_addAndCheck(std::optional<hilti::rt::Bytes> dat
         rseq += overlap_len;
 
         if ( new_c == c )
-            new_c = _addAndCheck(std::move(data), rseq, rupper, c);
+            new_c = _addAndCheck(std::move(data), rseq, rupper);
         else
-            _addAndCheck(std::move(data), rseq, rupper, c);
+            _addAndCheck(std::move(data), rseq, rupper);
     }
 
     return new_c;
@@ -151,11 +169,16 @@ bool Sink::_deliver(std::optional<hilti::rt::Bytes> data, uint64_t rseq, uint64_
         states.push_back(s);
     }
 
+    // With multiple units connected, they all share the same copy of the data.
+    std::shared_ptr<const hilti::rt::Bytes> shared;
+    if ( states.size() > 1 )
+        shared = std::make_shared<const hilti::rt::Bytes>(std::move(*data));
+
     for ( auto* s : states ) {
-        if ( states.size() == 1 )
-            s->data->append(std::move(*data));
+        if ( shared )
+            s->data->append(shared);
         else
-            s->data->append(*data);
+            s->data->append(std::move(*data));
 
         try {
             // Sinks are operating independently from the writer, so we
@@ -190,7 +213,7 @@ void Sink::_newData(std::optional<hilti::rt::Bytes> data, uint64_t rseq, uint64_
 
     _debugReassembler("buffering data", data, rseq, len);
 
-    ChunkList::iterator c;
+    ChunkMap::iterator c;
     auto rupper_rseq = rseq + len;
 
     if ( rupper_rseq <= _trim_rseq )
@@ -206,28 +229,50 @@ void Sink::_newData(std::optional<hilti::rt::Bytes> data, uint64_t rseq, uint64_
             data = data->sub(data->begin() + amount_old, data->end());
     }
 
-    if ( _chunks.empty() ) {
-        _chunks.emplace_back(std::move(data), rseq, rseq + len);
-        c = std::next(_chunks.end(), -1);
-    }
-    else
-        c = _addAndCheck(std::move(data), rseq, rupper_rseq, _chunks.begin());
+    c = _addAndCheck(std::move(data), rseq, rupper_rseq);
 
     // See if we have data in order now to deliver.
 
-    if ( c->rseq > _last_reassem_rseq || c->rupper <= _last_reassem_rseq )
+    if ( c->second.rseq > _last_reassem_rseq || c->second.rupper <= _last_reassem_rseq ) {
+        _enforceBufferLimit();
         goto exit;
+    }
 
     // We've filled a leading hole. Deliver as much as possible.
     _debugReassemblerBuffer("buffer content");
 
     _tryDeliver(c);
+    _enforceBufferLimit();
     return;
 
 exit:
     _debugReassemblerBuffer("buffer content");
 }
 
+void Sink::_enforceBufferLimit() {
+    if ( ! (_max_buffered && _auto_trim) )
+        return;
+
+    while ( _buffered > _max_buffered ) {
+        // Skip ahead to the first chunk still waiting for delivery, which is
+        // either preceded by missing data or blocked behind a gap.
+        auto c = _chunks.lower_bound(_last_reassem_rseq);
+        if ( c == _chunks.end() )
+            break;
+
+        SPICY_RT_DEBUG_VERBOSE(fmt("sink %p buffering %" PRIu64 " bytes, exceeding limit of %" PRIu64, this, _buffered,
+                                   _max_buffered));
+
+        auto buffered = _buffered;
+        auto last_reassem_rseq = _last_reassem_rseq;
+        _skip(c->second.rseq);
+
+        if ( _buffered >= buffered && _last_reassem_rseq == last_reassem_rseq )
+            // No progress, nothing more we can skip over.
+            break;
+    }
+}
+
 void Sink::_skip(uint64_t rseq) {
     SPICY_RT_DEBUG_VERBOSE(fmt("skipping sink %p to rseq %" PRIu64, this, rseq));
 
@@ -251,34 +296,38 @@ void Sink::_trim(uint64_t rseq) {
         SPICY_RT_DEBUG_VERBOSE(fmt("trimming sink %p to EOD", this));
     }
 
-    for ( auto c = _chunks.begin(); c != _chunks.end(); c = _chunks.erase(c) ) {
-        if ( c->rseq >= rseq )
+    for ( auto c = _chunks.begin(); c != _chunks.end(); c = _erase(c) ) {
+        if ( c->second.rseq >= rseq )
             break;
 
-        if ( c->data && _cur_rseq < c->rseq )
-            _reportUndelivered(c->rseq, *c->data);
+        if ( c->second.data && _cur_rseq < c->second.rseq )
+            _reportUndelivered(c->second.rseq, *c->second.data);
     }
 
     _trim_rseq = rseq;
 }
 
-void Sink::_tryDeliver(ChunkList::iterator c) {
+void Sink::_tryDeliver(ChunkMap::iterator c) {
     // Note that a new block may include both some old stuff and some new
     // stuff. _addAndCheck() will have split the new stuff off into its own
     // block(s), but in the following loop we have to take care not to
     // deliver already-delivered data.
 
     for ( ; c != _chunks.end(); c++ ) {
-        if ( c->rseq == _last_reassem_rseq ) {
+        if ( c->second.rseq > _last_reassem_rseq )
+            // Chunks are ordered, so nothing further can be in order now.
+            break;
+
+        if ( c->second.rseq == _last_reassem_rseq ) {
             // New stuff.
-            _last_reassem_rseq += (c->rupper - c->rseq);
-            if ( ! _deliver(c->data, c->rseq, c->rupper) ) {
+            _last_reassem_rseq += (c->second.rupper - c->second.rseq);
+            if ( ! _deliver(c->second.data, c->second.rseq, c->second.rupper) ) {
                 // Hit gap.
                 if ( _auto_trim )
                     // We trim just up to the gap here, excluding the gap itself.
                     // This will prevent future data beyond the gap from being
                     // delivered until we explicitly skip over it.
-                    _trim(c->rseq);
+                    _trim(c->second.rseq);
 
                 break;
             }
@@ -323,7 +372,7 @@ void Sink::_reportUndelivered(uint64_t rseq, const hilti::rt::Bytes& data) const
 }
 
 void Sink::_reportUndeliveredUpTo(uint64_t rupper) const {
-    for ( const auto& c : _chunks ) {
+    for ( const auto& [_, c] : _chunks ) {
         if ( c.rseq >= rupper )
             break;
 
@@ -377,7 +426,7 @@ void Sink::_debugReassemblerBuffer(std::string_view msg) const {
             this, msg, _cur_rseq, _last_reassem_rseq, _trim_rseq));
 
     for ( const auto&& [i, c] : hilti::rt::enumerate(_chunks) ) // not auto&, always copied anyways
-        _debugReassembler(fmt("  * chunk %d:", i), c.data, c.rseq, (c.rupper - c.rseq));
+        _debugReassembler(fmt("  * chunk %d:", i), c.second.data, c.second.rseq, (c.second.rupper - c.second.rseq));
 }
 
 void Sink::connect_mime_type(const MIMEType& mt, std::string_view scope) {
@@ -140,6 +140,27 @@ TEST_CASE("encode") {
     }
 }
 
+TEST_CASE("limit") {
+    base64::Stream stream;
+    base64::set_limit(stream, 6);
+
+    SUBCASE("decode") {
+        CHECK_EQ(base64::decode(stream, "Zm9v"_b), "foo"_b);
+        CHECK_EQ(base64::decode(stream, "YmFy"_b), "bar"_b);
+        // NOLINTNEXTLINE(bugprone-throw-keyword-missing)
+        CHECK_THROWS_WITH_AS(base64::decode(stream, "Zm9v"_b), "output exceeds limit", const base64::Base64Error&);
+        // NOLINTNEXTLINE(bugprone-throw-keyword-missing)
+        CHECK_THROWS_WITH_AS(base64::decode(stream, "Zm9v"_b), "decoding already finished",
+                             const base64::Base64Error&);
+    }
+
+    SUBCASE("encode") {
+        CHECK_EQ(base64::encode(stream, "foo"_b), "Zm9v"_b);
+        // NOLINTNEXTLINE(bugprone-throw-keyword-missing)
+        CHECK_THROWS_WITH_AS(base64::encode(stream, "foo"_b), "output exceeds limit", const base64::Base64Error&);
+    }
+}
+
 TEST_CASE("finish") {
     base64::Stream stream;
     CHECK_EQ(base64::finish(stream), ""_b);
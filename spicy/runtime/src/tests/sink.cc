@@ -7,10 +7,126 @@
 #include <spicy/rt/sink.h>
 
 using namespace hilti::rt;
+using namespace hilti::rt::bytes::literals;
 using namespace spicy::rt;
 
 TEST_SUITE_BEGIN("Sink");
 
+TEST_CASE("reassembly") {
+    Sink sink;
+
+    SUBCASE("in order") {
+        sink.write("012"_b);
+        sink.write("345"_b);
+        CHECK_EQ(sink.sequence_number(), 6);
+        CHECK_EQ(sink.size(), 6);
+    }
+
+    SUBCASE("out of order") {
+        sink.write("67"_b, 6);
+        sink.write("23"_b, 2);
+        sink.write("45"_b, 4);
+        CHECK_EQ(sink.sequence_number(), 0);
+        CHECK_EQ(sink.size(), 0);
+
+        sink.write("01"_b, 0);
+        CHECK_EQ(sink.sequence_number(), 8);
+        CHECK_EQ(sink.size(), 8);
+    }
+
+    SUBCASE("overlaps") {
+        sink.write("4567"_b, 4);
+        sink.write("2345"_b, 2);
+        sink.write("6789"_b, 6);
+        sink.write("012345"_b, 0);
+        CHECK_EQ(sink.sequence_number(), 10);
+        CHECK_EQ(sink.size(), 10);
+    }
+
+    SUBCASE("gap") {
+        sink.write("45"_b, 4);
+        sink.gap(2, 2);
+        sink.write("01"_b, 0);
+        CHECK_EQ(sink.sequence_number(), 4);
+        CHECK_EQ(sink.size(), 2);
+
+        // Data beyond the gap remains buffered until we skip over it.
+        sink.skip(4);
+        CHECK_EQ(sink.sequence_number(), 6);
+        CHECK_EQ(sink.size(), 4);
+    }
+
+    SUBCASE("reverse order") {
+        for ( uint64_t i = 100; i > 0; i-- )
+            sink.write("x"_b, i - 1);
+
+        CHECK_EQ(sink.sequence_number(), 100);
+        CHECK_EQ(sink.size(), 100);
+    }
+}
+
+TEST_CASE("set_max_buffer_size") {
+    Sink sink;
+    sink.set_max_buffer_size(4);
+
+    SUBCASE("within limit") {
+        sink.write("23"_b, 2);
+        sink.write("45"_b, 4);
+        CHECK_EQ(sink.sequence_number(), 0);
+
+        sink.write("01"_b, 0);
+        CHECK_EQ(sink.sequence_number(), 6);
+        CHECK_EQ(sink.size(), 6);
+    }
+
+    SUBCASE("exceeding limit skips hole") {
+        sink.write("23"_b, 2);
+        sink.write("45"_b, 4);
+        sink.write("67"_b, 6);
+        CHECK_EQ(sink.sequence_number(), 8);
+        CHECK_EQ(sink.size(), 6);
+
+        // Late data for the skipped range is ignored.
+        sink.write("01"_b, 0);
+        CHECK_EQ(sink.sequence_number(), 8);
+        CHECK_EQ(sink.size(), 6);
+    }
+
+    SUBCASE("exceeding limit skips multiple holes") {
+        sink.write("23"_b, 2);
+        sink.write("67"_b, 6);
+        sink.write("ab"_b, 10);
+        CHECK_EQ(sink.sequence_number(), 4);
+        CHECK_EQ(sink.size(), 2);
+
+        sink.write("cd"_b, 12);
+        CHECK_EQ(sink.sequence_number(), 8);
+        CHECK_EQ(sink.size(), 4);
+    }
+
+    SUBCASE("exceeding limit skips gap") {
+        sink.gap(2, 2);
+        sink.write("45"_b, 4);
+        sink.write("67"_b, 6);
+        CHECK_EQ(sink.sequence_number(), 0);
+
+        sink.write("89"_b, 8);
+        CHECK_EQ(sink.sequence_number(), 10);
+        CHECK_EQ(sink.size(), 6);
+    }
+
+    SUBCASE("setting limit enforces it") {
+        sink.set_max_buffer_size(0);
+        sink.write("23"_b, 2);
+        sink.write("45"_b, 4);
+        sink.write("67"_b, 6);
+        CHECK_EQ(sink.sequence_number(), 0);
+
+        sink.set_max_buffer_size(2);
+        CHECK_EQ(sink.sequence_number(), 8);
+    }
+}
+
 TEST_CASE("to_string") { CHECK_EQ(to_string(sink::ReassemblerPolicy::First), "sink::ReassemblerPolicy::First"); }
 
 TEST_SUITE_END();
@@ -98,6 +98,50 @@ TEST_CASE("decompress") {
     }
 }
 
+TEST_CASE("limits") {
+    // 10,000 times "A", compressed into 34 bytes.
+    const auto data =
+        "\x78\x9c\xed\xc1\x01\x0d\x00\x00\x00\xc2\xa0\x6c\xef\x5f\xca\x1c\x6e\x40\x01\x00\x00\x00\x00\x00\x00\x00\x00\xc0\xbf\x01\x87\xc1\xeb\x98"_b;
+    const auto expected = Bytes(std::string(10000, 'A'));
+
+    zlib::Stream stream;
+
+    SUBCASE("unlimited") { CHECK_EQ(zlib::decompress(stream, data), expected); }
+
+    SUBCASE("within limits") {
+        zlib::set_limits(stream, 10000, 300);
+        CHECK_EQ(zlib::decompress(stream, data), expected);
+    }
+
+    SUBCASE("size exceeded") {
+        zlib::set_limits(stream, 9999, 0);
+        // NOLINTNEXTLINE(bugprone-throw-keyword-missing)
+        CHECK_THROWS_WITH_AS(zlib::decompress(stream, data), "decompressed data exceeds limit",
+                             const zlib::ZlibError&);
+
+        // NOLINTNEXTLINE(bugprone-throw-keyword-missing)
+        CHECK_THROWS_WITH_AS(zlib::decompress(stream, data), "error'ed zlib stream cannot be reused",
+                             const zlib::ZlibError&);
+    }
+
+    SUBCASE("ratio exceeded") {
+        zlib::set_limits(stream, 0, 200);
+        // NOLINTNEXTLINE(bugprone-throw-keyword-missing)
+        CHECK_THROWS_WITH_AS(zlib::decompress(stream, data), "decompressed data exceeds limit",
+                             const zlib::ZlibError&);
+    }
+
+    SUBCASE("incremental") {
+        zlib::set_limits(stream, 10000, 0);
+
+        Bytes decompressed;
+        for ( uint64_t i = 0; i < data.size(); i++ )
+            decompressed.append(zlib::decompress(stream, data.sub(i, i + 1)));
+
+        CHECK_EQ(decompressed, expected);
+    }
+}
+
 TEST_CASE("to_string") { CHECK_EQ(to_string(zlib::Stream()), "<zlib stream>"); }
 
 TEST_CASE("crc32") {
@@ -2,6 +2,11 @@
 
 #include <zlib.h>
 
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <utility>
+
 #include <hilti/rt/types/bytes.h>
 
 #include <spicy/rt/zlib_.h>
@@ -9,12 +14,14 @@
 using namespace spicy::rt;
 using namespace spicy::rt::zlib;
 
-struct detail::State {
+struct zlib::detail::State {
     z_stream stream;
+    uint64_t max_size = 0;  // maximum total output, or zero for no limit
+    uint64_t max_ratio = 0; // maximum ratio of total output to total input, or zero for no limit
 };
 
 Stream::Stream(int64_t window_bits) {
-    _state = std::shared_ptr<detail::State>(new detail::State(), [](auto p) {
+    _state = std::shared_ptr<zlib::detail::State>(new zlib::detail::State(), [](auto p) {
         inflateEnd(&p->stream);
         delete p; // NOLINT(cppcoreguidelines-owning-memory)
     });
@@ -28,74 +35,95 @@ Stream::Stream(int64_t window_bits) {
 // Don't finish the stream here, it might be shared with other instances.
 Stream::~Stream() = default;
 
-hilti::rt::Bytes Stream::finish() { return hilti::rt::Bytes(); }
-
-hilti::rt::Bytes Stream::decompress(const hilti::rt::stream::View& data) {
+void Stream::setLimits(uint64_t max_size, uint64_t max_ratio) {
     if ( ! _state )
         throw ZlibError("error'ed zlib stream cannot be reused");
 
-    hilti::rt::Bytes decoded;
-
-    for ( auto block = data.firstBlock(); block; block = data.nextBlock(block) ) {
-        _state->stream.next_in = const_cast<Bytef*>(block->start);
-        _state->stream.avail_in = block->size;
-
-        do {
-            char buf[4096];
-            _state->stream.next_out = reinterpret_cast<unsigned char*>(buf);
-            _state->stream.avail_out = sizeof(buf);
+    _state->max_size = max_size;
+    _state->max_ratio = max_ratio;
+}
 
-            int zip_status = inflate(&_state->stream, Z_SYNC_FLUSH);
+hilti::rt::Bytes Stream::finish() { return hilti::rt::Bytes(); }
 
-            if ( zip_status != Z_STREAM_END && zip_status != Z_OK && zip_status != Z_BUF_ERROR ) {
-                _state = nullptr;
-                throw ZlibError("inflate failed");
-            }
+void Stream::_inflate(const unsigned char* data, uint64_t size, std::string* decoded) {
+    auto& stream = _state->stream;
+    stream.next_in = const_cast<Bytef*>(data);
+    stream.avail_in = size;
 
-            if ( auto len = (sizeof(buf) - _state->stream.avail_out) )
-                decoded.append(hilti::rt::Bytes(buf, static_cast<int>(len)));
+    // Upper bound for the total output we may produce from the input seen so
+    // far, including the current block.
+    auto limit = std::numeric_limits<uint64_t>::max();
 
-            if ( zip_status == Z_STREAM_END ) {
-                break;
-            }
+    if ( _state->max_size )
+        limit = _state->max_size;
 
-        } while ( _state->stream.avail_out == 0 );
+    if ( _state->max_ratio ) {
+        auto total_in = static_cast<uint64_t>(stream.total_in) + size;
+        if ( total_in <= limit / _state->max_ratio )
+            limit = std::min(limit, total_in * _state->max_ratio);
     }
 
-    return decoded;
-}
-
-hilti::rt::Bytes Stream::decompress(const hilti::rt::Bytes& data) {
-    if ( ! _state )
-        throw ZlibError("error'ed zlib stream cannot be reused");
-
-    hilti::rt::Bytes decoded;
-
-    _state->stream.next_in = const_cast<Bytef*>(reinterpret_cast<const Bytef*>(data.data()));
-    _state->stream.avail_in = data.size();
+    auto used = decoded->size();
 
     do {
-        char buf[4096];
-        _state->stream.next_out = reinterpret_cast<unsigned char*>(buf);
-        _state->stream.avail_out = sizeof(buf);
+        // We leave room for one byte beyond the limit so that we can tell when it's exceeded.
+        auto remaining = (limit - std::min<uint64_t>(limit, stream.total_out));
+        if ( remaining < std::numeric_limits<uint64_t>::max() )
+            ++remaining;
+
+        if ( used == decoded->size() ) {
+            // Grow the output geometrically, writing into it directly below.
+            auto grow = std::max<uint64_t>({used, size * 2, 4096});
+            decoded->resize(used + std::min(grow, remaining));
+        }
+
+        auto avail = std::min(static_cast<uint64_t>(decoded->size() - used), remaining);
+        stream.next_out = reinterpret_cast<unsigned char*>(decoded->data() + used);
+        stream.avail_out = static_cast<uInt>(std::min<uint64_t>(avail, std::numeric_limits<uInt>::max()));
+        auto avail_out = stream.avail_out;
 
-        int zip_status = inflate(&_state->stream, Z_SYNC_FLUSH);
+        int zip_status = inflate(&stream, Z_SYNC_FLUSH);
 
         if ( zip_status != Z_STREAM_END && zip_status != Z_OK && zip_status != Z_BUF_ERROR ) {
             _state = nullptr;
             throw ZlibError("inflate failed");
         }
 
-        if ( auto len = (sizeof(buf) - _state->stream.avail_out) )
-            decoded.append(hilti::rt::Bytes(buf, static_cast<int>(len)));
+        used += (avail_out - stream.avail_out);
+
+        if ( stream.total_out > limit ) {
+            _state = nullptr;
+            throw ZlibError("decompressed data exceeds limit");
+        }
 
         if ( zip_status == Z_STREAM_END ) {
             break;
         }
 
-    } while ( _state->stream.avail_out == 0 );
+    } while ( stream.avail_out == 0 );
+
+    decoded->resize(used);
+}
+
+hilti::rt::Bytes Stream::decompress(const hilti::rt::stream::View& data) {
+    if ( ! _state )
+        throw ZlibError("error'ed zlib stream cannot be reused");
+
+    std::string decoded;
+
+    for ( auto block = data.firstBlock(); block; block = data.nextBlock(block) )
+        _inflate(block->start, block->size, &decoded);
+
+    return {std::move(decoded)};
+}
+
+hilti::rt::Bytes Stream::decompress(const hilti::rt::Bytes& data) {
+    if ( ! _state )
+        throw ZlibError("error'ed zlib stream cannot be reused");
 
-    return decoded;
+    std::string decoded;
+    _inflate(reinterpret_cast<const unsigned char*>(data.data()), data.size(), &decoded);
+    return {std::move(decoded)};
 }
 
 uint64_t zlib::crc32_init() { return ::crc32(0L, Z_NULL, 0); }
@@ -0,0 +1,84 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#include <benchmark/benchmark.h>
+#pragma GCC diagnostic pop
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <hilti/rt/init.h>
+#include <hilti/rt/types/bytes.h>
+
+#include <spicy/rt/init.h>
+#include <spicy/rt/sink.h>
+
+static const uint64_t SegmentSize = 100;
+
+// Returns the order in which to write `n` segments, randomly permuted but
+// reproducible across runs.
+static std::vector<uint64_t> permutedSegments(uint64_t n) {
+    std::vector<uint64_t> segments(n);
+    std::iota(segments.begin(), segments.end(), 0);
+    std::shuffle(segments.begin(), segments.end(), std::mt19937_64(42)); // NOLINT
+    return segments;
+}
+
+// Feeds randomly permuted segments into a sink, which needs to buffer them
+// until the data in front of them has arrived.
+static void write_permuted(benchmark::State& state) {
+    hilti::rt::init();
+    spicy::rt::init();
+
+    auto segments = permutedSegments(state.range(0));
+    auto data = hilti::rt::Bytes(std::string(SegmentSize, 'x'));
+
+    for ( auto _ : state ) {
+        (void)_;
+        spicy::rt::Sink sink;
+
+        for ( auto i : segments )
+            sink.write(data, i * SegmentSize);
+
+        benchmark::DoNotOptimize(sink.sequence_number());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * segments.size() * SegmentSize));
+
+    spicy::rt::done();
+    hilti::rt::done();
+}
+
+// Like `write_permuted`, but with the sink's buffer capped so that it skips
+// ahead over missing data.
+static void write_permuted_capped(benchmark::State& state) {
+    hilti::rt::init();
+    spicy::rt::init();
+
+    auto segments = permutedSegments(state.range(0));
+    auto data = hilti::rt::Bytes(std::string(SegmentSize, 'x'));
+
+    for ( auto _ : state ) {
+        (void)_;
+        spicy::rt::Sink sink;
+        sink.set_max_buffer_size(100 * SegmentSize);
+
+        for ( auto i : segments )
+            sink.write(data, i * SegmentSize);
+
+        benchmark::DoNotOptimize(sink.sequence_number());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * segments.size() * SegmentSize));
+
+    spicy::rt::done();
+    hilti::rt::done();
+}
+
+BENCHMARK(write_permuted)->ArgName("segments")->RangeMultiplier(8)->Range(8, 1 << 15);
+BENCHMARK(write_permuted_capped)->ArgName("segments")->RangeMultiplier(8)->Range(8, 1 << 15);
+
+BENCHMARK_MAIN();
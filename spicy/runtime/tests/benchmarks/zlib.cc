@@ -0,0 +1,136 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+#include <zlib.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#include <benchmark/benchmark.h>
+#pragma GCC diagnostic pop
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include <hilti/rt/init.h>
+#include <hilti/rt/types/bytes.h>
+#include <hilti/rt/types/stream.h>
+
+#include <spicy/rt/filter.h>
+#include <spicy/rt/init.h>
+#include <spicy/rt/zlib_.h>
+
+// Size of the segments that compressed data arrives in, like TCP payload.
+static const uint64_t SegmentSize = 1460;
+
+static const char FilterName[] = "benchmark-filter";
+using FilterState = spicy::rt::filter::State<FilterName>;
+
+// Returns an HTTP-like body of at least `size` bytes. The content repeats
+// with small variations so that it compresses similar to real-world HTML.
+static std::string body(uint64_t size) {
+    std::string data;
+
+    for ( uint64_t i = 0; data.size() < size; i++ )
+        data += "<tr><td class=\"item\">" + std::to_string(i) + "</td><td><a href=\"/items/" +
+                std::to_string(i * 7919) + "\">details</a></td></tr>\n";
+
+    return data;
+}
+
+// Compresses data with gzip framing, like HTTP's `Content-Encoding: gzip`.
+static std::string gzip(const std::string& data) {
+    z_stream stream{};
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+
+    std::string compressed(deflateBound(&stream, data.size()), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = data.size();
+    stream.next_out = reinterpret_cast<Bytef*>(compressed.data());
+    stream.avail_out = compressed.size();
+    deflate(&stream, Z_FINISH);
+    compressed.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    return compressed;
+}
+
+// Decompresses a body segment by segment, forwarding each decompressed
+// block to the filter's destination. With `Move`, blocks are handed over to
+// the destination stream; otherwise they are copied into it.
+template<bool Move>
+static void decompress_and_forward(benchmark::State& state) {
+    hilti::rt::init();
+    spicy::rt::init();
+
+    auto data = hilti::rt::Bytes(gzip(body(state.range(0))));
+
+    for ( auto _ : state ) {
+        (void)_;
+
+        hilti::rt::ValueReference<hilti::rt::Stream> forward;
+        FilterState filter;
+        filter.__forward = forward;
+
+        spicy::rt::zlib::Stream zlib(15 + 16);
+
+        for ( uint64_t i = 0; i < data.size(); i += SegmentSize ) {
+            auto decompressed = zlib.decompress(data.sub(i, std::min<uint64_t>(i + SegmentSize, data.size())));
+
+            if constexpr ( Move )
+                spicy::rt::filter::forward(filter, nullptr, std::move(decompressed));
+            else
+                spicy::rt::filter::forward(filter, nullptr, decompressed);
+        }
+
+        benchmark::DoNotOptimize(forward->size());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * state.range(0)));
+
+    spicy::rt::done();
+    hilti::rt::done();
+}
+
+static void forward_copy(benchmark::State& state) { decompress_and_forward<false>(state); }
+static void forward_move(benchmark::State& state) { decompress_and_forward<true>(state); }
+
+// Decompresses a body segment by segment through the native zlib filter,
+// which inflates straight from the blocks of its input stream.
+static void forward_native(benchmark::State& state) {
+    hilti::rt::init();
+    spicy::rt::init();
+
+    auto data = gzip(body(state.range(0)));
+
+    for ( auto _ : state ) {
+        (void)_;
+
+        hilti::rt::ValueReference<hilti::rt::Stream> input;
+        FilterState filter;
+        spicy::rt::zlib::connect_filter(filter, nullptr, 15 + 16, 0, 0);
+
+        auto forward = spicy::rt::filter::init(filter, nullptr, input, input->view());
+
+        for ( uint64_t i = 0; i < data.size(); i += SegmentSize ) {
+            input->append(data.data() + i, std::min<uint64_t>(SegmentSize, data.size() - i));
+            spicy::rt::filter::flush(filter, nullptr);
+        }
+
+        input->freeze();
+        spicy::rt::filter::flush(filter, nullptr);
+
+        benchmark::DoNotOptimize(forward->size());
+        spicy::rt::filter::disconnect(filter, nullptr);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * state.range(0)));
+
+    spicy::rt::done();
+    hilti::rt::done();
+}
+
+BENCHMARK(forward_copy)->ArgName("body")->RangeMultiplier(8)->Range(1 << 14, 1 << 23);
+BENCHMARK(forward_move)->ArgName("body")->RangeMultiplier(8)->Range(1 << 14, 1 << 23);
+BENCHMARK(forward_native)->ArgName("body")->RangeMultiplier(8)->Range(1 << 14, 1 << 23);
+
+BENCHMARK_MAIN();
@@ -2,6 +2,7 @@
 
 #include <getopt.h>
 
+#include <atomic>
 #include <fstream>
 #include <iostream>
 
@@ -17,19 +18,30 @@
 
 using spicy::rt::fmt;
 
+constexpr int OptJitCache = 1000;
+constexpr int OptDisableDebugStreams = 1001;
+constexpr int OptCxxSplitUnits = 1002;
+constexpr int OptLto = 1003;
+
 static struct option long_driver_options[] = {{"abort-on-exceptions", required_argument, nullptr, 'A'},
                                               {"require-accept", no_argument, nullptr, 'c'},
                                               {"compiler-debug", required_argument, nullptr, 'D'},
+                                              {"cxx-split-units", required_argument, nullptr, OptCxxSplitUnits},
                                               {"debug", no_argument, nullptr, 'd'},
                                               {"debug-addl", required_argument, nullptr, 'X'},
+                                              {"disable-debug-streams", required_argument, nullptr,
+                                               OptDisableDebugStreams},
                                               {"disable-optimizations", no_argument, nullptr, 'g'},
                                               {"enable-profiling", no_argument, nullptr, 'Z'},
                                               {"file", required_argument, nullptr, 'f'},
                                               {"batch-file", required_argument, nullptr, 'F'},
                                               {"help", no_argument, nullptr, 'h'},
                                               {"increment", required_argument, nullptr, 'i'},
+                                              {"threads", required_argument, nullptr, 'j'},
+                                              {"jit-cache", required_argument, nullptr, OptJitCache},
                                               {"library-path", required_argument, nullptr, 'L'},
                                               {"list-parsers", no_argument, nullptr, 'l'},
+                                              {"lto", no_argument, nullptr, OptLto},
                                               {"parser", required_argument, nullptr, 'p'},
                                               {"parser-alias", required_argument, nullptr, 'P'},
                                               {"report-times", required_argument, nullptr, 'R'},
@@ -42,10 +54,11 @@ static struct option long_driver_options[] = {{"abort-on-exceptions", required_a
 
 static bool require_accept = false; // --require-accept
 
-static bool accepted = false; // set by hook_accept_input()
+// With batch input, the hooks may run concurrently on multiple threads.
+static std::atomic<bool> accepted = false; // set by hook_accept_input()
 static void hookAcceptInput() { accepted = true; }
 
-static bool declined = false; // set by hook_decline_input()
+static std::atomic<bool> declined = false; // set by hook_decline_input()
 static void hookDeclineInput(const std::string& reason) { declined = true; }
 
 class SpicyDriver : public spicy::Driver, public spicy::rt::Driver {
@@ -59,6 +72,7 @@ public:
 
     int opt_list_parsers = 0;
     int opt_increment = 0;
+    unsigned int opt_threads = 1;
     bool opt_input_is_batch = false;
     std::string opt_file = "/dev/stdin";
     std::string opt_parser;
@@ -84,6 +98,7 @@ void SpicyDriver::usage() {
            "  -g | --disable-optimizations        Disable HILTI-side optimizations of the generated code.\n"
            "  -i | --increment <i>                Feed data incrementally in chunks of size n.\n"
            "  -f | --file <path>                  Read input from <path> instead of stdin.\n"
+           "  -j | --threads <n>                  Process batch input with <n> worker threads.\n"
            "  -l | --list-parsers                 List available parsers and exit; use twice to include aliases.\n"
            "  -p | --parser <name>                Use parser <name> to process input. Only needed if more than one "
            "parser "
@@ -105,11 +120,20 @@ void SpicyDriver::usage() {
            "  -X | --debug-addl <addl>            Implies -d and adds selected additional instrumentation "
            "(comma-separated; see 'help' for list).\n"
            "  -Z | --enable-profiling             Report profiling statistics after execution.\n"
+           "       --cxx-split-units <n>          Spread each module's generated C++ code across <n> files to compile "
+           "them in parallel.\n"
+           "       --disable-debug-streams <streams>  Do not generate debug output for the given runtime debug "
+           "streams (colon-separated).\n"
+           "       --jit-cache <dir>              Cache compiled code in <dir> to reuse it across runs.\n"
+           "       --lto                          Link compiled code with link-time optimization against the runtime "
+           "library.\n"
            "\n"
            "Environment variables:\n"
            "\n"
            "  SPICY_PATH                      Colon-separated list of directories to search for modules. In contrast "
            "to --library-paths using this flag overwrites builtin paths.\n"
+           "  HILTI_JIT_CACHE                 Directory for caching compiled code across runs if --jit-cache is not "
+           "given.\n"
            "\n"
            "Inputs can be "
         << exts
@@ -126,7 +150,7 @@ void SpicyDriver::parseOptions(int argc, char** argv) {
     driver_options.logger = std::make_unique<hilti::Logger>();
 
     while ( true ) {
-        int c = getopt_long(argc, argv, "ABcD:f:F:ghdJX:Vlp:P:i:SRL:UVZ", long_driver_options, nullptr);
+        int c = getopt_long(argc, argv, "ABcD:f:F:ghdj:JX:Vlp:P:i:SRL:UVZ", long_driver_options, nullptr);
 
         if ( c < 0 )
             break;
@@ -212,6 +236,20 @@ void SpicyDriver::parseOptions(int argc, char** argv) {
                 opt_increment = atoi(optarg); // NOLINT
                 break;
 
+            case 'j': {
+                auto threads = atoi(optarg); // NOLINT
+                if ( threads < 1 )
+                    fatalError("number of threads must be at least 1");
+
+                opt_threads = threads;
+
+                if ( opt_threads > 1 )
+                    // Give each worker thread its own set of globals.
+                    compiler_options.cxx_enable_dynamic_globals = true;
+
+                break;
+            }
+
             case 'l': ++opt_list_parsers; break;
 
             case 'p': opt_parser = optarg; break;
@@ -235,6 +273,25 @@ void SpicyDriver::parseOptions(int argc, char** argv) {
                 driver_options.enable_profiling = true;
                 break;
 
+            case OptJitCache: compiler_options.jit_cache = optarg; break;
+
+            case OptLto: compiler_options.cxx_lto = true; break;
+
+            case OptDisableDebugStreams:
+                for ( const auto& s : hilti::util::split(optarg, ":") )
+                    compiler_options.disabled_debug_streams.emplace_back(hilti::util::trim(s));
+                break;
+
+            case OptCxxSplitUnits: {
+                bool valid = true;
+                auto n = hilti::util::charsToUInt64(optarg, 10, [&]() { valid = false; });
+                if ( ! valid || n == 0 )
+                    fatalError(fmt("expected positive integer for --cxx-split-units, but received '%s'", optarg));
+
+                compiler_options.cxx_split_units = n;
+                break;
+            }
+
             case 'h': usage(); exit(0);
             case '?': [[fallthrough]];
             default:
@@ -289,24 +346,24 @@ int main(int argc, char** argv) try {
     if ( driver.opt_list_parsers )
         driver.listParsers(std::cout, driver.opt_list_parsers > 1);
 
-    else {
+    else if ( driver.opt_input_is_batch ) {
         std::ifstream in(driver.opt_file, std::ios::in | std::ios::binary);
 
         if ( ! in.is_open() )
             driver.fatalError("cannot open input for reading");
 
-        if ( driver.opt_input_is_batch ) {
-            if ( auto x = driver.processPreBatchedInput(in); ! x )
-                driver.fatalError(x.error());
-        }
-        else {
-            auto parser = driver.lookupParser(driver.opt_parser);
-            if ( ! parser )
-                driver.fatalError(parser.error());
+        if ( auto x = driver.processPreBatchedInput(in, driver.opt_threads); ! x )
+            driver.fatalError(x.error());
+    }
 
-            if ( auto x = driver.processInput(**parser, in, driver.opt_increment); ! x )
-                driver.fatalError(x.error());
-        }
+    else {
+        auto parser = driver.lookupParser(driver.opt_parser);
+        if ( ! parser )
+            driver.fatalError(parser.error());
+
+        // This maps regular files into memory to avoid copying their content.
+        if ( auto x = driver.processInput(**parser, driver.opt_file, driver.opt_increment); ! x )
+            driver.fatalError(x.error());
     }
 
     driver.finishRuntime();
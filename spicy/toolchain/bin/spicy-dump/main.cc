@@ -2,8 +2,10 @@
 
 #include <getopt.h>
 
-#include <fstream>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include <hilti/rt/init.h>
 #include <hilti/rt/libhilti.h>
@@ -17,12 +19,15 @@
 #include <spicy/spicy.h>
 
 #include "options.h"
+#include "printer-arrow.h"
 #include "printer-json.h"
 #include "printer-text.h"
 
 using spicy::rt::fmt;
 
 static struct option long_options[] = {{"abort-on-exceptions", required_argument, nullptr, 'A'},
+                                       {"batch-size", required_argument, nullptr, 'b'},
+                                       {"columnar", no_argument, nullptr, 'C'},
                                        {"compiler-debug", required_argument, nullptr, 'D'},
                                        {"debug", no_argument, nullptr, 'd'},
                                        {"debug-addl", required_argument, nullptr, 'X'},
@@ -57,9 +62,11 @@ public:
     void usage();
 
     bool opt_json = false;
+    bool opt_columnar = false;
+    uint64_t opt_batch_size = 1024;
     int opt_list_parsers = 0;
     bool opt_enable_print = false;
-    std::string opt_file = "/dev/stdin";
+    std::vector<std::string> opt_files;
     std::string opt_parser;
     OutputOptions output_options;
 
@@ -76,8 +83,11 @@ void SpicyDump::usage() {
            "\n"
            "Options:\n"
            "\n"
+           "  -b | --batch-size <n>           With --columnar, group up to <n> units into each record batch "
+           "(default: 1024).\n"
            "  -d | --debug                    Include debug instrumentation into generated code.\n"
-           "  -f | --file <path>              Read input from <path> instead of stdin.\n"
+           "  -f | --file <path>              Read input from <path> instead of stdin. Can be given multiple times to "
+           "parse one unit from each file.\n"
            "  -l | --list-parsers             List available parsers and exit; use twice to include aliases.\n"
            "  -p | --parser <name>            Use parser <name> to process input. Only needed if more than one parser "
            "is available.\n"
@@ -85,6 +95,7 @@ void SpicyDump::usage() {
            "  -A | --abort-on-exceptions      When executing compiled code, abort() instead of throwing HILTI "
            "exceptions.\n"
            "  -B | --show-backtraces          Include backtraces when reporting unhandled exceptions.\n"
+           "  -C | --columnar                 Print columnar output as an Apache Arrow IPC stream.\n"
            "  -D | --compiler-debug <streams> Activate compile-time debugging output for given debug streams "
            "(comma-separated; 'help' for list).\n"
            "  -L | --library-path <path>      Add path to list of directories to search when importing modules.\n"
@@ -119,7 +130,7 @@ void SpicyDump::parseOptions(int argc, char** argv) {
     driver_options.logger = std::make_unique<hilti::Logger>();
 
     while ( true ) {
-        int c = getopt_long(argc, argv, "BAD:f:hdX:QVlp:PSRL:JZ", long_options, nullptr);
+        int c = getopt_long(argc, argv, "BAD:b:Cf:hdX:QVlp:PSRL:JZ", long_options, nullptr);
 
         if ( c < 0 )
             break;
@@ -127,15 +138,30 @@ void SpicyDump::parseOptions(int argc, char** argv) {
         switch ( c ) {
             case 'A': driver_options.abort_on_exceptions = true; break;
 
+            case 'b': {
+                try {
+                    opt_batch_size = std::stoull(optarg);
+                } catch ( const std::exception& ) {
+                    fatalError(fmt("invalid batch size '%s'", optarg));
+                }
+
+                if ( opt_batch_size == 0 )
+                    fatalError("batch size must be positive");
+
+                break;
+            }
+
             case 'B': driver_options.show_backtraces = true; break;
 
+            case 'C': opt_columnar = true; break;
+
             case 'd': {
                 hilti_compiler_options.debug = true;
                 break;
             }
 
             case 'f': {
-                opt_file = optarg;
+                opt_files.emplace_back(optarg);
                 break;
             }
 
@@ -212,6 +238,15 @@ void SpicyDump::parseOptions(int argc, char** argv) {
         }
     }
 
+    if ( opt_columnar && opt_json )
+        fatalError("cannot use --columnar and --json together");
+
+    if ( opt_columnar && output_options.include_offsets )
+        fatalError("--include-offsets is not supported with --columnar");
+
+    if ( opt_files.empty() )
+        opt_files.emplace_back("/dev/stdin");
+
     setCompilerOptions(std::move(hilti_compiler_options));
     setSpicyCompilerOptions(spicy_compiler_options);
     setDriverOptions(std::move(driver_options));
@@ -257,21 +292,28 @@ int main(int argc, char** argv) try {
         if ( ! parser )
             fatalError(parser.error());
 
-        std::ifstream in(driver.opt_file, std::ios::in | std::ios::binary);
-
-        if ( ! in.is_open() )
-            fatalError("cannot open stdin for reading");
-
-        auto unit = driver.processInput(**parser, in);
-        if ( ! unit )
-            fatalError(unit.error());
-
-        if ( driver.opt_json )
-            JSONPrinter(std::cout, driver.output_options).print(unit->value());
-        else {
-            TextPrinter(std::cout, driver.output_options).print(unit->value());
-            std::cout << '\n';
+        std::optional<ArrowPrinter> columnar;
+        if ( driver.opt_columnar )
+            columnar.emplace(std::cout, driver.opt_batch_size);
+
+        for ( const auto& file : driver.opt_files ) {
+            // This maps regular files into memory to avoid copying their content.
+            auto unit = driver.processInput(**parser, file);
+            if ( ! unit )
+                fatalError(unit.error());
+
+            if ( columnar )
+                columnar->print(unit->value());
+            else if ( driver.opt_json )
+                JSONPrinter(std::cout, driver.output_options).print(unit->value());
+            else {
+                TextPrinter(std::cout, driver.output_options).print(unit->value());
+                std::cout << '\n';
+            }
         }
+
+        if ( columnar )
+            columnar->finish();
     }
 
     driver.finishRuntime();
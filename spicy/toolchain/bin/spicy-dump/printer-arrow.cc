@@ -0,0 +1,824 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+#include "printer-arrow.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+
+#include <hilti/rt/libhilti.h>
+
+using namespace hilti::rt;
+
+namespace {
+
+/**
+ * Minimal FlatBuffers serializer, sufficient for the metadata of Arrow IPC
+ * messages. We describe the metadata as a small tree of objects and then lay
+ * it out front to back, placing each object's children after the object
+ * itself so that all references point forward, as FlatBuffers requires.
+ */
+namespace flatbuffer {
+
+// Pads buffer to a multiple of `n` bytes.
+void align(std::string& out, size_t n) { out.append((n - out.size() % n) % n, '\0'); }
+
+// Appends a scalar at its natural alignment, returning its position.
+template<typename T>
+size_t put(std::string& out, T x) {
+    align(out, sizeof(T));
+    auto pos = out.size();
+    out.append(reinterpret_cast<const char*>(&x), sizeof(T));
+    return pos;
+}
+
+// Sets the offset stored at position `at` to refer to position `target`.
+void patch(std::string& out, size_t at, size_t target) {
+    auto x = static_cast<uint32_t>(target - at);
+    memcpy(out.data() + at, &x, sizeof(x));
+}
+
+/** Base class for objects that can be referenced from a table. */
+class Object {
+public:
+    virtual ~Object() = default;
+
+    /** Appends the object to a buffer, returning the position that references must point to. */
+    virtual size_t write(std::string& out) const = 0;
+};
+
+using ObjectPtr = std::unique_ptr<Object>;
+
+/** A string. */
+class String : public Object {
+public:
+    String(std::string_view s) : _s(s) {}
+
+    size_t write(std::string& out) const override {
+        auto pos = put(out, static_cast<uint32_t>(_s.size()));
+        out.append(_s);
+        out.push_back('\0');
+        return pos;
+    }
+
+private:
+    std::string _s;
+};
+
+/** A vector of structs, given as their raw, already serialized bytes. */
+class Structs : public Object {
+public:
+    Structs(std::string data, size_t count) : _data(std::move(data)), _count(count) {}
+
+    size_t write(std::string& out) const override {
+        // The structs we use need 8-byte alignment, which applies to the
+        // elements following the length.
+        align(out, 8);
+        out.append(4, '\0');
+        auto pos = put(out, static_cast<uint32_t>(_count));
+        out.append(_data);
+        return pos;
+    }
+
+private:
+    std::string _data;
+    size_t _count;
+};
+
+/** A vector of references to other objects. */
+class Vector : public Object {
+public:
+    Vector() = default;
+
+    Vector& add(ObjectPtr x) {
+        _elements.emplace_back(std::move(x));
+        return *this;
+    }
+
+    size_t write(std::string& out) const override {
+        auto pos = put(out, static_cast<uint32_t>(_elements.size()));
+
+        std::vector<size_t> slots;
+        slots.reserve(_elements.size());
+        for ( size_t i = 0; i < _elements.size(); i++ )
+            slots.push_back(put<uint32_t>(out, 0));
+
+        for ( size_t i = 0; i < _elements.size(); i++ )
+            patch(out, slots[i], _elements[i]->write(out));
+
+        return pos;
+    }
+
+private:
+    std::vector<ObjectPtr> _elements;
+};
+
+/** A table with scalar fields and fields referencing other objects. */
+class Table : public Object {
+public:
+    template<typename T>
+    Table& scalar(uint16_t slot, T x) {
+        _fields.push_back({slot, std::string(reinterpret_cast<const char*>(&x), sizeof(T)), nullptr});
+        return *this;
+    }
+
+    Table& reference(uint16_t slot, ObjectPtr x) {
+        _fields.push_back({slot, std::string(sizeof(uint32_t), '\0'), std::move(x)});
+        return *this;
+    }
+
+    size_t write(std::string& out) const override {
+        // Place larger fields first, which keeps them all aligned without
+        // any padding as the table itself starts 8-byte aligned.
+        std::vector<const Field*> fields;
+        for ( const auto& f : _fields )
+            fields.push_back(&f);
+
+        std::stable_sort(fields.begin(), fields.end(),
+                         [](const auto* a, const auto* b) { return a->data.size() > b->data.size(); });
+
+        uint16_t num_slots = 0;
+        std::vector<uint16_t> offsets;
+        uint16_t size = sizeof(int32_t); // offset to vtable
+
+        for ( const auto* f : fields ) {
+            size = static_cast<uint16_t>((size + f->data.size() - 1) / f->data.size() * f->data.size());
+            offsets.push_back(size);
+            size += static_cast<uint16_t>(f->data.size());
+            num_slots = std::max(num_slots, static_cast<uint16_t>(f->slot + 1));
+        }
+
+        std::vector<uint16_t> vtable(num_slots, 0);
+        for ( size_t i = 0; i < fields.size(); i++ )
+            vtable[fields[i]->slot] = offsets[i];
+
+        auto vtable_pos = put(out, static_cast<uint16_t>(sizeof(uint16_t) * (2 + num_slots)));
+        put(out, size);
+
+        for ( auto o : vtable )
+            put(out, o);
+
+        align(out, 8);
+        auto pos = put(out, static_cast<int32_t>(out.size() - vtable_pos));
+        out.resize(pos + size, '\0');
+
+        for ( size_t i = 0; i < fields.size(); i++ )
+            memcpy(out.data() + pos + offsets[i], fields[i]->data.data(), fields[i]->data.size());
+
+        for ( size_t i = 0; i < fields.size(); i++ ) {
+            if ( fields[i]->reference )
+                patch(out, pos + offsets[i], fields[i]->reference->write(out));
+        }
+
+        return pos;
+    }
+
+private:
+    struct Field {
+        uint16_t slot;
+        std::string data;
+        ObjectPtr reference;
+    };
+
+    std::vector<Field> _fields;
+};
+
+/** Serializes a complete FlatBuffer with a given root table. */
+std::string finish(const Table& root) {
+    std::string out;
+    put<uint32_t>(out, 0);
+    patch(out, 0, root.write(out));
+    align(out, 8);
+    return out;
+}
+
+} // namespace flatbuffer
+
+/** Arrow's format constants, see https://github.com/apache/arrow/blob/main/format/. */
+namespace format {
+
+const int16_t MetadataVersionV5 = 4;
+
+enum HeaderType : uint8_t { Schema = 1, RecordBatch = 3 };
+
+enum Type : uint8_t {
+    Int = 2,
+    FloatingPoint = 3,
+    Binary = 4,
+    Utf8 = 5,
+    Bool = 6,
+    Timestamp = 10,
+    List = 12,
+    Struct = 13,
+    Duration = 18,
+};
+
+const int16_t PrecisionDouble = 2;
+const int16_t TimeUnitNanosecond = 3;
+
+// Slots of the tables' fields.
+enum MessageSlot : uint16_t { MessageVersion = 0, MessageHeaderType = 1, MessageHeader = 2, MessageBodyLength = 3 };
+enum SchemaSlot : uint16_t { SchemaEndianness = 0, SchemaFields = 1 };
+enum FieldSlot : uint16_t { FieldName = 0, FieldNullable = 1, FieldTypeType = 2, FieldType = 3, FieldChildren = 5 };
+enum RecordBatchSlot : uint16_t { RecordBatchLength = 0, RecordBatchNodes = 1, RecordBatchBuffers = 2 };
+
+} // namespace format
+
+// Returns the number of bytes needed to pad `n` to a multiple of 8.
+size_t padding(size_t n) { return (8 - n % 8) % 8; }
+
+} // namespace
+
+namespace columnar {
+
+namespace {
+
+// Follows optionals and references to the value they contain, returning an
+// invalid value if there's none.
+type_info::Value unwrap(type_info::Value v) {
+    while ( v ) {
+        const auto& type = v.type();
+
+        switch ( type.tag ) {
+            case TypeInfo::Optional: v = type.optional->value(v); break;
+            case TypeInfo::StrongReference: v = type.strong_reference->value(v); break;
+            case TypeInfo::ValueReference: v = type.value_reference->value(v); break;
+            case TypeInfo::WeakReference: v = type.weak_reference->value(v); break;
+            default: return v;
+        }
+    }
+
+    return v;
+}
+
+// Follows optionals and references to the type they contain.
+const TypeInfo* unwrap(const TypeInfo* type) {
+    while ( true ) {
+        switch ( type->tag ) {
+            case TypeInfo::Optional: type = type->optional->valueType(); break;
+            case TypeInfo::StrongReference: type = type->strong_reference->valueType(); break;
+            case TypeInfo::ValueReference: type = type->value_reference->valueType(); break;
+            case TypeInfo::WeakReference: type = type->weak_reference->valueType(); break;
+            default: return type;
+        }
+    }
+}
+
+/** Bitmap that grows one bit at a time, as used for validity and boolean values. */
+class Bitmap {
+public:
+    void append(bool b) {
+        if ( _bits % 8 == 0 )
+            _data.push_back('\0');
+
+        if ( b )
+            _data.back() = static_cast<char>(_data.back() | (1 << (_bits % 8)));
+
+        ++_bits;
+    }
+
+    std::string_view data() const { return _data; }
+
+    void clear() {
+        _data.clear();
+        _bits = 0;
+    }
+
+private:
+    std::string _data;
+    size_t _bits = 0;
+};
+
+/** Length and null count of a column, as recorded in a record batch. */
+struct FieldNode {
+    int64_t length;
+    int64_t null_count;
+};
+
+} // namespace
+
+/**
+ * Base class for the columns collecting a field's values across units.
+ * Derived classes store the values in the buffers Arrow prescribes for their
+ * type; this class maintains the validity bitmap tracking nulls.
+ */
+class Column {
+public:
+    Column(std::string name) : _name(std::move(name)) {}
+    virtual ~Column() = default;
+
+    Column(const Column&) = delete;
+    Column(Column&&) = delete;
+    Column& operator=(const Column&) = delete;
+    Column& operator=(Column&&) = delete;
+
+    /** Returns the number of values stored. */
+    size_t length() const { return _length; }
+
+    /**
+     * Appends a value to the column. Optionals and references are followed
+     * to their contained value.
+     *
+     * @param v value to append; if invalid or unset, the column records a null
+     */
+    void append(const type_info::Value& v) {
+        if ( auto x = unwrap(v) ) {
+            _validity.append(true);
+            appendValue(x);
+        }
+        else {
+            _validity.append(false);
+            appendNull();
+            ++_null_count;
+        }
+
+        ++_length;
+    }
+
+    /** Returns the schema description of the column. */
+    flatbuffer::ObjectPtr field() const {
+        auto children = std::make_unique<flatbuffer::Vector>();
+        for ( const auto* c : this->children() )
+            children->add(c->field());
+
+        auto field = std::make_unique<flatbuffer::Table>();
+        field->reference(format::FieldName, std::make_unique<flatbuffer::String>(_name));
+        field->scalar<uint8_t>(format::FieldNullable, 1);
+        field->scalar<uint8_t>(format::FieldTypeType, type());
+        field->reference(format::FieldType, typeParameters());
+        field->reference(format::FieldChildren, std::move(children));
+        return field;
+    }
+
+    /**
+     * Records the column's current content for a record batch, followed by
+     * that of its children.
+     *
+     * @param nodes receives the column's length and null count
+     * @param buffers receives the column's buffers
+     */
+    void collect(std::vector<FieldNode>* nodes, std::vector<std::string_view>* buffers) const {
+        nodes->push_back({static_cast<int64_t>(_length), static_cast<int64_t>(_null_count)});
+        buffers->push_back(_null_count ? _validity.data() : std::string_view());
+        collectValues(buffers);
+
+        for ( const auto* c : children() )
+            c->collect(nodes, buffers);
+    }
+
+    /** Removes all values, retaining the memory allocated for them. */
+    void clear() {
+        for ( auto* c : children() )
+            c->clear();
+
+        _validity.clear();
+        _length = 0;
+        _null_count = 0;
+        clearValues();
+    }
+
+    /** Returns the columns nested inside this one. */
+    virtual std::vector<Column*> children() const { return {}; }
+
+protected:
+    /** Returns Arrow's ID for the column's type. */
+    virtual format::Type type() const = 0;
+
+    /** Returns Arrow's table describing the column type's parameters. */
+    virtual flatbuffer::ObjectPtr typeParameters() const { return std::make_unique<flatbuffer::Table>(); }
+
+    /** Stores a valid value. */
+    virtual void appendValue(const type_info::Value& v) = 0;
+
+    /** Stores a placeholder for a null value. */
+    virtual void appendNull() = 0;
+
+    /** Records the buffers following the validity bitmap. */
+    virtual void collectValues(std::vector<std::string_view>* buffers) const = 0;
+
+    /** Removes all values stored by the derived class. */
+    virtual void clearValues() = 0;
+
+private:
+    std::string _name;
+    Bitmap _validity;
+    size_t _length = 0;
+    size_t _null_count = 0;
+};
+
+namespace {
+
+// Creates the column for values of a given type.
+std::unique_ptr<Column> makeColumn(std::string name, const TypeInfo* type);
+
+/** Column of boolean values. */
+class BoolColumn : public Column {
+public:
+    using Column::Column;
+
+protected:
+    format::Type type() const override { return format::Bool; }
+    void appendValue(const type_info::Value& v) override { _values.append(v.type().bool_->get(v)); }
+    void appendNull() override { _values.append(false); }
+    void collectValues(std::vector<std::string_view>* buffers) const override { buffers->push_back(_values.data()); }
+    void clearValues() override { _values.clear(); }
+
+private:
+    Bitmap _values;
+};
+
+/** Column of fixed-size numerical values: integers, reals, times, and intervals. */
+class FixedWidthColumn : public Column {
+public:
+    FixedWidthColumn(std::string name, TypeInfo::Tag tag) : Column(std::move(name)), _tag(tag) {}
+
+protected:
+    format::Type type() const override {
+        switch ( _tag ) {
+            case TypeInfo::Real: return format::FloatingPoint;
+            case TypeInfo::Time: return format::Timestamp;
+            case TypeInfo::Interval: return format::Duration;
+            default: return format::Int;
+        }
+    }
+
+    flatbuffer::ObjectPtr typeParameters() const override {
+        auto params = std::make_unique<flatbuffer::Table>();
+
+        switch ( _tag ) {
+            case TypeInfo::Real: params->scalar<int16_t>(0, format::PrecisionDouble); break;
+            case TypeInfo::Time:
+            case TypeInfo::Interval: params->scalar<int16_t>(0, format::TimeUnitNanosecond); break;
+            default: {
+                auto is_signed = (_tag >= TypeInfo::SignedInteger_int8 && _tag <= TypeInfo::SignedInteger_int64);
+                params->scalar<int32_t>(0, static_cast<int32_t>(width() * 8));
+                params->scalar<uint8_t>(1, is_signed ? 1 : 0);
+            }
+        }
+
+        return params;
+    }
+
+    void appendValue(const type_info::Value& v) override {
+        const auto& t = v.type();
+
+        switch ( _tag ) {
+            case TypeInfo::Interval: return put(t.interval->get(v).nanoseconds());
+            case TypeInfo::Real: return put(t.real->get(v));
+            case TypeInfo::SignedInteger_int8: return put(t.signed_integer_int8->get(v));
+            case TypeInfo::SignedInteger_int16: return put(t.signed_integer_int16->get(v));
+            case TypeInfo::SignedInteger_int32: return put(t.signed_integer_int32->get(v));
+            case TypeInfo::SignedInteger_int64: return put(t.signed_integer_int64->get(v));
+            case TypeInfo::Time: return put(static_cast<int64_t>(t.time->get(v).nanoseconds()));
+            case TypeInfo::UnsignedInteger_uint8: return put(t.unsigned_integer_uint8->get(v));
+            case TypeInfo::UnsignedInteger_uint16: return put(t.unsigned_integer_uint16->get(v));
+            case TypeInfo::UnsignedInteger_uint32: return put(t.unsigned_integer_uint32->get(v));
+            case TypeInfo::UnsignedInteger_uint64: return put(t.unsigned_integer_uint64->get(v));
+            default: throw RuntimeError("unexpected type for fixed-width column");
+        }
+    }
+
+    void appendNull() override { _values.append(width(), '\0'); }
+    void collectValues(std::vector<std::string_view>* buffers) const override { buffers->push_back(_values); }
+    void clearValues() override { _values.clear(); }
+
+private:
+    // Returns the number of bytes per value.
+    size_t width() const {
+        switch ( _tag ) {
+            case TypeInfo::SignedInteger_int8:
+            case TypeInfo::UnsignedInteger_uint8: return 1;
+            case TypeInfo::SignedInteger_int16:
+            case TypeInfo::UnsignedInteger_uint16: return 2;
+            case TypeInfo::SignedInteger_int32:
+            case TypeInfo::UnsignedInteger_uint32: return 4;
+            default: return 8;
+        }
+    }
+
+    template<typename T>
+    void put(T x) {
+        _values.append(reinterpret_cast<const char*>(&x), sizeof(x));
+    }
+
+    TypeInfo::Tag _tag;
+    std::string _values;
+};
+
+/**
+ * Column of variable-size values, stored as offsets into a data buffer.
+ * Bytes become binary values, and strings and enum labels become UTF-8
+ * values. Any other type is stored through its string representation.
+ */
+class BinaryColumn : public Column {
+public:
+    BinaryColumn(std::string name, TypeInfo::Tag tag) : Column(std::move(name)), _tag(tag) { clearValues(); }
+
+protected:
+    format::Type type() const override { return _tag == TypeInfo::Bytes ? format::Binary : format::Utf8; }
+
+    void appendValue(const type_info::Value& v) override {
+        const auto& t = v.type();
+
+        switch ( t.tag ) {
+            case TypeInfo::Bytes: _data.append(t.bytes->get(v).str()); break;
+            case TypeInfo::String: _data.append(t.string->get(v)); break;
+            case TypeInfo::Enum: appendLabel(v); break;
+            default: _data.append(v.to_string());
+        }
+
+        appendOffset();
+    }
+
+    void appendNull() override { appendOffset(); }
+
+    void collectValues(std::vector<std::string_view>* buffers) const override {
+        buffers->push_back(_offsets);
+        buffers->push_back(_data);
+    }
+
+    void clearValues() override {
+        _offsets.clear();
+        _data.clear();
+        appendOffset();
+    }
+
+private:
+    // Appends the label of an enum value, avoiding the copy that `Enum::get()` makes for known labels.
+    void appendLabel(const type_info::Value& v) {
+        if ( const auto* l = v.type().enum_->find(v) )
+            _data.append(l->name);
+        else
+            _data.append(v.type().enum_->get(v).name);
+    }
+
+    // Records the current end of the data as an offset.
+    void appendOffset() {
+        if ( _data.size() > static_cast<size_t>(std::numeric_limits<int32_t>::max()) )
+            throw RuntimeError("column data exceeds 2GB per batch, use a smaller batch size");
+
+        auto x = static_cast<int32_t>(_data.size());
+        _offsets.append(reinterpret_cast<const char*>(&x), sizeof(x));
+    }
+
+    TypeInfo::Tag _tag;
+    std::string _offsets;
+    std::string _data;
+};
+
+/** Column of vectors or sets, stored as offsets into a column of their elements. */
+class ListColumn : public Column {
+public:
+    ListColumn(std::string name, const TypeInfo* element_type)
+        : Column(std::move(name)), _elements(makeColumn("item", element_type)) {
+        clearValues();
+    }
+
+    std::vector<Column*> children() const override { return {_elements.get()}; }
+
+protected:
+    format::Type type() const override { return format::List; }
+
+    void appendValue(const type_info::Value& v) override {
+        const auto& t = v.type();
+        auto append = [this](const type_info::Value& e) { _elements->append(e); };
+
+        if ( t.tag == TypeInfo::Vector )
+            t.vector->forEach(v, append);
+        else
+            t.set->forEach(v, append);
+
+        appendOffset();
+    }
+
+    void appendNull() override { appendOffset(); }
+    void collectValues(std::vector<std::string_view>* buffers) const override { buffers->push_back(_offsets); }
+
+    void clearValues() override {
+        _offsets.clear();
+        appendOffset();
+    }
+
+private:
+    // Records the current number of elements as an offset.
+    void appendOffset() {
+        if ( _elements->length() > static_cast<size_t>(std::numeric_limits<int32_t>::max()) )
+            throw RuntimeError("list column exceeds 2^31 elements per batch, use a smaller batch size");
+
+        auto x = static_cast<int32_t>(_elements->length());
+        _offsets.append(reinterpret_cast<const char*>(&x), sizeof(x));
+    }
+
+    std::unique_ptr<Column> _elements;
+    std::string _offsets;
+};
+
+} // namespace
+
+/**
+ * Column of structs or bitfields, which stores each field in a child column.
+ * As in our other output formats, the fields of an anonymous bitfield are
+ * merged into the surrounding struct.
+ */
+class StructColumn : public Column {
+public:
+    StructColumn(std::string name, const TypeInfo* type) : Column(std::move(name)) {
+        if ( type->tag == TypeInfo::Bitfield ) {
+            for ( const auto& b : type->bitfield->bits() )
+                _members.push_back({nullptr, type->bitfield, &b, makeColumn(b.name, b.type)});
+
+            return;
+        }
+
+        _struct = type->struct_;
+
+        for ( const auto& f_ : _struct->fields() ) {
+            const auto& f = f_.get();
+
+            if ( f.type->tag == TypeInfo::Bitfield && f.isAnonymous() ) {
+                for ( const auto& b : f.type->bitfield->bits() )
+                    _members.push_back({&f, f.type->bitfield, &b, makeColumn(b.name, b.type)});
+            }
+            else
+                _members.push_back({&f, nullptr, nullptr, makeColumn(f.name, f.type)});
+        }
+    }
+
+    std::vector<Column*> children() const override {
+        std::vector<Column*> columns;
+        columns.reserve(_members.size());
+
+        for ( const auto& m : _members )
+            columns.push_back(m.column.get());
+
+        return columns;
+    }
+
+protected:
+    format::Type type() const override { return format::Struct; }
+
+    void appendValue(const type_info::Value& v) override {
+        for ( const auto& m : _members ) {
+            auto x = (m.field ? _struct->value(v, *m.field) : v);
+
+            if ( m.bits && x )
+                x = m.bitfield->value(x, *m.bits);
+
+            m.column->append(x);
+        }
+    }
+
+    void appendNull() override {
+        for ( const auto& m : _members )
+            m.column->append(type_info::Value());
+    }
+
+    void collectValues(std::vector<std::string_view>* buffers) const override {}
+    void clearValues() override {}
+
+private:
+    struct Member {
+        const type_info::struct_::Field* field; // struct field to read, or null for a bitfield's own bits
+        const type_info::Bitfield* bitfield;    // bitfield type if member is one of its bits, or null
+        const type_info::bitfield::Bits* bits;  // bits to read from the bitfield, or null
+        std::unique_ptr<Column> column;         // column storing the member's values
+    };
+
+    const type_info::Struct* _struct = nullptr;
+    std::vector<Member> _members;
+};
+
+namespace {
+
+std::unique_ptr<Column> makeColumn(std::string name, const TypeInfo* type) {
+    type = unwrap(type);
+
+    switch ( type->tag ) {
+        case TypeInfo::Bool: return std::make_unique<BoolColumn>(std::move(name));
+
+        case TypeInfo::Interval:
+        case TypeInfo::Real:
+        case TypeInfo::SignedInteger_int8:
+        case TypeInfo::SignedInteger_int16:
+        case TypeInfo::SignedInteger_int32:
+        case TypeInfo::SignedInteger_int64:
+        case TypeInfo::Time:
+        case TypeInfo::UnsignedInteger_uint8:
+        case TypeInfo::UnsignedInteger_uint16:
+        case TypeInfo::UnsignedInteger_uint32:
+        case TypeInfo::UnsignedInteger_uint64: return std::make_unique<FixedWidthColumn>(std::move(name), type->tag);
+
+        case TypeInfo::Bitfield:
+        case TypeInfo::Struct: return std::make_unique<StructColumn>(std::move(name), type);
+
+        case TypeInfo::Set: return std::make_unique<ListColumn>(std::move(name), type->set->dereferencedType());
+        case TypeInfo::Vector: return std::make_unique<ListColumn>(std::move(name), type->vector->dereferencedType());
+
+        default: return std::make_unique<BinaryColumn>(std::move(name), type->tag);
+    }
+}
+
+} // namespace
+
+} // namespace columnar
+
+ArrowPrinter::ArrowPrinter(std::ostream& output, uint64_t batch_size)
+    : _output(output), _batch_size(std::max(batch_size, uint64_t(1))) {}
+
+ArrowPrinter::~ArrowPrinter() = default;
+
+void ArrowPrinter::print(const type_info::Value& v) {
+    if ( ! _units ) {
+        const auto* type = columnar::unwrap(&v.type());
+        if ( type->tag != TypeInfo::Struct )
+            throw RuntimeError("columnar output requires a unit");
+
+        _type = &v.type();
+        _units = std::make_unique<columnar::StructColumn>("", type);
+        writeSchema();
+    }
+    else if ( &v.type() != _type )
+        throw RuntimeError("columnar output requires all units to be of the same type");
+
+    _units->append(v);
+
+    if ( _units->length() >= _batch_size )
+        writeBatch();
+}
+
+void ArrowPrinter::finish() {
+    if ( _units && _units->length() )
+        writeBatch();
+
+    // End-of-stream marker.
+    const int32_t eos[] = {-1, 0};
+    out().write(reinterpret_cast<const char*>(eos), sizeof(eos));
+    out().flush();
+}
+
+void ArrowPrinter::writeSchema() {
+    auto fields = std::make_unique<flatbuffer::Vector>();
+    for ( const auto* c : _units->children() )
+        fields->add(c->field());
+
+    auto schema = std::make_unique<flatbuffer::Table>();
+    schema->scalar<int16_t>(format::SchemaEndianness, systemByteOrder() == ByteOrder::Big ? 1 : 0);
+    schema->reference(format::SchemaFields, std::move(fields));
+
+    flatbuffer::Table message;
+    message.scalar<int16_t>(format::MessageVersion, format::MetadataVersionV5);
+    message.scalar<uint8_t>(format::MessageHeaderType, format::Schema);
+    message.reference(format::MessageHeader, std::move(schema));
+    message.scalar<int64_t>(format::MessageBodyLength, 0);
+
+    writeMessage(flatbuffer::finish(message), {});
+}
+
+void ArrowPrinter::writeBatch() {
+    std::vector<columnar::FieldNode> nodes;
+    std::vector<std::string_view> buffers;
+
+    for ( const auto* c : _units->children() )
+        c->collect(&nodes, &buffers);
+
+    std::string buffer_specs;
+    int64_t offset = 0;
+
+    for ( const auto& b : buffers ) {
+        const int64_t spec[] = {offset, static_cast<int64_t>(b.size())};
+        buffer_specs.append(reinterpret_cast<const char*>(spec), sizeof(spec));
+        offset += static_cast<int64_t>(b.size() + padding(b.size()));
+    }
+
+    auto node_specs =
+        std::string(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(columnar::FieldNode));
+
+    auto batch = std::make_unique<flatbuffer::Table>();
+    batch->scalar<int64_t>(format::RecordBatchLength, static_cast<int64_t>(_units->length()));
+    batch->reference(format::RecordBatchNodes, std::make_unique<flatbuffer::Structs>(node_specs, nodes.size()));
+    batch->reference(format::RecordBatchBuffers, std::make_unique<flatbuffer::Structs>(buffer_specs, buffers.size()));
+
+    flatbuffer::Table message;
+    message.scalar<int16_t>(format::MessageVersion, format::MetadataVersionV5);
+    message.scalar<uint8_t>(format::MessageHeaderType, format::RecordBatch);
+    message.reference(format::MessageHeader, std::move(batch));
+    message.scalar<int64_t>(format::MessageBodyLength, offset);
+
+    writeMessage(flatbuffer::finish(message), buffers);
+    _units->clear();
+}
+
+void ArrowPrinter::writeMessage(const std::string& metadata, const std::vector<std::string_view>& body) {
+    static const char zeros[8] = {0};
+
+    const int32_t prefix[] = {-1, static_cast<int32_t>(metadata.size())};
+    out().write(reinterpret_cast<const char*>(prefix), sizeof(prefix));
+    out().write(metadata.data(), static_cast<std::streamsize>(metadata.size()));
+
+    for ( const auto& b : body ) {
+        out().write(b.data(), static_cast<std::streamsize>(b.size()));
+        out().write(zeros, static_cast<std::streamsize>(padding(b.size())));
+    }
+}
@@ -0,0 +1,75 @@
+// Copyright (c) 2020-now by the Zeek Project. See LICENSE for details.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <hilti/rt/type-info.h>
+
+namespace columnar {
+class StructColumn;
+} // namespace columnar
+
+/**
+ * Render a sequence of parsed units into columnar batches, written as an
+ * Apache Arrow IPC stream.
+ *
+ * All units must be of the same type. Each field of the unit becomes one
+ * column, with sub-units turning into nested struct columns and vectors into
+ * list columns. Field values that are not set are recorded as nulls. The
+ * columns' buffers are retained across batches, so that, once warmed up,
+ * adding atomic values does not allocate memory.
+ */
+class ArrowPrinter {
+public:
+    /**
+     * Constructor.
+     *
+     * @param output stream to send output to
+     * @param batch_size maximum number of units to group into one record batch
+     */
+    ArrowPrinter(std::ostream& output, uint64_t batch_size = 1024);
+    ~ArrowPrinter();
+
+    ArrowPrinter(const ArrowPrinter&) = delete;
+    ArrowPrinter(ArrowPrinter&&) = delete;
+    ArrowPrinter& operator=(const ArrowPrinter&) = delete;
+    ArrowPrinter& operator=(ArrowPrinter&&) = delete;
+
+    /**
+     * Adds one parsed unit to the current batch. The first unit determines
+     * the schema and triggers writing it out. Once the batch is full, it
+     * gets written out as well.
+     *
+     * @param v value representing parsed unit to render
+     * @throws RuntimeError if the value is not a unit, or of a different
+     * type than the units added before
+     */
+    void print(const hilti::rt::type_info::Value& v);
+
+    /** Writes out any pending units and terminates the stream. */
+    void finish();
+
+private:
+    // Return output stream.
+    std::ostream& out() { return _output; }
+
+    // Writes out schema message derived from the columns.
+    void writeSchema();
+
+    // Writes out a record batch message for all pending units, then resets the columns.
+    void writeBatch();
+
+    // Writes out an encapsulated IPC message, including its body buffers.
+    void writeMessage(const std::string& metadata, const std::vector<std::string_view>& body);
+
+    std::ostream& _output;                          // output stream
+    uint64_t _batch_size;                           // maximum number of units per batch
+    const hilti::rt::TypeInfo* _type = nullptr;     // type of units, set with the first one
+    std::unique_ptr<columnar::StructColumn> _units; // columns for the units' fields
+};
@@ -40,8 +40,10 @@ nlohmann::json JSONPrinter::convert(const hilti::rt::type_info::Value& v) {
         case TypeInfo::Map: {
             auto j = json::array();
 
-            for ( auto [key, value] : type.map->iterate(v) )
+            type.map->forEach(v, [&](const type_info::Value& key, const type_info::Value& value) {
                 j.push_back({convert(key), convert(value)});
+            });
+
             return j;
         }
         case TypeInfo::MapIterator: {
@@ -70,8 +72,7 @@ nlohmann::json JSONPrinter::convert(const hilti::rt::type_info::Value& v) {
         case TypeInfo::Set: {
             auto j = json::array();
 
-            for ( auto i : type.set->iterate(v) )
-                j.push_back(convert(i));
+            type.set->forEach(v, [&](const type_info::Value& i) { j.push_back(convert(i)); });
 
             return j;
         }
@@ -162,8 +163,7 @@ nlohmann::json JSONPrinter::convert(const hilti::rt::type_info::Value& v) {
         case TypeInfo::Vector: {
             auto j = json::array();
 
-            for ( auto i : type.vector->iterate(v) )
-                j.push_back(convert(i));
+            type.vector->forEach(v, [&](const type_info::Value& i) { j.push_back(convert(i)); });
 
             return j;
         }
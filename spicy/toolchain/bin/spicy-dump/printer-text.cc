@@ -55,7 +55,7 @@ void TextPrinter::print(const type_info::Value& v) {
 
             out() << '{';
 
-            for ( auto [key, value] : type.map->iterate(v) ) {
+            type.map->forEach(v, [&](const type_info::Value& key, const type_info::Value& value) {
                 if ( ! first )
                     out() << ", ";
                 else
@@ -64,7 +64,7 @@ void TextPrinter::print(const type_info::Value& v) {
                 print(key);
                 out() << ": ";
                 print(value);
-            }
+            });
 
             out() << '}';
             break;
@@ -100,14 +100,14 @@ void TextPrinter::print(const type_info::Value& v) {
 
             out() << '{';
 
-            for ( auto i : type.set->iterate(v) ) {
+            type.set->forEach(v, [&](const type_info::Value& i) {
                 if ( ! first )
                     out() << ", ";
                 else
                     first = false;
 
                 print(i);
-            }
+            });
 
             out() << '}';
             break;
@@ -222,12 +222,12 @@ void TextPrinter::print(const type_info::Value& v) {
 
             bool empty = true;
             indent([&]() {
-                for ( auto i : type.vector->iterate(v) ) {
+                type.vector->forEach(v, [&](const type_info::Value& i) {
                     out() << "\n";
                     outputIndent();
                     print(i);
                     empty = false;
-                }
+                });
             });
 
             if ( ! empty ) {
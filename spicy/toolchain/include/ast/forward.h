@@ -61,6 +61,7 @@ class Gap;
 class SequenceNumber;
 class SetAutoTrim;
 class SetInitialSequenceNumber;
+class SetMaxBufferSize;
 class SetPolicy;
 class Skip;
 class Trim;
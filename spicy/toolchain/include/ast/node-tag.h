@@ -29,6 +29,7 @@ constexpr unsigned int Gap = 10306;
 constexpr unsigned int SequenceNumber = 10307;
 constexpr unsigned int SetAutoTrim = 10308;
 constexpr unsigned int SetInitialSequenceNumber = 10309;
+constexpr unsigned int SetMaxBufferSize = 10311;
 constexpr unsigned int SetPolicy = 10310;
 constexpr unsigned int Size = 10312;
 constexpr unsigned int Skip = 10313;
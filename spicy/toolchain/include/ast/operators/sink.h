@@ -22,6 +22,7 @@ SPICY_NODE_OPERATOR(sink, Gap)
 SPICY_NODE_OPERATOR(sink, SequenceNumber)
 SPICY_NODE_OPERATOR(sink, SetAutoTrim)
 SPICY_NODE_OPERATOR(sink, SetInitialSequenceNumber)
+SPICY_NODE_OPERATOR(sink, SetMaxBufferSize)
 SPICY_NODE_OPERATOR(sink, SetPolicy)
 SPICY_NODE_OPERATOR(sink, Skip)
 SPICY_NODE_OPERATOR(sink, Trim)
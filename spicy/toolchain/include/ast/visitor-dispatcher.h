@@ -28,6 +28,7 @@ public:
     virtual void operator()(spicy::operator_::sink::SequenceNumber* n) {}
     virtual void operator()(spicy::operator_::sink::SetAutoTrim* n) {}
     virtual void operator()(spicy::operator_::sink::SetInitialSequenceNumber* n) {}
+    virtual void operator()(spicy::operator_::sink::SetMaxBufferSize* n) {}
     virtual void operator()(spicy::operator_::sink::SetPolicy* n) {}
     virtual void operator()(spicy::operator_::sink::Skip* n) {}
     virtual void operator()(spicy::operator_::sink::Trim* n) {}
@@ -289,6 +289,34 @@ the initial number is not set, the sink implicitly uses zero instead.
 };
 HILTI_OPERATOR_IMPLEMENTATION(SetInitialSequenceNumber);
 
+class SetMaxBufferSize : public hilti::BuiltInMemberCall {
+public:
+    Signature signature(hilti::Builder* builder_) const final {
+        auto builder = Builder(builder_);
+        return Signature{
+            .kind = Kind::MemberCall,
+            .self = {hilti::parameter::Kind::InOut, builder.typeSink()},
+            .member = "set_max_buffer_size",
+            .param0 =
+                {
+                    .name = "max",
+                    .type = {hilti::parameter::Kind::In, builder.typeUnsignedInteger(64)},
+                },
+            .result = {hilti::Constness::Const, builder.typeVoid()},
+            .ns = "sink",
+            .doc = R"(
+Limits the number of bytes of out-of-order data that the sink buffers for
+reassembly. If more is pending, the sink skips over any missing data until
+back within limits, reporting each skip through the unit's ``%skipped`` hook.
+A limit of zero, which is the default, means unlimited. The limit applies only with auto-trimming enabled.
+)",
+        };
+    }
+
+    HILTI_OPERATOR(spicy, sink::SetMaxBufferSize);
+};
+HILTI_OPERATOR_IMPLEMENTATION(SetMaxBufferSize);
+
 class SetPolicy : public hilti::BuiltInMemberCall {
 public:
     Signature signature(hilti::Builder* builder_) const final {
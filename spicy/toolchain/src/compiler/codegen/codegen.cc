@@ -384,6 +384,11 @@ struct VisitorPass2 : public visitor::MutatingPostOrder {
         replaceNode(n, x);
     }
 
+    void operator()(operator_::sink::SetMaxBufferSize* n) final {
+        auto* x = builder()->memberCall(n->op0(), "set_max_buffer_size", {argument(n->op2(), 0)});
+        replaceNode(n, x);
+    }
+
     void operator()(operator_::sink::SetPolicy* n) final {
         auto* x = builder()->memberCall(n->op0(), "set_policy", {argument(n->op2(), 0)});
         replaceNode(n, x);
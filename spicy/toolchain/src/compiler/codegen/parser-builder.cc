@@ -146,7 +146,7 @@ struct ProductionVisitor : public production::Visitor {
         if ( pb->options().debug ) {
             pb->state().printDebug(builder());
             builder()->addDebugMsg("spicy-verbose", fmt("- parsing production: %s", hilti::util::trim(std::string(p))));
-            builder()->addCall("hilti::debugIndent", {builder()->stringLiteral("spicy-verbose")});
+            builder()->addDebugIndent("spicy-verbose");
         }
     }
 
@@ -154,7 +154,7 @@ struct ProductionVisitor : public production::Visitor {
         HILTI_DEBUG(spicy::logging::debug::ParserBuilder, fmt("- end production"));
 
         if ( pb->options().debug )
-            builder()->addCall("hilti::debugDedent", {builder()->stringLiteral("spicy-verbose")});
+            builder()->addDebugDedent("spicy-verbose");
 
         builder()->addComment(fmt("End parsing production: %s", hilti::util::trim(std::string(p))),
                               hilti::statement::comment::Separator::After);
@@ -2148,7 +2148,8 @@ void ParserBuilder::addParserMethods(hilti::type::Struct* s, type::Unit* t, bool
     auto* attr_ext_overload = builder()->attributeSet(
         {builder()->attribute(hilti::attribute::kind::NeededByFeature, builder()->stringLiteral("is_filter")),
          builder()->attribute(hilti::attribute::kind::NeededByFeature, builder()->stringLiteral("supports_sinks")),
-         builder()->attribute(hilti::attribute::kind::Static)});
+         builder()->attribute(hilti::attribute::kind::Static),
+         builder()->attribute(hilti::attribute::kind::SuspendsOnlyForInput)});
 
     auto* f_ext_overload1_result = builder()->qualifiedType(builder()->typeStreamView(), hilti::Constness::Mutable);
     auto* f_ext_overload1 =
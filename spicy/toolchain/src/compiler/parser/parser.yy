@@ -263,6 +263,7 @@ static std::vector<hilti::DocString> _docs;
 %token UINT64
 %token UINT8
 %token UNIT
+%token UNORDERED
 %token UNPACK
 %token UNSET
 %token VAR
@@ -502,8 +503,8 @@ opt_func_params
 func_params   : func_params ',' func_param       { $$ = std::move($1); $$.push_back($3); }
               | func_param                       { $$ = hilti::type::function::Parameters{$1}; }
 
-func_param    : opt_func_param_kind local_id ':' type opt_init_expression
-                                                 { $$ = builder->declarationParameter($2, $4, $1, $5, {}, __loc__); }
+func_param    : opt_func_param_kind local_id ':' type opt_init_expression opt_attributes
+                                                 { $$ = builder->declarationParameter($2, $4, $1, $5, $6, __loc__); }
 
 func_result   : ':' qtype                        { $$ = std::move($2); }
 
@@ -653,7 +654,10 @@ base_type_no_ref
               | VIEW type_param_begin qtype type_param_end                { $$ = viewForType(builder, std::move($3), __loc__)->type(); }
 
               | MAP type_param_begin qtype ',' qtype type_param_end        { $$ = builder->typeMap(std::move($3), std::move($5), __loc__); }
+              | MAP type_param_begin qtype ',' qtype type_param_end UNORDERED
+                                                                           { auto* t = builder->typeMap(std::move($3), std::move($5), __loc__); t->setUnordered(true); $$ = t; }
               | SET type_param_begin qtype type_param_end                 { $$ = builder->typeSet(std::move($3), __loc__); }
+              | SET type_param_begin qtype type_param_end UNORDERED       { auto* t = builder->typeSet(std::move($3), __loc__); t->setUnordered(true); $$ = t; }
               | VECTOR type_param_begin qtype type_param_end              { $$ = builder->typeVector(std::move($3), __loc__); }
 
               | SINK                             { $$ = builder->typeSink(__loc__); }
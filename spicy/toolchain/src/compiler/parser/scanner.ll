@@ -62,7 +62,7 @@ doc_field    [ \t]*##<[^\n]*\n?
 doc_text     [ \t]*##[^\n]*\n?
 comment      [ \t]*#[^#\n]*\n?
 
-attribute \&(bit-order|byte-order|chunked|convert|count|cxxname|default|eod|internal|ipv4|ipv6|hilti_type|length|max-size|no-emit|nosub|on-heap|optional|originator|parse-at|parse-from|requires|responder|size|static|synchronize|transient|try|type|until|until-including|while|have_prototype)
+attribute \&(bit-order|byte-order|chunked|convert|count|cxxname|default|eod|internal|ipv4|ipv6|hilti_type|length|max-size|no-emit|nosub|on-heap|optional|originator|parse-at|parse-from|requires|requires-type-feature|responder|size|static|synchronize|transient|try|type|until|until-including|while|have_prototype)
 property  %(byte-order|context|cxx-include|debug|description|done|error|filter|mime-type|orig|port|random-access|resp|s_default|skip|skip-implementation|skip-post|skip-pre|spicy-version|sync-advance-block-size|synchronize-after|synchronize-at)
 
 blank     [ \t]
@@ -193,6 +193,7 @@ uint8                 return token::UINT8;
 unit                  return token::UNIT;
 unpack                return token::UNPACK;
 unset                 return token::UNSET;
+\&unordered           return token::UNORDERED;
 var                   return token::VAR;
 vector                return token::VECTOR;
 view                  return token::VIEW;
@@ -684,6 +684,13 @@ bool detail::resolver::resolve(Builder* builder, Node* root) {
 
     bool hilti_modified = (*hilti::plugin::registry().hiltiPlugin().ast_resolve)(builder, root);
 
-    return visitor::visit(VisitorPass2(builder, root), root, ".spicy",
-                          [&](const auto& v) { return v.isModified() || hilti_modified; });
+    auto v = VisitorPass2(builder, root);
+
+    // Visit only modules that may have changed since the previous round.
+    for ( auto* m : builder->context()->modulesToResolve() ) {
+        if ( auto tag = m->branchTag(); tag.empty() || tag == ".spicy" )
+            visitor::visit(v, m, ".spicy");
+    }
+
+    return v.isModified() || hilti_modified;
 }